@@ -128,11 +128,46 @@ static bool exit_datamode(void)
 	return ret;
 }
 
+/* Pass data to the data mode handler. Returns the number of bytes consumed.
+ * Lock mutex_data, before calling.
+ */
+static size_t raw_send_data(const uint8_t *data, size_t size_send, uint8_t flags)
+{
+	int size_sent;
+	size_t size_finish = 0;
+
+	LOG_INF("Raw send: size_send: %zu, data %p", size_send, (void *)data);
+	LOG_HEXDUMP_DBG(data, MIN(size_send, HEXDUMP_LIMIT), "RX");
+
+	k_mutex_lock(&mutex_mode, K_FOREVER);
+	if (datamode_handler) {
+		size_sent = datamode_handler(DATAMODE_SEND, data, size_send, flags);
+		if (size_sent > 0) {
+			size_finish = size_sent;
+		} else if (size_sent == 0) {
+			size_finish = size_send;
+		} else {
+			LOG_WRN("Raw send failed, %zu dropped", size_send);
+			size_finish = size_send;
+		}
+	} else {
+		LOG_WRN("no handler, %zu dropped", size_send);
+		size_finish = size_send;
+	}
+	k_mutex_unlock(&mutex_mode);
+
+#if defined(CONFIG_SLM_DATAMODE_URC)
+	rsp_send("\r\n#XDATAMODE: %zu\r\n", size_finish);
+#endif
+
+	return size_finish;
+}
+
 /* Lock mutex_data, before calling. */
 static void raw_send(uint8_t flags)
 {
 	uint8_t *data = NULL;
-	int size_send, size_sent, size_all, size_finish;
+	int size_send, size_all;
 
 	/* NOTE ring_buf_get_claim() might not return full size */
 	do {
@@ -141,34 +176,8 @@ static void raw_send(uint8_t flags)
 		if (size_all != size_send) {
 			flags |= SLM_DATAMODE_FLAGS_MORE_DATA;
 		}
-		LOG_INF("Raw send: size_send: %d, data %p", size_send, (void *)data);
 		if (data != NULL && size_send > 0) {
-
-			/* Raw data sending */
-			size_finish = 0;
-
-			LOG_HEXDUMP_DBG(data, MIN(size_send, HEXDUMP_LIMIT), "RX");
-			k_mutex_lock(&mutex_mode, K_FOREVER);
-			if (datamode_handler && size_send > 0) {
-				size_sent = datamode_handler(DATAMODE_SEND, data, size_send, flags);
-				if (size_sent > 0) {
-					size_finish += size_sent;
-				} else if (size_sent == 0) {
-					size_finish += size_send;
-				} else {
-					LOG_WRN("Raw send failed, %d dropped", size_send);
-					size_finish += size_send;
-				}
-				(void)ring_buf_get_finish(&data_rb, size_finish);
-			} else {
-				LOG_WRN("no handler, %d dropped", size_send);
-				(void)ring_buf_get_finish(&data_rb, size_send + size_finish);
-			}
-			k_mutex_unlock(&mutex_mode);
-
-#if defined(CONFIG_SLM_DATAMODE_URC)
-			rsp_send("\r\n#XDATAMODE: %d\r\n", size_finish);
-#endif
+			(void)ring_buf_get_finish(&data_rb, raw_send_data(data, size_send, flags));
 		} else {
 			break;
 		}
@@ -187,6 +196,23 @@ static void write_data_buf(const uint8_t *buf, size_t len)
 	}
 
 	while (index < len) {
+		/* The data would fill the whole buffer, which would then be sent.
+		 * Send it directly from the UART buffer instead.
+		 */
+		if (ring_buf_is_empty(&data_rb) && len - index >= CONFIG_SLM_DATAMODE_BUF_SIZE) {
+			ret = raw_send_data(buf + index, CONFIG_SLM_DATAMODE_BUF_SIZE,
+					    SLM_DATAMODE_FLAGS_MORE_DATA);
+			index += ret;
+			if (ret < CONFIG_SLM_DATAMODE_BUF_SIZE) {
+				/* Keep the rest of the buffer together, as if it had been copied. */
+				ring_buf_reset(&data_rb);
+				index += ring_buf_put(&data_rb, buf + index,
+						      CONFIG_SLM_DATAMODE_BUF_SIZE - ret);
+				raw_send(SLM_DATAMODE_FLAGS_MORE_DATA);
+			}
+			continue;
+		}
+
 		ret = ring_buf_put(&data_rb, buf + index, len - index);
 		if (ret) {
 			index += ret;
@@ -51,6 +51,17 @@ static struct {
 		struct modem_pipe *pipe;
 		uint8_t address;
 		uint8_t receive_buf[RECV_BUF_LEN];
+		/* Given when the CMUX can accept more data for this DLCI. */
+		struct k_sem tx_idle_sem;
+		/* Reserved by PPP or GNSS, which exchange data without going through SLM. */
+		bool reserved;
+		/* Data received and sent by SLM on this DLCI. */
+		struct {
+			uint32_t rx_bytes;
+			uint32_t tx_bytes;
+			uint32_t tx_dropped;
+			uint32_t tx_waits;
+		} stats;
 	} dlcis[CHANNEL_COUNT];
 	/* Index of the DLCI used for AT communication; defaults to 0. */
 	unsigned int at_channel;
@@ -85,6 +96,7 @@ static void rx_work_fn(struct k_work *work)
 					INDEX_TO_DLCI(i), is_at ? " (AT)" : "", ret);
 				continue;
 			}
+			cmux.dlcis[i].stats.rx_bytes += ret;
 
 			if (!is_at) {
 				LOG_INF("DLCI %u discarding %u bytes of data.", INDEX_TO_DLCI(i),
@@ -101,7 +113,7 @@ static void rx_work_fn(struct k_work *work)
 static void dlci_pipe_event_handler(struct modem_pipe *pipe,
 				    enum modem_pipe_event event, void *user_data)
 {
-	const struct cmux_dlci *const dlci = user_data;
+	struct cmux_dlci *const dlci = user_data;
 	bool is_at = (ARRAY_INDEX(cmux.dlcis, dlci) == cmux.at_channel);
 
 	switch (event) {
@@ -124,6 +136,7 @@ static void dlci_pipe_event_handler(struct modem_pipe *pipe,
 		break;
 
 	case MODEM_PIPE_EVENT_TRANSMIT_IDLE:
+		k_sem_give(&dlci->tx_idle_sem);
 		if (is_at &&
 		    cmux.dlcis[cmux.at_channel].instance.state == MODEM_CMUX_DLCI_STATE_OPEN &&
 		    !ring_buf_is_empty(&cmux.tx_rb)) {
@@ -154,28 +167,30 @@ static void init_dlci(size_t dlci_idx, uint16_t recv_buf_size,
 
 	dlci->pipe = modem_cmux_dlci_init(&cmux.instance, &dlci->instance, &dlci_config);
 	dlci->address = dlci_config.dlci_address;
+	k_sem_init(&dlci->tx_idle_sem, 0, 1);
 
 	modem_pipe_attach(dlci->pipe, dlci_pipe_event_handler, dlci);
 }
 
-static size_t cmux_write(struct modem_pipe *pipe, const uint8_t *data, size_t len)
+static size_t cmux_write(struct cmux_dlci *dlci, const uint8_t *data, size_t len)
 {
 	size_t sent_len = 0;
 	int ret = 0;
 
 	while (sent_len < len) {
 		/* Push data to CMUX TX buffer.  */
-		ret = modem_pipe_transmit(pipe, data, len - sent_len);
+		ret = modem_pipe_transmit(dlci->pipe, data, len - sent_len);
 		if (ret <= 0) {
 			break;
 		}
 		sent_len += ret;
 		data += ret;
 	}
+	dlci->stats.tx_bytes += sent_len;
 
 	if (ret < 0) {
 		LOG_DBG("DLCI %u (AT). Sent %u out of %u bytes. (%d)",
-			INDEX_TO_DLCI(cmux.at_channel), sent_len, len, ret);
+			dlci->address, sent_len, len, ret);
 	}
 
 	return sent_len;
@@ -190,7 +205,7 @@ static void tx_work_fn(struct k_work *work)
 
 	do {
 		len = ring_buf_get_claim(&cmux.tx_rb, &data, ring_buf_capacity_get(&cmux.tx_rb));
-		len = cmux_write(cmux.dlcis[cmux.at_channel].pipe, data, len);
+		len = cmux_write(&cmux.dlcis[cmux.at_channel], data, len);
 		ring_buf_get_finish(&cmux.tx_rb, len);
 
 	} while (!ring_buf_is_empty(&cmux.tx_rb) && len != 0);
@@ -218,6 +233,7 @@ static int cmux_write_at_channel_nonblock(const uint8_t *data, size_t len)
 		ring_buf_put(&cmux.tx_rb, data, len);
 	} else {
 		LOG_WRN("TX buf overflow, dropping %u bytes.", len);
+		cmux.dlcis[cmux.at_channel].stats.tx_dropped += len;
 		ret = -ENOBUFS;
 	}
 
@@ -228,9 +244,11 @@ static int cmux_write_at_channel_nonblock(const uint8_t *data, size_t len)
 
 static int cmux_write_at_channel_block(const uint8_t *data, size_t len)
 {
+	struct cmux_dlci *dlci = &cmux.dlcis[cmux.at_channel];
 	size_t sent = 0;
 	size_t ret;
 	uint8_t *buf;
+	int err;
 
 	k_mutex_lock(&cmux.tx_rb_mutex, K_FOREVER);
 
@@ -239,16 +257,27 @@ static int cmux_write_at_channel_block(const uint8_t *data, size_t len)
 		sent += ret;
 		if (!ret) {
 			/* Buffer full, send partial data. */
+			k_sem_reset(&dlci->tx_idle_sem);
 			ret = ring_buf_get_claim(&cmux.tx_rb, &buf,
 						 ring_buf_capacity_get(&cmux.tx_rb));
-			ret = cmux_write(cmux.dlcis[cmux.at_channel].pipe, buf, ret);
+			ret = cmux_write(dlci, buf, ret);
 			ring_buf_get_finish(&cmux.tx_rb, ret);
 
 			if (ret == 0) {
-				/* Cannot send and buffers are full.
-				 * Data will be dropped.
+				/* The CMUX TX buffer is full, for example with data of other DLCIs.
+				 * Wait for it to accept data again, so that they take turns.
 				 */
-				break;
+				dlci->stats.tx_waits++;
+				k_mutex_unlock(&cmux.tx_rb_mutex);
+				err = k_sem_take(&dlci->tx_idle_sem,
+						 K_MSEC(CONFIG_SLM_CMUX_AT_TX_TIMEOUT));
+				k_mutex_lock(&cmux.tx_rb_mutex, K_FOREVER);
+				if (err) {
+					/* Cannot send and buffers are full.
+					 * Data will be dropped.
+					 */
+					break;
+				}
 			}
 		}
 	}
@@ -257,6 +286,7 @@ static int cmux_write_at_channel_block(const uint8_t *data, size_t len)
 
 	if (sent < len) {
 		LOG_WRN("TX buf overflow, dropping %u bytes.", len - sent);
+		dlci->stats.tx_dropped += len - sent;
 		return -ENOBUFS;
 	}
 
@@ -281,6 +311,30 @@ static int cmux_write_at_channel(const uint8_t *data, size_t len)
 	return ret;
 }
 
+SLM_AT_CMD_CUSTOM(xcmuxstat, "AT#XCMUXSTAT", handle_at_cmuxstat);
+static int handle_at_cmuxstat(enum at_parser_cmd_type cmd_type, struct at_parser *parser,
+			      uint32_t param_count)
+{
+	if (cmd_type != AT_PARSER_CMD_TYPE_READ) {
+		return -EINVAL;
+	}
+
+	for (size_t i = 0; i != ARRAY_SIZE(cmux.dlcis); ++i) {
+		const struct cmux_dlci *dlci = &cmux.dlcis[i];
+
+		if (dlci->reserved) {
+			/* The data of this DLCI is not seen here. */
+			continue;
+		}
+
+		rsp_send("\r\n#XCMUXSTAT: %u,%u,%u,%u,%u\r\n", dlci->address,
+			 dlci->stats.rx_bytes, dlci->stats.tx_bytes, dlci->stats.tx_dropped,
+			 dlci->stats.tx_waits);
+	}
+
+	return 0;
+}
+
 static void close_pipe(struct modem_pipe **pipe)
 {
 	if (*pipe) {
@@ -367,7 +421,10 @@ struct modem_pipe *slm_cmux_reserve(enum cmux_channel channel)
 	 * after which this pipe's events and data won't be received here anymore
 	 * until the channel is released (below) and we attach back to the pipe.
 	 */
-	return cmux_get_dlci(channel)->pipe;
+	struct cmux_dlci *dlci = cmux_get_dlci(channel);
+
+	dlci->reserved = true;
+	return dlci->pipe;
 }
 
 void slm_cmux_release(enum cmux_channel channel, bool fallback)
@@ -379,6 +436,7 @@ void slm_cmux_release(enum cmux_channel channel, bool fallback)
 		cmux.at_channel = 0;
 	}
 #endif
+	dlci->reserved = false;
 	modem_pipe_attach(dlci->pipe, dlci_pipe_event_handler, dlci);
 }
 
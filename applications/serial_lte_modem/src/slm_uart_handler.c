@@ -58,6 +58,10 @@ static atomic_t recovery_state;
 
 K_SEM_DEFINE(tx_done_sem, 0, 1);
 
+/* Set while data is sent directly from the buffer of the caller. */
+static bool tx_direct;
+static bool tx_direct_aborted;
+
 static inline struct rx_buf_t *block_start_get(uint8_t *buf)
 {
 	size_t block_num;
@@ -210,6 +214,12 @@ static void uart_callback(const struct device *dev, struct uart_event *evt, void
 	switch (evt->type) {
 	case UART_TX_DONE:
 	case UART_TX_ABORTED:
+		if (tx_direct) {
+			tx_direct = false;
+			tx_direct_aborted = (evt->type == UART_TX_ABORTED);
+			k_sem_give(&tx_done_sem);
+			break;
+		}
 		err = ring_buf_get_finish(&tx_buf, evt->data.tx.len);
 		if (err) {
 			LOG_ERR("UART_TX_%s failure: %d",
@@ -264,6 +274,41 @@ static void uart_callback(const struct device *dev, struct uart_event *evt, void
 	}
 }
 
+/* Send the data from the buffer of the caller, once tx_buf has been sent.
+ * Returns 1 if the data must be written to tx_buf instead.
+ * Lock mutex_tx_put, before calling.
+ */
+static int tx_write_direct(const uint8_t *data, size_t len)
+{
+	enum pm_device_state state = PM_DEVICE_STATE_OFF;
+	int err;
+
+	k_sem_take(&tx_done_sem, K_FOREVER);
+
+	/* tx_buf is kept until the UART is resumed. */
+	pm_device_state_get(slm_uart_dev, &state);
+	if (state != PM_DEVICE_STATE_ACTIVE || !ring_buf_is_empty(&tx_buf)) {
+		k_sem_give(&tx_done_sem);
+		return 1;
+	}
+
+	tx_direct = true;
+	err = uart_tx(slm_uart_dev, data, len, SYS_FOREVER_US);
+	if (err) {
+		LOG_ERR("UART TX error: %d", err);
+		tx_direct = false;
+		k_sem_give(&tx_done_sem);
+		return err;
+	}
+
+	/* The buffer of the caller must not be released before it has been sent. */
+	k_sem_take(&tx_done_sem, K_FOREVER);
+	err = tx_direct_aborted ? -EIO : 0;
+	k_sem_give(&tx_done_sem);
+
+	return err;
+}
+
 /* Write the data to tx_buffer and trigger sending. */
 static int slm_uart_tx_write(const uint8_t *data, size_t len)
 {
@@ -272,6 +317,15 @@ static int slm_uart_tx_write(const uint8_t *data, size_t len)
 	int err;
 
 	k_mutex_lock(&mutex_tx_put, K_FOREVER);
+
+	/* Data that does not fit in tx_buf would have to wait for the UART anyway. */
+	if (len > ring_buf_capacity_get(&tx_buf)) {
+		err = tx_write_direct(data, len);
+		if (err != 1) {
+			k_mutex_unlock(&mutex_tx_put);
+			return err;
+		}
+	}
 	while (sent < len) {
 		ret = ring_buf_put(&tx_buf, data + sent, len - sent);
 		if (ret) {
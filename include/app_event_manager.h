@@ -55,6 +55,11 @@ enum app_event_type_flags {
 	 */
 	APP_EVENT_TYPE_FLAGS_INIT_LOG_ENABLE =
 		APP_EVENT_TYPE_FLAGS_USER_SETTABLE_START,
+	/** processes event in the high priority lane.
+	 *  Flag set by user. Ignored unless
+	 *  @kconfig{CONFIG_APP_EVENT_MANAGER_PRIORITY_LANES} is enabled.
+	 */
+	APP_EVENT_TYPE_FLAGS_HIGH_PRIORITY,
 	/** shows number of predefined flags.*/
 	APP_EVENT_TYPE_FLAGS_COUNT,
 	/** marks beginning of user-specific flags.*/
@@ -133,6 +138,70 @@ static inline bool app_event_get_type_flag(const struct event_type *et,
 	const struct {} _CONCAT(_CONCAT(__event_subscriber_, ename), final_sub_redefined) = {}
 
 
+/** @brief Subscribe a listener to the early notification list for selected
+ *  subtypes of an event type.
+ *
+ * The listener is notified only about events whose subtype, as returned by the
+ * function registered with @ref APP_EVENT_SUBTYPE_REGISTER, is set in the mask.
+ * If no subtype function is registered for the event type, the listener is
+ * notified about all events.
+ *
+ * @note
+ * For this macro to be available the
+ * @kconfig{CONFIG_APP_EVENT_MANAGER_SUBSCRIBER_FILTER} option needs to be enabled.
+ *
+ * @param lname         Name of the listener.
+ * @param ename         Name of the event.
+ * @param subtype_mask  Bitmask of event subtypes.
+ */
+#define APP_EVENT_SUBSCRIBE_EARLY_FILTERED(lname, ename, subtype_mask)			\
+	_APP_EVENT_SUBSCRIBE_FILTERED(lname, ename,					\
+				      _APP_EM_SUBS_PRIO_ID(_APP_EM_SUBS_PRIO_EARLY),	\
+				      subtype_mask)
+
+
+/** @brief Subscribe a listener to the normal notification list for selected
+ *  subtypes of an event type.
+ *
+ * The listener is notified only about events whose subtype, as returned by the
+ * function registered with @ref APP_EVENT_SUBTYPE_REGISTER, is set in the mask.
+ * If no subtype function is registered for the event type, the listener is
+ * notified about all events.
+ *
+ * @note
+ * For this macro to be available the
+ * @kconfig{CONFIG_APP_EVENT_MANAGER_SUBSCRIBER_FILTER} option needs to be enabled.
+ *
+ * @param lname         Name of the listener.
+ * @param ename         Name of the event.
+ * @param subtype_mask  Bitmask of event subtypes.
+ */
+#define APP_EVENT_SUBSCRIBE_FILTERED(lname, ename, subtype_mask)			\
+	_APP_EVENT_SUBSCRIBE_FILTERED(lname, ename,					\
+				      _APP_EM_SUBS_PRIO_ID(_APP_EM_SUBS_PRIO_NORMAL),	\
+				      subtype_mask)
+
+
+/** @brief Register a function providing subtype of an event type.
+ *
+ * The function is called once for every processed event of the given type
+ * and must be of the form `uint8_t fn(const struct app_event_header *aeh)`.
+ * The returned subtype must be lower than 32. Listeners subscribed using
+ * @ref APP_EVENT_SUBSCRIBE_FILTERED are notified only about the subtypes
+ * they selected, without calling their notification function for others.
+ *
+ * Only one function can be registered for an event type.
+ *
+ * @note
+ * For this macro to be available the
+ * @kconfig{CONFIG_APP_EVENT_MANAGER_SUBSCRIBER_FILTER} option needs to be enabled.
+ *
+ * @param ename       Name of the event.
+ * @param subtype_fn  Function returning subtype of an event.
+ */
+#define APP_EVENT_SUBTYPE_REGISTER(ename, subtype_fn) _APP_EVENT_SUBTYPE_REGISTER(ename, subtype_fn)
+
+
 /** @brief Declare an event type.
  *
  * This macro provides declarations required for an event to be used
@@ -397,12 +466,64 @@ void *app_event_manager_alloc(size_t size);
  * The behavior of this function depends on the actual implementation.
  * The default implementation of this function is same as k_free.
  * It is annotated as weak and can be overridden by user.
+ * Override it together with @ref app_event_manager_alloc, unless the events
+ * are allocated from the kernel heap.
  *
  * @param addr  Pointer to previously allocated memory.
  **/
 void app_event_manager_free(void *addr);
 
 
+/** @brief Statistics of an event allocator size class.
+ *
+ * Provided by the memory slab based default event allocator
+ * (@kconfig{CONFIG_APP_EVENT_MANAGER_EVENT_ALLOCATOR_SLAB}).
+ */
+struct app_event_manager_slab_stats {
+	/** Size of a single block (in bytes). */
+	size_t block_size;
+
+	/** Number of blocks in the size class. */
+	uint32_t num_blocks;
+
+	/** Number of blocks that are currently in use. */
+	uint32_t num_used;
+
+	/** Maximum number of blocks that were in use at the same time. */
+	uint32_t max_used;
+
+	/** Number of allocations that failed because all blocks were in use. */
+	uint32_t alloc_fail_cnt;
+};
+
+
+/** @brief Get statistics of an event allocator size class.
+ *
+ * Size classes are indexed from zero in the ascending order of the block size.
+ *
+ * @param idx    Index of the size class.
+ * @param stats  Pointer to the structure that is filled with the statistics.
+ *
+ * @retval 0 If the operation was successful.
+ * @retval -ENOENT If there is no size class with the given index.
+ * @retval -ENOTSUP If the memory slab based default event allocator is not used.
+ */
+int app_event_manager_slab_stats_get(size_t idx, struct app_event_manager_slab_stats *stats);
+
+
+/** @brief Get statistics of an event listener.
+ *
+ * @note
+ * For this function to be available the
+ * @kconfig{CONFIG_APP_EVENT_MANAGER_LISTENER_STATS} option needs to be enabled.
+ *
+ * @param el     Pointer to the event listener.
+ * @param stats  Pointer to the structure that is filled with the statistics.
+ */
+void app_event_manager_listener_stats_get(const struct event_listener *el,
+					  struct event_listener_stats *stats);
+
+
 /** @brief Log event.
  *
  * This helper macro simplifies event logging.
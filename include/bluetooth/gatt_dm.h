@@ -264,9 +264,15 @@ const struct bt_gatt_dm_attr *bt_gatt_dm_desc_next(
  * This function is asynchronous. Discovery results are passed through
  * the supplied callback.
  *
- * @note Only one discovery procedure can be started simultaneously. To start
- * another one, wait for the result of the previous procedure to finish
- * and call @ref bt_gatt_dm_data_release if it was successful.
+ * @note Up to @kconfig{CONFIG_BT_GATT_DM_MAX_INSTANCES} discovery procedures
+ * can run simultaneously, each on a different connection. To start another
+ * one on the same connection, wait for the result of the previous procedure
+ * to finish and call @ref bt_gatt_dm_data_release if it was successful.
+ *
+ * @note If @kconfig{CONFIG_BT_GATT_DM_CACHE} is enabled and the peer is bonded,
+ * the Database Hash of the peer is read first. If the service was discovered
+ * before and the Database Hash has not changed, the completed callback is
+ * called with the cached attributes and no discovery procedure is performed.
  *
  * @param[in]     conn Connection object.
  * @param[in]     svc_uuid UUID of target service
@@ -285,6 +291,8 @@ const struct bt_gatt_dm_attr *bt_gatt_dm_desc_next(
  *
  * @retval 0 If the operation was successful.
  *           Otherwise, a (negative) error code is returned.
+ * @retval -EALREADY If discovery is already running on the connection
+ *                   or no free instance is available.
  */
 int bt_gatt_dm_start(struct bt_conn *conn,
 		     const struct bt_uuid *svc_uuid,
@@ -317,6 +325,16 @@ int bt_gatt_dm_continue(struct bt_gatt_dm *dm, void *context);
  */
 int bt_gatt_dm_data_release(struct bt_gatt_dm *dm);
 
+/** @brief Remove services cached for a peer.
+ *
+ * The services of a peer are removed automatically when its bond is deleted.
+ * Use this function if the database of the peer is known to be changed in a
+ * way that is not reflected by its Database Hash.
+ *
+ * @param[in] addr Address of the peer or NULL to remove all cached services.
+ */
+void bt_gatt_dm_cache_clear(const bt_addr_le_t *addr);
+
 /** @brief Print service discovery data.
  *
  * This function prints GATT attributes that belong to the discovered service.
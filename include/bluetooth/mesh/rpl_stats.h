@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/**
+ * @file
+ * @brief Bluetooth Mesh replay protection list statistics.
+ * @defgroup bt_mesh_rpl_stats Bluetooth Mesh replay protection list statistics
+ * @{
+ */
+
+#ifndef BT_MESH_RPL_STATS_H__
+#define BT_MESH_RPL_STATS_H__
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Replay protection list statistics. */
+struct bt_mesh_rpl_stats {
+	/** Number of lookups in the replay protection list. */
+	uint32_t lookups;
+	/** Number of additional hash index probes needed by the lookups. */
+	uint32_t probes;
+	/** Number of messages rejected as replayed. */
+	uint32_t replays;
+	/** Number of messages rejected because the list was full. */
+	uint32_t full;
+	/** Number of entries evicted on IV Index updates. */
+	uint32_t evicted;
+	/** Current number of entries in the list. */
+	uint16_t entries;
+	/** Highest number of entries in the list. */
+	uint16_t entries_max;
+};
+
+/** @brief Get the replay protection list statistics.
+ *
+ * Requires @kconfig{CONFIG_BT_MESH_RPL_STATS}.
+ *
+ * @param[out] stats Statistics.
+ */
+void bt_mesh_rpl_stats_get(struct bt_mesh_rpl_stats *stats);
+
+/** @brief Reset the replay protection list statistics.
+ *
+ * The current and highest number of entries are set to the current number
+ * of entries in the list.
+ *
+ * Requires @kconfig{CONFIG_BT_MESH_RPL_STATS}.
+ */
+void bt_mesh_rpl_stats_reset(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BT_MESH_RPL_STATS_H__ */
+
+/** @} */
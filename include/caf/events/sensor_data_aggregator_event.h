@@ -23,13 +23,21 @@ extern "C" {
 #endif
 
 /** @brief Sensor data aggregator event.
+ *
+ *  The samples are not copied. They stay valid until the buffer is released with
+ *  @ref sensor_data_aggregator_release_buffer_event.
  */
 struct sensor_data_aggregator_event {
 	struct app_event_header header;
 	const char *sensor_descr;
 	struct sensor_value *samples;
+
+	/** Time at which each sample was received by the aggregator, in system ticks.
+	 *  NULL unless CONFIG_CAF_SENSOR_DATA_AGGREGATOR_TIMESTAMPS is enabled.
+	 */
+	int64_t *timestamps;
 	enum sensor_state sensor_state;
-	uint8_t sample_cnt;
+	uint16_t sample_cnt;
 	uint8_t values_in_sample;
 };
 
@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef _SENSOR_DATA_AGGREGATOR_H_
+#define _SENSOR_DATA_AGGREGATOR_H_
+
+/**
+ * @file
+ * @defgroup caf_sensor_data_aggregator CAF Sensor Data Aggregator
+ * @{
+ * @brief CAF Sensor Data Aggregator.
+ */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Sensor data aggregator statistics. */
+struct sensor_data_aggregator_stats {
+	/** Number of samples stored in the aggregator. */
+	uint32_t sample_cnt;
+
+	/** Number of samples dropped, because all of the aggregator memory was in use. */
+	uint32_t drop_cnt;
+
+	/** Largest number of samples in use at the same time. */
+	uint32_t max_used;
+};
+
+/** @brief Get the statistics of an aggregator.
+ *
+ * The statistics are updated by the Application Event Manager thread. Each member is read
+ * atomically, but the members are not read together.
+ *
+ * @param[in]  sensor_descr Description of the sensor handled by the aggregator.
+ * @param[out] stats        Statistics of the aggregator.
+ *
+ * @retval 0 The statistics were read.
+ * @retval -ENOENT There is no aggregator for the sensor.
+ */
+int sensor_data_aggregator_stats_get(const char *sensor_descr,
+				     struct sensor_data_aggregator_stats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* _SENSOR_DATA_AGGREGATOR_H_ */
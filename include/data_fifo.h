@@ -31,6 +31,23 @@ struct data_fifo_msgq {
 	size_t size;
 };
 
+#if defined(CONFIG_DATA_FIFO_SPSC)
+/* Indices of one side of the single-producer/single-consumer ring.
+ * The indices are free-running and only written by the side owning them.
+ * Each side is kept in its own cache line so that the producer and the consumer
+ * do not evict each other's line on every update.
+ */
+struct data_fifo_spsc_side {
+	/* Next block to reserve (producer) or to read (consumer) */
+	atomic_t head;
+	/* Number of blocks committed (producer) or released (consumer) */
+	atomic_t tail;
+	/* Set while the side is blocked waiting for the other side */
+	atomic_t waiting;
+	struct k_sem sem;
+} __aligned(CONFIG_DATA_FIFO_SPSC_CACHE_LINE_SIZE);
+#endif /* CONFIG_DATA_FIFO_SPSC */
+
 struct data_fifo {
 	char *msgq_buffer;
 	char *slab_buffer;
@@ -39,19 +56,56 @@ struct data_fifo {
 	uint32_t elements_max;
 	size_t block_size_max;
 	bool initialized;
+#if defined(CONFIG_DATA_FIFO_SPSC)
+	bool spsc;
+	struct data_fifo_spsc_side producer;
+	struct data_fifo_spsc_side consumer;
+#endif /* CONFIG_DATA_FIFO_SPSC */
 };
 
-#define DATA_FIFO_DEFINE(name, elements_max_in, block_size_max_in)                                 \
+#define _DATA_FIFO_BUFFERS_DEFINE(name, elements_max_in, block_size_max_in)                        \
 	char __aligned(WB_UP(                                                                      \
 		1)) _msgq_buffer_##name[(elements_max_in) * sizeof(struct data_fifo_msgq)] = {0};  \
 	char __aligned(WB_UP(1)) _slab_buffer_##name[(elements_max_in) * (block_size_max_in)] = {  \
-		0};                                                                                \
+		0}
+
+#define DATA_FIFO_DEFINE(name, elements_max_in, block_size_max_in)                                 \
+	_DATA_FIFO_BUFFERS_DEFINE(name, elements_max_in, block_size_max_in);                       \
 	struct data_fifo name = {.msgq_buffer = _msgq_buffer_##name,                               \
 				 .slab_buffer = _slab_buffer_##name,                               \
 				 .block_size_max = block_size_max_in,                              \
 				 .elements_max = elements_max_in,                                  \
 				 .initialized = false}
 
+#if defined(CONFIG_DATA_FIFO_SPSC)
+/**
+ * @brief Define a data_fifo using the lock-free single-producer/single-consumer ring.
+ *
+ * The data_fifo is used through the same API as one defined with DATA_FIFO_DEFINE,
+ * but no kernel locks are taken unless a call has to wait. The API is then ISR-safe
+ * on both sides, given that the following rules are kept:
+ *
+ * - Only one context calls data_fifo_pointer_first_vacant_get and data_fifo_block_lock
+ *   (the producer), and only one context calls data_fifo_pointer_last_filled_get
+ *   and data_fifo_block_free (the consumer).
+ * - Blocks are locked in the order they were reserved, and freed in the order
+ *   they were read. The producer may free the most recently reserved block if it
+ *   has not been locked, to cancel the reservation.
+ *
+ * Blocks are handed over without copying: the producer writes directly into the
+ * block it reserved (data_fifo_pointer_first_vacant_get) and commits it with
+ * data_fifo_block_lock.
+ */
+#define DATA_FIFO_SPSC_DEFINE(name, elements_max_in, block_size_max_in)                            \
+	_DATA_FIFO_BUFFERS_DEFINE(name, elements_max_in, block_size_max_in);                       \
+	struct data_fifo name = {.msgq_buffer = _msgq_buffer_##name,                               \
+				 .slab_buffer = _slab_buffer_##name,                               \
+				 .block_size_max = block_size_max_in,                              \
+				 .elements_max = elements_max_in,                                  \
+				 .initialized = false,                                             \
+				 .spsc = true}
+#endif /* CONFIG_DATA_FIFO_SPSC */
+
 /**
  * @brief Get pointer to the first vacant block in slab.
  *
@@ -92,6 +146,8 @@ int data_fifo_pointer_first_vacant_get(struct data_fifo *data_fifo, void **data,
  * @retval -ESPIPE	A generic return value if an error occurs in k_msg_put.
  *			Since data has already been added to the slab, there
  *			must be space in the message queue.
+ * @retval -EPERM	The block is not the oldest reserved block
+ *			(DATA_FIFO_SPSC_DEFINE only).
  */
 int data_fifo_block_lock(struct data_fifo *data_fifo, void **data, size_t size);
 
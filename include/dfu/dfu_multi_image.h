@@ -167,6 +167,11 @@ int dfu_multi_image_register_writer(const struct dfu_image_writer *writer);
  *
  * A user shall NOT write any more chunks after any write results in a failure.
  *
+ * If @kconfig{CONFIG_DFU_MULTI_IMAGE_PIPELINE} is enabled, the chunk is copied to a buffer
+ * and the image writers are called from a separate thread. An error of the image writers
+ * is then returned by a later call to this function or by @c dfu_multi_image_done.
+ * A chunk that leaves a gap after the data received so far is still rejected immediately.
+ *
  * @param[in] offset Offset of the chunk within the entire package.
  * @param[in] chunk Pointer to the chunk's data.
  * @param[in] chunk_size Size of the chunk.
@@ -181,6 +186,9 @@ int dfu_multi_image_write(size_t offset, const uint8_t *chunk, size_t chunk_size
 /**
  * @brief Returns DFU Multi Image package write position.
  *
+ * If @kconfig{CONFIG_DFU_MULTI_IMAGE_PIPELINE} is enabled, the function waits until all the
+ * buffered package chunks are written.
+ *
  * @return Offset of the next needed package chunk in bytes.
  */
 size_t dfu_multi_image_offset(void);
@@ -126,6 +126,10 @@ int emds_entry_add(struct emds_dynamic_entry *entry);
  * To achieve better time predictability, this function must be called from an
  * interrupt context with the highest priority.
  *
+ * If @kconfig{CONFIG_EMDS_INCREMENTAL} is enabled, only the entries that have
+ * changed since the last call to @ref emds_load are stored, unless the snapshot
+ * is stored in a different partition.
+ *
  * When writing to flash, it bypasses the flash driver. Therefore, when running
  * with MPSL, make sure to uninitialize the MPSL before this function is called.
  * Otherwise, an assertion may be triggered by the exit of the function.
@@ -207,6 +211,20 @@ int emds_store_time_get(uint32_t *store_time_us);
  */
 int emds_store_size_get(size_t *store_size);
 
+/**
+ * @brief Get the number of bytes written by the last store operation.
+ *
+ * The size includes the snapshot metadata. If @kconfig{CONFIG_EMDS_INCREMENTAL}
+ * is enabled, only the entries that have changed are written, and nothing is
+ * written if no entries have changed.
+ *
+ * @param written Pointer to a variable where the size will be stored.
+ *
+ * @return 0 on success.
+ * @retval -ECANCELED if the function was called before @ref emds_init.
+ */
+int emds_store_written_get(size_t *written);
+
 /**
  * @brief Check if the store operation can be run.
  *
@@ -46,6 +46,26 @@ struct at_monitor_entry {
 		uint8_t paused : 1; /* Monitor is paused. */
 		uint8_t direct : 1; /* Dispatch in ISR. */
 	} flags;
+	/** Internal. End of the filter in the matcher, or 0 if the filter is not in the matcher. */
+	uint16_t node;
+#if defined(CONFIG_AT_MONITOR_STATS) || defined(__DOXYGEN__)
+	/** Number of notifications dispatched to this monitor. */
+	uint32_t hits;
+#endif
+};
+
+/**
+ * @brief AT monitor library statistics.
+ */
+struct at_monitor_stats {
+	/** Number of notifications received from the Modem library. */
+	uint32_t notif_cnt;
+	/** Number of notifications dropped because there was no space to copy them. */
+	uint32_t drop_cnt;
+	/** Number of notifications dropped because they are longer than a slab block. */
+	uint32_t toolong_cnt;
+	/** Largest number of notifications waiting to be dispatched in the workqueue. */
+	uint32_t queued_max;
 };
 
 /** Wildcard. Match any notifications. */
@@ -117,6 +137,36 @@ static inline void at_monitor_resume(struct at_monitor_entry *mon)
 	mon->flags.paused = false;
 }
 
+#if defined(CONFIG_AT_MONITOR_STATS) || defined(__DOXYGEN__)
+/**
+ * @brief Get the statistics of the AT monitor library.
+ *
+ * The hit rate of a monitor is the number of notifications dispatched to it,
+ * given by @ref at_monitor_hits_get, divided by @c notif_cnt.
+ *
+ * @note Requires @kconfig{CONFIG_AT_MONITOR_STATS}.
+ *
+ * @param[out] stats The statistics.
+ */
+void at_monitor_stats_get(struct at_monitor_stats *stats);
+
+/**
+ * @brief Get the number of notifications dispatched to a monitor.
+ *
+ * Notifications received while the monitor is paused are not counted.
+ *
+ * @note Requires @kconfig{CONFIG_AT_MONITOR_STATS}.
+ *
+ * @param mon The monitor.
+ *
+ * @return The number of notifications dispatched to monitor @p mon.
+ */
+static inline uint32_t at_monitor_hits_get(const struct at_monitor_entry *mon)
+{
+	return mon->hits;
+}
+#endif
+
 /** @} */
 
 #ifdef __cplusplus
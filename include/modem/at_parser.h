@@ -36,6 +36,37 @@ enum at_parser_cmd_type {
 	AT_PARSER_CMD_TYPE_TEST
 };
 
+#if defined(CONFIG_AT_PARSER_TOKEN_INDEX)
+/**
+ * @brief Location and type of a value in the current AT command line.
+ */
+struct at_parser_token_idx {
+	/* Offset of the value from the start of the current AT command line. */
+	uint16_t offset;
+	/* Length of the value. */
+	uint16_t len;
+	/* Type of the value, see enum at_token_type. */
+	uint8_t type;
+};
+
+/**
+ * @brief Index of the values in the current AT command line.
+ */
+struct at_parser_index {
+	/* Values found so far. */
+	struct at_parser_token_idx tokens[CONFIG_AT_PARSER_TOKEN_INDEX_SIZE];
+	/* Number of values in the index. */
+	uint16_t count;
+	/* Set while the AT command string is being received. */
+	bool partial;
+	/* Parser state after the last value in the index. */
+	bool is_next_empty;
+	const char *cursor;
+	/* Error that terminated the current AT command line, zero if not known yet. */
+	int err;
+};
+#endif /* CONFIG_AT_PARSER_TOKEN_INDEX */
+
 /**
  * @brief AT parser
  *
@@ -53,6 +84,10 @@ struct at_parser {
 	bool is_next_empty;
 	/* Sentinel value for determining initialization state. */
 	uint32_t init_sentinel;
+#if defined(CONFIG_AT_PARSER_TOKEN_INDEX)
+	/* Index of the values in the current AT command line. */
+	struct at_parser_index index;
+#endif
 };
 
 /**
@@ -76,6 +111,7 @@ struct at_parser {
  * @retval -EIO        There is nothing more to parse in the AT command string configured in
  *                     @p parser. Returned when @p index is greater than the maximum index for the
  *                     current AT command line.
+ * @retval -EINPROGRESS The value at the given index has not been received yet.
  */
 #define at_parser_num_get(parser, index, value)    \
 	_Generic((value),                          \
@@ -99,6 +135,46 @@ struct at_parser {
  */
 int at_parser_init(struct at_parser *parser, const char *at);
 
+/**
+ * @brief Initialize an AT parser for an AT command string that is still being received.
+ *
+ * The values of the AT command string received so far are indexed. When more data has been
+ * appended to the AT command string, call @ref at_parser_feed to index the new values.
+ *
+ * The AT command string must stay at the same location and be null-terminated after every
+ * update. Values that have not been completely received cannot be retrieved until they are, and
+ * @c -EINPROGRESS is returned for them.
+ *
+ * Only available when @kconfig{CONFIG_AT_PARSER_TOKEN_INDEX} is enabled.
+ *
+ * @param[in] parser A pointer to the AT parser.
+ * @param[in] at     A pointer to the AT command string received so far.
+ *
+ * @retval 0 If the operation was successful.
+ *           Otherwise, a (negative) error code is returned.
+ * @retval -EINVAL One or more of the supplied parameters are invalid.
+ */
+int at_parser_init_partial(struct at_parser *parser, const char *at);
+
+/**
+ * @brief Index the values appended to the AT command string of an AT parser.
+ *
+ * Only the values received since the last call are parsed.
+ *
+ * Only available when @kconfig{CONFIG_AT_PARSER_TOKEN_INDEX} is enabled.
+ *
+ * @param[in] parser   A pointer to the AT parser initialized with @ref at_parser_init_partial.
+ * @param[in] complete Whether the AT command string has been completely received.
+ *                     After this, the parser behaves as if initialized with @ref at_parser_init.
+ *
+ * @retval 0 If the operation was successful.
+ *           Otherwise, a (negative) error code is returned.
+ * @retval -EINVAL     One or more of the supplied parameters are invalid.
+ * @retval -EPERM      @p parser has not been initialized.
+ * @retval -EALREADY   The AT command string has already been completely received.
+ */
+int at_parser_feed(struct at_parser *parser, bool complete);
+
 /**
  * @brief Move the cursor of an AT parser to the next command line of its configured AT command
  *        string.
@@ -115,6 +191,7 @@ int at_parser_init(struct at_parser *parser, const char *at);
  * @retval -EPERM      @p parser has not been initialized.
  * @retval -EOPNOTSUPP The cursor cannot move to the next line. This error occurs if there is no
  *                     next line to move to or the configured AT command string is malformed.
+ * @retval -EINPROGRESS The AT command string has not been completely received.
  */
 int at_parser_cmd_next(struct at_parser *parser);
 
@@ -143,6 +220,7 @@ int at_parser_cmd_type_get(struct at_parser *parser, enum at_parser_cmd_type *ty
  * @retval -EINVAL     One or more of the supplied parameters are invalid.
  * @retval -EPERM      @p parser has not been initialized.
  * @retval -EBADMSG    The AT command string is malformed.
+ * @retval -EINPROGRESS The AT command string has not been completely received.
  */
 int at_parser_cmd_count_get(struct at_parser *parser, size_t *count);
 
@@ -167,6 +245,7 @@ int at_parser_cmd_count_get(struct at_parser *parser, size_t *count);
  * @retval -EIO        There is nothing more to parse in the AT command string configured in
  *                     @p parser. Returned when @p index is greater than the maximum index for the
  *                     current AT command line.
+ * @retval -EINPROGRESS The value at the given index has not been received yet.
  */
 int at_parser_int16_get(struct at_parser *parser, size_t index, int16_t *value);
 
@@ -191,6 +270,7 @@ int at_parser_int16_get(struct at_parser *parser, size_t index, int16_t *value);
  * @retval -EIO        There is nothing more to parse in the AT command string configured in
  *                     @p parser. Returned when @p index is greater than the maximum index for the
  *                     current AT command line.
+ * @retval -EINPROGRESS The value at the given index has not been received yet.
  */
 int at_parser_uint16_get(struct at_parser *parser, size_t index, uint16_t *value);
 
@@ -215,6 +295,7 @@ int at_parser_uint16_get(struct at_parser *parser, size_t index, uint16_t *value
  * @retval -EIO        There is nothing more to parse in the AT command string configured in
  *                     @p parser. Returned when @p index is greater than the maximum index for the
  *                     current AT command line.
+ * @retval -EINPROGRESS The value at the given index has not been received yet.
  */
 int at_parser_int32_get(struct at_parser *parser, size_t index, int32_t *value);
 
@@ -239,6 +320,7 @@ int at_parser_int32_get(struct at_parser *parser, size_t index, int32_t *value);
  * @retval -EIO        There is nothing more to parse in the AT command string configured in
  *                     @p parser. Returned when @p index is greater than the maximum index for the
  *                     current AT command line.
+ * @retval -EINPROGRESS The value at the given index has not been received yet.
  */
 int at_parser_uint32_get(struct at_parser *parser, size_t index, uint32_t *value);
 
@@ -263,6 +345,7 @@ int at_parser_uint32_get(struct at_parser *parser, size_t index, uint32_t *value
  * @retval -EIO        There is nothing more to parse in the AT command string configured in
  *                     @p parser. Returned when @p index is greater than the maximum index for the
  *                     current AT command line.
+ * @retval -EINPROGRESS The value at the given index has not been received yet.
  */
 int at_parser_int64_get(struct at_parser *parser, size_t index, int64_t *value);
 
@@ -287,6 +370,7 @@ int at_parser_int64_get(struct at_parser *parser, size_t index, int64_t *value);
  * @retval -EIO        There is nothing more to parse in the AT command string configured in
  *                     @p parser. Returned when @p index is greater than the maximum index for the
  *                     current AT command line.
+ * @retval -EINPROGRESS The value at the given index has not been received yet.
  */
 int at_parser_uint64_get(struct at_parser *parser, size_t index, uint64_t *value);
 
@@ -317,6 +401,7 @@ int at_parser_uint64_get(struct at_parser *parser, size_t index, uint64_t *value
  * @retval -EIO        There is nothing more to parse in the AT command string configured in
  *                     @p parser. Returned when @p index is greater than the maximum index for the
  *                     current AT command line.
+ * @retval -EINPROGRESS The value at the given index has not been received yet.
  */
 int at_parser_string_get(struct at_parser *parser, size_t index, char *str, size_t *len);
 
@@ -343,6 +428,7 @@ int at_parser_string_get(struct at_parser *parser, size_t index, char *str, size
  * @retval -EIO        There is nothing more to parse in the AT command string configured in
  *                     @p parser. Returned when @p index is greater than the maximum index for the
  *                     current AT command line.
+ * @retval -EINPROGRESS The value at the given index has not been received yet.
  */
 int at_parser_string_ptr_get(struct at_parser *parser, size_t index, const char **str_ptr,
 			     size_t *len);
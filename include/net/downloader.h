@@ -57,6 +57,7 @@ enum downloader_evt_id {
 	 * - -EHOSTUNREACH: Failed to resolve the target address.
 	 * - -EMSGSIZE: TLS packet is larger than the nRF91 Modem can handle.
 	 * - -EMLINK: Maximum number of redirects reached.
+	 * - -ESTALE: File has changed on the server since the checkpoint was saved.
 	 *
 	 * In case of @c ECONNRESET errors, returning zero from the callback will let the
 	 * library attempt to reconnect to the server and download the last fragment again.
@@ -202,8 +203,21 @@ struct downloader_host_cfg {
 	 * Use 0 to set the value of CONFIG_DOWNLOADER_MAX_REDIRECTS.
 	 */
 	uint8_t redirects_max;
+	/**
+	 * Name of the persistent checkpoint of the download, at most
+	 * @ref DOWNLOADER_CHECKPOINT_NAME_MAX characters.
+	 * The progress and the version of the file are stored under this name, so that the
+	 * download can be resumed after a reboot.
+	 * Requires the @kconfig{CONFIG_DOWNLOADER_CHECKPOINT} Kconfig option.
+	 * Set to NULL to disable checkpoints.
+	 * The string must be kept in scope while download is going on.
+	 */
+	const char *checkpoint;
 };
 
+/** Maximum length of a checkpoint name. */
+#define DOWNLOADER_CHECKPOINT_NAME_MAX 16
+
 /**
  * @brief Downloader internal state.
  */
@@ -248,6 +262,28 @@ struct downloader {
 	/** Transport parameters. */
 	uint8_t transport_internal[CONFIG_DOWNLOADER_TRANSPORT_PARAMS_SIZE];
 
+#if defined(CONFIG_DOWNLOADER_CHECKPOINT) || defined(__DOXYGEN__)
+	/** Checkpoint of the download. */
+	struct {
+		/** CRC32 of the URL. */
+		uint32_t url_crc;
+		/** Number of bytes accepted by the application. */
+		size_t delivered;
+		/** Progress at the last saved checkpoint. */
+		size_t saved;
+		/** File size at the checkpoint. */
+		size_t file_size;
+		/** File version at the checkpoint, null-terminated. */
+		char validator[CONFIG_DOWNLOADER_CHECKPOINT_VALIDATOR_SIZE];
+		/** File version in the last response, null-terminated. */
+		char received[CONFIG_DOWNLOADER_CHECKPOINT_VALIDATOR_SIZE];
+		/** The received file version is an entity tag, preferred over a date. */
+		bool received_preferred;
+		/** The file version at the checkpoint is known. */
+		bool has_validator;
+	} checkpoint;
+#endif
+
 	/** Ensure that thread is ready for download. */
 	struct k_sem event_sem;
 	/** Protect shared variables. */
@@ -365,6 +401,39 @@ int downloader_file_size_get(struct downloader *dl, size_t *size);
  */
 int downloader_downloaded_size_get(struct downloader *dl, size_t *size);
 
+/**
+ * @brief Retrieve the progress of an interrupted download from its checkpoint.
+ *
+ * Pass the progress as the @c from parameter of @ref downloader_get(), together with
+ * the same checkpoint name in the host configuration, to resume the download.
+ * The downloader verifies that the file on the server has not changed since the checkpoint.
+ *
+ * Requires the @kconfig{CONFIG_DOWNLOADER_CHECKPOINT} Kconfig option.
+ *
+ * @param[in]  name	Checkpoint name.
+ * @param[in]  url	URL of the download.
+ * @param[out] progress	Number of bytes delivered to the application before the checkpoint.
+ *
+ * @retval 0 on success.
+ * @retval -ENOENT if there is no checkpoint with this name.
+ * @retval -ESTALE if the checkpoint belongs to a download of another URL.
+ * @retval -EINVAL if a parameter is invalid.
+ */
+int downloader_checkpoint_get(const char *name, const char *url, size_t *progress);
+
+/**
+ * @brief Delete a download checkpoint.
+ *
+ * The checkpoint is deleted automatically when the download completes.
+ *
+ * Requires the @kconfig{CONFIG_DOWNLOADER_CHECKPOINT} Kconfig option.
+ *
+ * @param[in] name	Checkpoint name.
+ *
+ * @return Zero on success, a negative error code otherwise.
+ */
+int downloader_checkpoint_clear(const char *name);
+
 #ifdef __cplusplus
 }
 #endif
@@ -27,6 +27,13 @@ struct downloader_transport_coap_cfg {
 	enum coap_block_size block_size;
 	/** Max retransmission requests. */
 	uint8_t max_retransmission;
+	/**
+	 * Maximum number of block requests outstanding at the same time.
+	 * Zero or one requests one block at a time.
+	 * Capped by @kconfig{CONFIG_DOWNLOADER_TRANSPORT_COAP_WINDOW_MAX} and by the number of
+	 * blocks that fit in the downloader buffer.
+	 */
+	uint8_t window_size;
 };
 
 /**
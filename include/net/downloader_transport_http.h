@@ -24,6 +24,12 @@
 struct downloader_transport_http_cfg {
 	/** Socket receive timeout in milliseconds */
 	uint32_t sock_recv_timeo_ms;
+	/**
+	 * Maximum number of range requests sent ahead of time over the same connection.
+	 * Requires a range override to be set in the host configuration.
+	 * Zero or one disables pipelining.
+	 */
+	uint8_t pipeline_depth;
 };
 
 /**
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef NRF_CLOUD_BATCH_H_
+#define NRF_CLOUD_BATCH_H_
+
+/** @file nrf_cloud_batch.h
+ * @brief Module to batch device messages into bulk uploads to nRF Cloud.
+ */
+
+#include <zephyr/kernel.h>
+#include <net/nrf_cloud.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @defgroup nrf_cloud_batch nRF Cloud Batch
+ * @{
+ */
+
+/**
+ * @brief Add sensor data to the batch.
+ *
+ * The data is encoded as a device message and stored until the batch is sent to the
+ * bulk topic of nRF Cloud, using MQTT or CoAP. The batch is sent when it is full,
+ * when its oldest message reaches the age set by @kconfig{CONFIG_NRF_CLOUD_BATCH_MAX_AGE},
+ * when the modem connects to the network for another reason and
+ * @kconfig{CONFIG_NRF_CLOUD_BATCH_FLUSH_ON_RRC_CONNECTED} is enabled, or when
+ * @ref nrf_cloud_batch_flush is called.
+ *
+ * If the data does not have a timestamp, the current time is added if available, so that
+ * the sampling time is kept.
+ *
+ * @param[in] sensor Sensor data.
+ *
+ * @retval 0 The data was added to the batch.
+ * @retval -EINVAL Invalid parameter.
+ * @retval -E2BIG The message does not fit in an empty batch.
+ * @retval -ENOBUFS The batch is full and could not be sent.
+ */
+int nrf_cloud_batch_sensor_data_add(const struct nrf_cloud_sensor_data *sensor);
+
+/**
+ * @brief Add a pre-encoded device message to the batch.
+ *
+ * See @ref nrf_cloud_batch_sensor_data_add for when the batch is sent.
+ *
+ * @param[in] msg NULL-terminated JSON object, which must include a timestamp to keep the
+ *                sampling time.
+ *
+ * @retval 0 The message was added to the batch.
+ * @retval -EINVAL Invalid parameter.
+ * @retval -E2BIG The message does not fit in an empty batch.
+ * @retval -ENOBUFS The batch is full and could not be sent.
+ */
+int nrf_cloud_batch_msg_add(const char *msg);
+
+/**
+ * @brief Send the batched messages now.
+ *
+ * The messages are kept if they could not be sent, and sending is attempted again at the
+ * next trigger.
+ *
+ * @retval 0 The batch was sent, or there was nothing to send.
+ * @retval -EACCES Not connected to nRF Cloud.
+ * @return A negative error code from the MQTT or CoAP transport otherwise.
+ */
+int nrf_cloud_batch_flush(void);
+
+/**
+ * @brief Discard the batched messages.
+ */
+void nrf_cloud_batch_clear(void);
+
+/**
+ * @brief Get the number of batched messages.
+ *
+ * @return Number of messages waiting to be sent.
+ */
+size_t nrf_cloud_batch_count_get(void);
+
+/** @} */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NRF_CLOUD_BATCH_H_ */
@@ -32,7 +32,7 @@ enum pcm_mix_mode {
 /**
  * @brief Mixes two buffers of PCM data.
  *
- * @note Uses simple addition with hard clip protection.
+ * @note Uses saturating addition.
  * Input can be mono or stereo as long as the inputs match.
  * By selecting the mix mode, mono can also be mixed into a stereo buffer.
  * Hard coded for the signed 16-bit PCM.
@@ -52,6 +52,30 @@ enum pcm_mix_mode {
 int pcm_mix(void *const pcm_a, size_t size_a, void const *const pcm_b, size_t size_b,
 	    enum pcm_mix_mode mix_mode);
 
+/**
+ * @brief Mixes two buffers of PCM data with the given bit depth.
+ *
+ * @note Uses saturating addition. Samples with 24-bit depth are packed
+ * (three bytes per sample, little endian). If
+ * @kconfig{CONFIG_PCM_MIX_DSP} is enabled, the DSP extension instructions
+ * are used to mix the samples.
+ *
+ * @param pcm_a         [in/out] Pointer to the PCM data buffer A.
+ * @param size_a        [in]     Size of the PCM data buffer A (in bytes).
+ * @param pcm_b         [in]     Pointer to the PCM data buffer B.
+ * @param size_b        [in]     Size of the PCM data buffer B (in bytes).
+ * @param mix_mode      [in]     Mixing mode according to pcm_mix_mode.
+ * @param pcm_bit_depth [in]     Bit depth of PCM samples (16, 24, or 32).
+ *
+ * @retval 0            Success. Result stored in pcm_a.
+ * @retval -EINVAL      pcm_a is NULL, size_a = 0 or invalid bit depth.
+ * @retval -EPERM       Either size_b < size_a (for stereo to stereo, mono to mono)
+ *			or size_a/2 < size_b (for mono to stereo mix).
+ * @retval -ESRCH       Invalid mixing mode.
+ */
+int pcm_mix_bit_depth(void *const pcm_a, size_t size_a, void const *const pcm_b, size_t size_b,
+		      enum pcm_mix_mode mix_mode, uint8_t pcm_bit_depth);
+
 /**
  * @}
  */
@@ -42,7 +42,9 @@
 /** Filter types supported by the sample rate converter */
 enum sample_rate_converter_filter {
 	SAMPLE_RATE_FILTER_TEST = 1,
-	SAMPLE_RATE_FILTER_SIMPLE
+	SAMPLE_RATE_FILTER_SIMPLE,
+	/** Polyphase filter supporting fractional conversion ratios and drift compensation. */
+	SAMPLE_RATE_FILTER_POLYPHASE
 };
 
 /**
@@ -83,6 +85,31 @@ struct buf_ctx {
 	size_t bytes_in_buf;
 };
 
+#ifdef CONFIG_SAMPLE_RATE_CONVERTER_POLYPHASE
+/** State of the polyphase sample rate converter */
+struct sample_rate_converter_polyphase {
+	/* Input samples consumed per output sample, unsigned Q32.32. */
+	uint64_t step;
+
+	/* Position of the next output sample in the history buffer, unsigned Q32.32. */
+	uint64_t pos;
+
+	/* Drift compensation applied to the step, in parts per million. */
+	int32_t drift_ppm;
+
+	/* Coefficient table, one row per phase. The extra row is used for interpolation
+	 * between the last phase and the next sample.
+	 */
+#ifdef CONFIG_SAMPLE_RATE_CONVERTER_BIT_DEPTH_16
+	q15_t coeffs[CONFIG_SAMPLE_RATE_CONVERTER_POLYPHASE_PHASES + 1]
+		    [CONFIG_SAMPLE_RATE_CONVERTER_POLYPHASE_TAPS];
+#elif CONFIG_SAMPLE_RATE_CONVERTER_BIT_DEPTH_32
+	q31_t coeffs[CONFIG_SAMPLE_RATE_CONVERTER_POLYPHASE_PHASES + 1]
+		    [CONFIG_SAMPLE_RATE_CONVERTER_POLYPHASE_TAPS];
+#endif
+};
+#endif /* CONFIG_SAMPLE_RATE_CONVERTER_POLYPHASE */
+
 /** Context for the sample rate conversion */
 struct sample_rate_converter_ctx {
 	/* Input and output sample rate to be used for the conversion. */
@@ -116,13 +143,18 @@ struct sample_rate_converter_ctx {
 	};
 
 	/* State buffers used by the CMSIS DSP filters to keep history of the stream between process
-	 * calls.
+	 * calls. Also used by the polyphase converter.
 	 */
 #ifdef CONFIG_SAMPLE_RATE_CONVERTER_BIT_DEPTH_16
 	q15_t state_buf_15[SAMPLE_RATE_CONVERTER_STATE_BUFFER_SIZE];
 #elif CONFIG_SAMPLE_RATE_CONVERTER_BIT_DEPTH_32
 	q31_t state_buf_31[SAMPLE_RATE_CONVERTER_STATE_BUFFER_SIZE];
 #endif
+
+#ifdef CONFIG_SAMPLE_RATE_CONVERTER_POLYPHASE
+	/* State of the polyphase converter. */
+	struct sample_rate_converter_polyphase polyphase;
+#endif
 };
 
 /**
@@ -161,6 +193,11 @@ int sample_rate_converter_open(struct sample_rate_converter_ctx *ctx);
  * @param[out]		output_written		Number of bytes written to output.
  * @param[in]		output_sample_rate	Sample rate of output.
  *
+ * @note	With the @ref SAMPLE_RATE_FILTER_POLYPHASE filter, the number of output samples
+ *		varies between calls when the conversion ratio is fractional. The output array must
+ *		be able to store at least (input samples * output_sample_rate / input_sample_rate)
+ *		+ 2 samples.
+ *
  * @retval	0	On success.
  * @retval	-EINVAL	Invalid parameters for sample rate conversion.
  * @retval	-EFAULT	Output ring buffer has either not enough bytes to output, or not enough
@@ -172,6 +209,26 @@ int sample_rate_converter_process(struct sample_rate_converter_ctx *ctx,
 				  size_t output_size, size_t *output_written,
 				  uint32_t output_sample_rate);
 
+/**
+ * @brief	Set the drift compensation for the polyphase sample rate converter.
+ *
+ * @details	Adjusts the conversion ratio by the given amount to compensate for the drift
+ *		between the input and the output sample clocks. A positive value means that the
+ *		input is sampled faster than its nominal sample rate. The value can be updated
+ *		between process calls without discontinuities in the output.
+ *		The drift is kept when the context is re-initialized.
+ *
+ * @note	Only used with the @ref SAMPLE_RATE_FILTER_POLYPHASE filter.
+ *
+ * @param[in,out]	ctx		Pointer to the sample rate conversion context.
+ * @param[in]		drift_ppm	Drift in parts per million.
+ *
+ * @retval	0	On success.
+ * @retval	-EINVAL	NULL pointer given for context.
+ * @retval	-ENOTSUP	Polyphase converter is not enabled.
+ */
+int sample_rate_converter_drift_set(struct sample_rate_converter_ctx *ctx, int32_t drift_ppm);
+
 /**
  * @}
  */
@@ -23,9 +23,188 @@ struct at_notif_fifo {
 static void at_monitor_task(struct k_work *work);
 
 static K_FIFO_DEFINE(at_monitor_fifo);
-static K_HEAP_DEFINE(at_monitor_heap, CONFIG_AT_MONITOR_HEAP_SIZE);
 static K_WORK_DEFINE(at_monitor_work, at_monitor_task);
 
+#if defined(CONFIG_AT_MONITOR_SLAB)
+#define NOTIF_BLOCK_SIZE \
+	ROUND_UP(sizeof(struct at_notif_fifo) + CONFIG_AT_MONITOR_SLAB_NOTIF_LEN + 1, sizeof(void *))
+
+K_MEM_SLAB_DEFINE_STATIC(at_monitor_slab, NOTIF_BLOCK_SIZE, CONFIG_AT_MONITOR_SLAB_COUNT,
+			 sizeof(void *));
+#else
+static K_HEAP_DEFINE(at_monitor_heap, CONFIG_AT_MONITOR_HEAP_SIZE);
+#endif
+
+#if defined(CONFIG_AT_MONITOR_STATS)
+static struct at_monitor_stats stats;
+static uint32_t queued;
+#endif
+
+#if defined(CONFIG_AT_MONITOR_MATCHER)
+
+/* The filters are compiled into an Aho-Corasick automaton, a trie of all filters where each node
+ * also links to the node of its longest proper suffix. A notification is then scanned once,
+ * and every node where a filter ends is marked on the way. Node 0 is the root.
+ */
+struct matcher_node {
+	uint16_t child;		/* First child, or 0 if none. */
+	uint16_t sibling;	/* Next child of the same parent, or 0 if none. */
+	uint16_t fail;		/* Node of the longest proper suffix. */
+	uint16_t output;	/* Closest node, on the suffix chain, where a filter ends, or 0. */
+	char c;			/* Last character of the prefix. */
+	bool end;		/* A filter ends in this node. */
+};
+
+/* Set of nodes reached by a notification. */
+typedef uint32_t matcher_set_t[DIV_ROUND_UP(CONFIG_AT_MONITOR_MATCHER_NODES, 32)];
+
+#define NODE_NONE UINT16_MAX
+
+static struct matcher_node nodes[CONFIG_AT_MONITOR_MATCHER_NODES];
+static uint16_t node_cnt;
+
+static uint16_t child_find(uint16_t node, char c)
+{
+	for (uint16_t child = nodes[node].child; child; child = nodes[child].sibling) {
+		if (nodes[child].c == c) {
+			return child;
+		}
+	}
+
+	return 0;
+}
+
+static uint16_t child_add(uint16_t node, char c)
+{
+	uint16_t child = child_find(node, c);
+
+	if (child) {
+		return child;
+	}
+
+	if (node_cnt == ARRAY_SIZE(nodes)) {
+		return NODE_NONE;
+	}
+
+	child = node_cnt++;
+	nodes[child].c = c;
+	nodes[child].sibling = nodes[node].child;
+	nodes[node].child = child;
+
+	return child;
+}
+
+static uint16_t next_state(uint16_t node, char c)
+{
+	uint16_t child;
+
+	while (!(child = child_find(node, c)) && node) {
+		node = nodes[node].fail;
+	}
+
+	return child;
+}
+
+static void matcher_build(void)
+{
+	uint16_t node;
+	bool added;
+
+	node_cnt = 1;
+
+	/* Add the filters one level at a time, so that the nodes are numbered in breadth-first
+	 * order. The node of each monitor is the end of the part of its filter added so far.
+	 */
+	for (size_t depth = 0; ; depth++) {
+		added = false;
+
+		STRUCT_SECTION_FOREACH(at_monitor_entry, e) {
+			if (e->filter == ANY || e->node == NODE_NONE ||
+			    depth >= strlen(e->filter)) {
+				continue;
+			}
+			e->node = child_add(e->node, e->filter[depth]);
+			added = true;
+		}
+
+		if (!added) {
+			break;
+		}
+	}
+
+	STRUCT_SECTION_FOREACH(at_monitor_entry, e) {
+		if (e->node == NODE_NONE) {
+			LOG_WRN("No matcher node left for filter %s", e->filter);
+			e->node = 0;
+		}
+		if (e->node) {
+			nodes[e->node].end = true;
+		}
+	}
+
+	/* The suffix of a node is shorter, so it comes first in breadth-first order. */
+	for (node = 0; node < node_cnt; node++) {
+		for (uint16_t child = nodes[node].child; child; child = nodes[child].sibling) {
+			nodes[child].fail = node ? next_state(nodes[node].fail, nodes[child].c) : 0;
+			nodes[child].output = nodes[child].end ? child : nodes[nodes[child].fail].output;
+		}
+	}
+
+	LOG_DBG("Matcher uses %d of %d nodes", node_cnt, ARRAY_SIZE(nodes));
+}
+
+static void matcher_run(const char *notif, matcher_set_t set)
+{
+	uint16_t node = 0;
+
+	memset(set, 0, sizeof(matcher_set_t));
+
+	for (; *notif != '\0'; notif++) {
+		node = next_state(node, *notif);
+
+		/* The rest of the chain is already marked if one of its nodes is. */
+		for (uint16_t out = nodes[node].output;
+		     out && !(set[out / 32] & BIT(out % 32));
+		     out = nodes[nodes[out].fail].output) {
+			set[out / 32] |= BIT(out % 32);
+		}
+	}
+}
+
+static bool has_match(const struct at_monitor_entry *mon, const char *notif,
+		      const matcher_set_t set)
+{
+	if (mon->filter == ANY) {
+		return true;
+	}
+	if (mon->node) {
+		return set[mon->node / 32] & BIT(mon->node % 32);
+	}
+
+	return strstr(notif, mon->filter);
+}
+
+#else
+
+/* No matcher, each filter is searched for separately. */
+typedef uint32_t matcher_set_t[1];
+
+static void matcher_run(const char *notif, matcher_set_t set)
+{
+	ARG_UNUSED(notif);
+	ARG_UNUSED(set);
+}
+
+static bool has_match(const struct at_monitor_entry *mon, const char *notif,
+		      const matcher_set_t set)
+{
+	ARG_UNUSED(set);
+
+	return (mon->filter == ANY || strstr(notif, mon->filter));
+}
+
+#endif /* CONFIG_AT_MONITOR_MATCHER */
+
 static bool is_paused(const struct at_monitor_entry *mon)
 {
 	return mon->flags.paused;
@@ -36,9 +215,55 @@ static bool is_direct(const struct at_monitor_entry *mon)
 	return mon->flags.direct;
 }
 
-static bool has_match(const struct at_monitor_entry *mon, const char *notif)
+static void hits_inc(struct at_monitor_entry *mon)
 {
-	return (mon->filter == ANY || strstr(notif, mon->filter));
+#if defined(CONFIG_AT_MONITOR_STATS)
+	mon->hits++;
+#endif
+}
+
+static struct at_notif_fifo *notif_alloc(size_t len)
+{
+	struct at_notif_fifo *at_notif = NULL;
+
+#if defined(CONFIG_AT_MONITOR_SLAB)
+	ARG_UNUSED(len);
+
+	if (k_mem_slab_alloc(&at_monitor_slab, (void **)&at_notif, K_NO_WAIT)) {
+		return NULL;
+	}
+#else
+	at_notif = k_heap_alloc(&at_monitor_heap, sizeof(struct at_notif_fifo) + len + 1,
+				K_NO_WAIT);
+#endif
+
+#if defined(CONFIG_AT_MONITOR_STATS)
+	if (at_notif) {
+		unsigned int key = irq_lock();
+
+		queued++;
+		stats.queued_max = MAX(stats.queued_max, queued);
+		irq_unlock(key);
+	}
+#endif
+
+	return at_notif;
+}
+
+static void notif_free(struct at_notif_fifo *at_notif)
+{
+#if defined(CONFIG_AT_MONITOR_STATS)
+	unsigned int key = irq_lock();
+
+	queued--;
+	irq_unlock(key);
+#endif
+
+#if defined(CONFIG_AT_MONITOR_SLAB)
+	k_mem_slab_free(&at_monitor_slab, at_notif);
+#else
+	k_heap_free(&at_monitor_heap, at_notif);
+#endif
 }
 
 /* Dispatch AT notifications immediately, or schedules a workqueue task to do that.
@@ -49,15 +274,23 @@ void at_monitor_dispatch(const char *notif)
 {
 	bool monitored;
 	struct at_notif_fifo *at_notif;
-	size_t sz_needed;
+	size_t len;
+	matcher_set_t set;
 
 	__ASSERT_NO_MSG(notif != NULL);
 
+#if defined(CONFIG_AT_MONITOR_STATS)
+	stats.notif_cnt++;
+#endif
+
+	matcher_run(notif, set);
+
 	monitored = false;
 	STRUCT_SECTION_FOREACH(at_monitor_entry, e) {
-		if (!is_paused(e) && has_match(e, notif)) {
+		if (!is_paused(e) && has_match(e, notif, set)) {
 			if (is_direct(e)) {
 				LOG_DBG("Dispatching to %p (ISR)", e->handler);
+				hits_inc(e);
 				e->handler(notif);
 			} else {
 				/* Copy and schedule work-queue task */
@@ -71,16 +304,30 @@ void at_monitor_dispatch(const char *notif)
 		return;
 	}
 
-	sz_needed = sizeof(struct at_notif_fifo) + strlen(notif) + sizeof(char);
+	len = strlen(notif);
 
-	at_notif = k_heap_alloc(&at_monitor_heap, sz_needed, K_NO_WAIT);
+#if defined(CONFIG_AT_MONITOR_SLAB)
+	if (len > CONFIG_AT_MONITOR_SLAB_NOTIF_LEN) {
+#if defined(CONFIG_AT_MONITOR_STATS)
+		stats.toolong_cnt++;
+#endif
+		LOG_WRN("Notification too long (%zu > %d bytes): %s",
+			len, CONFIG_AT_MONITOR_SLAB_NOTIF_LEN, notif);
+		return;
+	}
+#endif
+
+	at_notif = notif_alloc(len);
 	if (!at_notif) {
-		LOG_WRN("No heap space for incoming notification: %s", notif);
-		__ASSERT(at_notif, "No heap space for incoming notification: %s", notif);
+#if defined(CONFIG_AT_MONITOR_STATS)
+		stats.drop_cnt++;
+#endif
+		LOG_WRN("No space for incoming notification: %s", notif);
+		__ASSERT(at_notif, "No space for incoming notification: %s", notif);
 		return;
 	}
 
-	strcpy(at_notif->data, notif);
+	memcpy(at_notif->data, notif, len + 1);
 
 	k_fifo_put(&at_monitor_fifo, at_notif);
 	k_work_submit(&at_monitor_work);
@@ -89,24 +336,40 @@ void at_monitor_dispatch(const char *notif)
 static void at_monitor_task(struct k_work *work)
 {
 	struct at_notif_fifo *at_notif;
+	matcher_set_t set;
 
 	while ((at_notif = k_fifo_get(&at_monitor_fifo, K_NO_WAIT))) {
 		/* Match notification with all monitors */
 		LOG_DBG("AT notif: %.*s", strlen(at_notif->data) - strlen("\r\n"), at_notif->data);
+		matcher_run(at_notif->data, set);
 		STRUCT_SECTION_FOREACH(at_monitor_entry, e) {
-			if (!is_paused(e) && !is_direct(e) && has_match(e, at_notif->data)) {
+			if (!is_paused(e) && !is_direct(e) && has_match(e, at_notif->data, set)) {
 				LOG_DBG("Dispatching to %p", e->handler);
+				hits_inc(e);
 				e->handler(at_notif->data);
 			}
 		}
-		k_heap_free(&at_monitor_heap, at_notif);
+		notif_free(at_notif);
 	}
 }
 
+#if defined(CONFIG_AT_MONITOR_STATS)
+void at_monitor_stats_get(struct at_monitor_stats *out)
+{
+	__ASSERT_NO_MSG(out != NULL);
+
+	*out = stats;
+}
+#endif
+
 static int at_monitor_sys_init(void)
 {
 	int err;
 
+#if defined(CONFIG_AT_MONITOR_MATCHER)
+	matcher_build();
+#endif
+
 	err = nrf_modem_at_notif_handler_set(at_monitor_dispatch);
 	if (err) {
 		LOG_ERR("Failed to hook the dispatch function, err %d", err);
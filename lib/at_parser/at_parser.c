@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
  */
 
+#include <stddef.h>
 #include <string.h>
 #include <stdlib.h>
 #include <stdbool.h>
@@ -231,6 +232,67 @@ finalize:
 	return 0;
 }
 
+#if defined(CONFIG_AT_PARSER_TOKEN_INDEX)
+/* Add the values following the last indexed value to the index.
+ *
+ * The parser state is moved along with the index, so that the remaining values can be
+ * tokenized from the end of the index if it is full.
+ * While the AT command string is partial, a value is only indexed if it is followed by more
+ * data, because the rest of the value may not have been received yet. Errors are not final
+ * either, since they may be caused by the missing data.
+ */
+static void at_parser_index_build(struct at_parser *parser)
+{
+	struct at_parser_index *index = &parser->index;
+	struct at_token token;
+	ptrdiff_t offset;
+	int err;
+
+	parser->cursor = index->cursor;
+	parser->count = index->count;
+	parser->is_next_empty = index->is_next_empty;
+
+	while (index->err == 0 && index->count < ARRAY_SIZE(index->tokens)) {
+		err = at_parser_tok(parser, &token);
+		if (index->partial && (err || parser->cursor[0] == NULL_TERMINATOR)) {
+			break;
+		}
+
+		if (err) {
+			index->err = err;
+			break;
+		}
+
+		offset = token.start - parser->at;
+		if (offset > UINT16_MAX || token.len > UINT16_MAX) {
+			/* Leave the rest of the line to be tokenized on demand. */
+			break;
+		}
+
+		index->tokens[index->count].offset = offset;
+		index->tokens[index->count].len = token.len;
+		index->tokens[index->count].type = token.type;
+		index->count++;
+
+		index->cursor = parser->cursor;
+		index->is_next_empty = parser->is_next_empty;
+	}
+
+	/* Leave the parser right after the last indexed value. */
+	parser->cursor = index->cursor;
+	parser->count = index->count;
+	parser->is_next_empty = index->is_next_empty;
+}
+
+static void at_parser_index_reset(struct at_parser *parser)
+{
+	parser->index.count = 0;
+	parser->index.err = 0;
+	parser->index.cursor = parser->cursor;
+	parser->index.is_next_empty = parser->is_next_empty;
+}
+#endif /* CONFIG_AT_PARSER_TOKEN_INDEX */
+
 /* Seek the AT parser cursor to the given index. */
 static int at_parser_seek(struct at_parser *parser, size_t index, struct at_token *token)
 {
@@ -238,8 +300,15 @@ static int at_parser_seek(struct at_parser *parser, size_t index, struct at_toke
 
 	if (!is_index_ahead(parser, index)) {
 		/* Rewind parser. */
+#if defined(CONFIG_AT_PARSER_TOKEN_INDEX)
+		/* The index always precedes the requested value. */
+		parser->cursor = parser->index.cursor;
+		parser->count = parser->index.count;
+		parser->is_next_empty = parser->index.is_next_empty;
+#else
 		parser->cursor = parser->at;
 		parser->count = 0;
+#endif
 	}
 
 	do {
@@ -249,6 +318,32 @@ static int at_parser_seek(struct at_parser *parser, size_t index, struct at_toke
 	return err;
 }
 
+/* Get the token at the given index in the current AT command line. */
+static int at_parser_token_get(struct at_parser *parser, size_t index, struct at_token *token)
+{
+#if defined(CONFIG_AT_PARSER_TOKEN_INDEX)
+	const struct at_parser_index *idx = &parser->index;
+
+	if (index < idx->count) {
+		token->start = parser->at + idx->tokens[index].offset;
+		token->len = idx->tokens[index].len;
+		token->type = idx->tokens[index].type;
+
+		return 0;
+	}
+
+	if (idx->partial) {
+		return -EINPROGRESS;
+	}
+
+	if (idx->err) {
+		return idx->err;
+	}
+#endif /* CONFIG_AT_PARSER_TOKEN_INDEX */
+
+	return at_parser_seek(parser, index, token);
+}
+
 int at_parser_init(struct at_parser *parser, const char *at)
 {
 	if (!parser || !at) {
@@ -261,9 +356,54 @@ int at_parser_init(struct at_parser *parser, const char *at)
 	parser->cursor = at;
 	parser->init_sentinel = INIT_SENTINEL;
 
+#if defined(CONFIG_AT_PARSER_TOKEN_INDEX)
+	at_parser_index_reset(parser);
+	at_parser_index_build(parser);
+#endif
+
 	return 0;
 }
 
+#if defined(CONFIG_AT_PARSER_TOKEN_INDEX)
+int at_parser_init_partial(struct at_parser *parser, const char *at)
+{
+	if (!parser || !at) {
+		return -EINVAL;
+	}
+
+	memset(parser, 0, sizeof(struct at_parser));
+
+	parser->at = at;
+	parser->cursor = at;
+	parser->init_sentinel = INIT_SENTINEL;
+	parser->index.partial = true;
+
+	at_parser_index_reset(parser);
+	at_parser_index_build(parser);
+
+	return 0;
+}
+
+int at_parser_feed(struct at_parser *parser, bool complete)
+{
+	int err;
+
+	err = at_parser_check(parser);
+	if (err) {
+		return err;
+	}
+
+	if (!parser->index.partial) {
+		return -EALREADY;
+	}
+
+	parser->index.partial = !complete;
+	at_parser_index_build(parser);
+
+	return 0;
+}
+#endif /* CONFIG_AT_PARSER_TOKEN_INDEX */
+
 int at_parser_cmd_next(struct at_parser *parser)
 {
 	int err;
@@ -274,6 +414,12 @@ int at_parser_cmd_next(struct at_parser *parser)
 		return err;
 	}
 
+#if defined(CONFIG_AT_PARSER_TOKEN_INDEX)
+	if (parser->index.partial) {
+		return -EINPROGRESS;
+	}
+#endif
+
 	do {
 		err = at_parser_tok(parser, &token);
 	} while (!err);
@@ -291,6 +437,11 @@ int at_parser_cmd_next(struct at_parser *parser)
 	 */
 	parser->at = parser->cursor;
 
+#if defined(CONFIG_AT_PARSER_TOKEN_INDEX)
+	at_parser_index_reset(parser);
+	at_parser_index_build(parser);
+#endif
+
 	return 0;
 }
 
@@ -341,6 +492,12 @@ int at_parser_cmd_count_get(struct at_parser *parser, size_t *count)
 		return err;
 	}
 
+#if defined(CONFIG_AT_PARSER_TOKEN_INDEX)
+	if (parser->index.partial) {
+		return -EINPROGRESS;
+	}
+#endif
+
 	do {
 		err = at_parser_tok(parser, &token);
 	} while (!err);
@@ -365,7 +522,7 @@ static int at_parser_num_get_impl(struct at_parser *parser, size_t index, void *
 		return err;
 	}
 
-	err = at_parser_seek(parser, index, &token);
+	err = at_parser_token_get(parser, index, &token);
 	if (err) {
 		return err;
 	}
@@ -484,7 +641,7 @@ static int at_parser_string_common_get_impl(struct at_parser *parser, size_t ind
 		return err;
 	}
 
-	err = at_parser_seek(parser, index, &token);
+	err = at_parser_token_get(parser, index, &token);
 	if (err) {
 		return err;
 	}
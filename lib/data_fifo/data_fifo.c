@@ -13,19 +13,225 @@ LOG_MODULE_REGISTER(data_fifo, CONFIG_DATA_FIFO_LOG_LEVEL);
 
 static struct k_spinlock lock;
 
+#if defined(CONFIG_DATA_FIFO_SPSC)
+/* Lock-free single-producer/single-consumer ring.
+ *
+ * Blocks are taken from the slab buffer in order. The producer owns producer.head (reserved)
+ * and producer.tail (committed), the consumer owns consumer.head (read) and consumer.tail
+ * (released). The indices run modulo twice the number of blocks, so that a full ring can be
+ * told from an empty one, while each index still maps to the same block every time it wraps.
+ * The message queue buffer is used to store the size of each committed block.
+ *
+ * Kernel objects are only used when a call has to wait for the other side.
+ */
+
+static inline void *spsc_block(struct data_fifo *data_fifo, uint32_t idx)
+{
+	return data_fifo->slab_buffer + (idx % data_fifo->elements_max) * data_fifo->block_size_max;
+}
+
+static inline struct data_fifo_msgq *spsc_entry(struct data_fifo *data_fifo, uint32_t idx)
+{
+	return &((struct data_fifo_msgq *)data_fifo->msgq_buffer)[idx % data_fifo->elements_max];
+}
+
+static inline uint32_t spsc_idx(atomic_t *idx)
+{
+	return (uint32_t)atomic_get(idx);
+}
+
+static inline uint32_t spsc_next(struct data_fifo *data_fifo, uint32_t idx)
+{
+	return (idx + 1 == 2 * data_fifo->elements_max) ? 0 : idx + 1;
+}
+
+static inline uint32_t spsc_prev(struct data_fifo *data_fifo, uint32_t idx)
+{
+	return (idx == 0) ? 2 * data_fifo->elements_max - 1 : idx - 1;
+}
+
+/* Number of blocks from index from to index to. */
+static inline uint32_t spsc_count(struct data_fifo *data_fifo, uint32_t to, uint32_t from)
+{
+	return (to >= from) ? to - from : to + 2 * data_fifo->elements_max - from;
+}
+
+static void spsc_reset(struct data_fifo *data_fifo)
+{
+	struct data_fifo_spsc_side *sides[] = {&data_fifo->producer, &data_fifo->consumer};
+
+	ARRAY_FOR_EACH(sides, i) {
+		atomic_clear(&sides[i]->head);
+		atomic_clear(&sides[i]->tail);
+		atomic_clear(&sides[i]->waiting);
+		k_sem_init(&sides[i]->sem, 0, 1);
+	}
+}
+
+/** @brief Wait for the other side to make progress.
+ *
+ * The waiting flag is set before the caller checks the ring state again, so that
+ * a notification sent in between is not lost.
+ *
+ * @retval 0		The caller shall check the ring state again.
+ * @retval -EAGAIN	Timed out.
+ */
+static int spsc_wait(struct data_fifo_spsc_side *side, k_timepoint_t end)
+{
+	int ret;
+
+	if (!atomic_get(&side->waiting)) {
+		atomic_set(&side->waiting, 1);
+		return 0;
+	}
+
+	ret = k_sem_take(&side->sem, sys_timepoint_timeout(end));
+	if (ret) {
+		atomic_clear(&side->waiting);
+		return -EAGAIN;
+	}
+
+	return 0;
+}
+
+static void spsc_notify(struct data_fifo_spsc_side *side)
+{
+	if (atomic_cas(&side->waiting, 1, 0)) {
+		k_sem_give(&side->sem);
+	}
+}
+
+static int spsc_reserve(struct data_fifo *data_fifo, void **data, k_timeout_t timeout)
+{
+	struct data_fifo_spsc_side *producer = &data_fifo->producer;
+	k_timepoint_t end = sys_timepoint_calc(timeout);
+	uint32_t head = spsc_idx(&producer->head);
+	int ret;
+
+	while (spsc_count(data_fifo, head, spsc_idx(&data_fifo->consumer.tail)) >=
+	       data_fifo->elements_max) {
+		if (K_TIMEOUT_EQ(timeout, K_NO_WAIT)) {
+			return -ENOMEM;
+		}
+
+		ret = spsc_wait(producer, end);
+		if (ret) {
+			return ret;
+		}
+	}
+
+	atomic_clear(&producer->waiting);
+
+	*data = spsc_block(data_fifo, head);
+	atomic_set(&producer->head, spsc_next(data_fifo, head));
+
+	return 0;
+}
+
+static int spsc_commit(struct data_fifo *data_fifo, void *data, size_t size)
+{
+	struct data_fifo_spsc_side *producer = &data_fifo->producer;
+	uint32_t tail = spsc_idx(&producer->tail);
+	struct data_fifo_msgq *entry;
+
+	if ((tail == spsc_idx(&producer->head)) || (data != spsc_block(data_fifo, tail))) {
+		LOG_ERR("Block %p is not the oldest reserved block", data);
+		return -EPERM;
+	}
+
+	entry = spsc_entry(data_fifo, tail);
+	entry->block_ptr = data;
+	entry->size = size;
+
+	/* Publishing the index makes the block and its size visible to the consumer */
+	atomic_set(&producer->tail, spsc_next(data_fifo, tail));
+	spsc_notify(&data_fifo->consumer);
+
+	return 0;
+}
+
+static int spsc_read(struct data_fifo *data_fifo, void **data, size_t *size, k_timeout_t timeout)
+{
+	struct data_fifo_spsc_side *consumer = &data_fifo->consumer;
+	k_timepoint_t end = sys_timepoint_calc(timeout);
+	uint32_t head = spsc_idx(&consumer->head);
+	struct data_fifo_msgq *entry;
+	int ret;
+
+	while (head == spsc_idx(&data_fifo->producer.tail)) {
+		if (K_TIMEOUT_EQ(timeout, K_NO_WAIT)) {
+			return -ENOMSG;
+		}
+
+		ret = spsc_wait(consumer, end);
+		if (ret) {
+			return ret;
+		}
+	}
+
+	atomic_clear(&consumer->waiting);
+
+	entry = spsc_entry(data_fifo, head);
+	*data = entry->block_ptr;
+	*size = entry->size;
+	atomic_set(&consumer->head, spsc_next(data_fifo, head));
+
+	return 0;
+}
+
+static void spsc_free(struct data_fifo *data_fifo, void *data)
+{
+	struct data_fifo_spsc_side *producer = &data_fifo->producer;
+	struct data_fifo_spsc_side *consumer = &data_fifo->consumer;
+	uint32_t cons_tail = spsc_idx(&consumer->tail);
+	uint32_t prod_head = spsc_idx(&producer->head);
+
+	if ((cons_tail != spsc_idx(&consumer->head)) && (data == spsc_block(data_fifo, cons_tail))) {
+		/* Consumer has finished reading the oldest block */
+		atomic_set(&consumer->tail, spsc_next(data_fifo, cons_tail));
+		spsc_notify(producer);
+	} else if ((prod_head != spsc_idx(&producer->tail)) &&
+		   (data == spsc_block(data_fifo, spsc_prev(data_fifo, prod_head)))) {
+		/* Producer cancels its last reservation */
+		atomic_set(&producer->head, spsc_prev(data_fifo, prod_head));
+	} else {
+		LOG_ERR("Block %p freed out of order", data);
+		__ASSERT_NO_MSG(false);
+	}
+}
+#endif /* CONFIG_DATA_FIFO_SPSC */
+
 /** @brief Checks that the elements in the msgq and slab are legal.
  * I.e. the number of msgq elements cannot be more than mem blocks used.
  */
 static int msgq_slab_legal_used_elements(struct data_fifo *data_fifo, uint32_t *msgq_num_used_in,
 					 uint32_t *slab_blocks_num_used_in)
 {
-	/* Lock so msgq and slab reads are in sync */
-	k_spinlock_key_t key = k_spin_lock(&lock);
-
-	uint32_t msgq_num_used = k_msgq_num_used_get(&data_fifo->msgq);
-	uint32_t slab_blocks_num_used = k_mem_slab_num_used_get(&data_fifo->mem_slab);
-
-	k_spin_unlock(&lock, key);
+	uint32_t msgq_num_used;
+	uint32_t slab_blocks_num_used;
+
+#if defined(CONFIG_DATA_FIFO_SPSC)
+	if (data_fifo->spsc) {
+		/* Read the consumer indices first. The indices only move forward, so the
+		 * number of locked blocks can not be negative.
+		 */
+		uint32_t cons_head = spsc_idx(&data_fifo->consumer.head);
+		uint32_t cons_tail = spsc_idx(&data_fifo->consumer.tail);
+
+		msgq_num_used = spsc_count(data_fifo, spsc_idx(&data_fifo->producer.tail), cons_head);
+		slab_blocks_num_used =
+			spsc_count(data_fifo, spsc_idx(&data_fifo->producer.head), cons_tail);
+	} else
+#endif /* CONFIG_DATA_FIFO_SPSC */
+	{
+		/* Lock so msgq and slab reads are in sync */
+		k_spinlock_key_t key = k_spin_lock(&lock);
+
+		msgq_num_used = k_msgq_num_used_get(&data_fifo->msgq);
+		slab_blocks_num_used = k_mem_slab_num_used_get(&data_fifo->mem_slab);
+
+		k_spin_unlock(&lock, key);
+	}
 
 	if (slab_blocks_num_used < msgq_num_used) {
 		LOG_ERR("Num used mgsq %d cannot be larger than used blocks %d", msgq_num_used,
@@ -48,6 +254,12 @@ int data_fifo_pointer_first_vacant_get(struct data_fifo *data_fifo, void **data,
 	__ASSERT_NO_MSG(data_fifo->initialized);
 	int ret;
 
+#if defined(CONFIG_DATA_FIFO_SPSC)
+	if (data_fifo->spsc) {
+		return spsc_reserve(data_fifo, data, timeout);
+	}
+#endif /* CONFIG_DATA_FIFO_SPSC */
+
 	ret = k_mem_slab_alloc(&data_fifo->mem_slab, data, timeout);
 	return ret;
 }
@@ -66,6 +278,12 @@ int data_fifo_block_lock(struct data_fifo *data_fifo, void **data, size_t size)
 		return -EINVAL;
 	}
 
+#if defined(CONFIG_DATA_FIFO_SPSC)
+	if (data_fifo->spsc) {
+		return spsc_commit(data_fifo, *data, size);
+	}
+#endif /* CONFIG_DATA_FIFO_SPSC */
+
 	struct data_fifo_msgq msgq_tmp;
 
 	msgq_tmp.block_ptr = *data;
@@ -91,6 +309,12 @@ int data_fifo_pointer_last_filled_get(struct data_fifo *data_fifo, void **data,
 	__ASSERT_NO_MSG(data_fifo->initialized);
 	int ret;
 
+#if defined(CONFIG_DATA_FIFO_SPSC)
+	if (data_fifo->spsc) {
+		return spsc_read(data_fifo, data, size, timeout);
+	}
+#endif /* CONFIG_DATA_FIFO_SPSC */
+
 	struct data_fifo_msgq msgq_tmp;
 
 	ret = k_msgq_get(&data_fifo->msgq, &msgq_tmp, timeout);
@@ -108,6 +332,13 @@ void data_fifo_block_free(struct data_fifo *data_fifo, void *data)
 	__ASSERT_NO_MSG(data_fifo != NULL);
 	__ASSERT_NO_MSG(data_fifo->initialized);
 
+#if defined(CONFIG_DATA_FIFO_SPSC)
+	if (data_fifo->spsc) {
+		spsc_free(data_fifo, data);
+		return;
+	}
+#endif /* CONFIG_DATA_FIFO_SPSC */
+
 	k_mem_slab_free(&data_fifo->mem_slab, data);
 }
 
@@ -144,6 +375,13 @@ int data_fifo_empty(struct data_fifo *data_fifo)
 		return ret;
 	}
 
+#if defined(CONFIG_DATA_FIFO_SPSC)
+	if (data_fifo->spsc) {
+		spsc_reset(data_fifo);
+		return 0;
+	}
+#endif /* CONFIG_DATA_FIFO_SPSC */
+
 	for (int i = 0; i < fifo_locked_num; i++) {
 		ret = data_fifo_pointer_last_filled_get(data_fifo, &old_data, &size, K_NO_WAIT);
 		if (ret == -ENOMSG) {
@@ -192,6 +430,14 @@ int data_fifo_init(struct data_fifo *data_fifo)
 	__ASSERT_NO_MSG((data_fifo->block_size_max % WB_UP(1)) == 0);
 	int ret;
 
+#if defined(CONFIG_DATA_FIFO_SPSC)
+	if (data_fifo->spsc) {
+		spsc_reset(data_fifo);
+		data_fifo->initialized = true;
+		return 0;
+	}
+#endif /* CONFIG_DATA_FIFO_SPSC */
+
 	k_msgq_init(&data_fifo->msgq, data_fifo->msgq_buffer, sizeof(struct data_fifo_msgq),
 		    data_fifo->elements_max);
 
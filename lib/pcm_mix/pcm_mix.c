@@ -6,94 +6,202 @@
 
 #include <pcm_mix.h>
 
+#include <string.h>
 #include <zephyr/kernel.h>
 
+#if defined(CONFIG_PCM_MIX_DSP)
+#include <cmsis_core.h>
+#endif
+
 #include <zephyr/logging/log.h>
 LOG_MODULE_REGISTER(pcm_mix, CONFIG_PCM_MIX_LOG_LEVEL);
 
-/* Clip signal if amplitude is outside legal range */
-static void hard_limiter(int32_t *const pcm)
+#define INT24_MAX ((1 << 23) - 1)
+#define INT24_MIN (-(1 << 23))
+
+/* Channel layout of buffer A relative to buffer B, derived from the mix mode */
+struct mix_layout {
+	/* Distance (in samples) between consecutive frames in buffer A */
+	uint8_t a_stride;
+	/* Bitmask of channels in a frame of buffer A to mix buffer B into */
+	uint8_t a_channels;
+};
+
+/* Saturate to the signed 16-bit range without branching */
+static inline int16_t sat16(int32_t val)
 {
-	if (*pcm < INT16_MIN) {
-		LOG_DBG("Clip");
-		*pcm = INT16_MIN;
-	} else if (*pcm > INT16_MAX) {
-		LOG_DBG("Clip");
-		*pcm = INT16_MAX;
-	}
+	val = (val > INT16_MAX) ? INT16_MAX : val;
+	val = (val < INT16_MIN) ? INT16_MIN : val;
+
+	return (int16_t)val;
 }
 
-/* Mix stereo-stereo or mono-mono. I.e. buffers are of equal size */
-static void pcm_mix_identical(void *const pcm_a, size_t size_a, void const *const pcm_b,
-			      size_t size_b)
+static inline int32_t sat24(int32_t val)
 {
-	int32_t res;
+	val = (val > INT24_MAX) ? INT24_MAX : val;
+	val = (val < INT24_MIN) ? INT24_MIN : val;
 
-	for (uint32_t i = 0; i < size_b / 2; i++) {
-		res = ((int16_t *)pcm_a)[i] + ((int16_t *)pcm_b)[i];
+	return val;
+}
 
-		hard_limiter(&res);
+static inline int32_t sat32(int64_t val)
+{
+	val = (val > INT32_MAX) ? INT32_MAX : val;
+	val = (val < INT32_MIN) ? INT32_MIN : val;
 
-		((int16_t *)pcm_a)[i] = (int16_t)res;
-	}
+	return (int32_t)val;
 }
 
-/* Mix mono into both channels of a stereo buffer */
-static void pcm_mix_b_mono_into_a_stereo_lr(void *const pcm_a, size_t size_a,
-					    void const *const pcm_b, size_t size_b)
+#if defined(CONFIG_PCM_MIX_DSP)
+/* Mix 16-bit samples using the saturating dual 16-bit addition (QADD16).
+ * Each word of buffer A holds two samples: either two consecutive mono samples or
+ * one stereo frame. The matching word of buffer B is built so that it only
+ * contributes to the selected channels.
+ */
+static void mix_16(int16_t *restrict pcm_a, const int16_t *restrict pcm_b, size_t num_samples,
+		   struct mix_layout layout)
 {
-	int32_t res;
+	uint32_t a;
+	uint32_t b;
+	size_t i = 0;
 
-	/* Use size_b as this is the length of the mono sample.
-	 * This must be *2 to traverse the stereo sample and /2 since
-	 * the sample is two bytes in size.
-	 */
-	for (uint32_t i = 0; i < size_b; i++) {
-		res = ((int16_t *)pcm_a)[i] + ((int16_t *)pcm_b)[i / 2];
+	if (layout.a_stride == 1) {
+		for (; i + 1 < num_samples; i += 2) {
+			memcpy(&a, &pcm_a[i], sizeof(a));
+			memcpy(&b, &pcm_b[i], sizeof(b));
+			a = __QADD16(a, b);
+			memcpy(&pcm_a[i], &a, sizeof(a));
+		}
+
+		for (; i < num_samples; i++) {
+			pcm_a[i] = sat16((int32_t)pcm_a[i] + pcm_b[i]);
+		}
+
+		return;
+	}
+
+	for (; i < num_samples; i++) {
+		uint32_t b_sample = (uint16_t)pcm_b[i];
 
-		hard_limiter(&res);
+		switch (layout.a_channels) {
+		case BIT(0):
+			b = b_sample;
+			break;
+		case BIT(1):
+			b = b_sample << 16;
+			break;
+		default:
+			b = b_sample | (b_sample << 16);
+			break;
+		}
 
-		((int16_t *)pcm_a)[i] = (int16_t)res;
+		memcpy(&a, &pcm_a[i * 2], sizeof(a));
+		a = __QADD16(a, b);
+		memcpy(&pcm_a[i * 2], &a, sizeof(a));
 	}
 }
 
-/* Mix mono into left channel of a stereo buffer */
-static void pcm_mix_b_mono_into_a_stereo_l(void *const pcm_a, size_t size_a,
-					   void const *const pcm_b, size_t size_b)
+static void mix_32(int32_t *restrict pcm_a, const int32_t *restrict pcm_b, size_t num_samples,
+		   struct mix_layout layout)
 {
-	int32_t res;
+	for (size_t i = 0; i < num_samples; i++) {
+		int32_t *frame = &pcm_a[i * layout.a_stride];
 
-	for (uint32_t i = 0; i < size_b / 2; i++) {
-		res = ((int16_t *)pcm_a)[i * 2] + ((int16_t *)pcm_b)[i];
+		for (uint8_t ch = 0; ch < layout.a_stride; ch++) {
+			if (layout.a_channels & BIT(ch)) {
+				frame[ch] = __QADD(frame[ch], pcm_b[i]);
+			}
+		}
+	}
+}
+#else
+/* Portable implementation. The loops are kept free of branches and function calls,
+ * so that the compiler can vectorize them where the target allows it.
+ */
+static void mix_16(int16_t *restrict pcm_a, const int16_t *restrict pcm_b, size_t num_samples,
+		   struct mix_layout layout)
+{
+	if (layout.a_stride == 1) {
+		for (size_t i = 0; i < num_samples; i++) {
+			pcm_a[i] = sat16((int32_t)pcm_a[i] + pcm_b[i]);
+		}
+
+		return;
+	}
 
-		hard_limiter(&res);
+	for (uint8_t ch = 0; ch < layout.a_stride; ch++) {
+		if (!(layout.a_channels & BIT(ch))) {
+			continue;
+		}
 
-		((int16_t *)pcm_a)[i * 2] = (int16_t)res;
+		for (size_t i = 0; i < num_samples; i++) {
+			pcm_a[i * 2 + ch] = sat16((int32_t)pcm_a[i * 2 + ch] + pcm_b[i]);
+		}
 	}
 }
 
-/* Mix mono into right channel of a stereo buffer */
-static void pcm_mix_b_mono_into_a_stereo_r(void *const pcm_a, size_t size_a,
-					   void const *const pcm_b, size_t size_b)
+static void mix_32(int32_t *restrict pcm_a, const int32_t *restrict pcm_b, size_t num_samples,
+		   struct mix_layout layout)
 {
-	int32_t res;
+	for (uint8_t ch = 0; ch < layout.a_stride; ch++) {
+		if (!(layout.a_channels & BIT(ch))) {
+			continue;
+		}
 
-	for (uint32_t i = 0; i < size_b / 2; i++) {
-		res = ((int16_t *)pcm_a)[i * 2 + 1] + ((int16_t *)pcm_b)[i];
+		for (size_t i = 0; i < num_samples; i++) {
+			int32_t *a = &pcm_a[i * layout.a_stride + ch];
+
+			*a = sat32((int64_t)*a + pcm_b[i]);
+		}
+	}
+}
+#endif /* CONFIG_PCM_MIX_DSP */
 
-		hard_limiter(&res);
+static inline int32_t load24(const uint8_t *p)
+{
+	/* Little endian, sign extended */
+	return ((int32_t)(((uint32_t)p[0] << 8) | ((uint32_t)p[1] << 16) |
+			  ((uint32_t)p[2] << 24))) >> 8;
+}
 
-		((int16_t *)pcm_a)[i * 2 + 1] = (int16_t)res;
+static inline void store24(uint8_t *p, int32_t val)
+{
+	p[0] = (uint8_t)val;
+	p[1] = (uint8_t)(val >> 8);
+	p[2] = (uint8_t)(val >> 16);
+}
+
+/* Mix packed 24-bit samples (three bytes per sample, little endian) */
+static void mix_24(uint8_t *restrict pcm_a, const uint8_t *restrict pcm_b, size_t num_samples,
+		   struct mix_layout layout)
+{
+	for (size_t i = 0; i < num_samples; i++) {
+		int32_t b = load24(&pcm_b[i * 3]);
+		uint8_t *frame = &pcm_a[i * 3 * layout.a_stride];
+
+		for (uint8_t ch = 0; ch < layout.a_stride; ch++) {
+			if (layout.a_channels & BIT(ch)) {
+				store24(&frame[ch * 3], sat24(load24(&frame[ch * 3]) + b));
+			}
+		}
 	}
 }
 
-int pcm_mix(void *const pcm_a, size_t size_a, void const *const pcm_b, size_t size_b,
-	    enum pcm_mix_mode mix_mode)
+int pcm_mix_bit_depth(void *const pcm_a, size_t size_a, void const *const pcm_b, size_t size_b,
+		      enum pcm_mix_mode mix_mode, uint8_t pcm_bit_depth)
 {
+	struct mix_layout layout;
+	uint8_t bytes_per_sample = pcm_bit_depth / 8;
+
 	if (pcm_a == NULL || size_a == 0) {
 		return -EINVAL;
 	}
 
+	if (pcm_bit_depth != 16 && pcm_bit_depth != 24 && pcm_bit_depth != 32) {
+		LOG_ERR("Invalid bit depth: %d", pcm_bit_depth);
+		return -EINVAL;
+	}
+
 	if (pcm_b == NULL || size_b == 0) {
 		/* Nothing to mix, returning */
 		return 0;
@@ -106,30 +214,49 @@ int pcm_mix(void *const pcm_a, size_t size_a, void const *const pcm_b, size_t si
 		if (size_b > size_a) {
 			return -EPERM;
 		}
-		pcm_mix_identical(pcm_a, size_a, pcm_b, size_b);
+		layout.a_stride = 1;
+		layout.a_channels = BIT(0);
 		break;
 	case B_MONO_INTO_A_STEREO_LR:
-		if (size_b > (size_a / 2)) {
-			return -EPERM;
-		}
-		pcm_mix_b_mono_into_a_stereo_lr(pcm_a, size_a, pcm_b, size_b);
+		layout.a_stride = 2;
+		layout.a_channels = BIT(0) | BIT(1);
 		break;
 	case B_MONO_INTO_A_STEREO_L:
-		pcm_mix_b_mono_into_a_stereo_l(pcm_a, size_a, pcm_b, size_b);
-		if (size_b > (size_a / 2)) {
-			LOG_ERR("size a %d size b %d", size_a, size_b);
-			return -EPERM;
-		}
+		layout.a_stride = 2;
+		layout.a_channels = BIT(0);
 		break;
 	case B_MONO_INTO_A_STEREO_R:
-		pcm_mix_b_mono_into_a_stereo_r(pcm_a, size_a, pcm_b, size_b);
-		if (size_b > (size_a / 2)) {
-			return -EPERM;
-		}
+		layout.a_stride = 2;
+		layout.a_channels = BIT(1);
 		break;
 	default:
 		return -ESRCH;
 	};
 
+	if (layout.a_stride == 2 && size_b > (size_a / 2)) {
+		LOG_ERR("size a %zu size b %zu", size_a, size_b);
+		return -EPERM;
+	}
+
+	size_t num_samples = size_b / bytes_per_sample;
+
+	switch (pcm_bit_depth) {
+	case 16:
+		mix_16(pcm_a, pcm_b, num_samples, layout);
+		break;
+	case 24:
+		mix_24(pcm_a, pcm_b, num_samples, layout);
+		break;
+	default:
+		mix_32(pcm_a, pcm_b, num_samples, layout);
+		break;
+	}
+
 	return 0;
 }
+
+int pcm_mix(void *const pcm_a, size_t size_a, void const *const pcm_b, size_t size_b,
+	    enum pcm_mix_mode mix_mode)
+{
+	return pcm_mix_bit_depth(pcm_a, size_a, pcm_b, size_b, mix_mode, 16);
+}
@@ -6,6 +6,9 @@
 
 #include "sample_rate_converter.h"
 #include "sample_rate_converter_filter.h"
+#ifdef CONFIG_SAMPLE_RATE_CONVERTER_POLYPHASE
+#include "sample_rate_converter_polyphase.h"
+#endif
 
 #include <errno.h>
 #include <stdbool.h>
@@ -102,6 +105,29 @@ static int sample_rate_converter_reconfigure(struct sample_rate_converter_ctx *c
 
 	__ASSERT(ctx != NULL, "Context cannot be NULL");
 
+#ifdef CONFIG_SAMPLE_RATE_CONVERTER_POLYPHASE
+	if (filter == SAMPLE_RATE_FILTER_POLYPHASE) {
+		ret = sample_rate_converter_polyphase_validate(sample_rate_input,
+							       sample_rate_output);
+		if (ret) {
+			LOG_ERR("Invalid sample rate given (%d)", ret);
+			return ret;
+		}
+
+		ctx->sample_rate_input = sample_rate_input;
+		ctx->sample_rate_output = sample_rate_output;
+		ctx->filter_type = filter;
+
+		/* The conversion ratio is not an integer, the polyphase converter keeps track
+		 * of the ratio itself.
+		 */
+		ctx->conversion_ratio = 0;
+		sample_rate_converter_polyphase_init(ctx);
+
+		return 0;
+	}
+#endif /* CONFIG_SAMPLE_RATE_CONVERTER_POLYPHASE */
+
 	ret = validate_sample_rates(sample_rate_input, sample_rate_output);
 	if (ret) {
 		LOG_ERR("Invalid sample rate given (%d)", ret);
@@ -247,6 +273,13 @@ int sample_rate_converter_process(struct sample_rate_converter_ctx *ctx,
 		}
 	}
 
+#ifdef CONFIG_SAMPLE_RATE_CONVERTER_POLYPHASE
+	if (ctx->conversion_ratio == 0) {
+		return sample_rate_converter_polyphase_process(ctx, input, samples_in, output,
+							       output_size, output_written);
+	}
+#endif
+
 	if ((ctx->conversion_ratio < 0) && (samples_in < abs(ctx->conversion_ratio))) {
 		LOG_ERR("Number of samples in can not be less than the conversion ratio (%d) when "
 			"downsampling",
@@ -393,3 +426,25 @@ int sample_rate_converter_process(struct sample_rate_converter_ctx *ctx,
 
 	return 0;
 }
+
+int sample_rate_converter_drift_set(struct sample_rate_converter_ctx *ctx, int32_t drift_ppm)
+{
+	if (ctx == NULL) {
+		LOG_ERR("Context cannot be NULL");
+		return -EINVAL;
+	}
+
+#ifdef CONFIG_SAMPLE_RATE_CONVERTER_POLYPHASE
+	ctx->polyphase.drift_ppm = drift_ppm;
+
+	if (ctx->filter_type == SAMPLE_RATE_FILTER_POLYPHASE) {
+		sample_rate_converter_polyphase_step_update(ctx);
+	}
+
+	return 0;
+#else
+	ARG_UNUSED(drift_ppm);
+
+	return -ENOTSUP;
+#endif
+}
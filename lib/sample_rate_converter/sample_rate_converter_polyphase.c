@@ -0,0 +1,208 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include "sample_rate_converter.h"
+#include "sample_rate_converter_polyphase.h"
+
+#include <errno.h>
+#include <math.h>
+#include <string.h>
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_REGISTER(sample_rate_converter_polyphase, CONFIG_SAMPLE_RATE_CONVERTER_LOG_LEVEL);
+
+/**
+ * The polyphase converter implements band-limited interpolation: every output sample is computed
+ * as a dot product of the filter phase closest to the fractional position of the output sample
+ * and the input history. The result is linearly interpolated between two neighbouring phases.
+ *
+ * The coefficient table is computed once, when the converter is configured, using a Blackman
+ * windowed sinc with the cut-off frequency at 90% of the lower of the two Nyquist frequencies.
+ * Each phase is normalized to unity DC gain. Single precision is used, as the targets have at
+ * most a single-precision FPU.
+ *
+ * The position of the next output sample is kept as an unsigned Q32.32 number of input samples
+ * relative to the start of the history buffer.
+ */
+
+#define TAPS	 CONFIG_SAMPLE_RATE_CONVERTER_POLYPHASE_TAPS
+#define PHASES	 CONFIG_SAMPLE_RATE_CONVERTER_POLYPHASE_PHASES
+#define HISTORY	 (TAPS - 1)
+
+/* Supported ratio range between the output and the input sample rate */
+#define RATIO_MIN_DIV 3
+#define RATIO_MAX_MUL 3
+
+#define CUTOFF_SCALE 0.9f
+#define PI_F ((float)M_PI)
+
+BUILD_ASSERT((TAPS % 2) == 0, "Number of taps must be even");
+BUILD_ASSERT(IS_POWER_OF_TWO(PHASES), "Number of phases must be a power of two");
+BUILD_ASSERT(TAPS <= CONFIG_SAMPLE_RATE_CONVERTER_MAX_FILTER_SIZE,
+	     "State buffer too small for the polyphase filter");
+
+#ifdef CONFIG_SAMPLE_RATE_CONVERTER_BIT_DEPTH_16
+typedef q15_t sample_t;
+#define SAMPLE_FRAC_BITS 15
+#define SAMPLE_MAX	 INT16_MAX
+#define SAMPLE_MIN	 INT16_MIN
+#define STATE_BUF(ctx)	 ((ctx)->state_buf_15)
+#elif CONFIG_SAMPLE_RATE_CONVERTER_BIT_DEPTH_32
+typedef q31_t sample_t;
+#define SAMPLE_FRAC_BITS 31
+#define SAMPLE_MAX	 INT32_MAX
+#define SAMPLE_MIN	 INT32_MIN
+#define STATE_BUF(ctx)	 ((ctx)->state_buf_31)
+#endif
+
+/* Weight used to interpolate between neighbouring phases, in Q15 */
+#define MU_FRAC_BITS 15
+
+static inline sample_t saturate(int64_t val)
+{
+	val = (val > SAMPLE_MAX) ? SAMPLE_MAX : val;
+	val = (val < SAMPLE_MIN) ? SAMPLE_MIN : val;
+
+	return (sample_t)val;
+}
+
+static inline int64_t dot_product(const sample_t *coeffs, const sample_t *samples)
+{
+	int64_t acc = 0;
+
+	for (size_t i = 0; i < TAPS; i++) {
+		acc += (int64_t)coeffs[i] * samples[i];
+	}
+
+	return acc >> SAMPLE_FRAC_BITS;
+}
+
+static float windowed_sinc(float t, float cutoff)
+{
+	float x = PI_F * cutoff * t;
+	float sinc = (t == 0.0f) ? 1.0f : (sinf(x) / x);
+	float window = 0.42f + 0.5f * cosf(2.0f * PI_F * t / TAPS) +
+		       0.08f * cosf(4.0f * PI_F * t / TAPS);
+
+	return cutoff * sinc * window;
+}
+
+int sample_rate_converter_polyphase_validate(uint32_t sample_rate_input,
+					     uint32_t sample_rate_output)
+{
+	if ((sample_rate_input == 0) || (sample_rate_output == 0)) {
+		LOG_ERR("Sample rate cannot be zero");
+		return -EINVAL;
+	}
+
+	if (((uint64_t)sample_rate_output * RATIO_MIN_DIV < sample_rate_input) ||
+	    (sample_rate_output > (uint64_t)sample_rate_input * RATIO_MAX_MUL)) {
+		LOG_ERR("Unsupported conversion ratio %d/%d", sample_rate_input,
+			sample_rate_output);
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+void sample_rate_converter_polyphase_step_update(struct sample_rate_converter_ctx *ctx)
+{
+	struct sample_rate_converter_polyphase *pp = &ctx->polyphase;
+	uint64_t step = (((uint64_t)ctx->sample_rate_input) << 32) / ctx->sample_rate_output;
+
+	/* Positive drift means that the input is sampled faster than the nominal rate,
+	 * so more input samples are consumed for every output sample.
+	 */
+	step = (uint64_t)((int64_t)step + (((int64_t)step / 1000) * pp->drift_ppm) / 1000);
+
+	pp->step = step;
+}
+
+void sample_rate_converter_polyphase_init(struct sample_rate_converter_ctx *ctx)
+{
+	struct sample_rate_converter_polyphase *pp = &ctx->polyphase;
+	float cutoff = CUTOFF_SCALE;
+	float h[TAPS];
+
+	if (ctx->sample_rate_output < ctx->sample_rate_input) {
+		cutoff *= (float)ctx->sample_rate_output / ctx->sample_rate_input;
+	}
+
+	/* Output sample at fractional position f lies between the two middle taps. */
+	for (size_t p = 0; p <= PHASES; p++) {
+		float frac = (float)p / PHASES;
+		float sum = 0.0f;
+
+		for (size_t k = 0; k < TAPS; k++) {
+			h[k] = windowed_sinc((float)k - (TAPS / 2 - 1) - frac, cutoff);
+			sum += h[k];
+		}
+
+		for (size_t k = 0; k < TAPS; k++) {
+			float coeff = (h[k] / sum) * (float)(1LL << SAMPLE_FRAC_BITS);
+
+			pp->coeffs[p][k] = saturate(llroundf(coeff));
+		}
+	}
+
+	memset(STATE_BUF(ctx), 0, HISTORY * sizeof(sample_t));
+	pp->pos = 0;
+
+	sample_rate_converter_polyphase_step_update(ctx);
+
+	LOG_DBG("Polyphase converter initialized, step 0x%08x%08x, cut-off %d/1000",
+		(uint32_t)(pp->step >> 32), (uint32_t)pp->step, (int)(cutoff * 1000));
+}
+
+int sample_rate_converter_polyphase_process(struct sample_rate_converter_ctx *ctx,
+					    void const *const input, size_t samples_in,
+					    void *const output, size_t output_size,
+					    size_t *output_written)
+{
+	struct sample_rate_converter_polyphase *pp = &ctx->polyphase;
+	sample_t *buf = STATE_BUF(ctx);
+	sample_t *out = output;
+	/* Output samples can be produced while the filter fits in the buffer, that is, for
+	 * positions before the first new input sample.
+	 */
+	uint64_t pos_limit = ((uint64_t)samples_in) << 32;
+	size_t out_cnt = 0;
+
+	if (pp->pos < pos_limit) {
+		out_cnt = ((pos_limit - pp->pos - 1) / pp->step) + 1;
+	}
+
+	if (out_cnt * sizeof(sample_t) > output_size) {
+		LOG_ERR("Conversion will produce %zu samples, more than the output buffer can hold",
+			out_cnt);
+		return -EINVAL;
+	}
+
+	/* The history is kept at the start of the state buffer, new samples are appended to it.
+	 * This is the only copy of the input samples.
+	 */
+	memcpy(&buf[HISTORY], input, samples_in * sizeof(sample_t));
+
+	for (size_t i = 0; i < out_cnt; i++) {
+		size_t idx = pp->pos >> 32;
+		uint64_t scaled_frac = (pp->pos & UINT32_MAX) * PHASES;
+		size_t phase = scaled_frac >> 32;
+		int64_t mu = (scaled_frac & UINT32_MAX) >> (32 - MU_FRAC_BITS);
+		int64_t a = dot_product(pp->coeffs[phase], &buf[idx]);
+		int64_t b = dot_product(pp->coeffs[phase + 1], &buf[idx]);
+
+		out[i] = saturate(a + (((b - a) * mu) >> MU_FRAC_BITS));
+		pp->pos += pp->step;
+	}
+
+	/* Keep the last samples as history for the next block. */
+	memmove(buf, &buf[samples_in], HISTORY * sizeof(sample_t));
+	pp->pos -= pos_limit;
+
+	*output_written = out_cnt * sizeof(sample_t);
+
+	return 0;
+}
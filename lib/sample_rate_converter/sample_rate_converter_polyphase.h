@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef _SAMPLE_RATE_CONVERTER_POLYPHASE_H_
+#define _SAMPLE_RATE_CONVERTER_POLYPHASE_H_
+
+#include "sample_rate_converter.h"
+
+/**
+ * @brief Validate sample rates for the polyphase converter.
+ *
+ * @param[in]	sample_rate_input	Sample rate of the input samples.
+ * @param[in]	sample_rate_output	Sample rate of the output samples.
+ *
+ * @retval	0	On success.
+ * @retval	-EINVAL	Conversion ratio not supported.
+ */
+int sample_rate_converter_polyphase_validate(uint32_t sample_rate_input,
+					     uint32_t sample_rate_output);
+
+/**
+ * @brief Initialize the polyphase converter for the sample rates stored in the context.
+ *
+ * @details Computes the coefficient table for the conversion, clears the sample history and
+ *	    applies the drift compensation stored in the context.
+ *
+ * @param[in,out]	ctx	Pointer to the sample rate conversion context.
+ */
+void sample_rate_converter_polyphase_init(struct sample_rate_converter_ctx *ctx);
+
+/**
+ * @brief Update the step of the polyphase converter after the drift has changed.
+ *
+ * @param[in,out]	ctx	Pointer to the sample rate conversion context.
+ */
+void sample_rate_converter_polyphase_step_update(struct sample_rate_converter_ctx *ctx);
+
+/**
+ * @brief Process a block of samples with the polyphase converter.
+ *
+ * @param[in,out]	ctx		Pointer to the sample rate conversion context.
+ * @param[in]		input		Pointer to samples to process.
+ * @param[in]		samples_in	Number of input samples.
+ * @param[out]		output		Array that output will be written.
+ * @param[in]		output_size	Size of the output array in bytes.
+ * @param[out]		output_written	Number of bytes written to output.
+ *
+ * @retval	0	On success.
+ * @retval	-EINVAL	Output array too small.
+ */
+int sample_rate_converter_polyphase_process(struct sample_rate_converter_ctx *ctx,
+					    void const *const input, size_t samples_in,
+					    void *const output, size_t output_size,
+					    size_t *output_written);
+
+#endif /* _SAMPLE_RATE_CONVERTER_POLYPHASE_H_ */
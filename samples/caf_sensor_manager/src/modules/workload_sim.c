@@ -22,7 +22,7 @@ LOG_MODULE_REGISTER(MODULE);
 struct workload {
 	struct sensor_value *samples;
 	struct k_work work;
-	uint8_t sample_cnt;
+	uint16_t sample_cnt;
 	uint8_t values_in_sample;
 	atomic_t busy;
 	const char *sensor_descr;
@@ -5,6 +5,7 @@
  */
 
 #include <stdio.h>
+#include <string.h>
 #include <zephyr/kernel.h>
 #include <zephyr/spinlock.h>
 #include <zephyr/sys/slist.h>
@@ -19,10 +20,58 @@ static void event_processor_fn(struct k_work *work);
 
 struct app_event_manager_event_display_bm _app_event_manager_event_display_bm;
 
-static K_WORK_DEFINE(event_processor, event_processor_fn);
-static sys_slist_t eventq = SYS_SLIST_STATIC_INIT(&eventq);
+enum event_lane_id {
+	EVENT_LANE_NORMAL,
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_PRIORITY_LANES)
+	EVENT_LANE_HIGH,
+#endif
+
+	EVENT_LANE_COUNT
+};
+
+struct event_lane {
+	sys_slist_t eventq;
+	struct k_work work;
+	struct k_work_q *work_q;
+};
+
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_PRIORITY_LANES)
+/* Listeners of the two lanes must not preempt each other. */
+BUILD_ASSERT(CONFIG_SYSTEM_WORKQUEUE_PRIORITY < 0,
+	     "Priority lanes require a cooperative system work queue");
+BUILD_ASSERT(CONFIG_APP_EVENT_MANAGER_HIGH_PRIO_LANE_THREAD_PRIORITY <
+	     CONFIG_SYSTEM_WORKQUEUE_PRIORITY,
+	     "High priority lane must have a higher priority than the system work queue");
+
+static K_THREAD_STACK_DEFINE(high_prio_lane_stack,
+			     CONFIG_APP_EVENT_MANAGER_HIGH_PRIO_LANE_STACK_SIZE);
+static struct k_work_q high_prio_lane_work_q;
+#endif
+
+static struct event_lane lanes[EVENT_LANE_COUNT] = {
+	[EVENT_LANE_NORMAL] = {
+		.eventq = SYS_SLIST_STATIC_INIT(&lanes[EVENT_LANE_NORMAL].eventq),
+		.work = Z_WORK_INITIALIZER(event_processor_fn),
+		.work_q = &k_sys_work_q,
+	},
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_PRIORITY_LANES)
+	[EVENT_LANE_HIGH] = {
+		.eventq = SYS_SLIST_STATIC_INIT(&lanes[EVENT_LANE_HIGH].eventq),
+		.work = Z_WORK_INITIALIZER(event_processor_fn),
+		.work_q = &high_prio_lane_work_q,
+	},
+#endif
+};
 static struct k_spinlock lock;
 
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_SUBSCRIBER_FILTER)
+static const struct event_subtype_provider *subtype_providers[CONFIG_APP_EVENT_MANAGER_MAX_EVENT_CNT];
+#endif
+
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_LISTENER_STATS)
+static struct k_spinlock stats_lock;
+#endif
+
 static bool log_is_event_displayed(const struct event_type *et)
 {
 	size_t idx = et - _event_type_list_start;
@@ -114,18 +163,217 @@ static void log_event_init(void)
 	}
 }
 
+static void event_alloc_fail(void)
+{
+	LOG_ERR("Application Event Manager OOM error\n");
+	__ASSERT_NO_MSG(false);
+	if (IS_ENABLED(CONFIG_APP_EVENT_MANAGER_REBOOT_ON_EVENT_ALLOC_FAIL)) {
+		sys_reboot(SYS_REBOOT_WARM);
+	} else {
+		k_panic();
+	}
+}
+
+static void subtype_providers_init(void)
+{
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_SUBSCRIBER_FILTER)
+	STRUCT_SECTION_FOREACH(event_subtype_provider, sp) {
+		size_t idx = sp->type_id - _event_type_list_start;
+
+		APP_EVENT_ASSERT_ID(sp->type_id);
+		__ASSERT(!subtype_providers[idx], "Subtype of %s registered twice",
+			 sp->type_id->name);
+		subtype_providers[idx] = sp;
+	}
+#endif
+}
+
+static uint32_t event_subtype_bit(const struct app_event_header *aeh)
+{
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_SUBSCRIBER_FILTER)
+	const struct event_subtype_provider *sp =
+		subtype_providers[aeh->type_id - _event_type_list_start];
+
+	if (sp) {
+		uint8_t subtype = sp->subtype_get(aeh);
+
+		__ASSERT_NO_MSG(subtype < 32);
+		return BIT(subtype);
+	}
+#endif
+
+	return UINT32_MAX;
+}
+
+static bool subscriber_is_notified(const struct event_subscriber *es, uint32_t subtype_bit)
+{
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_SUBSCRIBER_FILTER)
+	return (es->subtype_mask & subtype_bit) != 0;
+#else
+	return true;
+#endif
+}
+
+static void listener_stats_update(const struct event_listener *el, bool notified,
+				  uint32_t cycles)
+{
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_LISTENER_STATS)
+	k_spinlock_key_t key = k_spin_lock(&stats_lock);
+
+	if (notified) {
+		el->stats->notify_cnt++;
+		el->stats->exec_cycles += cycles;
+	} else {
+		el->stats->skip_cnt++;
+	}
+
+	k_spin_unlock(&stats_lock, key);
+#endif
+}
+
+void app_event_manager_listener_stats_get(const struct event_listener *el,
+					  struct event_listener_stats *stats)
+{
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_LISTENER_STATS)
+	k_spinlock_key_t key = k_spin_lock(&stats_lock);
+
+	*stats = *el->stats;
+
+	k_spin_unlock(&stats_lock, key);
+#else
+	ARG_UNUSED(el);
+	memset(stats, 0, sizeof(*stats));
+	__ASSERT_NO_MSG(false);
+#endif
+}
+
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_EVENT_ALLOCATOR_SLAB)
+/* Use the same alignment as guaranteed by the kernel heap. */
+#define EVENT_SLAB_ALIGN		(2 * sizeof(void *))
+#define EVENT_SLAB_BLOCK_SIZE(size)	ROUND_UP(size, EVENT_SLAB_ALIGN)
+
+BUILD_ASSERT(CONFIG_APP_EVENT_MANAGER_SLAB_SMALL_BLOCK_SIZE <
+	     CONFIG_APP_EVENT_MANAGER_SLAB_MEDIUM_BLOCK_SIZE);
+BUILD_ASSERT(CONFIG_APP_EVENT_MANAGER_SLAB_MEDIUM_BLOCK_SIZE <
+	     CONFIG_APP_EVENT_MANAGER_SLAB_LARGE_BLOCK_SIZE);
+
+K_MEM_SLAB_DEFINE_STATIC(event_slab_small,
+			 EVENT_SLAB_BLOCK_SIZE(CONFIG_APP_EVENT_MANAGER_SLAB_SMALL_BLOCK_SIZE),
+			 CONFIG_APP_EVENT_MANAGER_SLAB_SMALL_BLOCK_COUNT,
+			 EVENT_SLAB_ALIGN);
+K_MEM_SLAB_DEFINE_STATIC(event_slab_medium,
+			 EVENT_SLAB_BLOCK_SIZE(CONFIG_APP_EVENT_MANAGER_SLAB_MEDIUM_BLOCK_SIZE),
+			 CONFIG_APP_EVENT_MANAGER_SLAB_MEDIUM_BLOCK_COUNT,
+			 EVENT_SLAB_ALIGN);
+K_MEM_SLAB_DEFINE_STATIC(event_slab_large,
+			 EVENT_SLAB_BLOCK_SIZE(CONFIG_APP_EVENT_MANAGER_SLAB_LARGE_BLOCK_SIZE),
+			 CONFIG_APP_EVENT_MANAGER_SLAB_LARGE_BLOCK_COUNT,
+			 EVENT_SLAB_ALIGN);
+
+struct event_slab {
+	struct k_mem_slab *slab;
+	atomic_t alloc_fail_cnt;
+};
+
+/* Size classes sorted by ascending block size. */
+static struct event_slab event_slabs[] = {
+	{ .slab = &event_slab_small },
+	{ .slab = &event_slab_medium },
+	{ .slab = &event_slab_large },
+};
+
+static bool event_slab_owns(const struct k_mem_slab *slab, const void *addr)
+{
+	const uint8_t *start = (const uint8_t *)slab->buffer;
+	const uint8_t *end = start + (slab->info.num_blocks * slab->info.block_size);
+
+	return ((const uint8_t *)addr >= start) && ((const uint8_t *)addr < end);
+}
+
 void * __weak app_event_manager_alloc(size_t size)
 {
-	void *event = k_malloc(size);
+	void *event = NULL;
+	size_t i;
+
+	for (i = 0; i < ARRAY_SIZE(event_slabs); i++) {
+		if (size <= event_slabs[i].slab->info.block_size) {
+			break;
+		}
+	}
+
+	if (likely(i < ARRAY_SIZE(event_slabs))) {
+		if (k_mem_slab_alloc(event_slabs[i].slab, &event, K_NO_WAIT)) {
+			atomic_inc(&event_slabs[i].alloc_fail_cnt);
+			event = NULL;
+		}
+	} else {
+		LOG_WRN("Event of size %zu exceeds the largest size class", size);
+	}
+
+	if (IS_ENABLED(CONFIG_APP_EVENT_MANAGER_SLAB_HEAP_FALLBACK) && !event) {
+		event = k_malloc(size);
+	}
 
 	if (unlikely(!event)) {
-		LOG_ERR("Application Event Manager OOM error\n");
-		__ASSERT_NO_MSG(false);
-		if (IS_ENABLED(CONFIG_APP_EVENT_MANAGER_REBOOT_ON_EVENT_ALLOC_FAIL)) {
-			sys_reboot(SYS_REBOOT_WARM);
-		} else {
-			k_panic();
+		event_alloc_fail();
+		return NULL;
+	}
+
+	return event;
+}
+
+void __weak app_event_manager_free(void *addr)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(event_slabs); i++) {
+		if (event_slab_owns(event_slabs[i].slab, addr)) {
+			k_mem_slab_free(event_slabs[i].slab, addr);
+			return;
 		}
+	}
+
+	/* Heap fallback, or an overridden app_event_manager_alloc(). */
+	k_free(addr);
+}
+
+int app_event_manager_slab_stats_get(size_t idx, struct app_event_manager_slab_stats *stats)
+{
+	if (idx >= ARRAY_SIZE(event_slabs)) {
+		return -ENOENT;
+	}
+
+	struct k_mem_slab *slab = event_slabs[idx].slab;
+
+	stats->block_size = slab->info.block_size;
+	stats->num_blocks = slab->info.num_blocks;
+	stats->num_used = k_mem_slab_num_used_get(slab);
+	stats->max_used = k_mem_slab_max_used_get(slab);
+	stats->alloc_fail_cnt = atomic_get(&event_slabs[idx].alloc_fail_cnt);
+
+	return 0;
+}
+
+static void event_slab_init(void)
+{
+	/* Static event sizes are known only if provided by the event types. */
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_PROVIDE_EVENT_SIZE)
+	const struct k_mem_slab *largest = event_slabs[ARRAY_SIZE(event_slabs) - 1].slab;
+
+	STRUCT_SECTION_FOREACH(event_type, et) {
+		if (et->struct_size > largest->info.block_size) {
+			LOG_WRN("Event %s (%u bytes) does not fit in any size class",
+				et->name, et->struct_size);
+		}
+	}
+#endif
+}
+
+#else
+void * __weak app_event_manager_alloc(size_t size)
+{
+	void *event = k_malloc(size);
+
+	if (unlikely(!event)) {
+		event_alloc_fail();
 		return NULL;
 	}
 
@@ -137,22 +385,55 @@ void __weak app_event_manager_free(void *addr)
 	k_free(addr);
 }
 
+int app_event_manager_slab_stats_get(size_t idx, struct app_event_manager_slab_stats *stats)
+{
+	ARG_UNUSED(idx);
+	ARG_UNUSED(stats);
+
+	return -ENOTSUP;
+}
+
+static void event_slab_init(void)
+{
+}
+#endif /* CONFIG_APP_EVENT_MANAGER_EVENT_ALLOCATOR_SLAB */
+
+static bool event_lane_is_sliced(const struct event_lane *lane)
+{
+	/* The normal lane processes one event per work item run. The cooperative system work
+	 * queue thread then yields between events, which lets the high priority lane run.
+	 */
+	return IS_ENABLED(CONFIG_APP_EVENT_MANAGER_PRIORITY_LANES) &&
+	       (lane == &lanes[EVENT_LANE_NORMAL]);
+}
+
 static void event_processor_fn(struct k_work *work)
 {
+	struct event_lane *lane = CONTAINER_OF(work, struct event_lane, work);
 	sys_slist_t events = SYS_SLIST_STATIC_INIT(&events);
+	bool resubmit = false;
 
 	/* Make current event list local. */
 	k_spinlock_key_t key = k_spin_lock(&lock);
 
-	if (sys_slist_is_empty(&eventq)) {
+	if (sys_slist_is_empty(&lane->eventq)) {
 		k_spin_unlock(&lock, key);
 		return;
 	}
 
-	sys_slist_merge_slist(&events, &eventq);
+	if (event_lane_is_sliced(lane)) {
+		sys_slist_append(&events, sys_slist_get_not_empty(&lane->eventq));
+		resubmit = !sys_slist_is_empty(&lane->eventq);
+	} else {
+		sys_slist_merge_slist(&events, &lane->eventq);
+	}
 
 	k_spin_unlock(&lock, key);
 
+	if (resubmit) {
+		(void)k_work_submit_to_queue(lane->work_q, work);
+	}
+
 	/* Traverse the list of events. */
 	sys_snode_t *node;
 	while (NULL != (node = sys_slist_get(&events))) {
@@ -173,6 +454,7 @@ static void event_processor_fn(struct k_work *work)
 		log_event(aeh);
 
 		bool consumed = false;
+		uint32_t subtype_bit = event_subtype_bit(aeh);
 
 		for (const struct event_subscriber *es = et->subs_start;
 		     (es != et->subs_stop) && !consumed;
@@ -185,10 +467,22 @@ static void event_processor_fn(struct k_work *work)
 			__ASSERT_NO_MSG(el != NULL);
 			__ASSERT_NO_MSG(el->notification != NULL);
 
+			if (!subscriber_is_notified(es, subtype_bit)) {
+				listener_stats_update(el, false, 0);
+				continue;
+			}
+
 			log_event_progress(et, el);
 
+			uint32_t start = IS_ENABLED(CONFIG_APP_EVENT_MANAGER_LISTENER_STATS) ?
+					 k_cycle_get_32() : 0;
+
 			consumed = el->notification(aeh);
 
+			if (IS_ENABLED(CONFIG_APP_EVENT_MANAGER_LISTENER_STATS)) {
+				listener_stats_update(el, true, k_cycle_get_32() - start);
+			}
+
 			if (consumed) {
 				log_event_consumed(et);
 			}
@@ -204,11 +498,23 @@ static void event_processor_fn(struct k_work *work)
 	}
 }
 
+static struct event_lane *event_lane_get(const struct event_type *et)
+{
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_PRIORITY_LANES)
+	if (app_event_get_type_flag(et, APP_EVENT_TYPE_FLAGS_HIGH_PRIORITY)) {
+		return &lanes[EVENT_LANE_HIGH];
+	}
+#endif
+
+	return &lanes[EVENT_LANE_NORMAL];
+}
+
 void _event_submit(struct app_event_header *aeh)
 {
 	__ASSERT_NO_MSG(aeh);
 	APP_EVENT_ASSERT_ID(aeh->type_id);
 
+	struct event_lane *lane = event_lane_get(aeh->type_id);
 	k_spinlock_key_t key = k_spin_lock(&lock);
 
 	if (IS_ENABLED(CONFIG_APP_EVENT_MANAGER_SUBMIT_HOOKS)) {
@@ -216,10 +522,28 @@ void _event_submit(struct app_event_header *aeh)
 			h->hook(aeh);
 		}
 	}
-	sys_slist_append(&eventq, &aeh->node);
+	sys_slist_append(&lane->eventq, &aeh->node);
 	k_spin_unlock(&lock, key);
 
-	k_work_submit(&event_processor);
+	/* Work queue of the high priority lane is started on initialization.
+	 * Events submitted earlier are processed after the work queue starts.
+	 */
+	(void)k_work_submit_to_queue(lane->work_q, &lane->work);
+}
+
+static void event_lanes_init(void)
+{
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_PRIORITY_LANES)
+	struct k_work_queue_config cfg = {
+		.name = "app_evt_high",
+	};
+
+	k_work_queue_start(&high_prio_lane_work_q, high_prio_lane_stack,
+			   K_THREAD_STACK_SIZEOF(high_prio_lane_stack),
+			   CONFIG_APP_EVENT_MANAGER_HIGH_PRIO_LANE_THREAD_PRIORITY, &cfg);
+
+	(void)k_work_submit_to_queue(lanes[EVENT_LANE_HIGH].work_q, &lanes[EVENT_LANE_HIGH].work);
+#endif
 }
 
 int app_event_manager_init(void)
@@ -230,6 +554,9 @@ int app_event_manager_init(void)
 			CONFIG_APP_EVENT_MANAGER_MAX_EVENT_CNT);
 
 	log_event_init();
+	subtype_providers_init();
+	event_slab_init();
+	event_lanes_init();
 
 	if (IS_ENABLED(CONFIG_APP_EVENT_MANAGER_POSTINIT_HOOK)) {
 		STRUCT_SECTION_FOREACH(app_event_manager_postinit_hook, h) {
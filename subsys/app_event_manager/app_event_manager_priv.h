@@ -106,12 +106,40 @@ extern "C" {
 	((const struct event_subscriber *)&_APP_EM_TAG_NAME(ename, _APP_EM_MARKER_ARRAY_END))
 
 
-/* Subscribe a listener to an event. */
-#define _APP_EVENT_SUBSCRIBE(lname, ename, prio)					\
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_SUBSCRIBER_FILTER)
+#define _APP_EVENT_SUBSCRIBER_SUBTYPE_MASK(mask) .subtype_mask = (mask),
+#else
+#define _APP_EVENT_SUBSCRIBER_SUBTYPE_MASK(mask)
+#endif
+
+/* Subscribe a listener to an event, limited to the event subtypes from the mask. */
+#define _APP_EVENT_SUBSCRIBE_MASK(lname, ename, prio, mask)				\
 	const struct event_subscriber _CONCAT(_CONCAT(__event_subscriber_, ename), lname)\
 	__used __aligned(__alignof(struct event_subscriber))				\
 	__attribute__((__section__(_APP_EVENT_SUBSCRIBERS_SECTION_NAME(ename, prio)))) = {\
 		.listener = &_CONCAT(__event_listener_, lname),				\
+		_APP_EVENT_SUBSCRIBER_SUBTYPE_MASK(mask) /* No comma here intentionally */\
+	}
+
+/* Subscribe a listener to an event. */
+#define _APP_EVENT_SUBSCRIBE(lname, ename, prio) \
+	_APP_EVENT_SUBSCRIBE_MASK(lname, ename, prio, UINT32_MAX)
+
+/* Subscribe a listener to selected subtypes of an event. */
+#define _APP_EVENT_SUBSCRIBE_FILTERED(lname, ename, prio, mask)				\
+	BUILD_ASSERT(IS_ENABLED(CONFIG_APP_EVENT_MANAGER_SUBSCRIBER_FILTER),		\
+		     "Enable APP_EVENT_MANAGER_SUBSCRIBER_FILTER before usage");	\
+	BUILD_ASSERT((mask) != 0, "Subtype mask cannot be empty");			\
+	_APP_EVENT_SUBSCRIBE_MASK(lname, ename, prio, mask)
+
+/* Register function providing subtype of an event. */
+#define _APP_EVENT_SUBTYPE_REGISTER(ename, subtype_fn)					\
+	BUILD_ASSERT(IS_ENABLED(CONFIG_APP_EVENT_MANAGER_SUBSCRIBER_FILTER),		\
+		     "Enable APP_EVENT_MANAGER_SUBSCRIBER_FILTER before usage");	\
+	STRUCT_SECTION_ITERABLE(event_subtype_provider,					\
+				_CONCAT(__event_subtype_provider_, ename)) = {		\
+		.type_id = _EVENT_ID(ename),						\
+		.subtype_get = (subtype_fn),						\
 	}
 
 
@@ -187,11 +215,23 @@ extern "C" {
 
 
 
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_LISTENER_STATS)
+#define _APP_EVENT_LISTENER_STATS_DEFINE(lname) \
+	static struct event_listener_stats _CONCAT(__event_listener_stats_, lname);
+#define _APP_EVENT_LISTENER_STATS_PTR(lname) \
+	.stats = &_CONCAT(__event_listener_stats_, lname),
+#else
+#define _APP_EVENT_LISTENER_STATS_DEFINE(lname)
+#define _APP_EVENT_LISTENER_STATS_PTR(lname)
+#endif
+
 /* Declarations and definitions - for more details refer to public API. */
 #define _APP_EVENT_LISTENER(lname, notification_fn)					\
+	_APP_EVENT_LISTENER_STATS_DEFINE(lname) /* No semicolon here intentionally */	\
 	STRUCT_SECTION_ITERABLE(event_listener, _CONCAT(__event_listener_, lname)) = {	\
 		.name = STRINGIFY(lname),						\
 		.notification = (notification_fn),					\
+		_APP_EVENT_LISTENER_STATS_PTR(lname) /* No comma here intentionally */	\
 	}
 
 
@@ -374,6 +414,20 @@ struct event_dyndata {
 };
 
 
+/** @brief Event listener statistics.
+ */
+struct event_listener_stats {
+	/** Total time spent in the notification function (in cycles). */
+	uint64_t exec_cycles;
+
+	/** Number of notification function calls. */
+	uint32_t notify_cnt;
+
+	/** Number of notifications skipped because of the subscriber subtype mask. */
+	uint32_t skip_cnt;
+};
+
+
 /** @brief Event listener.
  *
  * All event listeners must be defined using @ref APP_EVENT_LISTENER.
@@ -387,6 +441,11 @@ struct event_listener {
 	 * not propagated to further listeners, or false, otherwise.
 	 */
 	bool (*notification)(const struct app_event_header *aeh);
+
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_LISTENER_STATS)
+	/** Statistics of this listener. */
+	struct event_listener_stats *stats;
+#endif
 };
 
 
@@ -395,6 +454,26 @@ struct event_listener {
 struct event_subscriber {
 	/** Pointer to the listener. */
 	const struct event_listener *listener;
+
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_SUBSCRIBER_FILTER)
+	/** Bitmask of event subtypes that the listener is notified about. */
+	uint32_t subtype_mask;
+#endif
+};
+
+
+/** @brief Event subtype provider.
+ *
+ * Event subtype providers must be registered using @ref APP_EVENT_SUBTYPE_REGISTER.
+ */
+struct event_subtype_provider {
+	/** Pointer to the event type object. */
+	const struct event_type *type_id;
+
+	/** Pointer to the function returning subtype of the given event.
+	 * Returned value must be lower than 32.
+	 */
+	uint8_t (*subtype_get)(const struct app_event_header *aeh);
 };
 
 
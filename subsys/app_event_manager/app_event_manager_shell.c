@@ -45,6 +45,33 @@ static int show_listeners(const struct shell *shell, size_t argc,
 	return 0;
 }
 
+static int show_listener_stats(const struct shell *shell, size_t argc,
+		char **argv)
+{
+	if (!IS_ENABLED(CONFIG_APP_EVENT_MANAGER_LISTENER_STATS)) {
+		shell_error(shell, "Listener statistics are disabled");
+		return -ENOTSUP;
+	}
+
+	shell_fprintf(shell, SHELL_NORMAL, "Listener statistics:\n");
+
+	STRUCT_SECTION_FOREACH(event_listener, el) {
+		struct event_listener_stats stats;
+
+		app_event_manager_listener_stats_get(el, &stats);
+
+		uint64_t total_us = k_cyc_to_us_floor64(stats.exec_cycles);
+		uint64_t avg_us = (stats.notify_cnt > 0) ? (total_us / stats.notify_cnt) : 0;
+
+		shell_fprintf(shell, SHELL_NORMAL,
+			      "|\t[L:%s] notified %u, skipped %u, total %llu us, avg %llu us\n",
+			      el->name, stats.notify_cnt, stats.skip_cnt,
+			      (unsigned long long)total_us, (unsigned long long)avg_us);
+	}
+
+	return 0;
+}
+
 static int show_subscribers(const struct shell *shell, size_t argc,
 		char **argv)
 {
@@ -81,6 +108,30 @@ static int show_subscribers(const struct shell *shell, size_t argc,
 	return 0;
 }
 
+static int show_slabs(const struct shell *shell, size_t argc,
+		char **argv)
+{
+	struct app_event_manager_slab_stats stats;
+	size_t idx = 0;
+
+	if (!IS_ENABLED(CONFIG_APP_EVENT_MANAGER_EVENT_ALLOCATOR_SLAB)) {
+		shell_error(shell, "Memory slab event allocator is disabled");
+		return -ENOTSUP;
+	}
+
+	shell_fprintf(shell, SHELL_NORMAL, "Event allocator size classes:\n");
+
+	while (!app_event_manager_slab_stats_get(idx, &stats)) {
+		shell_fprintf(shell, SHELL_NORMAL,
+			      "|\t%zu: block size %zu, used %u/%u, max used %u, failed %u\n",
+			      idx, stats.block_size, stats.num_used, stats.num_blocks,
+			      stats.max_used, stats.alloc_fail_cnt);
+		idx++;
+	}
+
+	return 0;
+}
+
 static void set_event_displaying(const struct shell *shell, size_t argc,
 				 char **argv, bool enable)
 {
@@ -154,7 +205,11 @@ SHELL_STATIC_SUBCMD_SET_CREATE(sub_app_event_manager,
 		      show_listeners, 0, 0),
 	SHELL_CMD_ARG(show_subscribers, NULL, "Show subscribers",
 		      show_subscribers, 0, 0),
+	SHELL_CMD_ARG(show_listener_stats, NULL, "Show listener statistics",
+		      show_listener_stats, 0, 0),
 	SHELL_CMD_ARG(show_events, NULL, "Show events", show_events, 0, 0),
+	SHELL_CMD_ARG(show_slabs, NULL, "Show event allocator statistics",
+		      show_slabs, 0, 0),
 	SHELL_CMD_ARG(disable, NULL, "Disable displaying event with given ID",
 		      disable_event_displaying, 0,
 		      sizeof(_app_event_manager_event_display_bm) * 8 - 1),
@@ -5,8 +5,12 @@
  */
 
 #include <inttypes.h>
+#include <stdlib.h>
 #include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
+#include <zephyr/net_buf.h>
+#include <zephyr/settings/settings.h>
+#include <zephyr/sys/byteorder.h>
 
 #include <bluetooth/gatt_dm.h>
 
@@ -18,6 +22,8 @@ LOG_MODULE_REGISTER(bt_gatt_dm, CONFIG_BT_GATT_DM_LOG_LEVEL);
 
 #define DATA_ALIGN 4U
 
+#define DB_HASH_LEN 16
+
 /* They are placed in data_chunk without padding, so they must be aligned */
 BUILD_ASSERT(sizeof(struct bt_gatt_service_val) % DATA_ALIGN == 0);
 BUILD_ASSERT(sizeof(struct bt_gatt_chrc) % DATA_ALIGN == 0);
@@ -40,6 +46,15 @@ static int gatt_dm_wq_init(void)
 SYS_INIT(gatt_dm_wq_init, POST_KERNEL, CONFIG_BT_GATT_DM_WORKQ_INIT_PRIO);
 #endif
 
+static void gatt_dm_work_submit(struct k_work *work)
+{
+#if defined(CONFIG_BT_GATT_DM_WORKQ_OWN)
+	k_work_submit_to_queue(&bt_gatt_dm_wq, work);
+#else
+	k_work_submit(work);
+#endif
+}
+
 /* Flags for parsed attribute array state */
 enum {
 	STATE_ATTRS_LOCKED,
@@ -92,10 +107,50 @@ struct bt_gatt_dm {
 
 	/* Work item used for discovery callbacks. */
 	struct k_work discover_work;
+
+#if defined(CONFIG_BT_GATT_DM_CACHE)
+	/* Parameters used to read the Database Hash of the peer */
+	struct bt_gatt_read_params hash_params;
+	/* Database Hash read from the peer */
+	uint8_t db_hash[DB_HASH_LEN];
+	/* Store the result of the discovery in the cache when it completes */
+	bool cache_pending;
+#endif
 };
 
-/* Currently only one instance is supported */
-static struct bt_gatt_dm bt_gatt_dm_inst;
+static struct bt_gatt_dm bt_gatt_dm_inst[CONFIG_BT_GATT_DM_MAX_INSTANCES];
+static struct k_spinlock bt_gatt_dm_inst_lock;
+
+/* Returns a free instance, or NULL if none is available or the discovery is
+ * already running on the given connection.
+ */
+static struct bt_gatt_dm *dm_alloc(struct bt_conn *conn)
+{
+	struct bt_gatt_dm *dm = NULL;
+	k_spinlock_key_t key = k_spin_lock(&bt_gatt_dm_inst_lock);
+
+	for (size_t i = 0; i < ARRAY_SIZE(bt_gatt_dm_inst); i++) {
+		struct bt_gatt_dm *cur = &bt_gatt_dm_inst[i];
+
+		if (atomic_test_bit(cur->state_flags, STATE_ATTRS_LOCKED)) {
+			if (cur->conn == conn) {
+				dm = NULL;
+				break;
+			}
+		} else if (!dm) {
+			dm = cur;
+		}
+	}
+
+	if (dm) {
+		atomic_set_bit(dm->state_flags, STATE_ATTRS_LOCKED);
+		dm->conn = conn;
+	}
+
+	k_spin_unlock(&bt_gatt_dm_inst_lock, key);
+
+	return dm;
+}
 
 /* Returns pointer to newly allocated space in a dm->data_chunk */
 static void *user_data_alloc(struct bt_gatt_dm *dm,
@@ -268,9 +323,552 @@ static struct bt_gatt_dm_attr *attr_find_by_handle(
 	return NULL;
 }
 
+#if defined(CONFIG_BT_GATT_DM_CACHE)
+
+#define CACHE_SETTINGS_KEY "bt/dm_cache"
+/* "bt/dm_cache/" + entry index + terminator */
+#define CACHE_SETTINGS_KEY_SIZE (sizeof(CACHE_SETTINGS_KEY) + 4)
+
+/* Longest serialized UUID: length byte and 128-bit value */
+#define CACHE_UUID_MAX_LEN (1 + BT_UUID_SIZE_128)
+
+/* Part of the cache entry that is stored persistently */
+struct cache_record {
+	/* Peer address */
+	bt_addr_le_t addr;
+	/* Database Hash of the peer when the service was discovered */
+	uint8_t db_hash[DB_HASH_LEN];
+	/* Serialized UUID used to start the discovery, zero length if none was used */
+	uint8_t svc_uuid[CACHE_UUID_MAX_LEN];
+	/* Length of the serialized attributes */
+	uint16_t len;
+	/* Serialized attributes */
+	uint8_t data[CONFIG_BT_GATT_DM_CACHE_DATA_SIZE];
+};
+
+struct cache_entry {
+	struct cache_record rec;
+	/* Value of the usage counter at last access, zero if the entry is not used */
+	uint32_t last_used;
+};
+
+static struct cache_entry cache[CONFIG_BT_GATT_DM_CACHE_ENTRIES];
+static uint32_t cache_clock;
+static K_MUTEX_DEFINE(cache_lock);
+
+/* Entries that must be stored or deleted from the settings */
+static ATOMIC_DEFINE(cache_dirty, CONFIG_BT_GATT_DM_CACHE_ENTRIES);
+
+static void discovery_complete(struct bt_gatt_dm *dm);
+
+static size_t cache_uuid_len(const struct bt_uuid *uuid)
+{
+	switch (uuid->type) {
+	case BT_UUID_TYPE_16:
+		return 1 + BT_UUID_SIZE_16;
+	case BT_UUID_TYPE_32:
+		return 1 + BT_UUID_SIZE_32;
+	default:
+		return 1 + BT_UUID_SIZE_128;
+	}
+}
+
+static void cache_uuid_encode(struct net_buf_simple *buf, const struct bt_uuid *uuid)
+{
+	switch (uuid->type) {
+	case BT_UUID_TYPE_16:
+		net_buf_simple_add_u8(buf, BT_UUID_SIZE_16);
+		net_buf_simple_add_le16(buf, BT_UUID_16(uuid)->val);
+		break;
+	case BT_UUID_TYPE_32:
+		net_buf_simple_add_u8(buf, BT_UUID_SIZE_32);
+		net_buf_simple_add_le32(buf, BT_UUID_32(uuid)->val);
+		break;
+	default:
+		net_buf_simple_add_u8(buf, BT_UUID_SIZE_128);
+		net_buf_simple_add_mem(buf, BT_UUID_128(uuid)->val, BT_UUID_SIZE_128);
+		break;
+	}
+}
+
+static int cache_uuid_decode(struct net_buf_simple *buf, struct bt_uuid_128 *uuid)
+{
+	uint8_t len;
+
+	if (buf->len < 1) {
+		return -EINVAL;
+	}
+
+	len = net_buf_simple_pull_u8(buf);
+	if ((buf->len < len) ||
+	    !bt_uuid_create(&uuid->uuid, net_buf_simple_pull_mem(buf, len), len)) {
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+static void cache_svc_uuid_encode(const struct bt_gatt_dm *dm,
+				  uint8_t svc_uuid[CACHE_UUID_MAX_LEN])
+{
+	struct net_buf_simple buf;
+
+	memset(svc_uuid, 0, CACHE_UUID_MAX_LEN);
+
+	if (dm->search_svc_by_uuid) {
+		net_buf_simple_init_with_data(&buf, svc_uuid, CACHE_UUID_MAX_LEN);
+		net_buf_simple_reset(&buf);
+		cache_uuid_encode(&buf, &dm->svc_uuid.uuid);
+	}
+}
+
+/* Must be called with the cache_lock held. */
+static struct cache_entry *cache_find(const bt_addr_le_t *addr,
+				      const uint8_t svc_uuid[CACHE_UUID_MAX_LEN])
+{
+	for (size_t i = 0; i < ARRAY_SIZE(cache); i++) {
+		if (cache[i].last_used &&
+		    bt_addr_le_eq(&cache[i].rec.addr, addr) &&
+		    !memcmp(cache[i].rec.svc_uuid, svc_uuid, CACHE_UUID_MAX_LEN)) {
+			return &cache[i];
+		}
+	}
+
+	return NULL;
+}
+
+/* Must be called with the cache_lock held. */
+static void cache_entry_invalidate(struct cache_entry *entry)
+{
+	entry->last_used = 0;
+	atomic_set_bit(cache_dirty, entry - cache);
+}
+
+static void cache_store_work_handler(struct k_work *work)
+{
+	char key[CACHE_SETTINGS_KEY_SIZE];
+	int err;
+
+	if (!IS_ENABLED(CONFIG_BT_SETTINGS)) {
+		atomic_clear(cache_dirty);
+		return;
+	}
+
+	for (size_t i = 0; i < ARRAY_SIZE(cache); i++) {
+		if (!atomic_test_and_clear_bit(cache_dirty, i)) {
+			continue;
+		}
+
+		snprintk(key, sizeof(key), CACHE_SETTINGS_KEY "/%u", (unsigned int)i);
+
+		k_mutex_lock(&cache_lock, K_FOREVER);
+		if (cache[i].last_used) {
+			err = settings_save_one(key, &cache[i].rec,
+						offsetof(struct cache_record, data) +
+						cache[i].rec.len);
+		} else {
+			err = settings_delete(key);
+		}
+		k_mutex_unlock(&cache_lock);
+
+		if (err) {
+			LOG_WRN("Failed to store cache entry %u, error: %d", (unsigned int)i, err);
+		}
+	}
+}
+
+static K_WORK_DEFINE(cache_store_work, cache_store_work_handler);
+
+static size_t cache_attr_len(const struct bt_gatt_dm_attr *attr)
+{
+	const struct bt_gatt_service_val *service_val = bt_gatt_dm_attr_service_val(attr);
+	const struct bt_gatt_chrc *chrc = bt_gatt_dm_attr_chrc_val(attr);
+	size_t len = 2 + 1 + cache_uuid_len(attr->uuid);
+
+	if (service_val) {
+		len += 2 + cache_uuid_len(service_val->uuid);
+	} else if (chrc) {
+		len += 2 + 1 + cache_uuid_len(chrc->uuid);
+	}
+
+	return len;
+}
+
+static void cache_attr_encode(struct net_buf_simple *buf, const struct bt_gatt_dm_attr *attr)
+{
+	const struct bt_gatt_service_val *service_val = bt_gatt_dm_attr_service_val(attr);
+	const struct bt_gatt_chrc *chrc = bt_gatt_dm_attr_chrc_val(attr);
+
+	net_buf_simple_add_le16(buf, attr->handle);
+	net_buf_simple_add_u8(buf, attr->perm);
+	cache_uuid_encode(buf, attr->uuid);
+
+	if (service_val) {
+		net_buf_simple_add_le16(buf, service_val->end_handle);
+		cache_uuid_encode(buf, service_val->uuid);
+	} else if (chrc) {
+		net_buf_simple_add_le16(buf, chrc->value_handle);
+		net_buf_simple_add_u8(buf, chrc->properties);
+		cache_uuid_encode(buf, chrc->uuid);
+	}
+}
+
+static void cache_store(struct bt_gatt_dm *dm)
+{
+	struct bt_conn_info info;
+	struct cache_entry *entry;
+	struct net_buf_simple buf;
+	uint8_t svc_uuid[CACHE_UUID_MAX_LEN];
+	size_t len = 0;
+
+	for (size_t i = 0; i < dm->cur_attr_id; i++) {
+		len += cache_attr_len(&dm->attrs[i]);
+	}
+
+	if (len > sizeof(entry->rec.data)) {
+		LOG_DBG("Service too large to be cached: %zu bytes", len);
+		return;
+	}
+
+	if (bt_conn_get_info(dm->conn, &info)) {
+		return;
+	}
+
+	cache_svc_uuid_encode(dm, svc_uuid);
+
+	/* Called from the Bluetooth RX context, which must not wait for the settings. */
+	if (k_mutex_lock(&cache_lock, K_NO_WAIT)) {
+		LOG_DBG("Cache busy, service not cached");
+		return;
+	}
+
+	entry = cache_find(info.le.dst, svc_uuid);
+	if (!entry) {
+		/* Use a free entry or replace the least recently used one. */
+		entry = &cache[0];
+		for (size_t i = 1; i < ARRAY_SIZE(cache); i++) {
+			if (cache[i].last_used < entry->last_used) {
+				entry = &cache[i];
+			}
+		}
+	}
+
+	net_buf_simple_init_with_data(&buf, entry->rec.data, sizeof(entry->rec.data));
+	net_buf_simple_reset(&buf);
+
+	for (size_t i = 0; i < dm->cur_attr_id; i++) {
+		cache_attr_encode(&buf, &dm->attrs[i]);
+	}
+
+	bt_addr_le_copy(&entry->rec.addr, info.le.dst);
+	memcpy(entry->rec.db_hash, dm->db_hash, sizeof(entry->rec.db_hash));
+	memcpy(entry->rec.svc_uuid, svc_uuid, sizeof(entry->rec.svc_uuid));
+	entry->rec.len = buf.len;
+	entry->last_used = ++cache_clock;
+	atomic_set_bit(cache_dirty, entry - cache);
+
+	LOG_DBG("Cached %zu attributes in entry %d", dm->cur_attr_id, (int)(entry - cache));
+
+	k_mutex_unlock(&cache_lock);
+
+	gatt_dm_work_submit(&cache_store_work);
+}
+
+static int cache_attr_decode(struct bt_gatt_dm *dm, struct net_buf_simple *buf)
+{
+	struct bt_gatt_dm_attr *cur_attr;
+	struct bt_uuid_128 uuid;
+	struct bt_uuid_128 val_uuid;
+	struct bt_gatt_attr attr = {
+		.uuid = &uuid.uuid,
+	};
+	uint16_t val_handle;
+	uint8_t props;
+
+	if (buf->len < 3) {
+		return -EINVAL;
+	}
+
+	attr.handle = net_buf_simple_pull_le16(buf);
+	attr.perm = net_buf_simple_pull_u8(buf);
+	if (cache_uuid_decode(buf, &uuid)) {
+		return -EINVAL;
+	}
+
+	if (!bt_uuid_cmp(attr.uuid, BT_UUID_GATT_PRIMARY) ||
+	    !bt_uuid_cmp(attr.uuid, BT_UUID_GATT_SECONDARY)) {
+		struct bt_gatt_service_val *service_val;
+
+		if (buf->len < 2) {
+			return -EINVAL;
+		}
+
+		val_handle = net_buf_simple_pull_le16(buf);
+		if (cache_uuid_decode(buf, &val_uuid)) {
+			return -EINVAL;
+		}
+
+		cur_attr = attr_store(dm, &attr, sizeof(*service_val));
+		if (!cur_attr) {
+			return -ENOMEM;
+		}
+
+		service_val = bt_gatt_dm_attr_service_val(cur_attr);
+		service_val->end_handle = val_handle;
+		service_val->uuid = uuid_store(dm, &val_uuid.uuid);
+		if (!service_val->uuid) {
+			return -ENOMEM;
+		}
+	} else if (!bt_uuid_cmp(attr.uuid, BT_UUID_GATT_CHRC)) {
+		struct bt_gatt_chrc *chrc;
+
+		if (buf->len < 3) {
+			return -EINVAL;
+		}
+
+		val_handle = net_buf_simple_pull_le16(buf);
+		props = net_buf_simple_pull_u8(buf);
+		if (cache_uuid_decode(buf, &val_uuid)) {
+			return -EINVAL;
+		}
+
+		cur_attr = attr_store(dm, &attr, sizeof(*chrc));
+		if (!cur_attr) {
+			return -ENOMEM;
+		}
+
+		chrc = bt_gatt_dm_attr_chrc_val(cur_attr);
+		chrc->value_handle = val_handle;
+		chrc->properties = props;
+		chrc->uuid = uuid_store(dm, &val_uuid.uuid);
+		if (!chrc->uuid) {
+			return -ENOMEM;
+		}
+	} else if (!attr_store(dm, &attr, 0)) {
+		return -ENOMEM;
+	}
+
+	return 0;
+}
+
+/* Fills the instance with the cached attributes. Returns 0 on a cache hit. */
+static int cache_load(struct bt_gatt_dm *dm)
+{
+	struct bt_conn_info info;
+	struct cache_entry *entry;
+	struct net_buf_simple buf;
+	struct bt_gatt_service_val *service_val;
+	uint8_t svc_uuid[CACHE_UUID_MAX_LEN];
+	int err = 0;
+
+	if (bt_conn_get_info(dm->conn, &info)) {
+		return -ENOENT;
+	}
+
+	cache_svc_uuid_encode(dm, svc_uuid);
+
+	/* Called from the Bluetooth RX context, which must not wait for the settings. */
+	if (k_mutex_lock(&cache_lock, K_NO_WAIT)) {
+		LOG_DBG("Cache busy, service discovered");
+		return -EBUSY;
+	}
+
+	entry = cache_find(info.le.dst, svc_uuid);
+	if (!entry) {
+		err = -ENOENT;
+		goto unlock;
+	}
+
+	if (memcmp(entry->rec.db_hash, dm->db_hash, sizeof(dm->db_hash))) {
+		LOG_DBG("Database Hash changed");
+		/* The remaining entries of the peer are stale as well. */
+		for (size_t i = 0; i < ARRAY_SIZE(cache); i++) {
+			if (cache[i].last_used && bt_addr_le_eq(&cache[i].rec.addr, info.le.dst)) {
+				cache_entry_invalidate(&cache[i]);
+			}
+		}
+		gatt_dm_work_submit(&cache_store_work);
+		err = -ESTALE;
+		goto unlock;
+	}
+
+	net_buf_simple_init_with_data(&buf, entry->rec.data, entry->rec.len);
+
+	while (buf.len && !err) {
+		err = cache_attr_decode(dm, &buf);
+	}
+
+	service_val = (dm->cur_attr_id) ? bt_gatt_dm_attr_service_val(&dm->attrs[0]) : NULL;
+	if (!err && !service_val) {
+		err = -EINVAL;
+	}
+
+	if (err) {
+		LOG_WRN("Invalid cache entry %d, error: %d", (int)(entry - cache), err);
+		cache_entry_invalidate(entry);
+		gatt_dm_work_submit(&cache_store_work);
+		svc_attr_memory_release(dm);
+		goto unlock;
+	}
+
+	entry->last_used = ++cache_clock;
+
+	/* Leave the parameters as a completed discovery would, so that it can be continued. */
+	dm->discover_params.uuid = NULL;
+	dm->discover_params.start_handle = dm->attrs[0].handle + 1;
+	dm->discover_params.end_handle = service_val->end_handle;
+	dm->discover_params.type = BT_GATT_DISCOVER_CHARACTERISTIC;
+
+	LOG_DBG("Loaded %zu attributes from cache entry %d", dm->cur_attr_id,
+		(int)(entry - cache));
+
+unlock:
+	k_mutex_unlock(&cache_lock);
+
+	return err;
+}
+
+static uint8_t cache_hash_read_cb(struct bt_conn *conn, uint8_t err,
+				  struct bt_gatt_read_params *params,
+				  const void *data, uint16_t length)
+{
+	struct bt_gatt_dm *dm = CONTAINER_OF(params, struct bt_gatt_dm, hash_params);
+
+	if (!atomic_test_bit(dm->state_flags, STATE_ATTRS_LOCKED)) {
+		LOG_WRN("Attributes not locked");
+		return BT_GATT_ITER_STOP;
+	}
+
+	if (!err && data && (length == sizeof(dm->db_hash))) {
+		memcpy(dm->db_hash, data, sizeof(dm->db_hash));
+
+		if (!cache_load(dm)) {
+			discovery_complete(dm);
+			return BT_GATT_ITER_STOP;
+		}
+
+		dm->cache_pending = true;
+	} else {
+		LOG_DBG("Database Hash not available, error: %u", err);
+	}
+
+	/* Discovery cannot be started from the read callback. */
+	gatt_dm_work_submit(&dm->discover_work);
+
+	return BT_GATT_ITER_STOP;
+}
+
+/* Reads the Database Hash of a bonded peer. Returns 0 if the read was started. */
+static int cache_hash_read(struct bt_gatt_dm *dm)
+{
+	struct bt_conn_info info;
+	int err;
+
+	err = bt_conn_get_info(dm->conn, &info);
+	if (err) {
+		return err;
+	}
+
+	if (!bt_le_bond_exists(info.id, info.le.dst)) {
+		/* Without bond, the database of the peer might change at any time. */
+		return -ENOENT;
+	}
+
+	dm->hash_params.func = cache_hash_read_cb;
+	dm->hash_params.handle_count = 0;
+	dm->hash_params.by_uuid.start_handle = BT_ATT_FIRST_ATTRIBUTE_HANDLE;
+	dm->hash_params.by_uuid.end_handle = BT_ATT_LAST_ATTRIBUTE_HANDLE;
+	dm->hash_params.by_uuid.uuid = BT_UUID_GATT_DB_HASH;
+
+	err = bt_gatt_read(dm->conn, &dm->hash_params);
+	if (err) {
+		LOG_WRN("Database Hash read failed, error: %d", err);
+	}
+
+	return err;
+}
+
+void bt_gatt_dm_cache_clear(const bt_addr_le_t *addr)
+{
+	k_mutex_lock(&cache_lock, K_FOREVER);
+
+	for (size_t i = 0; i < ARRAY_SIZE(cache); i++) {
+		if (cache[i].last_used &&
+		    (!addr || bt_addr_le_eq(&cache[i].rec.addr, addr))) {
+			cache_entry_invalidate(&cache[i]);
+		}
+	}
+
+	k_mutex_unlock(&cache_lock);
+
+	gatt_dm_work_submit(&cache_store_work);
+}
+
+static void cache_bond_deleted(uint8_t id, const bt_addr_le_t *peer)
+{
+	bt_gatt_dm_cache_clear(peer);
+}
+
+static struct bt_conn_auth_info_cb cache_auth_info_cb = {
+	.bond_deleted = cache_bond_deleted,
+};
+
+static int cache_init(void)
+{
+	return bt_conn_auth_info_cb_register(&cache_auth_info_cb);
+}
+
+SYS_INIT(cache_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
+
+#if defined(CONFIG_BT_SETTINGS)
+static int cache_settings_set(const char *key, size_t len, settings_read_cb read_cb,
+			      void *cb_arg)
+{
+	struct cache_entry *entry;
+	unsigned long index;
+	ssize_t size;
+
+	index = strtoul(key, NULL, 10);
+	if (index >= ARRAY_SIZE(cache)) {
+		/* The cache was made smaller, drop the entry. */
+		return 0;
+	}
+
+	entry = &cache[index];
+
+	if ((len < offsetof(struct cache_record, data)) || (len > sizeof(entry->rec))) {
+		return -EINVAL;
+	}
+
+	size = read_cb(cb_arg, &entry->rec, len);
+	if ((size != len) || (entry->rec.len != len - offsetof(struct cache_record, data))) {
+		LOG_WRN("Invalid cache entry %lu", index);
+		entry->last_used = 0;
+		return 0;
+	}
+
+	entry->last_used = ++cache_clock;
+
+	LOG_DBG("Loaded cache entry %lu", index);
+
+	return 0;
+}
+
+SETTINGS_STATIC_HANDLER_DEFINE(bt_gatt_dm_cache, CACHE_SETTINGS_KEY, NULL, cache_settings_set,
+			       NULL, NULL);
+#endif /* CONFIG_BT_SETTINGS */
+
+#endif /* CONFIG_BT_GATT_DM_CACHE */
+
 static void discovery_complete(struct bt_gatt_dm *dm)
 {
 	LOG_DBG("Discovery complete.");
+#if defined(CONFIG_BT_GATT_DM_CACHE)
+	if (dm->cache_pending) {
+		dm->cache_pending = false;
+		cache_store(dm);
+	}
+#endif
 	atomic_set_bit(dm->state_flags, STATE_ATTRS_RELEASE_PENDING);
 	if (dm->callback->completed) {
 		dm->callback->completed(dm, dm->context);
@@ -373,11 +971,7 @@ static uint8_t discovery_process_service(struct bt_gatt_dm *dm,
 	dm->discover_params.start_handle = cur_attr->handle + 1;
 	LOG_DBG("Starting descriptors discovery");
 
-#if defined(CONFIG_BT_GATT_DM_WORKQ_OWN)
-	k_work_submit_to_queue(&bt_gatt_dm_wq, &dm->discover_work);
-#else
-	k_work_submit(&dm->discover_work);
-#endif
+	gatt_dm_work_submit(&dm->discover_work);
 
 	return BT_GATT_ITER_STOP;
 }
@@ -396,11 +990,7 @@ static uint8_t discovery_process_attribute(struct bt_gatt_dm *dm,
 			dm->discover_params.type =
 				BT_GATT_DISCOVER_CHARACTERISTIC;
 
-#if defined(CONFIG_BT_GATT_DM_WORKQ_OWN)
-			k_work_submit_to_queue(&bt_gatt_dm_wq, &dm->discover_work);
-#else
-			k_work_submit(&dm->discover_work);
-#endif
+			gatt_dm_work_submit(&dm->discover_work);
 		} else {
 			discovery_complete(dm);
 		}
@@ -475,28 +1065,26 @@ static uint8_t discovery_callback(struct bt_conn *conn,
 		LOG_DBG("Attr: handle %u", attr->handle);
 	}
 
-	if (conn != bt_gatt_dm_inst.conn) {
+	struct bt_gatt_dm *dm = CONTAINER_OF(params, struct bt_gatt_dm, discover_params);
+
+	if (conn != dm->conn) {
 		LOG_ERR("Unexpected conn object. Aborting.");
-		discovery_complete_error(&bt_gatt_dm_inst, -EFAULT);
+		discovery_complete_error(dm, -EFAULT);
 		return BT_GATT_ITER_STOP;
 	}
 
 	switch (params->type) {
 	case BT_GATT_DISCOVER_PRIMARY:
 	case BT_GATT_DISCOVER_SECONDARY:
-		return discovery_process_service(&bt_gatt_dm_inst,
-						 attr, params);
+		return discovery_process_service(dm, attr, params);
 	case BT_GATT_DISCOVER_ATTRIBUTE:
-		return discovery_process_attribute(&bt_gatt_dm_inst,
-						   attr, params);
+		return discovery_process_attribute(dm, attr, params);
 	case BT_GATT_DISCOVER_CHARACTERISTIC:
-		return discovery_process_characteristic(&bt_gatt_dm_inst,
-							attr,
-							params);
+		return discovery_process_characteristic(dm, attr, params);
 	default:
 		/* This should not be possible */
 		__ASSERT(false, "Unknown param type.");
-		discovery_complete_error(&bt_gatt_dm_inst, -EINVAL);
+		discovery_complete_error(dm, -EINVAL);
 
 		break;
 	}
@@ -651,13 +1239,11 @@ int bt_gatt_dm_start(struct bt_conn *conn,
 		return -EINVAL;
 	}
 
-	dm = &bt_gatt_dm_inst;
-
-	if (atomic_test_and_set_bit(dm->state_flags, STATE_ATTRS_LOCKED)) {
+	dm = dm_alloc(conn);
+	if (!dm) {
 		return -EALREADY;
 	}
 
-	dm->conn = conn;
 	dm->context = context;
 	dm->callback = cb;
 	dm->cur_attr_id = 0;
@@ -679,6 +1265,14 @@ int bt_gatt_dm_start(struct bt_conn *conn,
 	dm->discover_params.type = BT_GATT_DISCOVER_PRIMARY;
 	k_work_init(&dm->discover_work, gatt_discover_work);
 
+#if defined(CONFIG_BT_GATT_DM_CACHE)
+	dm->cache_pending = false;
+	if (!cache_hash_read(dm)) {
+		/* Discovery continues when the Database Hash is read. */
+		return 0;
+	}
+#endif
+
 	err = bt_gatt_discover(conn, &dm->discover_params);
 	if (err) {
 		LOG_ERR("Discover failed, error: %d.", err);
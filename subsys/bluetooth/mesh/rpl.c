@@ -17,14 +17,94 @@ LOG_MODULE_REGISTER(bt_mesh_rpl);
 #include <mesh/net.h>
 #include <mesh/rpl.h>
 #include <emds/emds.h>
+#include <bluetooth/mesh/rpl_stats.h>
 
+/* The entries of the replay list are kept contiguous from the start of the
+ * list, and the list is stored as is in EMDS.
+ */
 static struct bt_mesh_rpl replay_list[CONFIG_BT_MESH_CRPL];
 
 EMDS_STATIC_ENTRY_DEFINE(rpl_store, CONFIG_BT_MESH_RPL_INDEX, replay_list, sizeof(replay_list));
 
+/* Open addressing hash index over the source addresses of the replay list,
+ * with linear probing. Each slot holds the position of an entry in the
+ * replay list plus one, or zero if the slot is empty. The index is twice the
+ * size of the list, so that lookups are short and always terminate. It is
+ * not stored, but rebuilt from the replay list when needed.
+ */
+#define RPL_INDEX_SIZE (2 * CONFIG_BT_MESH_CRPL)
+#define RPL_INDEX_EMPTY 0
+
+BUILD_ASSERT(CONFIG_BT_MESH_CRPL < UINT16_MAX, "RPL too large for the index");
+
+static uint16_t rpl_index[RPL_INDEX_SIZE];
+/* Number of entries in the replay list */
+static uint16_t rpl_count;
+static bool rpl_index_valid;
+
+#if defined(CONFIG_BT_MESH_RPL_STATS)
+static struct bt_mesh_rpl_stats rpl_stats;
+#define RPL_STATS_INC(_field) (rpl_stats._field++)
+#define RPL_STATS_ADD(_field, _val) (rpl_stats._field += (_val))
+#else
+#define RPL_STATS_INC(_field)
+#define RPL_STATS_ADD(_field, _val)
+#endif
+
+static size_t rpl_hash(uint16_t src)
+{
+	/* Fibonacci hashing spreads consecutive unicast addresses over the
+	 * index, and the result is scaled to the index size without division.
+	 */
+	uint32_t hash = (uint32_t)src * 2654435769U;
+
+	return ((uint64_t)hash * RPL_INDEX_SIZE) >> 32;
+}
+
+/* Get the index slot of the given address. If the address is not in the
+ * replay list, this is the empty slot where it should be inserted.
+ */
+static uint16_t *rpl_index_slot(uint16_t src)
+{
+	size_t i = rpl_hash(src);
+
+	while (rpl_index[i] != RPL_INDEX_EMPTY &&
+	       replay_list[rpl_index[i] - 1].src != src) {
+		RPL_STATS_INC(probes);
+
+		if (++i == RPL_INDEX_SIZE) {
+			i = 0;
+		}
+	}
+
+	return &rpl_index[i];
+}
+
+static void rpl_index_build(void)
+{
+	(void)memset(rpl_index, 0, sizeof(rpl_index));
+
+	for (rpl_count = 0; rpl_count < ARRAY_SIZE(replay_list); rpl_count++) {
+		if (!replay_list[rpl_count].src) {
+			break;
+		}
+
+		*rpl_index_slot(replay_list[rpl_count].src) = rpl_count + 1;
+	}
+
+	rpl_index_valid = true;
+
+#if defined(CONFIG_BT_MESH_RPL_STATS)
+	rpl_stats.entries = rpl_count;
+	rpl_stats.entries_max = MAX(rpl_stats.entries_max, rpl_count);
+#endif
+}
+
 void bt_mesh_rpl_update(struct bt_mesh_rpl *rpl,
 		struct bt_mesh_net_rx *rx)
 {
+	uint16_t old_src = rpl->src;
+
 	/* If this is the first message on the new IV index, we should reset it
 	 * to zero to avoid invalid combinations of IV index and seg.
 	 */
@@ -35,6 +115,26 @@ void bt_mesh_rpl_update(struct bt_mesh_rpl *rpl,
 	rpl->src = rx->ctx.addr;
 	rpl->seq = rx->seq;
 	rpl->old_iv = rx->old_iv;
+
+	if (old_src == rpl->src || !rpl_index_valid) {
+		return;
+	}
+
+	if (!old_src && rpl == &replay_list[rpl_count]) {
+		/* New entry at the end of the list */
+		*rpl_index_slot(rpl->src) = ++rpl_count;
+
+#if defined(CONFIG_BT_MESH_RPL_STATS)
+		rpl_stats.entries = rpl_count;
+		rpl_stats.entries_max = MAX(rpl_stats.entries_max, rpl_count);
+#endif
+	} else {
+		/* The address of an existing entry was replaced, which only
+		 * happens if two segmented messages from new addresses were
+		 * given the same slot. Rebuild the index on the next lookup.
+		 */
+		rpl_index_valid = false;
+	}
 }
 
 /* Check the Replay Protection List for a replay attempt. If non-NULL match
@@ -45,7 +145,8 @@ void bt_mesh_rpl_update(struct bt_mesh_rpl *rpl,
 bool bt_mesh_rpl_check(struct bt_mesh_net_rx *rx,
 		struct bt_mesh_rpl **match, bool bridge)
 {
-	int i;
+	struct bt_mesh_rpl *rpl;
+	uint16_t *slot;
 
 	/* Don't bother checking messages from ourselves */
 	if (rx->net_if == BT_MESH_NET_IF_LOCAL) {
@@ -57,48 +158,60 @@ bool bt_mesh_rpl_check(struct bt_mesh_net_rx *rx,
 		return false;
 	}
 
-	for (i = 0; i < ARRAY_SIZE(replay_list); i++) {
-		struct bt_mesh_rpl *rpl = &replay_list[i];
+	if (!rpl_index_valid) {
+		rpl_index_build();
+	}
 
-		/* Empty slot */
-		if (!rpl->src) {
-			if (match) {
-				*match = rpl;
-			} else {
-				bt_mesh_rpl_update(rpl, rx);
-			}
+	RPL_STATS_INC(lookups);
 
-			return false;
+	slot = rpl_index_slot(rx->ctx.addr);
+	if (*slot == RPL_INDEX_EMPTY) {
+		if (rpl_count == ARRAY_SIZE(replay_list)) {
+			LOG_ERR("RPL is full!");
+			RPL_STATS_INC(full);
+			return true;
 		}
 
-		/* Existing slot for given address */
-		if (rpl->src == rx->ctx.addr) {
-			if (rx->old_iv && !rpl->old_iv) {
-				return true;
-			}
+		/* First empty slot. It is added to the index once it is
+		 * updated with the address.
+		 */
+		rpl = &replay_list[rpl_count];
+		if (match) {
+			*match = rpl;
+		} else {
+			bt_mesh_rpl_update(rpl, rx);
+		}
 
-			if ((!rx->old_iv && rpl->old_iv) ||
-			    rpl->seq < rx->seq) {
-				if (match) {
-					*match = rpl;
-				} else {
-					bt_mesh_rpl_update(rpl, rx);
-				}
+		return false;
+	}
 
-				return false;
-			} else {
-				return true;
-			}
+	/* Existing slot for given address */
+	rpl = &replay_list[*slot - 1];
+
+	if (rx->old_iv && !rpl->old_iv) {
+		RPL_STATS_INC(replays);
+		return true;
+	}
+
+	if ((!rx->old_iv && rpl->old_iv) ||
+	    rpl->seq < rx->seq) {
+		if (match) {
+			*match = rpl;
+		} else {
+			bt_mesh_rpl_update(rpl, rx);
 		}
+
+		return false;
 	}
 
-	LOG_ERR("RPL is full!");
+	RPL_STATS_INC(replays);
 	return true;
 }
 
 void bt_mesh_rpl_clear(void)
 {
 	(void)memset(replay_list, 0, sizeof(replay_list));
+	rpl_index_build();
 }
 
 void bt_mesh_rpl_reset(void)
@@ -130,6 +243,11 @@ void bt_mesh_rpl_reset(void)
 	}
 
 	(void) memset(&replay_list[last - shift + 1], 0, sizeof(struct bt_mesh_rpl) * shift);
+
+	RPL_STATS_ADD(evicted, shift);
+
+	/* Entries have moved, so the index must be rebuilt. */
+	rpl_index_build();
 }
 
 void bt_mesh_rpl_pending_store(uint16_t addr)
@@ -137,3 +255,17 @@ void bt_mesh_rpl_pending_store(uint16_t addr)
 
 void bt_mesh_rpl_pending_store_all_nodes(void)
 {}
+
+#if defined(CONFIG_BT_MESH_RPL_STATS)
+void bt_mesh_rpl_stats_get(struct bt_mesh_rpl_stats *stats)
+{
+	*stats = rpl_stats;
+}
+
+void bt_mesh_rpl_stats_reset(void)
+{
+	(void)memset(&rpl_stats, 0, sizeof(rpl_stats));
+	rpl_stats.entries = rpl_count;
+	rpl_stats.entries_max = rpl_count;
+}
+#endif
@@ -5,11 +5,13 @@
  */
 
 #include <zephyr/kernel.h>
+#include <string.h>
 #include <zephyr/drivers/sensor.h>
 #include <app_event_manager.h>
 
 #include <caf/events/sensor_event.h>
 #include <caf/events/sensor_data_aggregator_event.h>
+#include <caf/sensor_data_aggregator.h>
 #include <caf/sensor_manager.h>
 
 #define MODULE sensor_data_aggregator
@@ -20,63 +22,107 @@ LOG_MODULE_REGISTER(MODULE, CONFIG_CAF_SENSOR_DATA_AGGREGATOR_LOG_LEVEL);
 
 #define DT_DRV_COMPAT caf_aggregator
 
-/* The name of the structure array that describes the aggregator buffers */
-#define __AGG_BUFFS_NAME(agg_node) DT_CAT3(agg_, agg_node, _buffs)
+/* The samples of an aggregator are kept in a ring of buf_count * buf_data_length bytes.
+ * Contiguous regions of the ring are passed to consumers without copying, and each region is
+ * kept until it is released.
+ */
+#define __SAMPLE_SIZE(agg_node) (DT_PROP(agg_node, sample_size) * sizeof(struct sensor_value))
+#define __RING_SIZE(agg_node) (DT_PROP(agg_node, buf_count) * DT_PROP(agg_node, buf_data_length))
+#define __RING_LEN(agg_node) (__RING_SIZE(agg_node) / __SAMPLE_SIZE(agg_node))
+#define __REGION_LEN(agg_node) (DT_PROP(agg_node, buf_data_length) / __SAMPLE_SIZE(agg_node))
+
+/* A region sent on a sensor state change or at the end of the ring can be shorter than
+ * buf_data_length, so more regions than buffers can be in use.
+ */
+#define __REGION_MAX(agg_node) (2 * DT_PROP(agg_node, buf_count))
+
+#define __TIMESTAMPS_SIZE(agg_node) \
+	COND_CODE_1(CONFIG_CAF_SENSOR_DATA_AGGREGATOR_TIMESTAMPS, \
+		    (__RING_LEN(agg_node) * sizeof(int64_t)), (0))
 
-/* This macros are used only if no memory region is used and the aggregator buffers are created
+#define __MEMORY_REGION(agg_node) DT_PHANDLE(agg_node, memory_region)
+
+/* The names of the arrays used by the aggregator */
+#define __REGIONS_NAME(agg_node) DT_CAT3(agg_, agg_node, _regions)
+
+/* This macros are used only if no memory region is used and the aggregator data is created
  * in BSS.
  */
-#define __DATA_BUFF_NAME(agg_node, n) DT_CAT5(agg_, agg_node,  _buff_,  n,  _data)
-#define __DEFINE_DATA(n, agg_node, size)                         \
-	static struct sensor_value __DATA_BUFF_NAME(agg_node, n) \
-		[DIV_ROUND_UP(size, sizeof(struct sensor_value))]
+#define __SAMPLES_NAME(agg_node) DT_CAT3(agg_, agg_node, _samples)
+#define __TIMESTAMPS_NAME(agg_node) DT_CAT3(agg_, agg_node, _timestamps)
 /* End of BSS version only macros. */
 
-#define __INITIALIZE_BUFF(n, agg_node)                                                        \
-	COND_CODE_1(DT_NODE_HAS_PROP(agg_node, memory_region),                                \
-		({(struct sensor_value *) (DT_REG_ADDR(DT_PHANDLE(agg_node, memory_region)) + \
-			n * (DT_PROP(agg_node, buf_data_length)))}),                          \
-		({__DATA_BUFF_NAME(agg_node, n)})                                             \
-	)
-
-#define __XDEFINE_BUF_DATA(agg_node)                                                    \
-	COND_CODE_0(DT_NODE_HAS_PROP(agg_node, memory_region),                          \
-		(LISTIFY(DT_PROP(agg_node, buf_count), __DEFINE_DATA, (;),              \
-			agg_node, DT_PROP(agg_node, buf_data_length));),                \
-		()                                                                      \
-	)                                                                               \
-	static struct aggregator_buffer __AGG_BUFFS_NAME(agg_node)[] = {                \
-		LISTIFY(DT_PROP(agg_node, buf_count), __INITIALIZE_BUFF, (,), agg_node) \
-	};                                                                              \
-	BUILD_ASSERT((DT_PROP(agg_node, buf_data_length) %                              \
-		(DT_PROP(agg_node, sample_size) * sizeof(struct sensor_value))) == 0,   \
-		"Wrong sensor data or buffer size in " DT_NODE_FULL_NAME(agg_node));
+#define __DEFINE_DATA(agg_node)                                                            \
+	static struct sensor_value                                                          \
+		__SAMPLES_NAME(agg_node)[__RING_SIZE(agg_node) / sizeof(struct sensor_value)]; \
+	IF_ENABLED(CONFIG_CAF_SENSOR_DATA_AGGREGATOR_TIMESTAMPS,                            \
+		(static int64_t __TIMESTAMPS_NAME(agg_node)[__RING_LEN(agg_node)];))
+
+/* If a memory region is used, the timestamps follow the samples. */
+#define __SAMPLES_ADDR(agg_node)                                                  \
+	COND_CODE_1(DT_NODE_HAS_PROP(agg_node, memory_region),                    \
+		((struct sensor_value *)DT_REG_ADDR(__MEMORY_REGION(agg_node))),  \
+		(__SAMPLES_NAME(agg_node)))
+
+#define __TIMESTAMPS_ADDR(agg_node)                                                      \
+	COND_CODE_1(CONFIG_CAF_SENSOR_DATA_AGGREGATOR_TIMESTAMPS,                        \
+		(COND_CODE_1(DT_NODE_HAS_PROP(agg_node, memory_region),                  \
+			((int64_t *)(DT_REG_ADDR(__MEMORY_REGION(agg_node)) +            \
+				     __RING_SIZE(agg_node))),                            \
+			(__TIMESTAMPS_NAME(agg_node)))),                                 \
+		(NULL))
+
+#define __XDEFINE_BUF_DATA(agg_node)                                                       \
+	COND_CODE_0(DT_NODE_HAS_PROP(agg_node, memory_region),                             \
+		(__DEFINE_DATA(agg_node)),                                                 \
+		(BUILD_ASSERT(DT_REG_SIZE(__MEMORY_REGION(agg_node)) >=                    \
+			      (__RING_SIZE(agg_node) + __TIMESTAMPS_SIZE(agg_node)),       \
+			      "Memory region too small in " DT_NODE_FULL_NAME(agg_node));) \
+	)                                                                                  \
+	static struct aggregator_region __REGIONS_NAME(agg_node)[__REGION_MAX(agg_node)];  \
+	BUILD_ASSERT((DT_PROP(agg_node, buf_data_length) % __SAMPLE_SIZE(agg_node)) == 0,  \
+		"Wrong sensor data or buffer size in " DT_NODE_FULL_NAME(agg_node));       \
+	BUILD_ASSERT(__REGION_LEN(agg_node) <= UINT16_MAX,                                 \
+		"Buffer too large in " DT_NODE_FULL_NAME(agg_node));
 
 #define __DEFINE_BUF_DATA(i) __XDEFINE_BUF_DATA(DT_DRV_INST(i))
 
-#define __DEFINE_AGGREGATOR(i)                               \
-	[i].sensor_descr = DT_INST_PROP(i, sensor_descr),    \
-	[i].values_in_sample = DT_INST_PROP(i, sample_size), \
-	[i].buf_count = DT_INST_PROP(i, buf_count),          \
-	[i].buf_len = DT_INST_PROP(i, buf_data_length),      \
-	[i].agg_buffers = __AGG_BUFFS_NAME(DT_DRV_INST(i)),  \
-	[i].active_buf  = __AGG_BUFFS_NAME(DT_DRV_INST(i)),
-
-
-struct aggregator_buffer {
-	struct sensor_value *samples;	/* Dynamic data. */
-	bool busy;			/* Buffer status. */
-	uint8_t sample_cnt;		/* Number of samples already saved in the buffer. */
+#define __DEFINE_AGGREGATOR(i)                                        \
+	[i].sensor_descr = DT_INST_PROP(i, sensor_descr),             \
+	[i].samples = __SAMPLES_ADDR(DT_DRV_INST(i)),                 \
+	[i].timestamps = __TIMESTAMPS_ADDR(DT_DRV_INST(i)),           \
+	[i].regions = __REGIONS_NAME(DT_DRV_INST(i)),                 \
+	[i].values_in_sample = DT_INST_PROP(i, sample_size),          \
+	[i].ring_len = __RING_LEN(DT_DRV_INST(i)),                    \
+	[i].region_len = __REGION_LEN(DT_DRV_INST(i)),                \
+	[i].region_max = __REGION_MAX(DT_DRV_INST(i)),
+
+
+struct aggregator_region {
+	uint32_t start;		/* Index of the first sample in the ring. */
+	uint16_t sample_cnt;	/* Number of samples in the region. */
+	bool released;		/* Region status. */
 };
 
 struct aggregator {
 	const char *sensor_descr;		/* sensor_description of the sensor. */
-	struct aggregator_buffer *agg_buffers;	/* Buffers. */
-	struct aggregator_buffer *active_buf;	/* Active buffer to which data will be placed. */
+	struct sensor_value *samples;		/* Ring of samples. */
+	int64_t *timestamps;			/* Reception time of each sample in ticks, or NULL. */
+	struct aggregator_region *regions;	/* Regions passed to consumers, oldest first. */
 	enum sensor_state sensor_state;		/* Sensors state. */
 	const uint8_t values_in_sample;		/* Number of sensor values in a sample. */
-	const uint8_t buf_count;		/* Number of buffers. */
-	const uint8_t buf_len;			/* Size of buffor data in bytes. */
+	const uint32_t ring_len;		/* Number of samples in the ring. */
+	const uint16_t region_len;		/* Number of samples in a full region. */
+	const uint16_t region_max;		/* Number of region descriptors. */
+	uint16_t region_first;			/* Oldest region in use. */
+	uint16_t region_cnt;			/* Number of regions in use. */
+	uint16_t active_cnt;			/* Number of samples not passed to consumers yet. */
+	uint32_t head;				/* Index at which the next sample is placed. */
+	uint32_t used;				/* Number of samples in use. */
+	bool overflow;				/* Samples are being dropped. */
+	atomic_t sample_cnt;			/* Statistics. */
+	atomic_t drop_cnt;
+	atomic_t max_used;
 };
 
 
@@ -86,16 +132,6 @@ static struct aggregator aggregators[] = {
 };
 
 
-static struct aggregator_buffer *get_free_buffer(struct aggregator *agg)
-{
-	for (size_t i = 0; i < agg->buf_count; i++) {
-		if (!agg->agg_buffers[i].busy) {
-			return &agg->agg_buffers[i];
-		}
-	}
-	return NULL;
-}
-
 static struct aggregator *get_aggregator(const char *sensor_descr)
 {
 	for (size_t i = 0; i < ARRAY_SIZE(aggregators); i++) {
@@ -106,27 +142,90 @@ static struct aggregator *get_aggregator(const char *sensor_descr)
 	return NULL;
 }
 
-static void release_buffer(struct aggregator *agg, struct aggregator_buffer *ab)
+static struct aggregator_region *get_region(struct aggregator *agg, size_t n)
 {
-	__ASSERT_NO_MSG(ab);
+	return &agg->regions[(agg->region_first + n) % agg->region_max];
+}
 
-	ab->sample_cnt = 0;
-	ab->busy = false;
-	if (agg->active_buf == NULL) {
-		agg->active_buf = ab;
-	}
+/* The active samples must be sent before the next sample is placed, either because they fill
+ * a region or because they reach the end of the ring, where a region cannot continue.
+ */
+static bool active_region_full(const struct aggregator *agg)
+{
+	return (agg->active_cnt == agg->region_len) ||
+	       ((agg->active_cnt > 0) && (agg->head == 0));
 }
 
-static void send_buffer(struct aggregator *agg, struct aggregator_buffer *ab)
+static int send_region(struct aggregator *agg)
 {
-	ab->busy = true;
+	struct aggregator_region *region;
+
+	if (agg->region_cnt == agg->region_max) {
+		return -ENOMEM;
+	}
+
+	region = get_region(agg, agg->region_cnt);
+	region->start = (agg->head + agg->ring_len - agg->active_cnt) % agg->ring_len;
+	region->sample_cnt = agg->active_cnt;
+	region->released = false;
+	agg->region_cnt++;
+	agg->active_cnt = 0;
+
 	struct sensor_data_aggregator_event *event = new_sensor_data_aggregator_event();
+
 	event->values_in_sample = agg->values_in_sample;
-	event->samples = ab->samples;
-	event->sample_cnt = ab->sample_cnt;
+	event->samples = &agg->samples[region->start * agg->values_in_sample];
+	event->timestamps = agg->timestamps ? &agg->timestamps[region->start] : NULL;
+	event->sample_cnt = region->sample_cnt;
 	event->sensor_state = agg->sensor_state;
 	event->sensor_descr = agg->sensor_descr;
 	APP_EVENT_SUBMIT(event);
+
+	return 0;
+}
+
+static void release_region(struct aggregator *agg, const struct sensor_value *samples)
+{
+	size_t i;
+
+	/* Regions are usually released in order, so the search ends at the first one. */
+	for (i = 0; i < agg->region_cnt; i++) {
+		struct aggregator_region *region = get_region(agg, i);
+
+		if (!region->released &&
+		    (&agg->samples[region->start * agg->values_in_sample] == samples)) {
+			region->released = true;
+			break;
+		}
+	}
+
+	if (i == agg->region_cnt) {
+		LOG_WRN("Released unknown buffer %p", (void *)samples);
+		return;
+	}
+
+	/* Samples can only be reused once all older regions are released too. */
+	while ((agg->region_cnt > 0) && get_region(agg, 0)->released) {
+		agg->used -= get_region(agg, 0)->sample_cnt;
+		agg->region_first = (agg->region_first + 1) % agg->region_max;
+		agg->region_cnt--;
+	}
+
+	if (active_region_full(agg)) {
+		(void)send_region(agg);
+	}
+}
+
+static int drop_sample(struct aggregator *agg)
+{
+	atomic_inc(&agg->drop_cnt);
+
+	if (!agg->overflow) {
+		LOG_WRN("Aggregator for %s is full, dropping samples", agg->sensor_descr);
+		agg->overflow = true;
+	}
+
+	return -ENOBUFS;
 }
 
 static int enqueue_sample(struct aggregator *agg, struct sensor_event *event)
@@ -136,30 +235,56 @@ static int enqueue_sample(struct aggregator *agg, struct sensor_event *event)
 	if ((event->dyndata.size) != chunk_bytes) {
 		return -EBADMSG;
 	}
-	if (!agg->active_buf) {
-		return -ENOMEM;
+
+	if (active_region_full(agg) && send_region(agg)) {
+		return drop_sample(agg);
+	}
+
+	if (agg->used == agg->ring_len) {
+		return drop_sample(agg);
+	}
+
+	memcpy(&agg->samples[agg->head * agg->values_in_sample], event->dyndata.data,
+	       chunk_bytes);
+	if (agg->timestamps) {
+		agg->timestamps[agg->head] = k_uptime_ticks();
 	}
 
-	struct aggregator_buffer *ab = agg->active_buf;
-	size_t pos_values = ab->sample_cnt * agg->values_in_sample;
-	size_t avail_bytes = agg->buf_len - pos_values * sizeof(struct sensor_value);
+	agg->head = (agg->head + 1) % agg->ring_len;
+	agg->active_cnt++;
+	agg->used++;
+	agg->overflow = false;
 
-	if (avail_bytes < chunk_bytes) {
-		__ASSERT_NO_MSG(false);
-		return -ENOMEM;
+	atomic_inc(&agg->sample_cnt);
+	if (agg->used > atomic_get(&agg->max_used)) {
+		atomic_set(&agg->max_used, agg->used);
 	}
-	memcpy(&ab->samples[pos_values], (uint8_t *)event->dyndata.data, chunk_bytes);
-	ab->sample_cnt++;
-	avail_bytes -= chunk_bytes;
 
-	if (avail_bytes < chunk_bytes) {
-		send_buffer(agg, ab);
-		agg->active_buf = get_free_buffer(agg);
+	if (active_region_full(agg)) {
+		/* If no region is free, this is attempted again later. */
+		(void)send_region(agg);
 	}
 
 	return 0;
 }
 
+int sensor_data_aggregator_stats_get(const char *sensor_descr,
+				     struct sensor_data_aggregator_stats *stats)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(aggregators); i++) {
+		struct aggregator *agg = &aggregators[i];
+
+		if (!strcmp(sensor_descr, agg->sensor_descr)) {
+			stats->sample_cnt = atomic_get(&agg->sample_cnt);
+			stats->drop_cnt = atomic_get(&agg->drop_cnt);
+			stats->max_used = atomic_get(&agg->max_used);
+			return 0;
+		}
+	}
+
+	return -ENOENT;
+}
+
 static bool event_handler(const struct app_event_header *aeh)
 {
 	if (is_sensor_event(aeh)) {
@@ -169,7 +294,8 @@ static bool event_handler(const struct app_event_header *aeh)
 		if (agg) {
 			int err = enqueue_sample(agg, event);
 
-			if (err) {
+			/* Dropped samples are counted and reported once per overflow. */
+			if (err && (err != -ENOBUFS)) {
 				LOG_ERR("Error code: %d", err);
 			}
 		} else {
@@ -186,12 +312,7 @@ static bool event_handler(const struct app_event_header *aeh)
 
 		__ASSERT_NO_MSG(agg);
 
-		for (size_t i = 0; i < agg->buf_count; i++) {
-			if (agg->agg_buffers[i].samples == event->samples) {
-				release_buffer(agg, &agg->agg_buffers[i]);
-				break;
-			}
-		}
+		release_region(agg, event->samples);
 
 		return false;
 	}
@@ -201,11 +322,10 @@ static bool event_handler(const struct app_event_header *aeh)
 		struct aggregator *agg = get_aggregator(event->descr);
 
 		if (agg) {
-			struct aggregator_buffer *ab = agg->active_buf;
-
 			agg->sensor_state = event->state;
-			send_buffer(agg, ab);
-			agg->active_buf = get_free_buffer(agg);
+			if (send_region(agg)) {
+				LOG_ERR("No free region to report sensor state");
+			}
 		}
 
 		return false;
@@ -5,6 +5,7 @@
  */
 
 #include <dfu/dfu_multi_image.h>
+#include <zephyr/kernel.h>
 #include <zephyr/sys/byteorder.h>
 #include <zephyr/sys/util.h>
 #include <zephyr/logging/log.h>
@@ -78,6 +79,35 @@ struct dfu_multi_image_ctx {
 
 static struct dfu_multi_image_ctx ctx;
 
+#ifdef CONFIG_DFU_MULTI_IMAGE_PIPELINE
+
+#define PIPELINE_BUF_COUNT 2
+
+/* Package data waiting to be written by the pipeline thread. */
+struct pipeline_item {
+	size_t offset;
+	size_t size;
+	uint8_t buf_no;
+};
+
+static struct {
+	uint8_t bufs[PIPELINE_BUF_COUNT][CONFIG_DFU_MULTI_IMAGE_PIPELINE_BUF_SIZE];
+	/* Buffer being filled by dfu_multi_image_write(), if its size is not 0. */
+	struct pipeline_item fill;
+	/* Package offset following the last buffered data. */
+	size_t next_offset;
+	/* First error of the pipeline thread. */
+	int err;
+} pipeline;
+
+K_MSGQ_DEFINE(pipeline_msgq, sizeof(struct pipeline_item), PIPELINE_BUF_COUNT, 4);
+K_SEM_DEFINE(pipeline_free_sem, PIPELINE_BUF_COUNT, PIPELINE_BUF_COUNT);
+
+static int pipeline_flush(void);
+static void pipeline_reset(void);
+
+#endif /* CONFIG_DFU_MULTI_IMAGE_PIPELINE */
+
 static int parse_fixed_header(void)
 {
 	ctx.cur_item_size += sys_get_le16(ctx.buffer);
@@ -457,6 +487,10 @@ int dfu_multi_image_init(uint8_t *buffer, size_t buffer_size)
 		return -EINVAL;
 	}
 
+#ifdef CONFIG_DFU_MULTI_IMAGE_PIPELINE
+	pipeline_reset();
+#endif
+
 	memset(&ctx, 0, sizeof(ctx));
 	ctx.buffer = buffer;
 	ctx.buffer_size = buffer_size;
@@ -476,22 +510,11 @@ int dfu_multi_image_register_writer(const struct dfu_image_writer *writer)
 	return 0;
 }
 
-int dfu_multi_image_write(size_t offset, const uint8_t *chunk, size_t chunk_size)
+static int write_chunk(size_t offset, const uint8_t *chunk, size_t chunk_size)
 {
 	int result;
 	size_t chunk_offset = 0;
 
-#ifdef CONFIG_DFU_MULTI_IMAGE_SAVE_PROGRESS
-	if (!ctx.saved_progress_loaded) {
-		/* Load saved progress from settings if available */
-		int err = load_saved_progress();
-
-		if (err) {
-			return err;
-		}
-	}
-#endif /* CONFIG_DFU_MULTI_IMAGE_SAVE_PROGRESS */
-
 	if (offset > ctx.cur_offset) {
 		/* Unexpected data gap */
 		return -ESPIPE;
@@ -518,6 +541,160 @@ int dfu_multi_image_write(size_t offset, const uint8_t *chunk, size_t chunk_size
 	return 0;
 }
 
+#ifdef CONFIG_DFU_MULTI_IMAGE_PIPELINE
+
+static void pipeline_thread_fn(void *p1, void *p2, void *p3)
+{
+	struct pipeline_item item;
+	int err;
+
+	ARG_UNUSED(p1);
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	while (true) {
+		k_msgq_get(&pipeline_msgq, &item, K_FOREVER);
+
+		/* Once an image write fails, the rest of the package is dropped. */
+		if (pipeline.err == 0) {
+			err = write_chunk(item.offset, pipeline.bufs[item.buf_no], item.size);
+			if (err) {
+				LOG_ERR("Failed to write package at offset %zu (err %d)",
+					item.offset, err);
+				pipeline.err = err;
+			}
+		}
+
+		k_sem_give(&pipeline_free_sem);
+	}
+}
+
+K_THREAD_DEFINE(dfu_multi_image_pipeline, CONFIG_DFU_MULTI_IMAGE_PIPELINE_STACK_SIZE,
+		pipeline_thread_fn, NULL, NULL, NULL,
+		CONFIG_DFU_MULTI_IMAGE_PIPELINE_THREAD_PRIORITY, 0, 0);
+
+/* Pass the buffer being filled to the pipeline thread. */
+static void pipeline_submit(void)
+{
+	if (pipeline.fill.size == 0) {
+		return;
+	}
+
+	k_msgq_put(&pipeline_msgq, &pipeline.fill, K_FOREVER);
+
+	pipeline.fill.buf_no = (pipeline.fill.buf_no + 1) % PIPELINE_BUF_COUNT;
+	pipeline.fill.size = 0;
+}
+
+/* Wait until all the buffered package data is written, and return the first error. */
+static int pipeline_flush(void)
+{
+	pipeline_submit();
+
+	for (size_t i = 0; i < PIPELINE_BUF_COUNT; i++) {
+		k_sem_take(&pipeline_free_sem, K_FOREVER);
+	}
+	for (size_t i = 0; i < PIPELINE_BUF_COUNT; i++) {
+		k_sem_give(&pipeline_free_sem);
+	}
+
+	return pipeline.err;
+}
+
+/* Drop the buffered package data that has not been written yet. */
+static void pipeline_reset(void)
+{
+	pipeline.err = -ECANCELED;
+	(void)pipeline_flush();
+
+	pipeline.fill.size = 0;
+	pipeline.err = 0;
+}
+
+/* Return the package offset that follows the data received so far. */
+static size_t pipeline_next_offset(void)
+{
+	/* Once all buffers are written, the parser offset also skips images without writer. */
+	if (pipeline.fill.size == 0 &&
+	    k_sem_count_get(&pipeline_free_sem) == PIPELINE_BUF_COUNT) {
+		return ctx.cur_offset;
+	}
+
+	return pipeline.next_offset;
+}
+
+static int pipeline_write(size_t offset, const uint8_t *chunk, size_t chunk_size)
+{
+	size_t next_offset;
+	size_t size;
+
+	if (pipeline.err) {
+		return pipeline.err;
+	}
+
+	next_offset = pipeline_next_offset();
+
+	if (offset > next_offset) {
+		/* Unexpected data gap, the chunk can be written again from the expected offset. */
+		return -ESPIPE;
+	}
+
+	/* Skip the data that is already buffered or written, so that the buffers are contiguous. */
+	size = MIN(next_offset - offset, chunk_size);
+	offset += size;
+	chunk += size;
+	chunk_size -= size;
+
+	while (chunk_size > 0) {
+		if (pipeline.err) {
+			return pipeline.err;
+		}
+
+		if (pipeline.fill.size == 0) {
+			/* Wait for the pipeline thread to release the next buffer. */
+			k_sem_take(&pipeline_free_sem, K_FOREVER);
+			pipeline.fill.offset = offset;
+		}
+
+		size = MIN(chunk_size, sizeof(pipeline.bufs[0]) - pipeline.fill.size);
+		memcpy(pipeline.bufs[pipeline.fill.buf_no] + pipeline.fill.size, chunk, size);
+		pipeline.fill.size += size;
+		pipeline.next_offset = offset + size;
+
+		if (pipeline.fill.size == sizeof(pipeline.bufs[0])) {
+			pipeline_submit();
+		}
+
+		offset += size;
+		chunk += size;
+		chunk_size -= size;
+	}
+
+	return 0;
+}
+
+#endif /* CONFIG_DFU_MULTI_IMAGE_PIPELINE */
+
+int dfu_multi_image_write(size_t offset, const uint8_t *chunk, size_t chunk_size)
+{
+#ifdef CONFIG_DFU_MULTI_IMAGE_SAVE_PROGRESS
+	if (!ctx.saved_progress_loaded) {
+		/* Load saved progress from settings if available */
+		int err = load_saved_progress();
+
+		if (err) {
+			return err;
+		}
+	}
+#endif /* CONFIG_DFU_MULTI_IMAGE_SAVE_PROGRESS */
+
+#ifdef CONFIG_DFU_MULTI_IMAGE_PIPELINE
+	return pipeline_write(offset, chunk, chunk_size);
+#else
+	return write_chunk(offset, chunk, chunk_size);
+#endif
+}
+
 size_t dfu_multi_image_offset(void)
 {
 #ifdef CONFIG_DFU_MULTI_IMAGE_SAVE_PROGRESS
@@ -531,6 +708,10 @@ size_t dfu_multi_image_offset(void)
 	}
 #endif /* CONFIG_DFU_MULTI_IMAGE_SAVE_PROGRESS */
 
+#ifdef CONFIG_DFU_MULTI_IMAGE_PIPELINE
+	(void)pipeline_flush();
+#endif
+
 	return ctx.cur_offset;
 }
 
@@ -547,6 +728,15 @@ int dfu_multi_image_done(bool success)
 	}
 #endif /* CONFIG_DFU_MULTI_IMAGE_SAVE_PROGRESS */
 
+#ifdef CONFIG_DFU_MULTI_IMAGE_PIPELINE
+	int pipeline_err = pipeline_flush();
+
+	if (pipeline_err) {
+		/* Do not confirm an image that failed to be written */
+		success = false;
+	}
+#endif
+
 	const struct dfu_image_writer *writer = current_image_writer();
 	int err = 0;
 
@@ -561,6 +751,12 @@ int dfu_multi_image_done(bool success)
 	}
 #endif /* CONFIG_DFU_MULTI_IMAGE_SAVE_PROGRESS */
 
+#ifdef CONFIG_DFU_MULTI_IMAGE_PIPELINE
+	if (pipeline_err) {
+		return pipeline_err;
+	}
+#endif
+
 	/* On success, verify that all images have been fully written */
 	if (!err && success && ctx.cur_image_no != ctx.header.image_count) {
 		return -ESPIPE;
@@ -572,7 +768,13 @@ int dfu_multi_image_done(bool success)
 int dfu_multi_image_reset(void)
 {
 	int err = 0;
-	const struct dfu_image_writer *writer = current_image_writer();
+	const struct dfu_image_writer *writer;
+
+#ifdef CONFIG_DFU_MULTI_IMAGE_PIPELINE
+	pipeline_reset();
+#endif
+
+	writer = current_image_writer();
 
 #ifdef CONFIG_DFU_MULTI_IMAGE_SAVE_PROGRESS
 	settings_subsys_init();
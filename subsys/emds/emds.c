@@ -85,6 +85,28 @@ static struct emds_snapshot_candidate allocated_snapshot;
 static sys_slist_t emds_dynamic_entries;
 static struct emds_partition partition[PARTITIONS_NUM_MAX];
 static emds_store_cb_t app_store_cb;
+static size_t store_written;
+
+#if defined(CONFIG_EMDS_INCREMENTAL)
+#define TRACKED_ENTRIES CONFIG_EMDS_INCREMENTAL_ENTRIES_MAX
+
+/* Checksums of the entries as they are in the loaded snapshots. Entries are
+ * numbered in the order they are stored: static entries first, then dynamic
+ * entries. Entries beyond the tracked number are stored in every snapshot.
+ */
+static uint32_t entry_crc[TRACKED_ENTRIES];
+/* Entries found in the loaded snapshots */
+static ATOMIC_DEFINE(entry_loaded, TRACKED_ENTRIES);
+/* Entries with a valid checksum, that is, entries loaded with their current size */
+static ATOMIC_DEFINE(entry_persisted, TRACKED_ENTRIES);
+static ATOMIC_DEFINE(entry_dirty, TRACKED_ENTRIES);
+/* The snapshots have been loaded into the entries, so they can be the base of
+ * an incremental snapshot.
+ */
+static bool snapshot_loaded;
+/* The allocated snapshot only holds the changed entries */
+static bool store_delta;
+#endif
 
 static void emds_print_init_info(void)
 {
@@ -246,38 +268,149 @@ int emds_store_time_get(uint32_t *store_time)
 	*store_time = words * CONFIG_EMDS_FLASH_TIME_WRITE_ONE_WORD_US;
 	*store_time += chunk_handling * CONFIG_EMDS_CHUNK_PREPARATION_TIME_US;
 
+	if (IS_ENABLED(CONFIG_EMDS_INCREMENTAL)) {
+		/* In the worst case, all entries have changed after they have been checked. */
+		*store_time += chunk_handling * CONFIG_EMDS_CHUNK_PREPARATION_TIME_US;
+	}
+
+	return 0;
+}
+
+int emds_store_written_get(size_t *written)
+{
+	if (emds_state == EMDS_STATE_NOT_INITIALIZED) {
+		return -ECANCELED;
+	}
+
+	*written = store_written;
+
 	return 0;
 }
 
-static uint8_t *emds_entry_memory_get(struct emds_data_entry *entry)
+static struct emds_entry *emds_entry_find(uint16_t id, int *idx)
 {
+	*idx = 0;
+
 	STRUCT_SECTION_FOREACH(emds_entry, ch) {
-		if (ch->id == entry->id) {
-			entry->length = MIN(ch->len, entry->length);
-			return ch->data;
+		if (ch->id == id) {
+			return ch;
 		}
+
+		(*idx)++;
 	}
 
 	struct emds_dynamic_entry *ch;
 
 	SYS_SLIST_FOR_EACH_CONTAINER(&emds_dynamic_entries, ch, node) {
-		if (ch->entry.id == entry->id) {
-			entry->length = MIN(ch->entry.len, entry->length);
-			return ch->entry.data;
+		if (ch->entry.id == id) {
+			return &ch->entry;
 		}
+
+		(*idx)++;
 	}
 
-	LOG_WRN("Entry with ID %u not found", entry->id);
 	return NULL;
 }
 
-static int emds_read_data(const struct flash_area *fa, struct emds_snapshot_metadata *metadata)
+#if defined(CONFIG_EMDS_INCREMENTAL)
+static bool emds_entry_is_tracked(int idx)
+{
+	return idx < TRACKED_ENTRIES;
+}
+
+static uint32_t emds_entry_crc(const struct emds_entry *entry)
+{
+	return crc32_k_4_2_update(0, entry->data, entry->len);
+}
+
+/* Only the freshest copy of an entry is loaded. As the snapshots are read from
+ * the freshest to the oldest one, this is the first copy that is found. The
+ * untracked entries are always in the freshest snapshot.
+ */
+static bool emds_entry_load_skip(int idx, bool freshest)
+{
+	if (!emds_entry_is_tracked(idx)) {
+		return !freshest;
+	}
+
+	return atomic_test_bit(entry_loaded, idx);
+}
+
+static void emds_entry_loaded(const struct emds_entry *entry, int idx, uint16_t length)
+{
+	if (!emds_entry_is_tracked(idx)) {
+		return;
+	}
+
+	atomic_set_bit(entry_loaded, idx);
+
+	/* An entry that has changed size since it was stored is always stored again. */
+	if (length == entry->len) {
+		entry_crc[idx] = emds_entry_crc(entry);
+		atomic_set_bit(entry_persisted, idx);
+	}
+}
+
+/* Mark the entries that have changed since they were loaded, and return the number of them.
+ * All entries are tracked when this is called.
+ */
+static int emds_entries_dirty_mark(void)
+{
+	int dirty = 0;
+	int idx = 0;
+
+	STRUCT_SECTION_FOREACH(emds_entry, ch) {
+		if (!atomic_test_bit(entry_persisted, idx) || entry_crc[idx] != emds_entry_crc(ch)) {
+			atomic_set_bit(entry_dirty, idx);
+			dirty++;
+		}
+
+		idx++;
+	}
+
+	struct emds_dynamic_entry *ch;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&emds_dynamic_entries, ch, node) {
+		if (!atomic_test_bit(entry_persisted, idx) ||
+		    entry_crc[idx] != emds_entry_crc(&ch->entry)) {
+			atomic_set_bit(entry_dirty, idx);
+			dirty++;
+		}
+
+		idx++;
+	}
+
+	return dirty;
+}
+
+static bool emds_entry_store_skip(int idx)
+{
+	return store_delta && emds_entry_is_tracked(idx) && !atomic_test_bit(entry_dirty, idx);
+}
+#else
+static bool emds_entry_load_skip(int idx, bool freshest)
+{
+	return false;
+}
+
+static void emds_entry_loaded(const struct emds_entry *entry, int idx, uint16_t length)
+{
+}
+
+static bool emds_entry_store_skip(int idx)
+{
+	return false;
+}
+#endif /* CONFIG_EMDS_INCREMENTAL */
+
+static int emds_read_data(const struct flash_area *fa, struct emds_snapshot_metadata *metadata,
+			  bool freshest)
 {
 	struct emds_data_entry entry;
 	off_t data_off = metadata->data_instance_off;
 	int32_t data_len = metadata->data_instance_len;
-	int32_t flash_entry_data_len;
-	uint8_t *data_buf;
+	struct emds_entry *ch;
+	int idx;
 	int rc;
 
 	while (data_len > 0) {
@@ -289,25 +422,105 @@ static int emds_read_data(const struct flash_area *fa, struct emds_snapshot_meta
 
 		data_off += sizeof(entry);
 		data_len -= sizeof(entry);
-		flash_entry_data_len = entry.length;
-
-		data_buf = emds_entry_memory_get(&entry);
 
-		if (data_buf) {
-			rc = flash_area_read(fa, data_off, data_buf, entry.length);
+		ch = emds_entry_find(entry.id, &idx);
+		if (!ch) {
+			LOG_WRN("Entry with ID %u not found", entry.id);
+		} else if (!emds_entry_load_skip(idx, freshest)) {
+			rc = flash_area_read(fa, data_off, ch->data, MIN(ch->len, entry.length));
 			if (rc) {
 				LOG_ERR("Failed to read data for entry ID %u: %d", entry.id, rc);
 				return -EIO;
 			}
+
+			emds_entry_loaded(ch, idx, entry.length);
 		}
 
-		data_off += flash_entry_data_len;
-		data_len -= flash_entry_data_len;
+		data_off += entry.length;
+		data_len -= entry.length;
 	}
 
 	return 0;
 }
 
+#if defined(CONFIG_EMDS_INCREMENTAL)
+static void emds_entries_load_reset(void)
+{
+	(void)memset(entry_loaded, 0, sizeof(entry_loaded));
+	(void)memset(entry_persisted, 0, sizeof(entry_persisted));
+}
+
+/* Read the last snapshot that holds all entries and is older than the snapshot with the given
+ * metadata offset. Older snapshots are stored at higher metadata offsets in the partition.
+ */
+static int emds_read_complete_snapshot(const struct emds_partition *partition,
+				       off_t metadata_off)
+{
+	struct emds_snapshot_metadata metadata;
+
+	for (metadata_off += sizeof(metadata);
+	     metadata_off + sizeof(metadata) <= partition->fa->fa_size;
+	     metadata_off += sizeof(metadata)) {
+		if (emds_flash_snapshot_read(partition, metadata_off, &metadata) ||
+		    emds_flash_snapshot_is_delta(&metadata)) {
+			continue;
+		}
+
+		LOG_WRN("Falling back to snapshot with fresh_cnt %u", metadata.fresh_cnt);
+		emds_entries_load_reset();
+
+		return emds_read_data(partition->fa, &metadata, true);
+	}
+
+	return -ENOENT;
+}
+
+/* Read the freshest snapshot, and the snapshots it is based on. Every incremental snapshot is
+ * based on the snapshot stored just before it in the same partition, down to the last snapshot
+ * that holds all entries. If a base snapshot is missing, only the last snapshot that holds all
+ * entries is loaded.
+ */
+static int emds_read_snapshots(const struct emds_partition *partition,
+			       const struct emds_snapshot_candidate *freshest)
+{
+	struct emds_snapshot_metadata metadata = freshest->metadata;
+	off_t metadata_off = freshest->metadata_off;
+	int rc;
+
+	emds_entries_load_reset();
+	snapshot_loaded = false;
+
+	rc = emds_read_data(partition->fa, &metadata, true);
+
+	while (!rc && emds_flash_snapshot_is_delta(&metadata)) {
+		uint32_t fresh_cnt = metadata.fresh_cnt;
+
+		metadata_off += sizeof(struct emds_snapshot_metadata);
+		rc = emds_flash_snapshot_read(partition, metadata_off, &metadata);
+		if (!rc && metadata.fresh_cnt != fresh_cnt - 1) {
+			rc = -ENOENT;
+		}
+
+		if (rc) {
+			LOG_ERR("Base of snapshot with fresh_cnt %u not found: %d", fresh_cnt, rc);
+
+			/* The loaded entries are not the base of the next snapshot, so it
+			 * holds all entries.
+			 */
+			rc = emds_read_complete_snapshot(partition, metadata_off);
+			return rc ? -EIO : 0;
+		}
+
+		LOG_DBG("Loading base snapshot with fresh_cnt %u", metadata.fresh_cnt);
+		rc = emds_read_data(partition->fa, &metadata, false);
+	}
+
+	snapshot_loaded = (rc == 0);
+
+	return rc;
+}
+#endif /* CONFIG_EMDS_INCREMENTAL */
+
 int emds_load(void)
 {
 	struct emds_snapshot_candidate candidate = {0};
@@ -338,8 +551,13 @@ int emds_load(void)
 	LOG_DBG("Found freshest snapshot in partition %d with fresh_cnt %u",
 		freshest_snapshot.partition_index, freshest_snapshot.metadata.fresh_cnt);
 
+#if defined(CONFIG_EMDS_INCREMENTAL)
+	return emds_read_snapshots(&partition[freshest_snapshot.partition_index],
+				   &freshest_snapshot);
+#else
 	return emds_read_data(partition[freshest_snapshot.partition_index].fa,
-			      &freshest_snapshot.metadata);
+			      &freshest_snapshot.metadata, true);
+#endif
 }
 
 int emds_prepare(void)
@@ -367,12 +585,23 @@ int emds_prepare(void)
 						  data_size);
 		if (rc == 0) {
 			allocated_snapshot.partition_index = freshest_partition_idx;
+#if defined(CONFIG_EMDS_INCREMENTAL)
+			/* The loaded snapshots are the base of the next one, as long as
+			 * all entries can be tracked.
+			 */
+			store_delta = snapshot_loaded &&
+				      (emds_entries_size(&data_size) <= TRACKED_ENTRIES);
+#endif
 			emds_state = EMDS_STATE_READY;
 			return 0;
 		}
 		rc = 0;
 	}
 
+#if defined(CONFIG_EMDS_INCREMENTAL)
+	store_delta = false;
+#endif
+
 	do {
 		if (idx != freshest_partition_idx) {
 			if (erase_enabled) {
@@ -431,13 +660,17 @@ static void data_to_stream(const struct emds_partition *partition, off_t *data_o
 }
 
 static void entry_to_stream(const struct emds_partition *partition, off_t *data_off, uint8_t *out,
-			    size_t *wp, struct emds_entry *entry)
+			    size_t *wp, struct emds_entry *entry, int idx)
 {
 	struct emds_data_entry data_entry = {
 		.id = entry->id,
 		.length = entry->len,
 	};
 
+	if (emds_entry_store_skip(idx)) {
+		return;
+	}
+
 	LOG_DBG("Storing entry ID %u, length %u", entry->id, entry->len);
 	data_to_stream(partition, data_off, (uint8_t *)&data_entry, out, wp, sizeof(data_entry));
 	data_to_stream(partition, data_off, entry->data, out, wp, entry->len);
@@ -462,6 +695,8 @@ int emds_store(void)
 	size_t wp = 0;
 	off_t data_off = allocated_snapshot.metadata.data_instance_off;
 	int idx = allocated_snapshot.partition_index;
+	int entry_idx = 0;
+	bool delta = false;
 	int rc = 0;
 
 	if (emds_state != EMDS_STATE_READY) {
@@ -471,12 +706,31 @@ int emds_store(void)
 	/* Lock all interrupts */
 	store_key = irq_lock();
 
+	store_written = 0;
+
+#if defined(CONFIG_EMDS_INCREMENTAL)
+	if (store_delta) {
+		(void)memset(entry_dirty, 0, sizeof(entry_dirty));
+
+		if (emds_entries_dirty_mark() == 0) {
+			/* The freshest snapshot is still up to date. */
+			LOG_DBG("No entries changed");
+			goto unlock_and_exit;
+		}
+
+		delta = true;
+	}
+#endif
+
 	if (SUSPEND_POFWARN()) {
 		rc = -ECANCELED;
 		goto unlock_and_exit;
 	}
 
-	if (flash_params_get_erase_cap(partition[idx].fp) & FLASH_ERASE_C_EXPLICIT) {
+	/* The size of an incremental snapshot is only known once it is written, so its
+	 * metadata is always written last.
+	 */
+	if (!delta && (flash_params_get_erase_cap(partition[idx].fp) & FLASH_ERASE_C_EXPLICIT)) {
 		LOG_DBG("Writing metadata on offset: 0x%4lx, address : 0x%4lx",
 			 allocated_snapshot.metadata_off,
 			 allocated_snapshot.metadata_off + partition[idx].fa->fa_off);
@@ -486,18 +740,27 @@ int emds_store(void)
 	}
 
 	STRUCT_SECTION_FOREACH(emds_entry, ch) {
-		entry_to_stream(&partition[idx], &data_off, data_chunk, &wp, ch);
+		entry_to_stream(&partition[idx], &data_off, data_chunk, &wp, ch, entry_idx++);
 	}
 
 	struct emds_dynamic_entry *ch;
 
 	SYS_SLIST_FOR_EACH_CONTAINER(&emds_dynamic_entries, ch, node) {
-		entry_to_stream(&partition[idx], &data_off, data_chunk, &wp, &ch->entry);
+		entry_to_stream(&partition[idx], &data_off, data_chunk, &wp, &ch->entry,
+				entry_idx++);
 	}
 
 	stream_fflush(&partition[idx], &data_off, data_chunk, &wp);
 
-	if (flash_params_get_erase_cap(partition[idx].fp) & FLASH_ERASE_C_EXPLICIT) {
+	store_written = data_off - allocated_snapshot.metadata.data_instance_off;
+
+#if defined(CONFIG_EMDS_INCREMENTAL)
+	if (delta) {
+		emds_flash_snapshot_delta_set(&allocated_snapshot, store_written);
+	}
+#endif
+
+	if (!delta && (flash_params_get_erase_cap(partition[idx].fp) & FLASH_ERASE_C_EXPLICIT)) {
 		LOG_DBG("Writing snapshot crc on offset: 0x%4lx, crc : 0x%4x",
 			 allocated_snapshot.metadata_off +
 					      offsetof(struct emds_snapshot_metadata, snapshot_crc),
@@ -516,6 +779,8 @@ int emds_store(void)
 				      offsetof(struct emds_snapshot_metadata, reserved));
 	}
 
+	store_written += sizeof(struct emds_snapshot_metadata);
+
 unlock_and_exit:
 	emds_state = EMDS_STATE_INITIALIZED;
 	RESUME_POFWARN();
@@ -541,6 +806,11 @@ int emds_clear(void)
 	emds_state = EMDS_STATE_INITIALIZED;
 	memset(&freshest_snapshot, 0, sizeof(freshest_snapshot));
 	memset(&allocated_snapshot, 0, sizeof(allocated_snapshot));
+#if defined(CONFIG_EMDS_INCREMENTAL)
+	emds_entries_load_reset();
+	snapshot_loaded = false;
+	store_delta = false;
+#endif
 	for (int i = 0; i < PARTITIONS_NUM_MAX; i++) {
 		rc = emds_flash_erase_partition(&partition[i]);
 		if (rc) {
@@ -22,6 +22,8 @@ LOG_MODULE_REGISTER(emds_flash, CONFIG_EMDS_LOG_LEVEL);
 #define SOC_NV_FLASH_NODE             DT_INST(0, soc_nv_flash)
 /* "EMDS" in ASCII */
 #define EMDS_SNAPSHOT_METADATA_MARKER 0x4D444553
+/* "EMDI" in ASCII, marks a snapshot that only holds the changed entries */
+#define EMDS_SNAPSHOT_DELTA_MARKER    0x4D444549
 
 static void cand_list_init(sys_slist_t *cand_list, struct emds_snapshot_candidate *cand_buf)
 {
@@ -95,6 +97,27 @@ static bool cand_snapshot_crc_check(const struct emds_partition *partition,
 	return crc == metadata->snapshot_crc;
 }
 
+static bool metadata_check(const struct emds_snapshot_metadata *metadata)
+{
+	uint32_t crc;
+
+	if (metadata->marker != EMDS_SNAPSHOT_METADATA_MARKER &&
+	    !(IS_ENABLED(CONFIG_EMDS_INCREMENTAL) &&
+	      metadata->marker == EMDS_SNAPSHOT_DELTA_MARKER)) {
+		LOG_DBG("Snapshot metadata marker mismatch");
+		return false;
+	}
+
+	crc = crc32_k_4_2_update(0, (const unsigned char *)metadata,
+				 offsetof(struct emds_snapshot_metadata, metadata_crc));
+	if (crc != metadata->metadata_crc) {
+		LOG_DBG("Snapshot metadata CRC mismatch");
+		return false;
+	}
+
+	return true;
+}
+
 static bool metadata_iterator(off_t *read_off, int cur_failures)
 {
 	*read_off -= sizeof(struct emds_snapshot_metadata);
@@ -155,7 +178,6 @@ int emds_flash_scan_partition(const struct emds_partition *partition,
 	const struct flash_area *fa = partition->fa;
 	off_t read_off = fa->fa_size - sizeof(cache);
 	int failures = 0;
-	uint32_t crc;
 	int rc;
 
 	cand_list_init(&cand_list, cand_buf);
@@ -167,18 +189,9 @@ int emds_flash_scan_partition(const struct emds_partition *partition,
 			return rc;
 		}
 
-		if (cache.marker != EMDS_SNAPSHOT_METADATA_MARKER) {
+		if (!metadata_check(&cache)) {
 			failures++;
-			LOG_DBG("Snapshot metadata marker mismatch at address 0x%04lx",
-				fa->fa_off + read_off);
-			continue;
-		}
-
-		crc = crc32_k_4_2_update(0, (const unsigned char *)&cache,
-					 offsetof(struct emds_snapshot_metadata, metadata_crc));
-		if (crc != cache.metadata_crc) {
-			failures++;
-			LOG_DBG("Snapshot metadata CRC mismatch at address 0x%04lx",
+			LOG_DBG("Invalid snapshot metadata at address 0x%04lx",
 				fa->fa_off + read_off);
 			continue;
 		}
@@ -297,6 +310,45 @@ int emds_flash_allocate_snapshot(const struct emds_partition *partition,
 	return 0;
 }
 
+#if defined(CONFIG_EMDS_INCREMENTAL)
+int emds_flash_snapshot_read(const struct emds_partition *partition, off_t metadata_off,
+			     struct emds_snapshot_metadata *metadata)
+{
+	int rc;
+
+	if (metadata_off < 0 ||
+	    metadata_off + sizeof(struct emds_snapshot_metadata) > partition->fa->fa_size) {
+		return -ENOENT;
+	}
+
+	rc = flash_area_read(partition->fa, metadata_off, metadata, sizeof(*metadata));
+	if (rc) {
+		LOG_ERR("Failed to read snapshot metadata: %d", rc);
+		return -EIO;
+	}
+
+	if (!metadata_check(metadata) || !cand_snapshot_crc_check(partition, metadata)) {
+		return -ENOENT;
+	}
+
+	return 0;
+}
+
+bool emds_flash_snapshot_is_delta(const struct emds_snapshot_metadata *metadata)
+{
+	return metadata->marker == EMDS_SNAPSHOT_DELTA_MARKER;
+}
+
+void emds_flash_snapshot_delta_set(struct emds_snapshot_candidate *snapshot, size_t data_size)
+{
+	snapshot->metadata.marker = EMDS_SNAPSHOT_DELTA_MARKER;
+	snapshot->metadata.data_instance_len = data_size;
+	snapshot->metadata.metadata_crc =
+		crc32_k_4_2_update(0, (const unsigned char *)&snapshot->metadata,
+				   offsetof(struct emds_snapshot_metadata, metadata_crc));
+}
+#endif /* CONFIG_EMDS_INCREMENTAL */
+
 static void nvmc_wait_ready(void)
 {
 #if defined CONFIG_SOC_FLASH_NRF_RRAM
@@ -153,6 +153,42 @@ int emds_flash_allocate_snapshot(const struct emds_partition *partition,
 				 struct emds_snapshot_candidate *allocated_snapshot,
 				 size_t data_size);
 
+/**
+ * @brief Read and validate the snapshot metadata at the given offset.
+ *
+ * Both the metadata and the snapshot data integrity are checked.
+ *
+ * @param partition Pointer to the emergency data storage partition structure.
+ * @param metadata_off Offset of the metadata within the partition.
+ * @param metadata Pointer to the metadata structure to fill.
+ *
+ * @retval 0 on success.
+ * @retval -ENOENT if there is no valid snapshot at the given offset.
+ * @retval -EIO if an error occurs during reading.
+ */
+int emds_flash_snapshot_read(const struct emds_partition *partition, off_t metadata_off,
+			     struct emds_snapshot_metadata *metadata);
+
+/**
+ * @brief Check if the snapshot only holds the entries changed since the previous snapshot.
+ *
+ * @param metadata Pointer to the snapshot metadata.
+ *
+ * @return true if the snapshot is incremental, false if it holds all entries.
+ */
+bool emds_flash_snapshot_is_delta(const struct emds_snapshot_metadata *metadata);
+
+/**
+ * @brief Mark the allocated snapshot as incremental.
+ *
+ * Updates the marker, the data instance length and the metadata CRC of the allocated
+ * snapshot. The previous snapshot in the partition is the base of the incremental snapshot.
+ *
+ * @param snapshot Pointer to the allocated snapshot candidate structure.
+ * @param data_size The size of the data written to the snapshot.
+ */
+void emds_flash_snapshot_delta_set(struct emds_snapshot_candidate *snapshot, size_t data_size);
+
 /** * @brief Write data to the emergency data storage partition.
  *
  * @param partition Pointer to the emergency data storage partition structure.
@@ -0,0 +1,39 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef DL_CHECKPOINT_H
+#define DL_CHECKPOINT_H
+
+#include <net/downloader.h>
+
+#if defined(CONFIG_DOWNLOADER_CHECKPOINT)
+int dl_checkpoint_start(struct downloader *dl, const char *url, size_t from);
+void dl_checkpoint_validator_set(struct downloader *dl, const char *validator, size_t len,
+				 bool preferred);
+int dl_checkpoint_validate(struct downloader *dl);
+void dl_checkpoint_update(struct downloader *dl);
+void dl_checkpoint_save(struct downloader *dl);
+void dl_checkpoint_complete(struct downloader *dl);
+#else
+static inline int dl_checkpoint_start(struct downloader *dl, const char *url, size_t from)
+{
+	return 0;
+}
+
+static inline void dl_checkpoint_validator_set(struct downloader *dl, const char *validator,
+					       size_t len, bool preferred) {}
+
+static inline int dl_checkpoint_validate(struct downloader *dl)
+{
+	return 0;
+}
+
+static inline void dl_checkpoint_update(struct downloader *dl) {}
+static inline void dl_checkpoint_save(struct downloader *dl) {}
+static inline void dl_checkpoint_complete(struct downloader *dl) {}
+#endif /* CONFIG_DOWNLOADER_CHECKPOINT */
+
+#endif /* DL_CHECKPOINT_H */
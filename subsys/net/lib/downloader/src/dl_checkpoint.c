@@ -0,0 +1,292 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/settings/settings.h>
+#include <zephyr/sys/crc.h>
+#include <net/downloader.h>
+
+#include "dl_checkpoint.h"
+
+#include <zephyr/logging/log.h>
+LOG_MODULE_DECLARE(downloader, CONFIG_DOWNLOADER_LOG_LEVEL);
+
+#define CHECKPOINT_KEY_PREFIX "dl_ckpt/"
+#define CHECKPOINT_KEY_SIZE   (sizeof(CHECKPOINT_KEY_PREFIX) + DOWNLOADER_CHECKPOINT_NAME_MAX)
+
+/* Persisted checkpoint record */
+struct dl_checkpoint_record {
+	/** CRC32 of the URL of the download */
+	uint32_t url_crc;
+	/** Number of bytes delivered to the application */
+	uint32_t progress;
+	/** Size of the file, zero if unknown */
+	uint32_t file_size;
+	/** Entity tag or last modification date of the file, null-terminated */
+	char validator[CONFIG_DOWNLOADER_CHECKPOINT_VALIDATOR_SIZE];
+};
+
+struct record_load_ctx {
+	struct dl_checkpoint_record *record;
+	bool loaded;
+};
+
+static int key_get(const char *name, char *key, size_t key_size)
+{
+	int len;
+
+	if (!name || name[0] == '\0' || strlen(name) > DOWNLOADER_CHECKPOINT_NAME_MAX) {
+		return -EINVAL;
+	}
+
+	len = snprintf(key, key_size, CHECKPOINT_KEY_PREFIX "%s", name);
+	if (len < 0 || len >= key_size) {
+		return -EINVAL;
+	}
+
+	return 0;
+}
+
+static int record_load_cb(const char *key, size_t len, settings_read_cb read_cb, void *cb_arg,
+			  void *param)
+{
+	ssize_t rc;
+	struct record_load_ctx *ctx = param;
+
+	if (len != sizeof(*ctx->record)) {
+		LOG_WRN("Ignoring checkpoint of unexpected size %zu", len);
+		return 0;
+	}
+
+	rc = read_cb(cb_arg, ctx->record, sizeof(*ctx->record));
+	if (rc != sizeof(*ctx->record)) {
+		return 0;
+	}
+
+	ctx->record->validator[sizeof(ctx->record->validator) - 1] = '\0';
+	ctx->loaded = true;
+
+	return 0;
+}
+
+static int record_load(const char *name, struct dl_checkpoint_record *record)
+{
+	int err;
+	char key[CHECKPOINT_KEY_SIZE];
+	struct record_load_ctx ctx = {
+		.record = record,
+	};
+
+	err = key_get(name, key, sizeof(key));
+	if (err) {
+		return err;
+	}
+
+	err = settings_load_subtree_direct(key, record_load_cb, &ctx);
+	if (err) {
+		return err;
+	}
+
+	return ctx.loaded ? 0 : -ENOENT;
+}
+
+static uint32_t url_crc(const char *url)
+{
+	return crc32_ieee(url, strlen(url));
+}
+
+static void record_save(struct downloader *dl)
+{
+	int err;
+	char key[CHECKPOINT_KEY_SIZE];
+	struct dl_checkpoint_record record = {
+		.url_crc = dl->checkpoint.url_crc,
+		.progress = dl->checkpoint.delivered,
+		.file_size = dl->file_size,
+	};
+
+	if (key_get(dl->host_cfg.checkpoint, key, sizeof(key))) {
+		return;
+	}
+
+	memcpy(record.validator, dl->checkpoint.validator, sizeof(record.validator));
+
+	err = settings_save_one(key, &record, sizeof(record));
+	if (err) {
+		LOG_WRN("Failed to save checkpoint, err %d", err);
+		return;
+	}
+
+	LOG_DBG("Checkpoint %s at %u bytes", dl->host_cfg.checkpoint, dl->checkpoint.delivered);
+
+	dl->checkpoint.saved = dl->checkpoint.delivered;
+}
+
+int dl_checkpoint_start(struct downloader *dl, const char *url, size_t from)
+{
+	int err;
+	struct dl_checkpoint_record record;
+
+	memset(&dl->checkpoint, 0, sizeof(dl->checkpoint));
+
+	if (!dl->host_cfg.checkpoint) {
+		return 0;
+	}
+
+	dl->checkpoint.url_crc = url_crc(url);
+	dl->checkpoint.saved = from;
+	dl->checkpoint.delivered = from;
+
+	if (from == 0) {
+		/* New download, the checkpoint is written once the file version is known */
+		return 0;
+	}
+
+	err = record_load(dl->host_cfg.checkpoint, &record);
+	if (err) {
+		LOG_WRN("No checkpoint for %s, resuming without validation",
+			dl->host_cfg.checkpoint);
+		return 0;
+	}
+
+	if (record.url_crc != dl->checkpoint.url_crc || from > record.progress) {
+		LOG_ERR("Checkpoint %s does not match the download", dl->host_cfg.checkpoint);
+		return -ESTALE;
+	}
+
+	memcpy(dl->checkpoint.validator, record.validator, sizeof(dl->checkpoint.validator));
+	dl->checkpoint.file_size = record.file_size;
+	dl->checkpoint.has_validator = true;
+
+	return 0;
+}
+
+void dl_checkpoint_validator_set(struct downloader *dl, const char *validator, size_t len,
+				 bool preferred)
+{
+	if (!dl->host_cfg.checkpoint) {
+		return;
+	}
+
+	/* Prefer the entity tag over the modification date */
+	if (dl->checkpoint.received_preferred && !preferred) {
+		return;
+	}
+
+	len = MIN(len, sizeof(dl->checkpoint.received) - 1);
+	memcpy(dl->checkpoint.received, validator, len);
+	dl->checkpoint.received[len] = '\0';
+	dl->checkpoint.received_preferred = preferred;
+}
+
+int dl_checkpoint_validate(struct downloader *dl)
+{
+	int err = 0;
+
+	if (!dl->host_cfg.checkpoint) {
+		return 0;
+	}
+
+	if (!dl->checkpoint.has_validator) {
+		/* First response of the download, remember the file version */
+		memcpy(dl->checkpoint.validator, dl->checkpoint.received,
+		       sizeof(dl->checkpoint.validator));
+		dl->checkpoint.file_size = dl->file_size;
+		dl->checkpoint.has_validator = true;
+		record_save(dl);
+	} else if (strcmp(dl->checkpoint.validator, dl->checkpoint.received) != 0 ||
+		   (dl->checkpoint.file_size && dl->file_size &&
+		    dl->checkpoint.file_size != dl->file_size)) {
+		LOG_ERR("File has changed since checkpoint %s", dl->host_cfg.checkpoint);
+		err = -ESTALE;
+	}
+
+	/* Each response carries its own validator */
+	dl->checkpoint.received[0] = '\0';
+	dl->checkpoint.received_preferred = false;
+
+	return err;
+}
+
+void dl_checkpoint_update(struct downloader *dl)
+{
+	if (!dl->host_cfg.checkpoint || !dl->checkpoint.has_validator) {
+		return;
+	}
+
+	/* All the data up to the current progress has been accepted by the application */
+	dl->checkpoint.delivered = dl->progress;
+
+	if (dl->checkpoint.delivered - dl->checkpoint.saved >=
+	    CONFIG_DOWNLOADER_CHECKPOINT_INTERVAL) {
+		record_save(dl);
+	}
+}
+
+void dl_checkpoint_save(struct downloader *dl)
+{
+	if (!dl->host_cfg.checkpoint || !dl->checkpoint.has_validator ||
+	    dl->checkpoint.delivered == dl->checkpoint.saved) {
+		return;
+	}
+
+	record_save(dl);
+}
+
+void dl_checkpoint_complete(struct downloader *dl)
+{
+	int err;
+	char key[CHECKPOINT_KEY_SIZE];
+
+	if (!dl->host_cfg.checkpoint || key_get(dl->host_cfg.checkpoint, key, sizeof(key))) {
+		return;
+	}
+
+	err = settings_delete(key);
+	if (err) {
+		LOG_WRN("Failed to delete checkpoint, err %d", err);
+	}
+
+	dl->checkpoint.has_validator = false;
+}
+
+int downloader_checkpoint_get(const char *name, const char *url, size_t *progress)
+{
+	int err;
+	struct dl_checkpoint_record record;
+
+	if (!name || !url || !progress) {
+		return -EINVAL;
+	}
+
+	err = record_load(name, &record);
+	if (err) {
+		return err;
+	}
+
+	if (record.url_crc != url_crc(url)) {
+		return -ESTALE;
+	}
+
+	*progress = record.progress;
+
+	return 0;
+}
+
+int downloader_checkpoint_clear(const char *name)
+{
+	int err;
+	char key[CHECKPOINT_KEY_SIZE];
+
+	err = key_get(name, key, sizeof(key));
+	if (err) {
+		return err;
+	}
+
+	return settings_delete(key);
+}
@@ -12,6 +12,7 @@
 #include <net/downloader.h>
 #include <net/downloader_transport.h>
 
+#include "dl_checkpoint.h"
 #include "dl_parse.h"
 #include "dl_socket.h"
 
@@ -201,6 +202,9 @@ static int stopped_evt_send(struct downloader *dl)
 		.id = DOWNLOADER_EVT_STOPPED,
 	};
 
+	/* Allow the download to be resumed from where it stopped */
+	dl_checkpoint_save(dl);
+
 	return dl->cfg.callback(&evt);
 }
 
@@ -241,8 +245,11 @@ int dl_transport_evt_data(struct downloader *dl, void *data, size_t len)
 	if (err) {
 		/* Application refused data, suspend */
 		restart_and_suspend(dl);
+		return 0;
 	}
 
+	dl_checkpoint_update(dl);
+
 	return 0;
 }
 
@@ -288,6 +295,8 @@ void download_thread(void *cli, void *a, void *b)
 			 */
 			rc = transport_download(dl);
 			if (rc) {
+				dl_checkpoint_save(dl);
+
 				if (rc == -ECONNRESET) {
 					goto reconnect;
 				}
@@ -319,6 +328,7 @@ reconnect:
 
 			if (dl->complete) {
 				LOG_INF("Download complete");
+				dl_checkpoint_complete(dl);
 				restart_and_suspend(dl);
 				download_complete_evt_send(dl);
 			}
@@ -463,6 +473,12 @@ static int downloader_start(struct downloader *dl, const struct downloader_host_
 		dl->host_cfg.redirects_max = CONFIG_DOWNLOADER_MAX_REDIRECTS;
 	}
 
+	err = dl_checkpoint_start(dl, url, from);
+	if (err) {
+		k_mutex_unlock(&dl->mutex);
+		return err;
+	}
+
 	dl->transport = NULL;
 	STRUCT_SECTION_FOREACH(dl_transport_entry, entry)
 	{
@@ -20,6 +20,7 @@
 #include <zephyr/logging/log.h>
 #include <string.h>
 #include <zephyr/sys/__assert.h>
+#include "dl_checkpoint.h"
 #include "dl_socket.h"
 #include "dl_parse.h"
 
@@ -31,10 +32,45 @@ LOG_MODULE_DECLARE(downloader, CONFIG_DOWNLOADER_LOG_LEVEL);
 #define COAP_VER	     1
 #define FILENAME_SIZE	     CONFIG_DOWNLOADER_MAX_FILENAME_SIZE
 #define COAP_PATH_ELEM_DELIM "/"
+#define COAP_ETAG_MAX_LEN    8
+
+/* Room for the header and options of a response, on top of its payload */
+#define COAP_RESPONSE_HEADROOM 128
+
+#define WINDOW_MAX CONFIG_DOWNLOADER_TRANSPORT_COAP_WINDOW_MAX
 
 #define COAP "coap://"
 #define COAPS "coaps://"
 
+enum coap_window_state {
+	/* No request outstanding */
+	WINDOW_SLOT_FREE,
+	/* Request sent, waiting for the response */
+	WINDOW_SLOT_PENDING,
+	/* Block received ahead of the ones before it, payload stashed */
+	WINDOW_SLOT_RECEIVED,
+};
+
+/* Block request of the window. */
+struct coap_window_slot {
+	/** Time by which the response is expected */
+	uint32_t deadline;
+	/** Current retransmission timeout */
+	uint32_t timeout;
+	/** Block number */
+	uint32_t num;
+	/** Message ID of the request */
+	uint16_t id;
+	/** Length of the stashed payload */
+	uint16_t len;
+	/** Retransmissions left */
+	uint8_t retries;
+	/** Slot state, see @ref coap_window_state */
+	uint8_t state;
+	/** Whether more blocks follow the stashed one */
+	bool more;
+};
+
 struct transport_params_coap {
 	/** Flag whether config is set */
 	bool cfg_set;
@@ -47,6 +83,22 @@ struct transport_params_coap {
 	/** CoAP pending object. */
 	struct coap_pending pending;
 
+	/** Window of outstanding block requests, when window_size > 1 */
+	struct {
+		/** Block requests, block number n is kept at n % size */
+		struct coap_window_slot slot[WINDOW_MAX];
+		/** First block that is not delivered yet */
+		uint32_t base;
+		/** Next block to request */
+		uint32_t next;
+		/** Bytes of the first block that were delivered before */
+		uint16_t skip;
+		/** Number of slots in use, limited by the buffer size */
+		uint8_t size;
+		/** Block size in use, as SZX */
+		uint8_t szx;
+	} win;
+
 	struct {
 		/** Socket descriptor. */
 		int fd;
@@ -73,6 +125,7 @@ struct transport_params_coap {
 BUILD_ASSERT(CONFIG_DOWNLOADER_TRANSPORT_PARAMS_SIZE >= sizeof(struct transport_params_coap));
 
 static int coap_request_send(struct downloader *dl);
+static void coap_window_reset(struct downloader *dl, uint8_t szx);
 
 static int coap_get_current_from_response_pkt(const struct coap_packet *cpkt)
 {
@@ -104,6 +157,10 @@ int coap_block_init(struct downloader *dl, size_t from)
 	coap->block_ctx.current = from;
 	coap_pending_clear(&coap->pending);
 
+	if (coap->cfg.window_size > 1) {
+		coap_window_reset(dl, coap->cfg.block_size);
+	}
+
 	coap->initialized = true;
 	return 0;
 }
@@ -206,6 +263,25 @@ static int coap_block_update(struct downloader *dl, struct coap_packet *pkt, siz
 	return 0;
 }
 
+/* Pass the entity tag of the block to the checkpoint and verify it. */
+static int coap_validator_check(struct downloader *dl, const struct coap_packet *pkt)
+{
+	int count;
+	struct coap_option etag;
+	char validator[COAP_ETAG_MAX_LEN * 2 + 1];
+	size_t len = 0;
+
+	count = coap_find_options(pkt, COAP_OPTION_ETAG, &etag, 1);
+	if (count > 0) {
+		len = bin2hex(etag.value, MIN(etag.len, COAP_ETAG_MAX_LEN), validator,
+			      sizeof(validator));
+	}
+
+	dl_checkpoint_validator_set(dl, validator, len, true);
+
+	return dl_checkpoint_validate(dl);
+}
+
 static int coap_parse(struct downloader *dl, size_t len)
 {
 	int err;
@@ -252,6 +328,13 @@ static int coap_parse(struct downloader *dl, size_t len)
 		return -EBADMSG;
 	}
 
+	if (IS_ENABLED(CONFIG_DOWNLOADER_CHECKPOINT) && dl->host_cfg.checkpoint) {
+		err = coap_validator_check(dl, &response);
+		if (err) {
+			return err;
+		}
+	}
+
 	payload = coap_packet_get_payload(&response, &payload_len);
 	if (!payload) {
 		LOG_WRN("No CoAP payload!");
@@ -273,26 +356,17 @@ static int coap_parse(struct downloader *dl, size_t len)
 	return 0;
 }
 
-static int coap_request_send(struct downloader *dl)
+/* Initialize a GET request for the file and add its Uri-Path options. */
+static int coap_request_init(struct downloader *dl, struct coap_packet *request, uint8_t *buf,
+			     size_t size, uint16_t id)
 {
 	int err;
-	uint16_t id;
 	char file[FILENAME_SIZE];
 	char *path_elem;
 	char *path_elem_saveptr;
-	struct coap_packet request;
-	struct transport_params_coap *coap;
 
-	coap = (struct transport_params_coap *)dl->transport_internal;
-
-	if (has_pending(dl)) {
-		id = coap->pending.id;
-	} else {
-		id = coap_next_id();
-	}
-
-	err = coap_packet_init(&request, dl->cfg.buf, dl->cfg.buf_size, COAP_VER,
-			       COAP_TYPE_CON, 8, coap_next_token(), COAP_METHOD_GET, id);
+	err = coap_packet_init(request, buf, size, COAP_VER, COAP_TYPE_CON, 8, coap_next_token(),
+			       COAP_METHOD_GET, id);
 	if (err) {
 		LOG_ERR("Failed to init CoAP message, err %d", err);
 		return err;
@@ -303,7 +377,7 @@ static int coap_request_send(struct downloader *dl)
 
 	path_elem = strtok_r(file, COAP_PATH_ELEM_DELIM, &path_elem_saveptr);
 	do {
-		err = coap_packet_append_option(&request, COAP_OPTION_URI_PATH, path_elem,
+		err = coap_packet_append_option(request, COAP_OPTION_URI_PATH, path_elem,
 						strlen(path_elem));
 		if (err) {
 			LOG_ERR("Unable add option to request");
@@ -311,6 +385,48 @@ static int coap_request_send(struct downloader *dl)
 		}
 	} while ((path_elem = strtok_r(NULL, COAP_PATH_ELEM_DELIM, &path_elem_saveptr)));
 
+	return 0;
+}
+
+static int coap_request_proxy_uri_append(struct downloader *dl, struct coap_packet *request)
+{
+	int err;
+	struct transport_params_coap *coap;
+
+	coap = (struct transport_params_coap *)dl->transport_internal;
+
+	if (coap->proxy_uri != NULL) {
+		err = coap_packet_append_option(request, COAP_OPTION_PROXY_URI,
+			coap->proxy_uri, strlen(coap->proxy_uri));
+		if (err) {
+			LOG_ERR("Unable to add Proxy-URI option");
+			return err;
+		}
+	}
+
+	return 0;
+}
+
+static int coap_request_send(struct downloader *dl)
+{
+	int err;
+	uint16_t id;
+	struct coap_packet request;
+	struct transport_params_coap *coap;
+
+	coap = (struct transport_params_coap *)dl->transport_internal;
+
+	if (has_pending(dl)) {
+		id = coap->pending.id;
+	} else {
+		id = coap_next_id();
+	}
+
+	err = coap_request_init(dl, &request, dl->cfg.buf, dl->cfg.buf_size, id);
+	if (err) {
+		return err;
+	}
+
 	err = coap_append_block2_option(&request, &coap->block_ctx);
 	if (err) {
 		LOG_ERR("Unable to add block2 option");
@@ -323,13 +439,9 @@ static int coap_request_send(struct downloader *dl)
 		return err;
 	}
 
-	if (coap->proxy_uri != NULL) {
-		err = coap_packet_append_option(&request, COAP_OPTION_PROXY_URI,
-			coap->proxy_uri, strlen(coap->proxy_uri));
-		if (err) {
-			LOG_ERR("Unable to add Proxy-URI option");
-			return err;
-		}
+	err = coap_request_proxy_uri_append(dl, &request);
+	if (err) {
+		return err;
 	}
 
 	if (!has_pending(dl)) {
@@ -364,6 +476,434 @@ static int coap_request_send(struct downloader *dl)
 	return 0;
 }
 
+/* Windowed block-wise transfer.
+ *
+ * Up to win.size Block2 requests are outstanding at the same time, each with its own message ID
+ * and retransmission timer. Blocks are delivered in order: a block that arrives before the ones
+ * preceding it is stashed at the end of the downloader buffer until they are received.
+ * Requests are built and responses are received in the remaining part of the buffer.
+ *
+ * Only one block is requested until the size of the file is known, which also lets the server
+ * choose a smaller block size before the window is opened (RFC 7959, section 2.4).
+ */
+
+static size_t coap_window_block_bytes(struct transport_params_coap *coap)
+{
+	return coap_block_size_to_bytes(coap->win.szx);
+}
+
+static size_t coap_window_rx_size(struct downloader *dl)
+{
+	struct transport_params_coap *coap;
+
+	coap = (struct transport_params_coap *)dl->transport_internal;
+
+	if (coap->win.size == 1) {
+		return dl->cfg.buf_size;
+	}
+
+	return dl->cfg.buf_size - coap->win.size * coap_window_block_bytes(coap);
+}
+
+static uint8_t *coap_window_stash(struct downloader *dl, struct coap_window_slot *slot)
+{
+	struct transport_params_coap *coap;
+	size_t idx;
+
+	coap = (struct transport_params_coap *)dl->transport_internal;
+	idx = slot - coap->win.slot;
+
+	return dl->cfg.buf + dl->cfg.buf_size - (idx + 1) * coap_window_block_bytes(coap);
+}
+
+static struct coap_window_slot *coap_window_slot_get(struct transport_params_coap *coap,
+						     uint32_t num)
+{
+	return &coap->win.slot[num % coap->win.size];
+}
+
+/* Drop all outstanding requests and restart the window at the current progress. */
+static void coap_window_reset(struct downloader *dl, uint8_t szx)
+{
+	struct transport_params_coap *coap;
+	size_t bytes = coap_block_size_to_bytes(szx);
+	size_t size;
+
+	coap = (struct transport_params_coap *)dl->transport_internal;
+
+	memset(&coap->win, 0, sizeof(coap->win));
+
+	coap->win.szx = szx;
+	coap->win.base = dl->progress / bytes;
+	coap->win.next = coap->win.base;
+	coap->win.skip = dl->progress % bytes;
+
+	/* Each block of the window is stashed, and a whole response must still fit */
+	size = 0;
+	if (dl->cfg.buf_size > bytes + COAP_RESPONSE_HEADROOM) {
+		size = (dl->cfg.buf_size - bytes - COAP_RESPONSE_HEADROOM) / bytes;
+	}
+
+	size = MIN(size, MIN(coap->cfg.window_size, WINDOW_MAX));
+	coap->win.size = MAX(size, 1);
+
+	LOG_DBG("CoAP window of %u blocks of %zu bytes from block %u", coap->win.size, bytes,
+		coap->win.base);
+}
+
+static int coap_window_request_send(struct downloader *dl, struct coap_window_slot *slot)
+{
+	int err;
+	struct coap_packet request;
+	struct transport_params_coap *coap;
+
+	coap = (struct transport_params_coap *)dl->transport_internal;
+
+	err = coap_request_init(dl, &request, dl->cfg.buf, coap_window_rx_size(dl), slot->id);
+	if (err) {
+		return err;
+	}
+
+	err = coap_append_option_int(&request, COAP_OPTION_BLOCK2,
+				     (slot->num << 4) | coap->win.szx);
+	if (err) {
+		LOG_ERR("Unable to add block2 option");
+		return err;
+	}
+
+	if (dl->file_size == 0) {
+		/* Ask for the size of the file */
+		err = coap_append_option_int(&request, COAP_OPTION_SIZE2, 0);
+		if (err) {
+			LOG_ERR("Unable to add size2 option");
+			return err;
+		}
+	}
+
+	err = coap_request_proxy_uri_append(dl, &request);
+	if (err) {
+		return err;
+	}
+
+	LOG_DBG("CoAP block %u requested, id %d", slot->num, slot->id);
+
+	err = dl_socket_send_timeout_set(coap->sock.fd, slot->timeout);
+	if (err) {
+		return err;
+	}
+
+	err = dl_socket_send(coap->sock.fd, dl->cfg.buf, request.offset);
+	if (err) {
+		LOG_ERR("Failed to send CoAP request, errno %d", errno);
+		return err;
+	}
+
+	if (IS_ENABLED(CONFIG_DOWNLOADER_LOG_HEADERS)) {
+		LOG_HEXDUMP_DBG(request.data, request.offset, "CoAP request");
+	}
+
+	slot->deadline = k_uptime_get_32() + slot->timeout;
+
+	return 0;
+}
+
+/* Request the blocks that fit in the window and are not requested yet. */
+static int coap_window_fill(struct downloader *dl)
+{
+	int err;
+	uint32_t limit;
+	uint32_t last = UINT32_MAX;
+	struct coap_window_slot *slot;
+	struct coap_transmission_parameters params;
+	struct transport_params_coap *coap;
+
+	coap = (struct transport_params_coap *)dl->transport_internal;
+
+	limit = coap->win.base + (dl->file_size ? coap->win.size : 1);
+	if (dl->file_size) {
+		last = (dl->file_size - 1) / coap_window_block_bytes(coap);
+	}
+
+	while (coap->win.next < limit && coap->win.next <= last) {
+		slot = coap_window_slot_get(coap, coap->win.next);
+		params = coap_get_transmission_parameters();
+
+		slot->num = coap->win.next;
+		slot->id = coap_next_id();
+		slot->timeout = params.ack_timeout;
+		slot->retries = coap->cfg.max_retransmission;
+		slot->state = WINDOW_SLOT_PENDING;
+
+		err = coap_window_request_send(dl, slot);
+		if (err) {
+			return err;
+		}
+
+		coap->win.next++;
+	}
+
+	return 0;
+}
+
+/* Retransmit the requests that timed out and get the time until the next one does. */
+static int coap_window_retransmit(struct downloader *dl, uint32_t *timeout)
+{
+	int err;
+	int32_t left;
+	uint32_t now = k_uptime_get_32();
+	struct coap_window_slot *slot;
+	struct transport_params_coap *coap;
+
+	coap = (struct transport_params_coap *)dl->transport_internal;
+
+	*timeout = UINT32_MAX;
+
+	for (size_t i = 0; i < coap->win.size; i++) {
+		slot = &coap->win.slot[i];
+		if (slot->state != WINDOW_SLOT_PENDING) {
+			continue;
+		}
+
+		left = (int32_t)(slot->deadline - now);
+		if (left <= 0) {
+			if (slot->retries == 0) {
+				LOG_ERR("CoAP max-retransmissions exceeded");
+				return -ECONNRESET;
+			}
+
+			slot->retries--;
+			slot->timeout *= 2;
+
+			LOG_DBG("Retransmitting CoAP block %u", slot->num);
+			err = coap_window_request_send(dl, slot);
+			if (err) {
+				LOG_DBG("coap_request_send failed, err %d", err);
+				return -ECONNRESET;
+			}
+
+			left = slot->timeout;
+		}
+
+		*timeout = MIN(*timeout, (uint32_t)left);
+	}
+
+	return 0;
+}
+
+/* Deliver the next block of the file. */
+static void coap_window_deliver(struct downloader *dl, const uint8_t *payload, size_t len,
+				bool more)
+{
+	size_t skip;
+	struct transport_params_coap *coap;
+
+	coap = (struct transport_params_coap *)dl->transport_internal;
+
+	skip = MIN(coap->win.skip, len);
+	coap->win.skip = 0;
+	coap->win.base++;
+
+	dl->progress += len - skip;
+	dl->buf_offset = 0;
+
+	dl_transport_evt_data(dl, (void *)(payload + skip), len - skip);
+
+	if (!more) {
+		/* Mark the end, in case we did not know the total size */
+		dl->file_size = dl->progress;
+	}
+
+	if (dl->progress == dl->file_size) {
+		dl->complete = true;
+	}
+}
+
+static int coap_window_parse(struct downloader *dl, size_t len)
+{
+	int err;
+	int block;
+	int size;
+	bool more;
+	uint8_t szx;
+	size_t offset;
+	uint8_t response_code;
+	uint16_t id;
+	uint16_t payload_len;
+	const uint8_t *payload;
+	struct coap_packet response;
+	struct coap_window_slot *slot = NULL;
+	struct transport_params_coap *coap;
+
+	coap = (struct transport_params_coap *)dl->transport_internal;
+
+	err = coap_packet_parse(&response, dl->cfg.buf, len, NULL, 0);
+	if (err) {
+		LOG_ERR("Failed to parse CoAP packet, err %d", err);
+		return 0;
+	}
+
+	id = coap_header_get_id(&response);
+	for (size_t i = 0; i < coap->win.size; i++) {
+		if (coap->win.slot[i].state == WINDOW_SLOT_PENDING && coap->win.slot[i].id == id) {
+			slot = &coap->win.slot[i];
+			break;
+		}
+	}
+
+	if (!slot) {
+		/* Duplicate, or a response to a request of a previous window */
+		LOG_DBG("Response %d is not pending", id);
+		return 0;
+	}
+
+	if (coap_header_get_type(&response) != COAP_TYPE_ACK) {
+		LOG_ERR("Response must be of coap type ACK");
+		goto retransmit;
+	}
+
+	response_code = coap_header_get_code(&response);
+	if (response_code != COAP_RESPONSE_CODE_OK && response_code != COAP_RESPONSE_CODE_CONTENT) {
+		LOG_ERR("Server responded with code 0x%x", response_code);
+		goto retransmit;
+	}
+
+	block = coap_get_option_int(&response, COAP_OPTION_BLOCK2);
+	if (block < 0) {
+		LOG_ERR("Failed to get block from CoAP packet, err %d", block);
+		goto retransmit;
+	}
+
+	payload = coap_packet_get_payload(&response, &payload_len);
+	if (!payload) {
+		LOG_WRN("No CoAP payload!");
+		goto retransmit;
+	}
+
+	szx = GET_BLOCK_SIZE(block);
+	more = GET_MORE(block);
+	offset = slot->num * coap_window_block_bytes(coap);
+
+	if (szx > coap->win.szx || (GET_BLOCK_NUM(block) << (szx + 4)) != offset) {
+		LOG_WRN("Block out of order %d, expected %u", GET_BLOCK_NUM(block), slot->num);
+		goto retransmit;
+	}
+
+	if (payload_len > coap_block_size_to_bytes(szx)) {
+		LOG_ERR("Block of %d bytes larger than the block size", payload_len);
+		goto retransmit;
+	}
+
+	if (more && payload_len < coap_block_size_to_bytes(szx)) {
+		if (szx == 0) {
+			goto retransmit;
+		}
+
+		/* The response did not fit in the buffer, ask for smaller blocks */
+		szx--;
+	}
+
+	if (szx != coap->win.szx) {
+		LOG_INF("CoAP block size reduced to %d bytes", coap_block_size_to_bytes(szx));
+		coap_window_reset(dl, szx);
+
+		/* Keep the payload only if it is the first block of the new window */
+		if (offset != coap->win.base * coap_window_block_bytes(coap) ||
+		    (more && payload_len < coap_window_block_bytes(coap))) {
+			return 0;
+		}
+
+		if (payload_len > coap_window_block_bytes(coap)) {
+			payload_len = coap_window_block_bytes(coap);
+			more = true;
+		}
+
+		slot = coap_window_slot_get(coap, coap->win.base);
+		slot->num = coap->win.base;
+	}
+
+	if (dl->file_size == 0) {
+		size = coap_get_option_int(&response, COAP_OPTION_SIZE2);
+		if (size > 0) {
+			LOG_DBG("Total size: %d", size);
+			dl->file_size = size;
+		}
+	}
+
+	if (IS_ENABLED(CONFIG_DOWNLOADER_CHECKPOINT) && dl->host_cfg.checkpoint) {
+		err = coap_validator_check(dl, &response);
+		if (err) {
+			return err;
+		}
+	}
+
+	if (slot->num == coap->win.base) {
+		slot->state = WINDOW_SLOT_FREE;
+		coap_window_deliver(dl, payload, payload_len, more);
+		return 0;
+	}
+
+	memcpy(coap_window_stash(dl, slot), payload, payload_len);
+	slot->len = payload_len;
+	slot->more = more;
+	slot->state = WINDOW_SLOT_RECEIVED;
+
+	return 0;
+
+retransmit:
+	slot->deadline = k_uptime_get_32();
+	return 0;
+}
+
+static int coap_window_download(struct downloader *dl)
+{
+	int ret, len;
+	uint32_t timeout;
+	struct coap_window_slot *slot;
+	struct transport_params_coap *coap;
+
+	coap = (struct transport_params_coap *)dl->transport_internal;
+
+	/* Deliver blocks that were received ahead of time, one per call */
+	slot = coap_window_slot_get(coap, coap->win.base);
+	if (slot->state == WINDOW_SLOT_RECEIVED) {
+		slot->state = WINDOW_SLOT_FREE;
+		coap_window_deliver(dl, coap_window_stash(dl, slot), slot->len, slot->more);
+		return 0;
+	}
+
+	ret = coap_window_fill(dl);
+	if (ret) {
+		LOG_DBG("data_req failed, err %d", ret);
+		/** Attempt reconnection. */
+		return ret;
+	}
+
+	ret = coap_window_retransmit(dl, &timeout);
+	if (ret) {
+		LOG_DBG("retransmission_req failed, err %d", ret);
+		/** Attempt reconnection. */
+		return ret;
+	}
+
+	ret = dl_socket_recv_timeout_set(coap->sock.fd, timeout);
+	if (ret) {
+		LOG_DBG("Failed to set CoAP recv timeout, err %d", ret);
+		return ret;
+	}
+
+	len = dl_socket_recv(coap->sock.fd, dl->cfg.buf, coap_window_rx_size(dl));
+	if (len < 0) {
+		if ((len == -ETIMEDOUT) || (len == -EWOULDBLOCK) || (len == -EAGAIN)) {
+			/* Timed out requests are sent again on the next call */
+			return 0;
+		}
+
+		return len;
+	}
+
+	return coap_window_parse(dl, len);
+}
+
 static bool dl_coap_proto_supported(struct downloader *dl, const char *url)
 {
 	if (strncmp(url, COAPS, (sizeof(COAPS) - 1)) == 0) {
@@ -505,6 +1045,10 @@ static int dl_coap_download(struct downloader *dl)
 
 	coap = (struct transport_params_coap *)dl->transport_internal;
 
+	if (coap->cfg.window_size > 1) {
+		return coap_window_download(dl);
+	}
+
 	if (coap->new_data_req) {
 		/* Request next fragment */
 		dl->buf_offset = 0;
@@ -561,6 +1105,10 @@ static int dl_coap_download(struct downloader *dl)
 	}
 
 	ret = coap_parse(dl, len);
+	if (ret == -ESTALE) {
+		return ret;
+	}
+
 	if (ret < 0) {
 		/* Request data again */
 		coap->retransmission_req = true;
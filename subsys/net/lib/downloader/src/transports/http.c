@@ -14,6 +14,7 @@
 #include <net/downloader.h>
 #include <net/downloader_transport.h>
 #include <net/downloader_transport_http.h>
+#include "dl_checkpoint.h"
 #include "dl_socket.h"
 #include "dl_parse.h"
 
@@ -75,6 +76,12 @@ struct transport_params_http {
 	bool ranged;
 	/** Ranged progress */
 	size_t ranged_progress;
+	/** Number of range requests whose response has not been fully received */
+	uint8_t ranged_pending;
+	/** Offset up to which the file has been requested */
+	size_t ranged_requested;
+	/** Bytes of the next response that were received with the current one */
+	size_t buffered;
 	/** HTTP header */
 	struct {
 		/** Header length */
@@ -175,6 +182,8 @@ static int http_get_request_send(struct downloader *dl)
 			       dl->hostname, dl->progress, off);
 		http->ranged = true;
 		http->ranged_progress = 0;
+		http->ranged_pending = 1;
+		http->ranged_requested = off + 1;
 		LOG_DBG("Range request up to %d bytes", dl->host_cfg.range_override);
 		goto send;
 	} else if (dl->progress) {
@@ -208,6 +217,87 @@ send:
 	return 0;
 }
 
+/* Keep up to pipeline_depth range requests in flight, so that the next responses are
+ * already on their way while the current one is being received. The requests are written
+ * to the unused part of the buffer, after the bytes that are kept for the next response.
+ */
+static int http_pipeline_fill(struct downloader *dl)
+{
+	int err;
+	int len;
+	size_t off;
+	char *buf;
+	size_t buf_size;
+	struct transport_params_http *http;
+
+	http = (struct transport_params_http *)dl->transport_internal;
+
+	/* The file size is known once the first response header has been received. */
+	if (!http->ranged || !dl->file_size || http->connection_close) {
+		return 0;
+	}
+
+	buf = dl->cfg.buf + http->buffered;
+	buf_size = dl->cfg.buf_size - http->buffered;
+
+	while (http->ranged_pending < http->cfg.pipeline_depth &&
+	       http->ranged_requested < dl->file_size) {
+		off = MIN(http->ranged_requested + dl->host_cfg.range_override, dl->file_size) - 1;
+
+		len = snprintf(buf, buf_size, HTTP_GET_RANGE, dl->file, dl->hostname,
+			       http->ranged_requested, off);
+		if (len < 0 || len >= buf_size) {
+			/* Retry once the buffered bytes have been processed */
+			return 0;
+		}
+
+		err = dl_socket_send(http->sock.fd, buf, len);
+		if (err) {
+			LOG_ERR("Failed to send HTTP request, errno %d", errno);
+			return err;
+		}
+
+		LOG_DBG("Pipelined range request %u-%u", http->ranged_requested, off);
+
+		http->ranged_requested = off + 1;
+		http->ranged_pending++;
+	}
+
+	return 0;
+}
+
+/* Pass the version of the file to the checkpoint, preferring the entity tag. */
+static void http_validator_parse(struct downloader *dl, size_t parse_len)
+{
+	char *p;
+	char *q;
+	static const struct {
+		const char *name;
+		bool preferred;
+	} fields[] = {
+		{"\r\netag:", true},
+		{"\r\nlast-modified:", false},
+	};
+
+	for (size_t i = 0; i < ARRAY_SIZE(fields); i++) {
+		p = strnstr(dl->cfg.buf, fields[i].name, parse_len);
+		if (!p) {
+			continue;
+		}
+		p += strlen(fields[i].name);
+		q = strnstr(p, "\r\n", parse_len - (p - dl->cfg.buf));
+		if (!q) {
+			/* Missing end of line */
+			continue;
+		}
+		while (p < q && *p == ' ') {
+			p++;
+		}
+
+		dl_checkpoint_validator_set(dl, p, q - p, fields[i].preferred);
+	}
+}
+
 /* Returns:
  * Number of bytes parsed on success.
  * Negative errno on error.
@@ -353,6 +443,10 @@ static int http_header_parse(struct downloader *dl, size_t buf_len)
 		}
 	} while (0);
 
+	if (IS_ENABLED(CONFIG_DOWNLOADER_CHECKPOINT) && dl->host_cfg.checkpoint) {
+		http_validator_parse(dl, parse_len);
+	}
+
 	p = strnstr(dl->cfg.buf, "\r\nconnection: close", parse_len);
 	if (p) {
 		LOG_WRN("Peer closed connection, will re-connect");
@@ -381,6 +475,11 @@ static int http_header_parse(struct downloader *dl, size_t buf_len)
 			return -EBADMSG;
 		}
 
+		err = dl_checkpoint_validate(dl);
+		if (err) {
+			return err;
+		}
+
 		return parse_len;
 	}
 
@@ -388,12 +487,12 @@ static int http_header_parse(struct downloader *dl, size_t buf_len)
 	/* We are still missing part of the header.
 	 * Return the lines (in number of bytes) that we have parsed.
 	 */
-	while (q > dl->cfg.buf && (*q != '\r') && (*q != '\n')) {
+	while (q > dl->cfg.buf && *(q - 1) != '\n') {
 		q--;
 	}
 
 	/* Keep \r and \n in the buffer in case it is part of the header ending. */
-	while (*(q - 1) == '\r' || *(q - 1) == '\n') {
+	while (q > dl->cfg.buf && (*(q - 1) == '\r' || *(q - 1) == '\n')) {
 		q--;
 	}
 
@@ -430,8 +529,8 @@ static int http_parse(struct downloader *dl, size_t len)
 		if (parsed_len == len) {
 			dl->buf_offset = 0;
 			return 0;
-		} else if (parsed_len) {
-			/* Keep remaining payload */
+		} else {
+			/* Keep remaining payload, or the partial header line */
 			len = len - parsed_len;
 			memmove(dl->cfg.buf, dl->cfg.buf + parsed_len, len);
 			dl->buf_offset = len;
@@ -566,6 +665,9 @@ static int dl_http_connect(struct downloader *dl)
 
 	http->connection_close = false;
 	http->new_data_req = true;
+	/* Requests sent over the previous connection are not answered. */
+	http->ranged_pending = 0;
+	http->buffered = 0;
 
 	return err;
 }
@@ -590,6 +692,9 @@ static int dl_http_close(struct downloader *dl)
 static int dl_http_download(struct downloader *dl)
 {
 	int ret, recv_len, data_len, expected_len;
+	size_t range_len = 0;
+	size_t range_left = 0;
+	size_t next_len = 0;
 	struct transport_params_http *http;
 
 	http = (struct transport_params_http *)dl->transport_internal;
@@ -609,6 +714,13 @@ static int dl_http_download(struct downloader *dl)
 
 	__ASSERT(dl->buf_offset < dl->cfg.buf_size, "Buffer overflow");
 
+	if (http->buffered) {
+		/* Process the next response that has already been received */
+		recv_len = http->buffered;
+		http->buffered = 0;
+		goto parse;
+	}
+
 	LOG_DBG("Receiving up to %d bytes at %p...", (dl->cfg.buf_size - dl->buf_offset),
 		(void *)(dl->cfg.buf + dl->buf_offset));
 
@@ -636,13 +748,32 @@ static int dl_http_download(struct downloader *dl)
 		return recv_len;
 	}
 
+parse:
 	data_len = http_parse(dl, recv_len + dl->buf_offset);
 	if (data_len < 0) {
 		return data_len;
 	}
 
+	if (!http->header.has_end) {
+		/* Wait for the rest of the header, the file size may not be known yet */
+		return recv_len > 0 ? 0 : -ECONNRESET;
+	}
+
 	expected_len = MIN(MIN_SIZE_IDENTIFY_BUF, dl->file_size - dl->progress);
 
+	if (http->ranged) {
+		/* With pipelined requests, the next response may follow the requested range. */
+		range_len = MIN(dl->host_cfg.range_override,
+				dl->file_size - (dl->progress - http->ranged_progress));
+		range_left = range_len - http->ranged_progress;
+		expected_len = MIN(expected_len, range_left);
+
+		if (data_len > range_left) {
+			next_len = data_len - range_left;
+			data_len = range_left;
+		}
+	}
+
 	if (data_len < expected_len) {
 		/* Wait for more data after the HTTP headers,
 		 * so we don't end up forwarding too small chunks to FOTA library.
@@ -657,12 +788,6 @@ static int dl_http_download(struct downloader *dl)
 	}
 	if (http->ranged) {
 		http->ranged_progress += data_len;
-		if (http->ranged_progress < dl->host_cfg.range_override) {
-			/* Ranged query: read until a full fragment is received */
-		} else {
-			/* Ranged query: request next fragment */
-			http->new_data_req = true;
-		}
 	}
 	if (dl->progress == dl->file_size) {
 		/* A full file has been received */
@@ -674,6 +799,36 @@ static int dl_http_download(struct downloader *dl)
 	if (dl->complete) {
 		return 0;
 	}
+
+	if (next_len) {
+		/* Keep the beginning of the next response */
+		memmove(dl->cfg.buf, dl->cfg.buf + data_len, next_len);
+		http->buffered = next_len;
+	}
+
+	if (http->ranged) {
+		ret = http_pipeline_fill(dl);
+		if (ret) {
+			LOG_DBG("Pipelined request failed, err %d", ret);
+			return -ECONNRESET;
+		}
+
+		if (http->ranged_progress < range_len) {
+			/* Ranged query: read until a full fragment is received */
+		} else if (http->ranged_pending > 1) {
+			/* Ranged query: the next fragment has already been requested */
+			http->ranged_pending--;
+			http->ranged_progress = 0;
+			http->header.has_end = false;
+			http->header.status_code = 0;
+		} else {
+			/* Ranged query: request next fragment */
+			http->ranged_pending = 0;
+			http->buffered = 0;
+			http->new_data_req = true;
+		}
+	}
+
 	/* Continue reading, unless connection is closed */
 	return recv_len > 0 ? 0 : -ECONNRESET;
 }
@@ -13,7 +13,6 @@
 #include <modem/lte_lc.h>
 #include <net/wifi_location_common.h>
 #include <net/nrf_cloud_codec.h>
-#include <cJSON.h>
 #include "nrf_cloud_codec_internal.h"
 #include "ground_fix_encode_types.h"
 #include "ground_fix_encode.h"
@@ -97,21 +96,9 @@ static int encode_message(struct nrf_cloud_obj_coap_cbor *msg, uint8_t *buf, siz
 			*len = out_len;
 		}
 	} else if (fmt == COAP_CONTENT_FORMAT_APP_JSON) {
-		struct nrf_cloud_data out;
-
-		err = nrf_cloud_encode_message(msg->app_id, msg->double_val, msg->str_val, NULL,
-					       msg->ts, &out);
+		err = nrf_cloud_encode_message(msg, NULL, (char *)buf, len);
 		if (err) {
-			*len = 0;
-		} else if (*len <= out.len) {
-			*len = 0;
-			cJSON_free((void *)out.ptr);
-			err = -E2BIG;
-		} else {
-			*len = out.len;
-			memcpy(buf, out.ptr, *len);
-			buf[*len - 1] = '\0';
-			cJSON_free((void *)out.ptr);
+			LOG_ERR("Error %d encoding message", err);
 		}
 	} else {
 		err = -EINVAL;
@@ -93,12 +93,21 @@ int nrf_cloud_alert_encode(const struct nrf_cloud_alert_info *alert,
 int nrf_cloud_sensor_data_encode(const struct nrf_cloud_sensor_data *input,
 				 struct nrf_cloud_data *output);
 
-/** @brief Encode general message of either a given numeric value or, if not NULL,
- *  a string value.  If topic is present, that topic will be used.
+/** @brief Encode the sensor data as JSON directly into the provided buffer.
+ *  On input, len is the size of the buffer; on output, the length of the
+ *  NUL terminated message.  If buf is NULL, only the length is computed.
+ *  Returns -E2BIG if the buffer is too small.
  */
-int nrf_cloud_encode_message(const char *app_id, double value, const char *str_val,
-			     const char *topic, int64_t ts,
-			     struct nrf_cloud_data *output);
+int nrf_cloud_sensor_data_json_write(const struct nrf_cloud_sensor_data *sensor, char *buf,
+				     size_t *len);
+
+/** @brief Encode general message as JSON directly into the provided buffer, without
+ *  building a cJSON tree.  If topic is present, that topic will be used.
+ *  On input, len is the size of the buffer; on output, the length of the
+ *  NUL terminated message.  Returns -E2BIG if the buffer is too small.
+ */
+int nrf_cloud_encode_message(const struct nrf_cloud_obj_coap_cbor *msg, const char *topic,
+			     char *buf, size_t *len);
 
 /** @brief Encode the sensor data to be sent to the device shadow. */
 int nrf_cloud_shadow_data_encode(const struct nrf_cloud_sensor_data *sensor,
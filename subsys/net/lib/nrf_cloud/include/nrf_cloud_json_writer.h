@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef NRF_CLOUD_JSON_WRITER_H_
+#define NRF_CLOUD_JSON_WRITER_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Maximum nesting depth of objects */
+#define NRF_CLOUD_JSON_WRITER_DEPTH_MAX 8
+
+/** @brief Streaming JSON writer.
+ *
+ * Writes a JSON document directly into a caller supplied buffer, without building
+ * an intermediate cJSON tree. The output is identical to what cJSON_PrintUnformatted()
+ * produces for the same members added in the same order.
+ *
+ * Errors are sticky: after the first error, all further calls are ignored and the error
+ * is returned by @ref nrf_cloud_json_writer_finish. If the writer is initialized without
+ * a buffer, nothing is written but the length of the output is still computed, which
+ * allows the exact output size to be allocated before writing.
+ *
+ * Used for sensor data messages, CoAP JSON device messages (including GNSS PVT) and the
+ * shadow control response. The following are still built as cJSON trees:
+ * - Modem info, service info and device status: the same encoders fill the caller's
+ *   cJSON object in the public nrf_cloud_modem_info_json_encode(),
+ *   nrf_cloud_service_info_json_encode() and nrf_cloud_dev_status_json_encode() APIs.
+ * - Shadow state and device status updates, which embed the info sections above.
+ * - nrf_cloud_pvt_data_encode() and the GNSS, location and A-GNSS/P-GPS requests, which
+ *   add to nrf_cloud_obj or cJSON objects owned by the caller.
+ * - Alerts and log messages, which have not been converted yet.
+ */
+struct nrf_cloud_json_writer {
+	char *buf;
+	size_t size;
+	size_t len;
+	int err;
+	uint8_t depth;
+	/* Bit n is set when the object at depth n already contains a member */
+	uint8_t has_member;
+};
+
+/** @brief Initialize the writer.
+ *
+ * @param w    Writer.
+ * @param buf  Output buffer, or NULL to only compute the length of the output.
+ * @param size Size of the output buffer, including room for the NUL terminator.
+ */
+void nrf_cloud_json_writer_init(struct nrf_cloud_json_writer *w, char *buf, size_t size);
+
+/** @brief Start an object. Use a NULL key for the root object. */
+void nrf_cloud_json_writer_obj_start(struct nrf_cloud_json_writer *w, const char *key);
+
+/** @brief End the current object. */
+void nrf_cloud_json_writer_obj_end(struct nrf_cloud_json_writer *w);
+
+/** @brief Add a string member to the current object. */
+void nrf_cloud_json_writer_str_add(struct nrf_cloud_json_writer *w, const char *key,
+				   const char *val);
+
+/** @brief Add a number member to the current object, formatted like cJSON does. */
+void nrf_cloud_json_writer_num_add(struct nrf_cloud_json_writer *w, const char *key,
+				   double val);
+
+/** @brief Add an integer member to the current object. */
+void nrf_cloud_json_writer_int_add(struct nrf_cloud_json_writer *w, const char *key,
+				   int64_t val);
+
+/** @brief Add a boolean member to the current object. */
+void nrf_cloud_json_writer_bool_add(struct nrf_cloud_json_writer *w, const char *key, bool val);
+
+/** @brief Add a null member to the current object. */
+void nrf_cloud_json_writer_null_add(struct nrf_cloud_json_writer *w, const char *key);
+
+/** @brief Finish the document.
+ *
+ * @param w   Writer.
+ * @param len Set to the length of the output, excluding the NUL terminator. Can be NULL.
+ *
+ * @retval 0 The document is complete and, if a buffer is used, NUL terminated.
+ * @retval -E2BIG The output does not fit in the buffer.
+ * @retval -EINVAL Invalid nesting of objects.
+ * @retval -ENOMEM A number could not be formatted.
+ */
+int nrf_cloud_json_writer_finish(struct nrf_cloud_json_writer *w, size_t *len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NRF_CLOUD_JSON_WRITER_H_ */
@@ -5,6 +5,7 @@
  */
 
 #include <zephyr/kernel.h>
+#include <net/nrf_cloud_pgps.h>
 #include "nrf_cloud_agnss_schema_v1.h"
 
 #ifndef NRF_CLOUD_PGPS_SCHEMA_V1_H_
@@ -59,6 +60,17 @@ struct pgps_sys_time {
 	struct nrf_cloud_agnss_system_time time;
 } __packed;
 
+/* Start of a prediction as downloaded: the time element and the header of the ephemerides
+ * element. The ephemerides follow it, and the schema version is not included.
+ */
+struct pgps_prediction_head {
+	uint8_t time_type;
+	uint16_t time_count;
+	struct nrf_cloud_pgps_system_time time;
+	uint8_t ephemeris_type;
+	uint16_t ephemeris_count;
+} __packed;
+
 struct pgps_location {
 	uint8_t schema_version;
 	uint8_t type;
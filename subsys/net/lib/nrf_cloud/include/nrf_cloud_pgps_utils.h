@@ -51,6 +51,7 @@ void npgps_download_unlock(void);
 /* settings functions */
 int npgps_save_header(struct nrf_cloud_pgps_header *header);
 const struct nrf_cloud_pgps_header *npgps_get_saved_header(void);
+int npgps_save_block_index(void);
 const struct gps_location *npgps_get_saved_location(void);
 int npgps_settings_init(void);
 
@@ -69,6 +70,8 @@ void npgps_free_block(int block);
 int npgps_get_block_extent(int block);
 void npgps_reset_block_pool(void);
 void npgps_mark_block_used(int block, bool used);
+uint32_t npgps_get_block_sentinel(int block);
+void npgps_set_block_sentinel(int block, uint32_t sentinel);
 void npgps_print_blocks(void);
 int npgps_num_free(void);
 int npgps_find_first_free(int from_block);
@@ -0,0 +1,267 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <net/nrf_cloud.h>
+#include <net/nrf_cloud_batch.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <string.h>
+#include <date_time.h>
+#include "nrf_cloud_codec_internal.h"
+#if defined(CONFIG_NRF_CLOUD_MQTT)
+#include "nrf_cloud_fsm.h"
+#endif
+#if defined(CONFIG_NRF_CLOUD_COAP)
+#include <net/nrf_cloud_coap.h>
+#endif
+#if defined(CONFIG_NRF_CLOUD_BATCH_FLUSH_ON_RRC_CONNECTED)
+#include <modem/lte_lc.h>
+#endif
+
+LOG_MODULE_REGISTER(nrf_cloud_batch, CONFIG_NRF_CLOUD_BATCH_LOG_LEVEL);
+
+/* The batch is a JSON array of device messages, which is what the bulk topic expects.
+ * Room is always kept for the closing bracket and the NUL terminator.
+ */
+#define BATCH_TAIL_SIZE sizeof("]")
+
+static char batch_buf[CONFIG_NRF_CLOUD_BATCH_BUF_SIZE];
+static size_t batch_len;
+static size_t batch_count;
+static K_MUTEX_DEFINE(batch_lock);
+
+static void flush_work_fn(struct k_work *work);
+
+static K_WORK_DELAYABLE_DEFINE(flush_work, flush_work_fn);
+
+#if defined(CONFIG_NRF_CLOUD_BATCH_FLUSH_ON_RRC_CONNECTED)
+static void lte_handler(const struct lte_lc_evt *const evt)
+{
+	/* The radio is on anyway, send the batch along with whatever woke it up */
+	if (evt->type == LTE_LC_EVT_RRC_UPDATE && evt->rrc_mode == LTE_LC_RRC_MODE_CONNECTED &&
+	    batch_count > 0) {
+		k_work_reschedule(&flush_work, K_NO_WAIT);
+	}
+}
+#endif
+
+static void batch_reset(void)
+{
+	batch_buf[0] = '[';
+	batch_len = 1;
+	batch_count = 0;
+}
+
+static int batch_send(void)
+{
+	int err;
+
+	batch_buf[batch_len] = ']';
+	batch_buf[batch_len + 1] = '\0';
+
+#if defined(CONFIG_NRF_CLOUD_MQTT)
+	struct nrf_cloud_tx_data output = {
+		.data.ptr = batch_buf,
+		.data.len = batch_len + 1,
+		.topic_type = NRF_CLOUD_TOPIC_BULK,
+		.qos = MQTT_QOS_1_AT_LEAST_ONCE,
+	};
+
+	if (nfsm_get_current_state() != STATE_DC_CONNECTED) {
+		return -EACCES;
+	}
+
+	err = nrf_cloud_send(&output);
+#else
+	err = nrf_cloud_coap_json_message_send(batch_buf, true, true);
+#endif
+
+	if (err > 0) {
+		/* CoAP result code */
+		err = -EIO;
+	}
+
+	return err;
+}
+
+static int batch_flush(void)
+{
+	size_t count = batch_count;
+	int err;
+
+	if (count == 0) {
+		return 0;
+	}
+
+	err = batch_send();
+	if (err) {
+		LOG_WRN("Failed to send %zu batched messages: %d", count, err);
+		return err;
+	}
+
+	LOG_DBG("Sent %zu batched messages, %zu bytes", count, batch_len + 1);
+	batch_reset();
+	(void)k_work_cancel_delayable(&flush_work);
+
+	return 0;
+}
+
+static void flush_work_fn(struct k_work *work)
+{
+	int err;
+
+	ARG_UNUSED(work);
+
+	k_mutex_lock(&batch_lock, K_FOREVER);
+	err = batch_flush();
+	if (err && CONFIG_NRF_CLOUD_BATCH_MAX_AGE > 0) {
+		/* Try again later, or at the next connection */
+		k_work_schedule(&flush_work, K_SECONDS(CONFIG_NRF_CLOUD_BATCH_MAX_AGE));
+	}
+	k_mutex_unlock(&batch_lock);
+}
+
+/* Space available for the next message, including its NUL terminator */
+static size_t batch_space(size_t sep)
+{
+	return sizeof(batch_buf) - batch_len - sep - BATCH_TAIL_SIZE + 1;
+}
+
+static void batch_commit(size_t sep, size_t len)
+{
+	if (sep) {
+		batch_buf[batch_len] = ',';
+	}
+
+	batch_len += sep + len;
+	batch_count++;
+
+	if (batch_count == 1) {
+#if defined(CONFIG_NRF_CLOUD_BATCH_FLUSH_ON_RRC_CONNECTED)
+		static bool lte_handler_registered;
+
+		if (!lte_handler_registered) {
+			lte_lc_register_handler(lte_handler);
+			lte_handler_registered = true;
+		}
+#endif
+		if (CONFIG_NRF_CLOUD_BATCH_MAX_AGE > 0) {
+			k_work_schedule(&flush_work, K_SECONDS(CONFIG_NRF_CLOUD_BATCH_MAX_AGE));
+		}
+	}
+}
+
+/* Writes a message at the end of the batch, sending the batch first if it is full */
+static int batch_add(int (*write)(const void *src, char *buf, size_t *len), const void *src)
+{
+	size_t sep;
+	size_t len;
+	int err;
+
+	k_mutex_lock(&batch_lock, K_FOREVER);
+
+	if (batch_len == 0) {
+		batch_reset();
+	}
+
+	for (int attempt = 0; attempt < 2; attempt++) {
+		sep = (batch_count > 0) ? 1 : 0;
+		len = batch_space(sep);
+
+		err = write(src, &batch_buf[batch_len + sep], &len);
+		if (err != -E2BIG) {
+			break;
+		}
+
+		if (batch_count == 0) {
+			LOG_ERR("Message does not fit in the batch buffer");
+			break;
+		}
+
+		if (attempt == 0 && batch_flush() != 0) {
+			err = -ENOBUFS;
+			break;
+		}
+	}
+
+	if (!err) {
+		batch_commit(sep, len);
+	}
+
+	k_mutex_unlock(&batch_lock);
+
+	return err;
+}
+
+static int sensor_data_write(const void *src, char *buf, size_t *len)
+{
+	return nrf_cloud_sensor_data_json_write(src, buf, len);
+}
+
+static int msg_write(const void *src, char *buf, size_t *len)
+{
+	size_t msg_len = strlen(src);
+
+	if (msg_len >= *len) {
+		return -E2BIG;
+	}
+
+	memcpy(buf, src, msg_len);
+	*len = msg_len;
+
+	return 0;
+}
+
+int nrf_cloud_batch_sensor_data_add(const struct nrf_cloud_sensor_data *sensor)
+{
+	struct nrf_cloud_sensor_data data;
+
+	if (!sensor || !sensor->data.ptr || !nrf_cloud_sensor_app_id_lookup(sensor->type)) {
+		return -EINVAL;
+	}
+
+	data = *sensor;
+
+	if (IS_ENABLED(CONFIG_DATE_TIME) && data.ts_ms <= NRF_CLOUD_NO_TIMESTAMP) {
+		/* If date_time_now() fails, the timestamp is left out. */
+		(void)date_time_now(&data.ts_ms);
+	}
+
+	return batch_add(sensor_data_write, &data);
+}
+
+int nrf_cloud_batch_msg_add(const char *msg)
+{
+	if (!msg || msg[0] != '{') {
+		return -EINVAL;
+	}
+
+	return batch_add(msg_write, msg);
+}
+
+int nrf_cloud_batch_flush(void)
+{
+	int err;
+
+	k_mutex_lock(&batch_lock, K_FOREVER);
+	err = batch_flush();
+	k_mutex_unlock(&batch_lock);
+
+	return err;
+}
+
+void nrf_cloud_batch_clear(void)
+{
+	k_mutex_lock(&batch_lock, K_FOREVER);
+	batch_reset();
+	(void)k_work_cancel_delayable(&flush_work);
+	k_mutex_unlock(&batch_lock);
+}
+
+size_t nrf_cloud_batch_count_get(void)
+{
+	return batch_count;
+}
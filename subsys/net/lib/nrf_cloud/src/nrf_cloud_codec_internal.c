@@ -5,6 +5,7 @@
  */
 
 #include "nrf_cloud_codec_internal.h"
+#include "nrf_cloud_json_writer.h"
 #include "nrf_cloud_mem.h"
 #include "nrf_cloud_fsm.h"
 #include <net/nrf_cloud_codec.h>
@@ -410,9 +411,36 @@ static bool compare(const char *s1, const char *s2)
 	return !strncmp(s1, s2, strlen(s2));
 }
 
+int nrf_cloud_sensor_data_json_write(const struct nrf_cloud_sensor_data *sensor, char *buf,
+				     size_t *len)
+{
+	struct nrf_cloud_json_writer w;
+
+	__ASSERT_NO_MSG(sensor != NULL);
+	__ASSERT_NO_MSG(sensor->data.ptr != NULL);
+	__ASSERT_NO_MSG(sensor->type < SENSOR_TYPE_ARRAY_SIZE);
+	__ASSERT_NO_MSG(len != NULL);
+
+	nrf_cloud_json_writer_init(&w, buf, *len);
+	nrf_cloud_json_writer_obj_start(&w, NULL);
+	nrf_cloud_json_writer_str_add(&w, NRF_CLOUD_JSON_APPID_KEY, sensor_type_str[sensor->type]);
+	nrf_cloud_json_writer_str_add(&w, NRF_CLOUD_JSON_DATA_KEY, sensor->data.ptr);
+	nrf_cloud_json_writer_str_add(&w, NRF_CLOUD_JSON_MSG_TYPE_KEY,
+				      NRF_CLOUD_JSON_MSG_TYPE_VAL_DATA);
+	if (sensor->ts_ms != NRF_CLOUD_NO_TIMESTAMP) {
+		nrf_cloud_json_writer_int_add(&w, NRF_CLOUD_MSG_TIMESTAMP_KEY, sensor->ts_ms);
+	}
+	nrf_cloud_json_writer_obj_end(&w);
+
+	return nrf_cloud_json_writer_finish(&w, len);
+}
+
 int nrf_cloud_sensor_data_encode(const struct nrf_cloud_sensor_data *sensor,
 				 struct nrf_cloud_data *output)
 {
+	size_t len = 0;
+	size_t size;
+	char *buffer;
 	int ret;
 
 	__ASSERT_NO_MSG(sensor != NULL);
@@ -421,36 +449,26 @@ int nrf_cloud_sensor_data_encode(const struct nrf_cloud_sensor_data *sensor,
 	__ASSERT_NO_MSG(output != NULL);
 	__ASSERT_NO_MSG(sensor->type < SENSOR_TYPE_ARRAY_SIZE);
 
-	cJSON *root_obj = cJSON_CreateObject();
-
-	if (root_obj == NULL) {
-		return -ENOMEM;
-	}
-
-	ret = json_add_str_cs(root_obj, NRF_CLOUD_JSON_APPID_KEY, sensor_type_str[sensor->type]);
-	ret += json_add_str_cs(root_obj, NRF_CLOUD_JSON_DATA_KEY, sensor->data.ptr);
-	ret += json_add_str_cs(root_obj, NRF_CLOUD_JSON_MSG_TYPE_KEY,
-			       NRF_CLOUD_JSON_MSG_TYPE_VAL_DATA);
-	if (sensor->ts_ms != NRF_CLOUD_NO_TIMESTAMP) {
-		ret += json_add_num_cs(root_obj, NRF_CLOUD_MSG_TIMESTAMP_KEY, sensor->ts_ms);
+	/* Compute the exact size first, so that the message is the only allocation */
+	ret = nrf_cloud_sensor_data_json_write(sensor, NULL, &len);
+	if (ret) {
+		return ret;
 	}
 
-	if (ret != 0) {
-		cJSON_Delete(root_obj);
+	size = len + 1;
+	buffer = nrf_cloud_malloc(size);
+	if (buffer == NULL) {
 		return -ENOMEM;
 	}
 
-	char *buffer;
-
-	buffer = cJSON_PrintUnformatted(root_obj);
-	cJSON_Delete(root_obj);
-
-	if (buffer == NULL) {
-		return -ENOMEM;
+	ret = nrf_cloud_sensor_data_json_write(sensor, buffer, &size);
+	if (ret) {
+		nrf_cloud_free(buffer);
+		return ret;
 	}
 
 	output->ptr = buffer;
-	output->len = strlen(buffer);
+	output->len = size;
 
 	return 0;
 }
@@ -864,58 +882,94 @@ int nrf_cloud_shadow_control_decode(struct nrf_cloud_obj *const ctrl_obj,
 	return 0;
 }
 
-int nrf_cloud_shadow_control_response_encode(struct nrf_cloud_ctrl_data const *const data,
-					     bool accept,
-					     struct nrf_cloud_data *const output)
+static void device_control_write(struct nrf_cloud_json_writer *w,
+				 struct nrf_cloud_ctrl_data const *const data)
 {
-	__ASSERT_NO_MSG(data != NULL);
-	__ASSERT_NO_MSG(output != NULL);
+	nrf_cloud_json_writer_obj_start(w, NRF_CLOUD_JSON_KEY_CTRL);
 
-	char *buffer = NULL;
-	int err = 0;
+	if (data) {
+		nrf_cloud_json_writer_bool_add(w, NRF_CLOUD_JSON_KEY_ALERT, data->alerts_enabled);
+		nrf_cloud_json_writer_int_add(w, NRF_CLOUD_JSON_KEY_LOG, data->log_level);
+	} else {
+		/* If data is NULL, add null to control object */
+		nrf_cloud_json_writer_null_add(w, NRF_CLOUD_JSON_KEY_ALERT);
+		nrf_cloud_json_writer_null_add(w, NRF_CLOUD_JSON_KEY_LOG);
+	}
 
-	/* Prepare JSON response for the delta */
-	cJSON *root_obj = cJSON_CreateObject();
-	cJSON *state_obj = NULL;
-	cJSON *reported_obj = NULL;
-	cJSON *desired_obj = NULL;
+	nrf_cloud_json_writer_obj_end(w);
+}
+
+static int shadow_control_response_write(struct nrf_cloud_ctrl_data const *const data,
+					 bool accept, char *buf, size_t *len)
+{
+	struct nrf_cloud_json_writer w;
+
+	nrf_cloud_json_writer_init(&w, buf, *len);
+	nrf_cloud_json_writer_obj_start(&w, NULL);
 
 	if (!IS_ENABLED(CONFIG_NRF_CLOUD_COAP)) {
-		state_obj = cJSON_AddObjectToObjectCS(root_obj, NRF_CLOUD_JSON_KEY_STATE);
+		nrf_cloud_json_writer_obj_start(&w, NRF_CLOUD_JSON_KEY_STATE);
 		if (!accept) {
-			desired_obj = cJSON_AddObjectToObjectCS(state_obj, NRF_CLOUD_JSON_KEY_DES);
 			/* Rejecting, add nulls to desired control items */
-			err = device_control_encode(desired_obj, NULL);
-			if (err) {
-				goto end;
-			}
+			nrf_cloud_json_writer_obj_start(&w, NRF_CLOUD_JSON_KEY_DES);
+			device_control_write(&w, NULL);
+			nrf_cloud_json_writer_obj_end(&w);
 		}
-		reported_obj = cJSON_AddObjectToObjectCS(state_obj, NRF_CLOUD_JSON_KEY_REP);
-	} else {
-		/* CoAP can currently only modify reported, not desired, so we need to simply
-		 * ignore invalid values.
-		 */
-		reported_obj = root_obj;
+		nrf_cloud_json_writer_obj_start(&w, NRF_CLOUD_JSON_KEY_REP);
 	}
 
-	err = device_control_encode(reported_obj, data);
+	/* CoAP can currently only modify reported, not desired, so we need to simply
+	 * ignore invalid values.
+	 */
+	device_control_write(&w, data);
+
+	if (!IS_ENABLED(CONFIG_NRF_CLOUD_COAP)) {
+		nrf_cloud_json_writer_obj_end(&w);
+		nrf_cloud_json_writer_obj_end(&w);
+	}
+
+	nrf_cloud_json_writer_obj_end(&w);
+
+	return nrf_cloud_json_writer_finish(&w, len);
+}
+
+int nrf_cloud_shadow_control_response_encode(struct nrf_cloud_ctrl_data const *const data,
+					     bool accept,
+					     struct nrf_cloud_data *const output)
+{
+	__ASSERT_NO_MSG(data != NULL);
+	__ASSERT_NO_MSG(output != NULL);
+
+	size_t len = 0;
+	size_t size;
+	char *buffer;
+	int err;
+
+	/* Compute the exact size first, so that the response is the only allocation */
+	err = shadow_control_response_write(data, accept, NULL, &len);
 	if (err) {
-		goto end;
+		LOG_ERR("Failed to encode device control");
+		return err;
 	}
 
-	buffer = cJSON_PrintUnformatted(root_obj);
-	if (!buffer) {
-		err = -ENOMEM;
-		goto end;
+	size = len + 1;
+	buffer = nrf_cloud_malloc(size);
+	if (buffer == NULL) {
+		return -ENOMEM;
+	}
+
+	err = shadow_control_response_write(data, accept, buffer, &size);
+	if (err) {
+		LOG_ERR("Failed to encode device control");
+		nrf_cloud_free(buffer);
+		return err;
 	}
 	LOG_DBG("Shadow response: %s", buffer);
 
 	output->ptr = buffer;
-	output->len = strlen(buffer);
+	output->len = size;
 
-end:
-	cJSON_Delete(root_obj);
-	return err;
+	return 0;
 }
 
 static int shadow_connection_info_update(cJSON *device_obj)
@@ -958,56 +1012,76 @@ int nrf_cloud_pvt_data_encode(const struct nrf_cloud_gnss_pvt * const pvt,
 	return 0;
 }
 
-int nrf_cloud_encode_message(const char *app_id, double value, const char *str_val,
-			     const char *topic, int64_t ts, struct nrf_cloud_data *output)
+int nrf_cloud_encode_message(const struct nrf_cloud_obj_coap_cbor *msg, const char *topic,
+			     char *buf, size_t *len)
 {
-	int ret = 0;
-
-	__ASSERT_NO_MSG(app_id != NULL);
-	__ASSERT_NO_MSG(output != NULL);
+	struct nrf_cloud_json_writer w;
+	int ret;
 
-	NRF_CLOUD_OBJ_JSON_DEFINE(root_obj);
-	NRF_CLOUD_OBJ_JSON_DEFINE(msg_obj);
+	__ASSERT_NO_MSG(msg != NULL);
+	__ASSERT_NO_MSG(msg->app_id != NULL);
+	__ASSERT_NO_MSG(buf != NULL);
+	__ASSERT_NO_MSG(len != NULL);
 
-	/* Init the root object and add a topic string if provided */
-	if (nrf_cloud_obj_init(&root_obj)) {
-		return -ENOMEM;
-	}
+	nrf_cloud_json_writer_init(&w, buf, *len);
+	nrf_cloud_json_writer_obj_start(&w, NULL);
 
+	/* Add a topic string if provided */
 	if (topic != NULL) {
-		ret = nrf_cloud_obj_str_add(&root_obj, NRF_CLOUD_REST_TOPIC_KEY, topic, false);
+		nrf_cloud_json_writer_str_add(&w, NRF_CLOUD_REST_TOPIC_KEY, topic);
 	}
 
-	/* Init the DATA message with provided app ID */
-	ret += nrf_cloud_obj_msg_init(&msg_obj, app_id, NRF_CLOUD_JSON_MSG_TYPE_VAL_DATA);
+	/* The DATA message with provided app ID */
+	nrf_cloud_json_writer_obj_start(&w, NRF_CLOUD_REST_MSG_KEY);
+	nrf_cloud_json_writer_str_add(&w, NRF_CLOUD_JSON_APPID_KEY, msg->app_id);
+	nrf_cloud_json_writer_str_add(&w, NRF_CLOUD_JSON_MSG_TYPE_KEY,
+				      NRF_CLOUD_JSON_MSG_TYPE_VAL_DATA);
+	nrf_cloud_json_writer_int_add(&w, NRF_CLOUD_MSG_TIMESTAMP_KEY, msg->ts);
 
-	ret += nrf_cloud_obj_ts_add(&msg_obj, ts);
-
-	if (str_val != NULL) {
-		ret += nrf_cloud_obj_str_add(&msg_obj, NRF_CLOUD_JSON_DATA_KEY, str_val, false);
-	} else {
-		ret += nrf_cloud_obj_num_add(&msg_obj, NRF_CLOUD_JSON_DATA_KEY, value, false);
-	}
-
-	/* Add the message to the root object */
-	ret += nrf_cloud_obj_object_add(&root_obj, NRF_CLOUD_REST_MSG_KEY, &msg_obj, false);
-	if (ret) {
-		ret = -ENOMEM;
-		goto cleanup;
+	switch (msg->type) {
+	case NRF_CLOUD_DATA_TYPE_STR:
+		nrf_cloud_json_writer_str_add(&w, NRF_CLOUD_JSON_DATA_KEY, msg->str_val);
+		break;
+	case NRF_CLOUD_DATA_TYPE_PVT:
+		nrf_cloud_json_writer_obj_start(&w, NRF_CLOUD_JSON_DATA_KEY);
+		nrf_cloud_json_writer_num_add(&w, NRF_CLOUD_JSON_GNSS_PVT_KEY_LON, msg->pvt->lon);
+		nrf_cloud_json_writer_num_add(&w, NRF_CLOUD_JSON_GNSS_PVT_KEY_LAT, msg->pvt->lat);
+		nrf_cloud_json_writer_num_add(&w, NRF_CLOUD_JSON_GNSS_PVT_KEY_ACCURACY,
+					      msg->pvt->accuracy);
+		if (msg->pvt->has_alt) {
+			nrf_cloud_json_writer_num_add(&w, NRF_CLOUD_JSON_GNSS_PVT_KEY_ALTITUDE,
+						      msg->pvt->alt);
+		}
+		if (msg->pvt->has_speed) {
+			nrf_cloud_json_writer_num_add(&w, NRF_CLOUD_JSON_GNSS_PVT_KEY_SPEED,
+						      msg->pvt->speed);
+		}
+		if (msg->pvt->has_heading) {
+			nrf_cloud_json_writer_num_add(&w, NRF_CLOUD_JSON_GNSS_PVT_KEY_HEADING,
+						      msg->pvt->heading);
+		}
+		nrf_cloud_json_writer_obj_end(&w);
+		break;
+	case NRF_CLOUD_DATA_TYPE_INT:
+		nrf_cloud_json_writer_int_add(&w, NRF_CLOUD_JSON_DATA_KEY, msg->int_val);
+		break;
+	case NRF_CLOUD_DATA_TYPE_DOUBLE:
+		nrf_cloud_json_writer_num_add(&w, NRF_CLOUD_JSON_DATA_KEY, msg->double_val);
+		break;
+	default:
+		LOG_ERR("Cannot encode unknown type.");
+		*len = 0;
+		return -EINVAL;
 	}
 
-	/* msg_obj now belongs to root_obj */
-	nrf_cloud_obj_reset(&msg_obj);
+	nrf_cloud_json_writer_obj_end(&w);
+	nrf_cloud_json_writer_obj_end(&w);
 
-	/* Encode the root object for the cloud */
-	ret = nrf_cloud_obj_cloud_encode(&root_obj);
-	if (ret == 0) {
-		*output = root_obj.encoded_data;
+	ret = nrf_cloud_json_writer_finish(&w, len);
+	if (ret) {
+		*len = 0;
 	}
 
-cleanup:
-	nrf_cloud_obj_free(&root_obj);
-	nrf_cloud_obj_free(&msg_obj);
 	return ret;
 }
 
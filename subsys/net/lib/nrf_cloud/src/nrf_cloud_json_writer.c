@@ -0,0 +1,247 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include "nrf_cloud_json_writer.h"
+
+#include <errno.h>
+#include <float.h>
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Enough for "%1.17g" of any double */
+#define NUM_STR_SIZE 32
+
+static void put(struct nrf_cloud_json_writer *w, const char *str, size_t len)
+{
+	if (w->err) {
+		return;
+	}
+
+	if (w->buf) {
+		/* Always keep room for the NUL terminator */
+		if (len >= w->size - w->len) {
+			w->err = -E2BIG;
+			return;
+		}
+		memcpy(&w->buf[w->len], str, len);
+	}
+
+	w->len += len;
+}
+
+static void put_str(struct nrf_cloud_json_writer *w, const char *str)
+{
+	/* Same escaping as cJSON */
+	static const char hex[] = "0123456789abcdef";
+	const char *run = str;
+	char esc[6] = { '\\', 'u', '0', '0' };
+
+	put(w, "\"", 1);
+
+	for (; *str; str++) {
+		unsigned char c = (unsigned char)*str;
+		size_t esc_len = 2;
+
+		switch (c) {
+		case '\"':
+		case '\\':
+			esc[1] = c;
+			break;
+		case '\b':
+			esc[1] = 'b';
+			break;
+		case '\f':
+			esc[1] = 'f';
+			break;
+		case '\n':
+			esc[1] = 'n';
+			break;
+		case '\r':
+			esc[1] = 'r';
+			break;
+		case '\t':
+			esc[1] = 't';
+			break;
+		default:
+			if (c >= ' ') {
+				continue;
+			}
+			esc[1] = 'u';
+			esc[4] = hex[c >> 4];
+			esc[5] = hex[c & 0xf];
+			esc_len = sizeof(esc);
+			break;
+		}
+
+		/* Copy the unescaped characters in one go */
+		put(w, run, str - run);
+		put(w, esc, esc_len);
+		run = str + 1;
+	}
+
+	put(w, run, str - run);
+	put(w, "\"", 1);
+}
+
+static void put_key(struct nrf_cloud_json_writer *w, const char *key)
+{
+	uint8_t bit = 1 << w->depth;
+
+	if (w->err) {
+		return;
+	}
+
+	if (w->depth == 0) {
+		/* Members can only be added to an object */
+		w->err = -EINVAL;
+		return;
+	}
+
+	if (w->has_member & bit) {
+		put(w, ",", 1);
+	}
+	w->has_member |= bit;
+
+	put_str(w, key);
+	put(w, ":", 1);
+}
+
+void nrf_cloud_json_writer_init(struct nrf_cloud_json_writer *w, char *buf, size_t size)
+{
+	*w = (struct nrf_cloud_json_writer) {
+		.buf = buf,
+		.size = size,
+	};
+
+	if (buf && size == 0) {
+		w->err = -E2BIG;
+	}
+}
+
+void nrf_cloud_json_writer_obj_start(struct nrf_cloud_json_writer *w, const char *key)
+{
+	if (w->err) {
+		return;
+	}
+
+	/* Only the root object is without a key, and there is only one root object */
+	if ((key == NULL) != (w->depth == 0) || (key == NULL && w->len > 0) ||
+	    w->depth >= NRF_CLOUD_JSON_WRITER_DEPTH_MAX - 1) {
+		w->err = -EINVAL;
+		return;
+	}
+
+	if (key) {
+		put_key(w, key);
+	}
+
+	put(w, "{", 1);
+	w->depth++;
+	w->has_member &= ~(1 << w->depth);
+}
+
+void nrf_cloud_json_writer_obj_end(struct nrf_cloud_json_writer *w)
+{
+	if (w->err) {
+		return;
+	}
+
+	if (w->depth == 0) {
+		w->err = -EINVAL;
+		return;
+	}
+
+	put(w, "}", 1);
+	w->depth--;
+}
+
+void nrf_cloud_json_writer_str_add(struct nrf_cloud_json_writer *w, const char *key,
+				   const char *val)
+{
+	put_key(w, key);
+	put_str(w, val);
+}
+
+void nrf_cloud_json_writer_num_add(struct nrf_cloud_json_writer *w, const char *key,
+				   double val)
+{
+	char num[NUM_STR_SIZE];
+	int len;
+
+	/* Same formatting as cJSON: integers in the int range are printed as such, other
+	 * values with the shortest of 15 or 17 significant digits that reads back the same.
+	 */
+	if (isnan(val) || isinf(val)) {
+		len = snprintf(num, sizeof(num), "null");
+	} else if (val > INT_MIN && val < INT_MAX && val == (double)(int)val) {
+		len = snprintf(num, sizeof(num), "%d", (int)val);
+	} else {
+		len = snprintf(num, sizeof(num), "%1.15g", val);
+		if (len > 0 && (size_t)len < sizeof(num)) {
+			double test = strtod(num, NULL);
+
+			if (fabs(test - val) > fmax(fabs(test), fabs(val)) * DBL_EPSILON) {
+				len = snprintf(num, sizeof(num), "%1.17g", val);
+			}
+		}
+	}
+
+	if (len <= 0 || (size_t)len >= sizeof(num)) {
+		if (!w->err) {
+			w->err = -ENOMEM;
+		}
+		return;
+	}
+
+	put_key(w, key);
+	put(w, num, len);
+}
+
+void nrf_cloud_json_writer_int_add(struct nrf_cloud_json_writer *w, const char *key,
+				   int64_t val)
+{
+	char num[NUM_STR_SIZE];
+	int len = snprintf(num, sizeof(num), "%lld", (long long)val);
+
+	put_key(w, key);
+	put(w, num, len);
+}
+
+void nrf_cloud_json_writer_bool_add(struct nrf_cloud_json_writer *w, const char *key, bool val)
+{
+	put_key(w, key);
+	put(w, val ? "true" : "false", val ? 4 : 5);
+}
+
+void nrf_cloud_json_writer_null_add(struct nrf_cloud_json_writer *w, const char *key)
+{
+	put_key(w, key);
+	put(w, "null", 4);
+}
+
+int nrf_cloud_json_writer_finish(struct nrf_cloud_json_writer *w, size_t *len)
+{
+	if (!w->err && (w->depth != 0 || w->len == 0)) {
+		w->err = -EINVAL;
+	}
+
+	if (w->err) {
+		return w->err;
+	}
+
+	if (w->buf) {
+		w->buf[w->len] = '\0';
+	}
+
+	if (len) {
+		*len = w->len;
+	}
+
+	return 0;
+}
@@ -76,6 +76,8 @@ struct pgps_index {
 	uint8_t dl_pnum;
 	uint8_t pnum_offset;
 	uint8_t cur_pnum;
+	bool dl_skip;
+	uint32_t dl_sentinel;
 	bool partial_request;
 	bool stale_server_data;
 	int32_t storage_extent;
@@ -108,7 +110,16 @@ static off_t prediction_cache_flash_offset = UINT32_MAX;
 static uint8_t prediction_cache[PGPS_PREDICTION_STORAGE_SIZE];
 #endif
 
-static uint8_t prediction_buf[PGPS_PREDICTION_STORAGE_SIZE];
+/* Predictions are written to flash as they are received. Only the element being received,
+ * either the start of a prediction or one ephemeris, is kept in RAM.
+ */
+#define PREDICTION_HEAD_SIZE		sizeof(struct pgps_prediction_head)
+#define EPHEMERIS_SIZE			sizeof(struct nrf_cloud_agnss_ephemeris)
+
+BUILD_ASSERT(PREDICTION_HEAD_SIZE + NRF_CLOUD_PGPS_NUM_SV * EPHEMERIS_SIZE ==
+	     PGPS_PREDICTION_DL_SIZE, "Unexpected P-GPS prediction layout");
+
+static uint8_t element_buf[MAX(PREDICTION_HEAD_SIZE, EPHEMERIS_SIZE)];
 static volatile bool accept_packets;
 static volatile bool loading_in_progress;
 static volatile bool notified;
@@ -117,7 +128,7 @@ static int validate_stored_predictions(uint16_t *bad_day, uint32_t *bad_time);
 static void log_pgps_header(const char *msg, const struct nrf_cloud_pgps_header *header);
 static int consume_pgps_header(const char *buf, size_t buf_len);
 static void cache_pgps_header(const struct nrf_cloud_pgps_header *header);
-static int consume_pgps_data(uint8_t pnum, const char *buf, size_t buf_len);
+static int consume_pgps_data(const uint8_t *buf, size_t buf_len);
 static void prediction_work_handler(struct k_work *work);
 static void prediction_timer_handler(struct k_timer *dummy);
 static bool prediction_timer_is_running(void);
@@ -201,6 +212,49 @@ static struct nrf_cloud_pgps_prediction *get_prediction_slot(int slot, off_t *fl
 	return get_cached_prediction(off);
 }
 
+static int read_sentinel(off_t off, uint32_t *sentinel)
+{
+	off += offsetof(struct nrf_cloud_pgps_prediction, sentinel);
+
+#if defined(CONFIG_PM_PARTITION_REGION_PGPS_EXTERNAL)
+	return flash_area_read(prediction_flash_area, off - prediction_flash_area->fa_off,
+			       sentinel, sizeof(*sentinel));
+#else
+	memcpy(sentinel, (const void *)off, sizeof(*sentinel));
+	return 0;
+#endif
+}
+
+/**
+ * @brief Use the saved block index to determine which prediction is stored in a slot,
+ * reading only its sentinel instead of the whole prediction.
+ *
+ * The sentinel is written after the rest of the prediction, and the index is only updated
+ * once a prediction has been stored or validated, so a match means the slot holds the
+ * complete prediction for that time.
+ *
+ * @return Prediction number, or -ENOENT if the slot must be read and validated in full.
+ */
+static int find_indexed_prediction(int slot, off_t off)
+{
+	uint32_t expected = npgps_get_block_sentinel(slot);
+	uint32_t stored;
+	int64_t pred_sec = expected;
+
+	if ((expected == 0) || (expected == UINT32_MAX) ||
+	    (pred_sec < index.start_sec) || (pred_sec >= index.end_sec) ||
+	    ((pred_sec - index.start_sec) % index.period_sec)) {
+		return -ENOENT;
+	}
+
+	if (read_sentinel(off, &stored) || (stored != expected)) {
+		LOG_DBG("Slot %d does not match index", slot);
+		return -ENOENT;
+	}
+
+	return (int)((pred_sec - index.start_sec) / index.period_sec);
+}
+
 static int determine_prediction_num(struct nrf_cloud_pgps_header *header,
 				    struct nrf_cloud_pgps_prediction *p)
 {
@@ -335,6 +389,10 @@ static int validate_stored_predictions(uint16_t *first_bad_day,
 	int64_t start_gps_sec = index.start_sec;
 	off_t off;
 	int64_t gps_sec;
+	bool indexed[NUM_PREDICTIONS] = {0};
+	int num_indexed = 0;
+	int num_stored = 0;
+	int64_t start_ms = k_uptime_get();
 
 	/* reset catalog of predictions */
 	discard_prediction_buffer();
@@ -346,6 +404,20 @@ static int validate_stored_predictions(uint16_t *first_bad_day,
 
 	/* build catalog of predictions by block */
 	for (i = 0; i < count; i++) {
+		if (IS_ENABLED(CONFIG_NRF_CLOUD_PGPS_STORAGE_INDEX)) {
+			off = storage_addr + i * PGPS_PREDICTION_STORAGE_SIZE;
+			pnum = find_indexed_prediction(i, off);
+			if ((pnum >= 0) && (index.predictions[pnum] == NULL)) {
+				index.predictions[pnum] = (struct nrf_cloud_pgps_prediction *)off;
+				indexed[pnum] = true;
+				num_indexed++;
+				num_stored++;
+				LOG_DBG("Prediction num:%u indexed at idx:%d, off:0x%lX",
+					pnum, i, (unsigned long) off);
+				continue;
+			}
+		}
+
 		pred = (struct nrf_cloud_pgps_prediction *)get_prediction_slot(i, &off);
 		if (pred == NULL) {
 			LOG_ERR("Prediction at idx:%d not accessible", i);
@@ -359,6 +431,7 @@ static int validate_stored_predictions(uint16_t *first_bad_day,
 				pred->time.time_full_s);
 		} else if (index.predictions[pnum] == NULL) {
 			index.predictions[pnum] = (struct nrf_cloud_pgps_prediction *)off;
+			num_stored++;
 			LOG_DBG("Prediction num:%u stored at idx:%d, off:0x%lX",
 				pnum, i, (unsigned long) off);
 		} else {
@@ -373,33 +446,41 @@ static int validate_stored_predictions(uint16_t *first_bad_day,
 		gps_sec = start_gps_sec + pnum * period_min * SEC_PER_MIN;
 		npgps_gps_sec_to_day_time(gps_sec, &gps_day, &gps_time_of_day);
 
-		pred = get_prediction(pnum);
-		if (pred == NULL) {
-			LOG_WRN("Prediction num:%u missing", pnum);
-			/* request partial data; download interrupted? */
-			*first_bad_day = gps_day;
-			*first_bad_time = gps_time_of_day;
-			break;
-		}
+		/* the sentinel of an indexed prediction already matched its time */
+		if (!indexed[pnum]) {
+			pred = get_prediction(pnum);
+			if (pred == NULL) {
+				LOG_WRN("Prediction num:%u missing", pnum);
+				/* request partial data; download interrupted? */
+				*first_bad_day = gps_day;
+				*first_bad_time = gps_time_of_day;
+				break;
+			}
 
-		err = validate_prediction(pred, gps_day, gps_time_of_day,
-					  period_min, true, false);
-		if (err) {
-			LOG_ERR("Prediction num:%u, gps_day:%u, "
-				"gps_time_of_day:%u is bad:%d; loc:%p",
-				pnum, gps_day, gps_time_of_day, err, pred);
-			/* request partial data; download interrupted? */
-			*first_bad_day = gps_day;
-			*first_bad_time = gps_time_of_day;
-			break;
+			err = validate_prediction(pred, gps_day, gps_time_of_day,
+						  period_min, true, false);
+			if (err) {
+				LOG_ERR("Prediction num:%u, gps_day:%u, "
+					"gps_time_of_day:%u is bad:%d; loc:%p",
+					pnum, gps_day, gps_time_of_day, err, pred);
+				/* request partial data; download interrupted? */
+				*first_bad_day = gps_day;
+				*first_bad_time = gps_time_of_day;
+				break;
+			}
 		}
 
 		i = get_prediction_block(pnum);
-		LOG_DBG("Prediction num:%u, loc:%p, blk:%d", pnum, pred, i);
-		__ASSERT(i != NO_BLOCK, "unexpected pointer value %p", pred);
+		LOG_DBG("Prediction num:%u, loc:%p, blk:%d", pnum, index.predictions[pnum], i);
+		__ASSERT(i != NO_BLOCK, "unexpected pointer value %p", index.predictions[pnum]);
 		npgps_mark_block_used(i, true);
+		npgps_set_block_sentinel(i, (uint32_t)gps_sec);
 	}
 
+	LOG_INF("Checked %d stored predictions in %d ms; %d from index, %d usable",
+		num_stored, (int)(k_uptime_get() - start_ms), num_indexed, pnum);
+	(void)npgps_save_block_index();
+
 	/* find first free block in flash, if any, after chronologicaly
 	 * last good prediction, if any; this is where any new downloads
 	 * should begin, to maintain a circularly arranged flash
@@ -1240,44 +1321,50 @@ static int open_storage(uint32_t offset, bool preserve)
 	return 0;
 }
 
-static int store_prediction(uint8_t *p, size_t len, uint32_t sentinel, bool last)
+static int store_prediction_head(const struct pgps_prediction_head *head)
 {
-	static bool first = true;
-	static uint8_t pad[PGPS_PREDICTION_PAD];
 	int err;
 	uint8_t schema = NRF_CLOUD_AGNSS_BIN_SCHEMA_VERSION;
-	size_t schema_offset = ((size_t) &((struct nrf_cloud_pgps_prediction *)0)->schema_version);
+	size_t schema_offset = offsetof(struct pgps_prediction_head, ephemeris_type);
 
-	if (first) {
-		memset(pad, 0xff, PGPS_PREDICTION_PAD);
-		first = false;
-	}
-
-	err = stream_flash_buffered_write(&stream, p, schema_offset, false);
+	err = stream_flash_buffered_write(&stream, (const uint8_t *)head, schema_offset, false);
 	if (err) {
 		LOG_ERR("Error writing pgps prediction:%d", err);
 		return err;
 	}
-	p += schema_offset;
-	len -= schema_offset;
 	err = stream_flash_buffered_write(&stream, &schema, sizeof(schema), false);
 	if (err) {
 		LOG_ERR("Error writing schema:%d", err);
 		return err;
 	}
-	err = stream_flash_buffered_write(&stream, p, len, false);
+	err = stream_flash_buffered_write(&stream, (const uint8_t *)head + schema_offset,
+					  sizeof(*head) - schema_offset, false);
 	if (err) {
 		LOG_ERR("Error writing pgps prediction:%d", err);
-		return err;
 	}
+	return err;
+}
+
+static int store_prediction_end(uint32_t sentinel, bool last)
+{
+	static bool first = true;
+	static uint8_t pad[PGPS_PREDICTION_PAD];
+	int err;
+
+	if (first) {
+		memset(pad, 0xff, PGPS_PREDICTION_PAD);
+		first = false;
+	}
+
 	err = stream_flash_buffered_write(&stream, (uint8_t *)&sentinel,
 					  sizeof(sentinel), false);
 	if (err) {
 		LOG_ERR("Error writing sentinel:%d", err);
+		return err;
 	}
 	err = stream_flash_buffered_write(&stream, pad, PGPS_PREDICTION_PAD, last);
 	if (err) {
-		LOG_ERR("Error writing sentinel:%d", err);
+		LOG_ERR("Error writing pad:%d", err);
 	}
 	return err;
 }
@@ -1290,7 +1377,6 @@ static int flush_storage(void)
 int nrf_cloud_pgps_process_update(uint8_t *buf, size_t len)
 {
 	int err;
-	size_t need;
 	int64_t gps_sec;
 
 	if (buf == NULL) {
@@ -1351,32 +1437,11 @@ int nrf_cloud_pgps_process_update(uint8_t *buf, size_t len)
 	/* assume cache is no longer valid */
 	discard_prediction_buffer();
 
-	need = MIN((PGPS_PREDICTION_DL_SIZE - index.pred_offset), len);
-	memcpy(&prediction_buf[index.pred_offset], buf, need);
-	LOG_DBG("need:%zd bytes; pred_offset:%u, fragment len:%zd, dl_ofs:%zd",
-		need, index.pred_offset, len, index.dl_offset);
-
-	len -= need;
-	buf += need;
-	index.pred_offset += need;
-	index.dl_offset += need;
-
-	if (index.pred_offset == PGPS_PREDICTION_DL_SIZE) {
-		LOG_DBG("consuming data prediction num:%u, remainder:%zd",
-			index.dl_pnum, len);
-		err = consume_pgps_data(index.dl_pnum, prediction_buf,
-					PGPS_PREDICTION_DL_SIZE);
-		if (err) {
-			return err;
-		}
-		if (len) { /* keep extra data for next time */
-			memcpy(prediction_buf, buf, len);
-		}
-		index.pred_offset = len;
-		index.dl_pnum++;
-	}
+	LOG_DBG("pred_offset:%u, fragment len:%zd, dl_ofs:%u",
+		index.pred_offset, len, index.dl_offset);
+
 	index.dl_offset += len;
-	return 0;
+	return consume_pgps_data(buf, len);
 }
 
 static int consume_pgps_header(const char *buf, size_t buf_len)
@@ -1411,200 +1476,222 @@ static void cache_pgps_header(const struct nrf_cloud_pgps_header *header)
 			(int64_t)index.period_sec * index.header.prediction_count;
 }
 
-static size_t get_next_pgps_element(struct nrf_cloud_agnss_element *element,
-				    const char *buf)
+static int consume_prediction_head(uint8_t pnum, const struct pgps_prediction_head *head)
 {
-	static uint16_t elements_left_to_process;
-	static enum nrf_cloud_agnss_type element_type;
-	size_t len = 0;
+	int64_t gps_sec;
+	int err;
 
-	/* Check if there are more elements left in the array to process.
-	 * The element type is only given once before the array, and not for
-	 * each element.
-	 */
-	if (elements_left_to_process == 0) {
-		element->type = (enum nrf_cloud_agnss_type)
-				buf[NRF_CLOUD_AGNSS_BIN_TYPE_OFFSET];
-		element_type = element->type;
-		elements_left_to_process =
-			*(uint16_t *)&buf[NRF_CLOUD_AGNSS_BIN_COUNT_OFFSET] - 1;
-		len += NRF_CLOUD_AGNSS_BIN_TYPE_SIZE +
-			NRF_CLOUD_AGNSS_BIN_COUNT_SIZE;
-	} else {
-		element->type = element_type;
-		elements_left_to_process -= 1;
-	}
-
-	switch (element->type) {
-	case NRF_CLOUD_AGNSS_GPS_EPHEMERIDES:
-		element->ephemeris = (struct nrf_cloud_agnss_ephemeris *)(buf + len);
-		len += sizeof(struct nrf_cloud_agnss_ephemeris);
-		break;
-	case NRF_CLOUD_AGNSS_GPS_SYSTEM_CLOCK:
-		element->time_and_tow =
-			(struct nrf_cloud_agnss_system_time *)(buf + len);
-		len += sizeof(struct nrf_cloud_agnss_system_time) -
-			sizeof(element->time_and_tow->sv_tow) + 4;
-		break;
-	default:
-		LOG_DBG("Unhandled P-GPS data type:%d", element->type);
+	/* skip the rest of the prediction unless it is stored */
+	index.dl_skip = true;
+
+	LOG_DBG("Parsing prediction num:%u, idx:%u, type:%u, count:%u",
+		pnum, index.loading_count, head->time_type, head->time_count);
+
+	if ((head->time_type != NRF_CLOUD_AGNSS_GPS_SYSTEM_CLOCK) ||
+	    (head->time_count != 1) ||
+	    (head->ephemeris_type != NRF_CLOUD_AGNSS_GPS_EPHEMERIDES) ||
+	    (head->ephemeris_count != NRF_CLOUD_PGPS_NUM_SV)) {
+		LOG_ERR("Prediction did not include GPS day and time of day, "
+			"or ephemerides; ignoring");
+		LOG_HEXDUMP_DBG(head, sizeof(*head), "bad data");
 		return 0;
 	}
 
-#if PGPS_DEBUG
-	LOG_DBG("  size:%zd, count:%u", len, elements_left_to_process);
-#endif
-	return len;
+	if (pnum >= NUM_PREDICTIONS) {
+		LOG_ERR("Unexpected prediction num:%u; ignoring", pnum);
+		return 0;
+	}
+
+	if (index.predictions[pnum]) {
+		LOG_WRN("Received duplicate packet; ignoring");
+		return 0;
+	}
+
+	gps_sec = npgps_gps_day_time_to_sec(head->time.date_day, head->time.time_full_s);
+	LOG_INF("Storing prediction num:%u idx:%u for gps sec:%d",
+		pnum, index.loading_count, (int32_t)gps_sec);
+
+	err = store_prediction_head(head);
+	if (err) {
+		LOG_ERR("Error storing prediction:%d", err);
+		return err;
+	}
+
+	index.dl_sentinel = (uint32_t)gps_sec;
+	index.dl_skip = false;
+	return 0;
 }
 
-static int consume_pgps_data(uint8_t pnum, const char *buf, size_t buf_len)
+static int consume_ephemeris(struct nrf_cloud_agnss_ephemeris *ephemeris)
 {
-	struct nrf_cloud_agnss_element element = {};
-	uint8_t *prediction_ptr = (uint8_t *)buf;
-	uint8_t *element_ptr = prediction_ptr;
-	struct agnss_header *elem = (struct agnss_header *)element_ptr;
-	size_t parsed_len = 0;
-	int64_t gps_sec;
-	bool finished = false;
-	int err = 0;
+	const uint8_t *p = (const uint8_t *)ephemeris;
+	bool empty = true;
+	int err;
+
+	if (index.dl_skip) {
+		return 0;
+	}
 
-	gps_sec = 0;
+	/* check for all zeros except first byte (sv_id) */
+	for (int i = 1; i < sizeof(*ephemeris); i++) {
+		if (p[i] != 0) {
+			empty = false;
+			break;
+		}
+	}
+	if (empty) {
+		LOG_DBG("Marking ephemeris:%u as empty", ephemeris->sv_id);
+		ephemeris->health = NRF_CLOUD_PGPS_EMPTY_EPHEM_HEALTH;
+	}
+
+	err = stream_flash_buffered_write(&stream, p, sizeof(*ephemeris), false);
+	if (err) {
+		LOG_ERR("Error writing pgps prediction:%d", err);
+	}
+	return err;
+}
 
-	LOG_DBG("Parsing prediction num:%u, idx:%u, type:%u, count:%u, buf len:%u",
-		pnum, index.loading_count, elem->type, elem->count, buf_len);
+static int consume_prediction_end(uint8_t pnum)
+{
+	bool finished;
+	int err;
 
-	while (parsed_len < buf_len) {
-		bool empty;
-		size_t element_size = get_next_pgps_element(&element, element_ptr);
+	if (index.dl_skip) {
+		return 0;
+	}
 
-		if (element_size == 0) {
-			LOG_DBG("  End of element");
-			break;
+	index.loading_count++;
+	finished = (index.loading_count == index.expected_count);
+	err = store_prediction_end(index.dl_sentinel, finished || (index.storage_extent == 1));
+	if (err) {
+		LOG_ERR("Error storing prediction:%d", err);
+		return err;
+	}
+	index.predictions[pnum] = npgps_block_to_pointer(index.store_block);
+	npgps_set_block_sentinel(index.store_block, index.dl_sentinel);
+
+	if (!finished) {
+		if (loading_in_progress && !notified && (index.loading_count > 1)) {
+			notified = true;
+			nrf_cloud_pgps_notify_prediction();
 		}
-		switch (element.type) {
-		case NRF_CLOUD_AGNSS_GPS_SYSTEM_CLOCK:
-			gps_sec = npgps_gps_day_time_to_sec(element.time_and_tow->date_day,
-							    element.time_and_tow->time_full_s);
-			break;
-		case NRF_CLOUD_AGNSS_GPS_EPHEMERIDES:
-			/* check for all zeros except first byte (sv_id) */
-			empty = true;
-			for (int i = 1; i < sizeof(struct nrf_cloud_agnss_ephemeris); i++) {
-				if (element_ptr[i] != 0) {
-					empty = false;
-					break;
-				}
-			}
-			if (empty) {
-				LOG_DBG("Marking ephemeris:%u as empty",
-					element.ephemeris->sv_id);
-				element.ephemeris->health = NRF_CLOUD_PGPS_EMPTY_EPHEM_HEALTH;
-			}
-			break;
-		default: /* just store */
-			break;
+
+		if (evt_handler) {
+			struct nrf_cloud_pgps_event evt = {
+				.type = PGPS_EVT_LOADING,
+			};
+
+			evt_handler(&evt);
 		}
+	} else {
+		if (loading_in_progress && !notified) {
+			notified = true;
+			nrf_cloud_pgps_notify_prediction();
+		}
+
+		LOG_INF("All P-GPS data received. Done.");
+		(void)npgps_save_block_index();
+		state = PGPS_READY;
+		if (evt_handler) {
+			struct nrf_cloud_pgps_event evt = {
+				.type = PGPS_EVT_READY,
+				.prediction = NULL
+			};
 
-		parsed_len += element_size;
-		element_ptr += element_size;
+			evt_handler(&evt);
+		}
+		npgps_print_blocks();
+		return 0;
 	}
 
-	if (parsed_len == buf_len) {
-		LOG_DBG("Parsing finished");
+	index.store_block = npgps_alloc_block();
+	if (index.store_block == NO_BLOCK) {
+		LOG_ERR("No more free blocks!");
+		return -ENOMEM;
+	}
+	index.storage_extent--;
+	if (index.storage_extent == 0) {
+		index.storage_extent = npgps_get_block_extent(index.store_block);
+		LOG_DBG("Moving to new flash region:%d, len:%d",
+			index.store_block, index.storage_extent);
+		err = flush_storage();
+		if (err) {
+			LOG_ERR("Error flushing storage:%d", err);
+			return err;
+		}
+		err = open_storage(npgps_block_to_offset(index.store_block),
+				   false);
+		if (err) {
+			LOG_ERR("Error opening storage again:%d", err);
+			return err;
+		}
+	} else if (index.storage_extent < 0) {
+		LOG_ERR("Unexpected storage extent:%d", index.storage_extent);
+		return -ENOMEM;
+	}
 
-		if (index.predictions[pnum]) {
-			LOG_WRN("Received duplicate packet; ignoring");
-		} else if (gps_sec == 0) {
-			LOG_ERR("Prediction did not include GPS day and time of day; ignoring");
-			LOG_HEXDUMP_DBG(prediction_ptr, buf_len, "bad data");
-		} else {
-			LOG_INF("Storing prediction num:%u idx:%u for gps sec:%d",
-				pnum, index.loading_count, (int32_t)gps_sec);
+	return 0;
+}
 
-			index.loading_count++;
-			finished = (index.loading_count == index.expected_count);
-			err = store_prediction(prediction_ptr, buf_len, (uint32_t)gps_sec,
-					       finished || (index.storage_extent == 1));
-			if (err) {
-				LOG_ERR("Error storing prediction:%d", err);
-				goto fail;
-			}
-			index.predictions[pnum] = npgps_block_to_pointer(index.store_block);
+/**
+ * @brief Parse downloaded prediction data and write it to flash as it arrives.
+ *
+ * The data is split into the start of each prediction, which must be checked before the
+ * prediction is stored, and its ephemerides. Each of these is gathered in element_buf,
+ * since it can span fragments, and then written through the flash stream, which only
+ * writes whole flash pages.
+ */
+static int consume_pgps_data(const uint8_t *buf, size_t buf_len)
+{
+	size_t elem_offset;
+	size_t elem_size;
+	size_t need;
+	int err = 0;
 
-			if (!finished) {
-				if (loading_in_progress && !notified && (index.loading_count > 1)) {
-					notified = true;
-					nrf_cloud_pgps_notify_prediction();
-				}
+	while (buf_len) {
+		if (index.pred_offset < PREDICTION_HEAD_SIZE) {
+			elem_offset = index.pred_offset;
+			elem_size = PREDICTION_HEAD_SIZE;
+		} else {
+			elem_offset = (index.pred_offset - PREDICTION_HEAD_SIZE) % EPHEMERIS_SIZE;
+			elem_size = EPHEMERIS_SIZE;
+		}
 
-				if (evt_handler) {
-					struct nrf_cloud_pgps_event evt = {
-						.type = PGPS_EVT_LOADING,
-					};
+		need = MIN(elem_size - elem_offset, buf_len);
+		memcpy(&element_buf[elem_offset], buf, need);
+		buf += need;
+		buf_len -= need;
+		index.pred_offset += need;
 
-					evt_handler(&evt);
-				}
-			} else {
-				if (loading_in_progress && !notified) {
-					notified = true;
-					nrf_cloud_pgps_notify_prediction();
-				}
+		if ((elem_offset + need) < elem_size) {
+			/* rest of the element is in the next fragment */
+			break;
+		}
 
-				LOG_INF("All P-GPS data received. Done.");
-				state = PGPS_READY;
-				if (evt_handler) {
-					struct nrf_cloud_pgps_event evt = {
-						.type = PGPS_EVT_READY,
-						.prediction = NULL
-					};
+		if (elem_size == PREDICTION_HEAD_SIZE) {
+			err = consume_prediction_head(index.dl_pnum,
+						      (struct pgps_prediction_head *)element_buf);
+		} else {
+			err = consume_ephemeris((struct nrf_cloud_agnss_ephemeris *)element_buf);
+		}
 
-					evt_handler(&evt);
-				}
-				npgps_print_blocks();
-				return 0;
-			}
+		if (!err && (index.pred_offset == PGPS_PREDICTION_DL_SIZE)) {
+			LOG_DBG("consumed data prediction num:%u, remainder:%zd",
+				index.dl_pnum, buf_len);
+			err = consume_prediction_end(index.dl_pnum);
+			index.pred_offset = 0;
+			index.dl_pnum++;
+		}
 
-			index.store_block = npgps_alloc_block();
-			if (index.store_block == NO_BLOCK) {
-				LOG_ERR("No more free blocks!");
-				err = -ENOMEM;
-				goto fail;
-			}
-			index.storage_extent--;
-			if (index.storage_extent == 0) {
-				index.storage_extent = npgps_get_block_extent(index.store_block);
-				LOG_DBG("Moving to new flash region:%d, len:%d",
-					index.store_block, index.storage_extent);
-				err = flush_storage();
-				if (err) {
-					LOG_ERR("Error flushing storage:%d", err);
-					goto fail;
-				}
-				err = open_storage(npgps_block_to_offset(index.store_block),
-						   false);
-				if (err) {
-					LOG_ERR("Error opening storage again:%d", err);
-					goto fail;
-				}
-			} else if (index.storage_extent < 0) {
-				LOG_ERR("Unexpected storage extent:%d", index.storage_extent);
-				err = -ENOMEM;
-				goto fail;
-			}
+		if (err) {
+			state = PGPS_NONE; /* Fatal error in managing flash storage.
+					    * Allow app to keep running w/o P-GPS.
+					    */
+			return err;
 		}
-	} else {
-		LOG_ERR("Parsing incomplete; aborting.");
-		err = -EINVAL;
-		goto fail;
 	}
 
 	return 0;
-
-fail:
-	state = PGPS_NONE; /* Fatal error in managing flash storage.
-			    * Allow app to keep running w/o P-GPS.
-			    */
-	return err;
 }
 
 int nrf_cloud_pgps_begin_update(void)
@@ -29,6 +29,8 @@ LOG_MODULE_DECLARE(nrf_cloud_pgps, CONFIG_NRF_CLOUD_GPS_LOG_LEVEL);
 #define SETTINGS_FULL_LOCATION			SETTINGS_NAME "/" SETTINGS_KEY_LOCATION
 #define SETTINGS_KEY_LEAP_SEC			"g2u_leap_sec"
 #define SETTINGS_FULL_LEAP_SEC			SETTINGS_NAME "/" SETTINGS_KEY_LEAP_SEC
+#define SETTINGS_KEY_BLOCK_INDEX		"block_index"
+#define SETTINGS_FULL_BLOCK_INDEX		SETTINGS_NAME "/" SETTINGS_KEY_BLOCK_INDEX
 
 struct block_pool {
 	int first_free;
@@ -45,6 +47,10 @@ static int gps_leap_seconds = GPS_TO_UTC_LEAP_SECONDS;
 static struct gps_location saved_location;
 static struct nrf_cloud_pgps_header saved_header;
 
+/* Sentinel of the prediction stored in each block, or 0 if not known */
+static uint32_t block_index[NUM_BLOCKS];
+static bool block_index_changed;
+
 static K_SEM_DEFINE(dl_active, 1, 1);
 
 static char dl_buf[2048];
@@ -105,6 +111,15 @@ static int settings_set(const char *key, size_t len_rd,
 			return 0;
 		}
 	}
+	if (IS_ENABLED(CONFIG_NRF_CLOUD_PGPS_STORAGE_INDEX) &&
+	    !strncmp(key, SETTINGS_KEY_BLOCK_INDEX,
+		     strlen(SETTINGS_KEY_BLOCK_INDEX)) &&
+	    (len_rd == sizeof(block_index))) {
+		if (read_cb(cb_arg, (void *)block_index, len_rd) == len_rd) {
+			LOG_DBG("Read block index");
+			return 0;
+		}
+	}
 	return -ENOTSUP;
 }
 
@@ -140,6 +155,22 @@ const struct nrf_cloud_pgps_header *npgps_get_saved_header(void)
 	return &saved_header;
 }
 
+int npgps_save_block_index(void)
+{
+	int ret = 0;
+
+	if (!IS_ENABLED(CONFIG_NRF_CLOUD_PGPS_STORAGE_INDEX) || !block_index_changed) {
+		return 0;
+	}
+
+	LOG_DBG("Saving block index");
+	ret = settings_save_one(SETTINGS_FULL_BLOCK_INDEX, block_index, sizeof(block_index));
+	if (!ret) {
+		block_index_changed = false;
+	}
+	return ret;
+}
+
 /* @TODO: consider rate-limiting these updates to reduce Flash wear */
 static int save_location(void)
 {
@@ -384,6 +415,21 @@ void npgps_mark_block_used(int block, bool used)
 	LOG_DBG("mark idx:%d = %u", block, used);
 }
 
+uint32_t npgps_get_block_sentinel(int block)
+{
+	__ASSERT((block >= 0) && (block < num_blocks), "block %d out of range", block);
+	return block_index[block];
+}
+
+void npgps_set_block_sentinel(int block, uint32_t sentinel)
+{
+	__ASSERT((block >= 0) && (block < num_blocks), "block %d out of range", block);
+	if (block_index[block] != sentinel) {
+		block_index[block] = sentinel;
+		block_index_changed = true;
+	}
+}
+
 void npgps_print_blocks(void)
 {
 	char map[num_blocks + 1];
@@ -14,11 +14,35 @@
 #include <zephyr/sys/util.h>
 #include <zephyr/sys/byteorder.h>
 #include <zephyr/sys/crc.h>
+#include <zephyr/sys/ring_buffer.h>
+#include <zephyr/sys/slist.h>
+
+#include <string.h>
 
 LOG_MODULE_REGISTER(nrf_rpc_uart, CONFIG_NRF_RPC_TR_LOG_LEVEL);
 
 #define CRC_SIZE sizeof(uint16_t)
 
+#define TX_WINDOW_SIZE CONFIG_NRF_RPC_UART_TX_WINDOW_SIZE
+
+/* Frames carry a sequence number only when more than one frame can wait for acknowledgment. */
+#define SEQ_ENABLED (IS_ENABLED(CONFIG_NRF_RPC_UART_RELIABLE) && (TX_WINDOW_SIZE > 1))
+#define SEQ_SIZE    (SEQ_ENABLED ? 1 : 0)
+#define SEQ_MASK    0x7fu
+/* Set in the first frame after the initialization to synchronize the receiver */
+#define SEQ_SYNC    0x80u
+
+/* Delimiters and the escaped acknowledgment payload */
+#define ACK_FRAME_MAX_SIZE (2 + 2 * CRC_SIZE)
+
+#if defined(CONFIG_NRF_RPC_UART_RELIABLE)
+#define ACK_WAITING_TIME CONFIG_NRF_RPC_UART_ACK_WAITING_TIME
+#define TX_ATTEMPTS	 CONFIG_NRF_RPC_UART_TX_ATTEMPTS
+#else
+#define ACK_WAITING_TIME 0
+#define TX_ATTEMPTS	 1
+#endif
+
 enum {
 	HDLC_CHAR_ESCAPE = 0x7d,
 	HDLC_CHAR_DELIMITER = 0x7e,
@@ -54,6 +78,42 @@ struct hdlc_decode_ctx {
 	uint16_t capacity;
 };
 
+enum tx_frame_state {
+	/* The frame slot is not used. */
+	TX_FRAME_FREE,
+	/* The frame waits in the TX queue. */
+	TX_FRAME_QUEUED,
+	/* The frame is being written to the UART. */
+	TX_FRAME_SENDING,
+	/* The frame has been written and waits for acknowledgment. */
+	TX_FRAME_SENT,
+	/* The frame has been completed and its buffer can be released. */
+	TX_FRAME_DONE,
+};
+
+struct tx_frame {
+	/* Required by the sys_slist */
+	sys_snode_t node;
+	/* HDLC encoded frame, including delimiters */
+	uint8_t *buf;
+	size_t len;
+	/* CRC field of the frame, echoed in the acknowledgment */
+	uint16_t crc;
+	uint8_t seq;
+	uint8_t attempts;
+	enum tx_frame_state state;
+	/* Time at which the frame is retransmitted if not acknowledged */
+	int64_t deadline;
+	/* Order in which the frames were written, used to retransmit them in the same order */
+	uint32_t order;
+};
+
+enum rx_seq_result {
+	RX_SEQ_NEW,
+	RX_SEQ_DUPLICATE,
+	RX_SEQ_OUT_OF_ORDER,
+};
+
 struct nrf_rpc_uart {
 	const struct device *uart;
 	nrf_rpc_tr_receive_handler_t receive_callback;
@@ -76,16 +136,56 @@ struct nrf_rpc_uart {
 
 	/* HDLC packet decoding state */
 	struct hdlc_decode_ctx rx_pkt_ctx;
+	/* Buffer of the packet being decoded: the RX ring buffer region or rx_pkt */
+	uint8_t *rx_pkt_buf;
+	/* CRC of the decoded bytes that precede the last CRC_SIZE ones */
+	uint16_t rx_pkt_crc;
+	uint16_t rx_pkt_crc_len;
+	/* Number of bytes of the frame being decoded in place that are kept in the ring buffer */
+	size_t rx_held;
 	uint8_t rx_pkt[CONFIG_NRF_RPC_UART_MAX_PACKET_SIZE];
 
-	/* Ack waiting semaphore */
-	struct k_sem ack_sem;
-	uint16_t ack_payload;
-	struct k_mutex ack_tx_lock;
 	struct trx_flips flips;
 
-	/* TX lock */
+	/* Next expected sequence number and synchronization state of the receiver */
+	uint8_t rx_seq;
+	bool rx_seq_synced;
+
+	/* TX lock, serializes the send() calls */
 	struct k_mutex tx_lock;
+
+	/* Protects the TX state shared with the UART ISR */
+	struct k_spinlock tx_spinlock;
+
+	/* Frames that have not been completed yet */
+	struct tx_frame tx_frames[TX_WINDOW_SIZE];
+	/* Counts free frame slots */
+	struct k_sem tx_slots;
+	/* Queue of frames to be written to the UART */
+	sys_slist_t tx_queue;
+	/* Frame currently written to the UART and the number of its bytes written so far */
+	struct tx_frame *tx_cur;
+	size_t tx_cur_off;
+	uint32_t tx_order;
+	/* Sequence number of the next frame */
+	uint8_t tx_seq;
+	/* Whether the receiver has acknowledged a frame since the last synchronization */
+	bool tx_seq_synced;
+	/* Whether the first frame has been acknowledged and all frame slots are available */
+	bool tx_window_open;
+	/* Frame slots kept out of the window until the receiver is synchronized */
+	uint8_t tx_slots_closed;
+	/* Frame slots to keep out of the window when they are released */
+	uint8_t tx_slots_closing;
+	/* Error of a frame that could not be delivered, reported by the next send() */
+	int tx_error;
+
+	/* Encoded acknowledgments, written between frames */
+	uint8_t tx_ack_buffer[ACK_FRAME_MAX_SIZE * (TX_WINDOW_SIZE + 1)];
+	struct ring_buf tx_ack_ringbuf;
+
+	/* Retransmission of frames that have not been acknowledged in time */
+	struct k_work_delayable retx_work;
 };
 
 static void log_hexdump_dbg(const uint8_t *data, size_t length, const char *fmt, ...)
@@ -102,10 +202,102 @@ static void log_hexdump_dbg(const uint8_t *data, size_t length, const char *fmt,
 	}
 }
 
-static void send_byte(const struct device *dev, uint8_t byte);
+static size_t hdlc_encoded_len(const uint8_t *data, size_t len)
+{
+	size_t out_len = len;
+
+	for (size_t i = 0; i < len; i++) {
+		if (data[i] == HDLC_CHAR_DELIMITER || data[i] == HDLC_CHAR_ESCAPE) {
+			out_len++;
+		}
+	}
+
+	return out_len;
+}
+
+static uint8_t *hdlc_encode(uint8_t *out, const uint8_t *data, size_t len)
+{
+	for (size_t i = 0; i < len; i++) {
+		uint8_t byte = data[i];
+
+		if (byte == HDLC_CHAR_DELIMITER || byte == HDLC_CHAR_ESCAPE) {
+			*out++ = HDLC_CHAR_ESCAPE;
+			byte ^= 0x20;
+		}
+
+		*out++ = byte;
+	}
+
+	return out;
+}
+
+static bool tx_frame_pending(const struct tx_frame *frame)
+{
+	return frame->state == TX_FRAME_QUEUED || frame->state == TX_FRAME_SENDING ||
+	       frame->state == TX_FRAME_SENT;
+}
+
+/* Must be called with the tx_spinlock held. */
+static void tx_queue_put(struct nrf_rpc_uart *uart_tr, struct tx_frame *frame)
+{
+	frame->state = TX_FRAME_QUEUED;
+	sys_slist_append(&uart_tr->tx_queue, &frame->node);
+}
+
+/* Must be called with the tx_spinlock held. */
+static void tx_slot_release(struct nrf_rpc_uart *uart_tr)
+{
+	if (uart_tr->tx_slots_closing > 0) {
+		uart_tr->tx_slots_closing--;
+		uart_tr->tx_slots_closed++;
+		return;
+	}
+
+	k_sem_give(&uart_tr->tx_slots);
+}
+
+/* Must be called with the tx_spinlock held. */
+static void tx_frame_complete(struct nrf_rpc_uart *uart_tr, struct tx_frame *frame)
+{
+	if (frame->state == TX_FRAME_QUEUED) {
+		sys_slist_find_and_remove(&uart_tr->tx_queue, &frame->node);
+	}
+
+	frame->state = TX_FRAME_DONE;
+
+	/* The slot of the frame being written is released when the write ends. */
+	if (frame != uart_tr->tx_cur) {
+		tx_slot_release(uart_tr);
+	}
+}
+
+/* Must be called with the tx_spinlock held. */
+static void tx_frame_sent(struct nrf_rpc_uart *uart_tr, struct tx_frame *frame)
+{
+	if (frame->state == TX_FRAME_DONE) {
+		/* Acknowledged while being written */
+		tx_slot_release(uart_tr);
+		return;
+	}
+
+	if (!IS_ENABLED(CONFIG_NRF_RPC_UART_RELIABLE)) {
+		tx_frame_complete(uart_tr, frame);
+		return;
+	}
+
+	frame->state = TX_FRAME_SENT;
+	frame->order = uart_tr->tx_order++;
+	frame->deadline = k_uptime_get() + ACK_WAITING_TIME;
+
+	k_work_schedule_for_queue(&uart_tr->rx_workq, &uart_tr->retx_work,
+				  K_MSEC(ACK_WAITING_TIME));
+}
 
 static void ack_rx(struct nrf_rpc_uart *uart_tr)
 {
+	struct tx_frame *acked = NULL;
+	k_spinlock_key_t key;
+
 	if (!IS_ENABLED(CONFIG_NRF_RPC_UART_RELIABLE) || uart_tr->rx_ack_ctx.len != CRC_SIZE) {
 		log_hexdump_dbg(uart_tr->rx_ack, uart_tr->rx_ack_ctx.len, ">>> RX invalid frame");
 		return;
@@ -115,39 +307,242 @@ static void ack_rx(struct nrf_rpc_uart *uart_tr)
 
 	LOG_DBG(">>> RX ack %04x", rx_ack);
 
-	if (uart_tr->ack_payload != rx_ack) {
-		LOG_WRN("Received ack %04x but expected %04x", rx_ack, uart_tr->ack_payload);
-		return;
+	key = k_spin_lock(&uart_tr->tx_spinlock);
+
+	for (size_t i = 0; i < TX_WINDOW_SIZE; i++) {
+		if (tx_frame_pending(&uart_tr->tx_frames[i]) &&
+		    uart_tr->tx_frames[i].crc == rx_ack) {
+			acked = &uart_tr->tx_frames[i];
+			break;
+		}
+	}
+
+	if (acked && SEQ_ENABLED) {
+		/* Frames are delivered in order, so the frames sent before are acknowledged too. */
+		for (size_t i = 0; i < TX_WINDOW_SIZE; i++) {
+			struct tx_frame *frame = &uart_tr->tx_frames[i];
+
+			if (tx_frame_pending(frame) &&
+			    ((acked->seq - frame->seq) & SEQ_MASK) < TX_WINDOW_SIZE) {
+				tx_frame_complete(uart_tr, frame);
+			}
+		}
+
+		if (!uart_tr->tx_window_open) {
+			/* The receiver is synchronized, open the whole window. */
+			uart_tr->tx_window_open = true;
+			uart_tr->tx_slots_closing = 0;
+			for (; uart_tr->tx_slots_closed > 0; uart_tr->tx_slots_closed--) {
+				k_sem_give(&uart_tr->tx_slots);
+			}
+		}
+
+		uart_tr->tx_seq_synced = true;
+	} else if (acked) {
+		tx_frame_complete(uart_tr, acked);
 	}
 
-	k_sem_give(&uart_tr->ack_sem);
+	k_spin_unlock(&uart_tr->tx_spinlock, key);
+
+	if (!acked) {
+		LOG_WRN("Received unexpected ack %04x", rx_ack);
+	}
 }
 
 static void ack_tx(struct nrf_rpc_uart *uart_tr, uint16_t ack_pld)
 {
-	uint8_t ack[2];
+	uint8_t ack[ACK_FRAME_MAX_SIZE];
+	uint8_t crc[CRC_SIZE];
+	uint8_t *end;
+	k_spinlock_key_t key;
+	bool queued;
 
 	if (!IS_ENABLED(CONFIG_NRF_RPC_UART_RELIABLE)) {
 		return;
 	}
 
-	sys_put_le16(ack_pld, ack);
-	k_mutex_lock(&uart_tr->ack_tx_lock, K_FOREVER);
+	sys_put_le16(ack_pld, crc);
+
+	ack[0] = HDLC_CHAR_DELIMITER;
+	end = hdlc_encode(&ack[1], crc, sizeof(crc));
+	*end++ = HDLC_CHAR_DELIMITER;
+
 	LOG_DBG("<<< TX ack %04x", ack_pld);
 
-	uart_poll_out(uart_tr->uart, HDLC_CHAR_DELIMITER);
+	/* Acknowledgments are written by the UART ISR between frames. */
+	key = k_spin_lock(&uart_tr->tx_spinlock);
+	queued = ring_buf_space_get(&uart_tr->tx_ack_ringbuf) >= (end - ack);
+	if (queued) {
+		ring_buf_put(&uart_tr->tx_ack_ringbuf, ack, end - ack);
+	}
+	k_spin_unlock(&uart_tr->tx_spinlock, key);
+
+	if (!queued) {
+		LOG_WRN("No space for ack %04x", ack_pld);
+		return;
+	}
+
+	uart_irq_tx_enable(uart_tr->uart);
+}
+
+static void retx_work_handler(struct k_work *work)
+{
+	struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+	struct nrf_rpc_uart *uart_tr = CONTAINER_OF(dwork, struct nrf_rpc_uart, retx_work);
+	int64_t now = k_uptime_get();
+	int64_t next = INT64_MAX;
+	size_t retransmitted = 0;
+	size_t dropped = 0;
+	bool go_back = false;
+	k_spinlock_key_t key;
+
+	key = k_spin_lock(&uart_tr->tx_spinlock);
+
+	/* Requeue the expired frames in the order in which they were written. */
+	while (true) {
+		struct tx_frame *oldest = NULL;
+
+		for (size_t i = 0; i < TX_WINDOW_SIZE; i++) {
+			struct tx_frame *frame = &uart_tr->tx_frames[i];
+
+			if (frame->state == TX_FRAME_SENT && (frame->deadline <= now || go_back) &&
+			    (!oldest || (int32_t)(frame->order - oldest->order) < 0)) {
+				oldest = frame;
+			}
+		}
+
+		if (!oldest) {
+			break;
+		}
+
+		if (go_back) {
+			tx_queue_put(uart_tr, oldest);
+			retransmitted++;
+			continue;
+		}
+
+		/* The receiver drops the frames following a lost one, so resend them as well.
+		 * Only the lost frame uses up its attempts.
+		 */
+		go_back = SEQ_ENABLED;
+		oldest->attempts++;
+
+		if (oldest->attempts < TX_ATTEMPTS) {
+			tx_queue_put(uart_tr, oldest);
+			retransmitted++;
+		} else if (SEQ_ENABLED) {
+			/* The receiver will not accept the frames following the lost one either.
+			 * Give up the whole window and synchronize the receiver with the next frame.
+			 * Until that frame is acknowledged, it is the only one in flight, so that
+			 * the receiver is not synchronized again by a later or retransmitted frame.
+			 */
+			if (uart_tr->tx_window_open) {
+				uart_tr->tx_window_open = false;
+				uart_tr->tx_slots_closing = TX_WINDOW_SIZE - 1;
+			}
+
+			while (uart_tr->tx_slots_closing > 0 &&
+			       k_sem_take(&uart_tr->tx_slots, K_NO_WAIT) == 0) {
+				uart_tr->tx_slots_closing--;
+				uart_tr->tx_slots_closed++;
+			}
+
+			for (size_t i = 0; i < TX_WINDOW_SIZE; i++) {
+				if (tx_frame_pending(&uart_tr->tx_frames[i])) {
+					tx_frame_complete(uart_tr, &uart_tr->tx_frames[i]);
+					dropped++;
+				}
+			}
+
+			uart_tr->tx_error = -EPROTO;
+			uart_tr->tx_seq_synced = false;
+		} else {
+			uart_tr->tx_error = -EPROTO;
+			tx_frame_complete(uart_tr, oldest);
+			dropped++;
+		}
+	}
+
+	for (size_t i = 0; i < TX_WINDOW_SIZE; i++) {
+		if (uart_tr->tx_frames[i].state == TX_FRAME_SENT) {
+			next = MIN(next, uart_tr->tx_frames[i].deadline);
+		}
+	}
 
-	send_byte(uart_tr->uart, ack[0]);
-	send_byte(uart_tr->uart, ack[1]);
+	k_spin_unlock(&uart_tr->tx_spinlock, key);
+
+	if (retransmitted > 0) {
+		LOG_WRN("Ack timeout, retransmitting %zu frames", retransmitted);
+		uart_irq_tx_enable(uart_tr->uart);
+	}
 
-	uart_poll_out(uart_tr->uart, HDLC_CHAR_DELIMITER);
+	if (dropped > 0) {
+		LOG_ERR("%zu frames not acknowledged", dropped);
+	}
 
-	k_mutex_unlock(&uart_tr->ack_tx_lock);
+	if (next != INT64_MAX) {
+		k_work_schedule_for_queue(&uart_tr->rx_workq, &uart_tr->retx_work,
+					  K_MSEC(MAX(next - now, 0)));
+	}
+}
+
+/* Write the pending acknowledgments and the queued frames to the UART. Called from the ISR. */
+static bool tx_fill(struct nrf_rpc_uart *uart_tr)
+{
+	struct tx_frame *frame;
+	k_spinlock_key_t key;
+	uint8_t *ack;
+	uint32_t ack_len;
+	int written = 0;
+
+	key = k_spin_lock(&uart_tr->tx_spinlock);
+
+	frame = uart_tr->tx_cur;
+
+	if (frame == NULL) {
+		/* Acknowledgments are not delayed behind the queued frames. */
+		ack_len = ring_buf_get_claim(&uart_tr->tx_ack_ringbuf, &ack,
+					     sizeof(uart_tr->tx_ack_buffer));
+		if (ack_len > 0) {
+			written = uart_fifo_fill(uart_tr->uart, ack, ack_len);
+			ring_buf_get_finish(&uart_tr->tx_ack_ringbuf, MAX(written, 0));
+			goto out;
+		}
+
+		sys_snode_t *node = sys_slist_get(&uart_tr->tx_queue);
+
+		if (node == NULL) {
+			uart_irq_tx_disable(uart_tr->uart);
+			goto out;
+		}
+
+		frame = CONTAINER_OF(node, struct tx_frame, node);
+		frame->state = TX_FRAME_SENDING;
+		uart_tr->tx_cur = frame;
+		uart_tr->tx_cur_off = 0;
+	}
+
+	written = uart_fifo_fill(uart_tr->uart, frame->buf + uart_tr->tx_cur_off,
+				 frame->len - uart_tr->tx_cur_off);
+	if (written > 0) {
+		uart_tr->tx_cur_off += written;
+	}
+
+	if (uart_tr->tx_cur_off == frame->len) {
+		uart_tr->tx_cur = NULL;
+		tx_frame_sent(uart_tr, frame);
+	}
+
+out:
+	k_spin_unlock(&uart_tr->tx_spinlock, key);
+
+	return written > 0;
 }
 
 static uint16_t tx_flip(struct nrf_rpc_uart *uart_tr, uint16_t crc_val)
 {
-	if (!IS_ENABLED(CONFIG_NRF_RPC_UART_RELIABLE)) {
+	/* The sequence number makes the flip bit redundant. */
+	if (!IS_ENABLED(CONFIG_NRF_RPC_UART_RELIABLE) || SEQ_ENABLED) {
 		return crc_val;
 	}
 
@@ -181,9 +576,46 @@ static bool rx_flip_check(struct nrf_rpc_uart *uart_tr, uint16_t crc_val)
 	return true;
 }
 
+static enum rx_seq_result rx_seq_check(struct nrf_rpc_uart *uart_tr, uint8_t seq,
+					     uint16_t crc_val)
+{
+	uint8_t distance;
+
+	if (seq & SEQ_SYNC) {
+		seq &= SEQ_MASK;
+
+		/* A retransmitted synchronization frame is a duplicate, not a new sequence. */
+		if (uart_tr->rx_seq_synced && ((uart_tr->rx_seq - seq) & SEQ_MASK) == 1 &&
+		    uart_tr->flips.last_rx_crc == crc_val) {
+			return RX_SEQ_DUPLICATE;
+		}
+
+		uart_tr->rx_seq = seq;
+		uart_tr->rx_seq_synced = true;
+	}
+
+	if (!uart_tr->rx_seq_synced) {
+		return RX_SEQ_OUT_OF_ORDER;
+	}
+
+	if (seq == uart_tr->rx_seq) {
+		uart_tr->rx_seq = (seq + 1) & SEQ_MASK;
+		uart_tr->flips.last_rx_crc = crc_val;
+		return RX_SEQ_NEW;
+	}
+
+	/* Frames from the current window are retransmitted if their acknowledgment was lost. */
+	distance = (uart_tr->rx_seq - seq) & SEQ_MASK;
+	if (distance <= TX_WINDOW_SIZE) {
+		return RX_SEQ_DUPLICATE;
+	}
+
+	return RX_SEQ_OUT_OF_ORDER;
+}
+
 static bool crc_compare(uint16_t rx_crc, uint16_t calc_crc)
 {
-	if (IS_ENABLED(CONFIG_NRF_RPC_UART_RELIABLE)) {
+	if (IS_ENABLED(CONFIG_NRF_RPC_UART_RELIABLE) && !SEQ_ENABLED) {
 		return (rx_crc & 0x7fffu) == (calc_crc & 0x7fffu);
 	}
 
@@ -229,60 +661,195 @@ static void hdlc_decode_byte(struct hdlc_decode_ctx *ctx, uint8_t *out, uint8_t
 	out[ctx->len++] = in;
 }
 
-static void work_handler(struct k_work *work)
+static void rx_frame_process(struct nrf_rpc_uart *uart_tr, const uint8_t *frame, size_t len)
 {
-	struct nrf_rpc_uart *uart_tr = CONTAINER_OF(work, struct nrf_rpc_uart, rx_work);
-	uint8_t *data;
-	size_t len;
-	int ret;
-	uint16_t crc_received = 0;
-	uint16_t crc_calculated = 0;
+	uint16_t crc_received;
+	uint16_t crc_calculated;
 
-	while (!ring_buf_is_empty(&uart_tr->rx_ringbuf)) {
-		len = ring_buf_get_claim(&uart_tr->rx_ringbuf, &data,
-					 CONFIG_NRF_RPC_UART_MAX_PACKET_SIZE);
-		for (size_t i = 0; i < len; i++) {
-			hdlc_decode_byte(&uart_tr->rx_pkt_ctx, uart_tr->rx_pkt, data[i]);
+	/* ACKs are already handled in ISR, so process only normal packets here */
+	if (len <= CRC_SIZE) {
+		return;
+	}
 
-			if (uart_tr->rx_pkt_ctx.state != HDLC_STATE_FRAME_FOUND) {
-				continue;
-			}
+	len -= CRC_SIZE;
+	crc_received = sys_get_le16(frame + len);
+	crc_calculated = uart_tr->rx_pkt_crc;
 
-			/* ACKs are already handled in ISR, so process only normal packets here */
-			if (uart_tr->rx_pkt_ctx.len <= CRC_SIZE) {
-				continue;
-			}
+	log_hexdump_dbg(frame, len, ">>> RX packet %04x", crc_received);
+
+	if (!crc_compare(crc_received, crc_calculated)) {
+		LOG_ERR("Invalid packet CRC: calculated %04x but received %04x", crc_calculated,
+			crc_received);
+		return;
+	}
+
+	if (SEQ_ENABLED) {
+		switch (rx_seq_check(uart_tr, frame[0], crc_received)) {
+		case RX_SEQ_NEW:
+			ack_tx(uart_tr, crc_received);
+			uart_tr->receive_callback(uart_tr->transport, frame + SEQ_SIZE,
+						  len - SEQ_SIZE, uart_tr->receive_ctx);
+			break;
+		case RX_SEQ_DUPLICATE:
+			LOG_WRN("Duplicate packet %04x", crc_received);
+			ack_tx(uart_tr, crc_received);
+			break;
+		default:
+			/* Not acknowledged, the sender retransmits it after the lost one */
+			LOG_WRN("Out of order packet %04x", crc_received);
+			break;
+		}
+		return;
+	}
+
+	ack_tx(uart_tr, crc_received);
+
+	if (rx_flip_check(uart_tr, crc_received)) {
+		LOG_WRN("Duplicate packet %04x", crc_received);
+	} else {
+		uart_tr->receive_callback(uart_tr->transport, frame, len, uart_tr->receive_ctx);
+	}
+}
+
+/* Update the CRC with the decoded bytes, except for the last ones that may be the CRC field. */
+static void rx_crc_update(struct nrf_rpc_uart *uart_tr)
+{
+	uint16_t len = uart_tr->rx_pkt_ctx.len;
 
-			uart_tr->rx_pkt_ctx.len -= CRC_SIZE;
-			crc_received = sys_get_le16(uart_tr->rx_pkt + uart_tr->rx_pkt_ctx.len);
-			crc_calculated =
-				crc16_ccitt(0xffff, uart_tr->rx_pkt, uart_tr->rx_pkt_ctx.len);
+	if (len > uart_tr->rx_pkt_crc_len + CRC_SIZE) {
+		uart_tr->rx_pkt_crc = crc16_ccitt(uart_tr->rx_pkt_crc,
+						  uart_tr->rx_pkt_buf + uart_tr->rx_pkt_crc_len,
+						  len - CRC_SIZE - uart_tr->rx_pkt_crc_len);
+		uart_tr->rx_pkt_crc_len = len - CRC_SIZE;
+	}
+}
 
-			log_hexdump_dbg(uart_tr->rx_pkt, uart_tr->rx_pkt_ctx.len,
-					">>> RX packet %04x", crc_received);
+/* Move the frame being decoded in place to the packet buffer. */
+static void rx_frame_move(struct nrf_rpc_uart *uart_tr)
+{
+	memcpy(uart_tr->rx_pkt, uart_tr->rx_pkt_buf, uart_tr->rx_pkt_ctx.len);
+	uart_tr->rx_pkt_buf = uart_tr->rx_pkt;
+}
 
-			if (!crc_compare(crc_received, crc_calculated)) {
-				LOG_ERR("Invalid packet CRC: calculated %04x but received %04x",
-					crc_calculated, crc_received);
+static void rx_frame_start(struct nrf_rpc_uart *uart_tr, uint8_t *buf)
+{
+	uart_tr->rx_pkt_ctx.state = HDLC_STATE_FRAME;
+	uart_tr->rx_pkt_ctx.len = 0;
+	uart_tr->rx_pkt_buf = IS_ENABLED(CONFIG_NRF_RPC_UART_RX_IN_PLACE) ? buf : uart_tr->rx_pkt;
+	uart_tr->rx_pkt_crc = 0xffff;
+	uart_tr->rx_pkt_crc_len = 0;
+}
+
+/*
+ * Decode the new bytes, starting at the offset, of the claimed region of the RX ring buffer.
+ *
+ * The unescaped bytes are never longer than the escaped ones, so a frame is decoded in place,
+ * over the region, and passed to nRF RPC from there. A frame that is not complete yet is kept
+ * in the ring buffer, so that it continues in the next claimed region. Returns the number of
+ * bytes at the end of the region that must not be released.
+ */
+static size_t rx_decode(struct nrf_rpc_uart *uart_tr, uint8_t *data, size_t offset, size_t len)
+{
+	struct hdlc_decode_ctx *ctx = &uart_tr->rx_pkt_ctx;
+	size_t keep;
+
+	for (size_t i = offset; i < len; i++) {
+		uint8_t in = data[i];
+
+		switch (ctx->state) {
+		case HDLC_STATE_UNSYNC:
+			if (in == HDLC_CHAR_DELIMITER) {
+				rx_frame_start(uart_tr, &data[i + 1]);
+			}
+			continue;
+		case HDLC_STATE_FRAME:
+			if (in == HDLC_CHAR_DELIMITER) {
+				if (ctx->len > 0) {
+					rx_crc_update(uart_tr);
+					rx_frame_process(uart_tr, uart_tr->rx_pkt_buf, ctx->len);
+				}
+
+				rx_frame_start(uart_tr, &data[i + 1]);
+				continue;
+			} else if (in == HDLC_CHAR_ESCAPE) {
+				ctx->state = HDLC_STATE_ESCAPE;
 				continue;
 			}
+			break;
+		case HDLC_STATE_ESCAPE:
+			in ^= 0x20;
+			ctx->state = HDLC_STATE_FRAME;
+			break;
+		default:
+			break;
+		}
 
-			ack_tx(uart_tr, crc_received);
+		if (ctx->len >= ctx->capacity) {
+			/* Ignore too long frame */
+			ctx->state = HDLC_STATE_UNSYNC;
+			continue;
+		}
 
-			if (rx_flip_check(uart_tr, crc_received)) {
-				LOG_WRN("Duplicate packet %04x", crc_received);
-			} else {
-				uart_tr->receive_callback(uart_tr->transport, uart_tr->rx_pkt,
-							  uart_tr->rx_pkt_ctx.len,
-							  uart_tr->receive_ctx);
+		uart_tr->rx_pkt_buf[ctx->len++] = in;
+	}
+
+	if (ctx->state == HDLC_STATE_UNSYNC) {
+		return 0;
+	}
+
+	rx_crc_update(uart_tr);
+
+	if (uart_tr->rx_pkt_buf == uart_tr->rx_pkt) {
+		return 0;
+	}
+
+	/* Leave enough space in the ring buffer for the rest of the frame. */
+	keep = data + len - uart_tr->rx_pkt_buf;
+	if (keep <= sizeof(uart_tr->rx_buffer) / 2) {
+		return keep;
+	}
+
+	rx_frame_move(uart_tr);
+
+	return 0;
+}
+
+static void work_handler(struct k_work *work)
+{
+	struct nrf_rpc_uart *uart_tr = CONTAINER_OF(work, struct nrf_rpc_uart, rx_work);
+	size_t held = uart_tr->rx_held;
+	uint8_t *data;
+	size_t len;
+	int ret;
+
+	while (true) {
+		len = ring_buf_get_claim(&uart_tr->rx_ringbuf, &data, sizeof(uart_tr->rx_buffer));
+
+		if (held > 0) {
+			/* The claimed region starts with the frame that is being decoded. */
+			uart_tr->rx_pkt_buf = data;
+		}
+
+		if (len == held) {
+			if (held == 0 || ring_buf_size_get(&uart_tr->rx_ringbuf) == held) {
+				ring_buf_get_finish(&uart_tr->rx_ringbuf, 0);
+				break;
 			}
+
+			/* The frame wraps around the end of the ring buffer. */
+			rx_frame_move(uart_tr);
+			held = 0;
+		} else {
+			held = rx_decode(uart_tr, data, held, len);
 		}
 
-		ret = ring_buf_get_finish(&uart_tr->rx_ringbuf, len);
+		ret = ring_buf_get_finish(&uart_tr->rx_ringbuf, len - held);
 		if (ret < 0) {
 			LOG_DBG("Cannot flush ring buffer: %d", ret);
 		}
 	}
+
+	uart_tr->rx_held = held;
 }
 
 static void decode_ack(struct nrf_rpc_uart *inst, const uint8_t *in, size_t len)
@@ -303,7 +870,15 @@ static void serial_cb(const struct device *uart, void *user_data)
 	uint8_t *rx_buffer;
 	bool new_data = false;
 
-	while (uart_irq_update(uart) && uart_irq_rx_ready(uart)) {
+	while (uart_irq_update(uart)) {
+		if (!uart_irq_rx_ready(uart)) {
+			if (uart_irq_tx_ready(uart) && tx_fill(uart_tr)) {
+				continue;
+			}
+
+			break;
+		}
+
 		rx_len = ring_buf_put_claim(&uart_tr->rx_ringbuf, &rx_buffer,
 					    uart_tr->rx_ringbuf.size);
 		if (rx_len > 0) {
@@ -373,9 +948,15 @@ static int init(const struct nrf_rpc_tr *transport, nrf_rpc_tr_receive_handler_t
 
 	k_mutex_init(&uart_tr->tx_lock);
 
+	/* Until the receiver is synchronized, only one frame can wait for acknowledgment. */
+	k_sem_init(&uart_tr->tx_slots, SEQ_ENABLED ? 1 : TX_WINDOW_SIZE, TX_WINDOW_SIZE);
+	uart_tr->tx_slots_closed = SEQ_ENABLED ? TX_WINDOW_SIZE - 1 : 0;
+	sys_slist_init(&uart_tr->tx_queue);
+	ring_buf_init(&uart_tr->tx_ack_ringbuf, sizeof(uart_tr->tx_ack_buffer),
+		      uart_tr->tx_ack_buffer);
+	k_work_init_delayable(&uart_tr->retx_work, retx_work_handler);
+
 	if (IS_ENABLED(CONFIG_NRF_RPC_UART_RELIABLE)) {
-		k_mutex_init(&uart_tr->ack_tx_lock);
-		k_sem_init(&uart_tr->ack_sem, 0, 1);
 		uart_tr->flips.tx_flip = FLIP_ZERO;
 		uart_tr->flips.rx_flip_any = 1;
 	}
@@ -390,6 +971,7 @@ static int init(const struct nrf_rpc_tr *transport, nrf_rpc_tr_receive_handler_t
 
 	uart_tr->rx_pkt_ctx.state = HDLC_STATE_UNSYNC;
 	uart_tr->rx_pkt_ctx.capacity = sizeof(uart_tr->rx_pkt);
+	uart_tr->rx_pkt_buf = uart_tr->rx_pkt;
 	uart_tr->rx_ack_ctx.state = HDLC_STATE_UNSYNC;
 	uart_tr->rx_ack_ctx.capacity = sizeof(uart_tr->rx_ack);
 	uart_irq_rx_enable(uart_tr->uart);
@@ -398,70 +980,118 @@ static int init(const struct nrf_rpc_tr *transport, nrf_rpc_tr_receive_handler_t
 	return 0;
 }
 
-static void send_byte(const struct device *dev, uint8_t byte)
-{
-	if (byte == HDLC_CHAR_DELIMITER || byte == HDLC_CHAR_ESCAPE) {
-		uart_poll_out(dev, HDLC_CHAR_ESCAPE);
-		byte ^= 0x20;
-	}
-
-	uart_poll_out(dev, byte);
-}
-
 static int send(const struct nrf_rpc_tr *transport, const uint8_t *data, size_t length)
 {
-	uint8_t crc[2];
-	uint16_t crc_val;
-	bool acked = true;
 	struct nrf_rpc_uart *uart_tr = transport->ctx;
+	uint8_t *reclaimed[TX_WINDOW_SIZE];
+	size_t reclaimed_cnt = 0;
+	struct tx_frame *frame = NULL;
+	k_spinlock_key_t key;
+	uint8_t crc[CRC_SIZE];
+	uint16_t crc_val;
+	uint8_t seq = 0;
+	uint8_t *buf;
+	uint8_t *end;
+	size_t len;
+	int err;
 
 	k_mutex_lock(&uart_tr->tx_lock, K_FOREVER);
 
-	crc_val = crc16_ccitt(0xffff, data, length);
+	/* Take the slot before choosing the sequence number, so that the frame only carries
+	 * the synchronization flag if it is sent while the window is closed.
+	 */
+	k_sem_take(&uart_tr->tx_slots, K_FOREVER);
+
+	if (SEQ_ENABLED) {
+		seq = uart_tr->tx_seq;
+		uart_tr->tx_seq = (seq + 1) & SEQ_MASK;
+
+		if (!uart_tr->tx_seq_synced) {
+			seq |= SEQ_SYNC;
+		}
+	}
+
+	crc_val = crc16_ccitt(0xffff, &seq, SEQ_SIZE);
+	crc_val = crc16_ccitt(crc_val, data, length);
 	crc_val = tx_flip(uart_tr, crc_val);
 	log_hexdump_dbg(data, length, "<<< TX packet %04x", crc_val);
 
-#if CONFIG_NRF_RPC_UART_RELIABLE
-	int attempts = 0;
+	sys_put_le16(crc_val, crc);
+
+	/* Escape the frame up front, so that the UART ISR only copies it to the FIFO. */
+	len = 2 + hdlc_encoded_len(&seq, SEQ_SIZE) + hdlc_encoded_len(data, length) +
+	      hdlc_encoded_len(crc, sizeof(crc));
+	buf = k_malloc(len);
+	if (buf == NULL) {
+		LOG_ERR("Failed to allocate TX frame");
+		k_free((void *)data);
+		if (SEQ_ENABLED) {
+			/* The receiver expects the sequence number with the next frame. */
+			uart_tr->tx_seq = seq & SEQ_MASK;
+		}
+		key = k_spin_lock(&uart_tr->tx_spinlock);
+		tx_slot_release(uart_tr);
+		k_spin_unlock(&uart_tr->tx_spinlock, key);
+		k_mutex_unlock(&uart_tr->tx_lock);
+		return -NRF_ENOMEM;
+	}
 
-	uart_tr->ack_payload = crc_val;
-	acked = false;
+	buf[0] = HDLC_CHAR_DELIMITER;
+	end = hdlc_encode(&buf[1], &seq, SEQ_SIZE);
+	end = hdlc_encode(end, data, length);
+	end = hdlc_encode(end, crc, sizeof(crc));
+	*end = HDLC_CHAR_DELIMITER;
+
+	k_free((void *)data);
 
-	do {
-		attempts++;
-		k_mutex_lock(&uart_tr->ack_tx_lock, K_FOREVER);
-		k_sem_reset(&uart_tr->ack_sem);
-#endif /* CONFIG_NRF_RPC_UART_RELIABLE */
+	key = k_spin_lock(&uart_tr->tx_spinlock);
 
-		uart_poll_out(uart_tr->uart, HDLC_CHAR_DELIMITER);
+	for (size_t i = 0; i < TX_WINDOW_SIZE; i++) {
+		struct tx_frame *slot = &uart_tr->tx_frames[i];
 
-		for (size_t i = 0; i < length; i++) {
-			send_byte(uart_tr->uart, data[i]);
+		if (slot->state == TX_FRAME_DONE && slot != uart_tr->tx_cur) {
+			reclaimed[reclaimed_cnt++] = slot->buf;
+			slot->buf = NULL;
+			slot->state = TX_FRAME_FREE;
 		}
 
-		sys_put_le16(crc_val, crc);
-		send_byte(uart_tr->uart, crc[0]);
-		send_byte(uart_tr->uart, crc[1]);
+		if (slot->state == TX_FRAME_FREE && frame == NULL) {
+			frame = slot;
+		}
+	}
 
-		uart_poll_out(uart_tr->uart, HDLC_CHAR_DELIMITER);
+	__ASSERT_NO_MSG(frame != NULL);
 
-#if CONFIG_NRF_RPC_UART_RELIABLE
-		k_mutex_unlock(&uart_tr->ack_tx_lock);
-		if (k_sem_take(&uart_tr->ack_sem, K_MSEC(CONFIG_NRF_RPC_UART_ACK_WAITING_TIME)) ==
-		    0) {
-			acked = true;
-			LOG_DBG("Acked successfully");
-		} else {
-			LOG_WRN("Ack timeout");
-		}
-	} while (!acked && attempts < CONFIG_NRF_RPC_UART_TX_ATTEMPTS);
-#endif /* CONFIG_NRF_RPC_UART_RELIABLE */
+	frame->buf = buf;
+	frame->len = len;
+	frame->crc = crc_val;
+	frame->seq = seq & SEQ_MASK;
+	frame->attempts = 0;
+	tx_queue_put(uart_tr, frame);
 
-	k_free((void *)data);
+	k_spin_unlock(&uart_tr->tx_spinlock, key);
+
+	for (size_t i = 0; i < reclaimed_cnt; i++) {
+		k_free(reclaimed[i]);
+	}
+
+	uart_irq_tx_enable(uart_tr->uart);
+
+	if (TX_WINDOW_SIZE == 1) {
+		/* Wait until the frame is completed to report its delivery status. */
+		k_sem_take(&uart_tr->tx_slots, K_FOREVER);
+		k_sem_give(&uart_tr->tx_slots);
+	}
+
+	/* Frames that could not be delivered are reported by the next send() call. */
+	key = k_spin_lock(&uart_tr->tx_spinlock);
+	err = uart_tr->tx_error;
+	uart_tr->tx_error = 0;
+	k_spin_unlock(&uart_tr->tx_spinlock, key);
 
 	k_mutex_unlock(&uart_tr->tx_lock);
 
-	return acked ? 0 : -EPROTO;
+	return err;
 }
 
 static void *tx_buf_alloc(const struct nrf_rpc_tr *transport, size_t *size)
@@ -515,3 +1145,4 @@ const struct nrf_rpc_tr_api nrf_rpc_uart_service_api = {
 	};
 
 DT_FOREACH_STATUS_OKAY(nordic_nrf_uarte, NRF_RPC_UART_TRANSPORT_DEFINE);
+DT_FOREACH_STATUS_OKAY(zephyr_uart_emul, NRF_RPC_UART_TRANSPORT_DEFINE);
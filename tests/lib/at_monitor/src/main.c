@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <nrf_modem_at.h>
+#include <modem/at_monitor.h>
+
+/* at_monitor_dispatch() is implemented in at_monitor library and
+ * we'll call it directly to fake received AT notifications
+ */
+extern void at_monitor_dispatch(const char *at_notif);
+
+/* The Modem library is not linked */
+int nrf_modem_at_notif_handler_set(nrf_modem_at_notif_handler_t callback)
+{
+	return 0;
+}
+
+AT_MONITOR(cereg_mon, "+CEREG", cereg_handler);
+AT_MONITOR(cereg_no_prefix_mon, "CEREG", cereg_no_prefix_handler);
+AT_MONITOR(cereg_roaming_mon, "+CEREG: 5", cereg_roaming_handler);
+AT_MONITOR(cesq_mon, "%CESQ", cesq_handler);
+AT_MONITOR(any_mon, ANY, any_handler);
+AT_MONITOR(paused_mon, "+CEREG", paused_handler, PAUSED);
+AT_MONITOR_ISR(cesq_isr_mon, "%CESQ", cesq_isr_handler);
+
+static void cereg_handler(const char *notif)
+{
+}
+
+static void cereg_no_prefix_handler(const char *notif)
+{
+}
+
+static void cereg_roaming_handler(const char *notif)
+{
+}
+
+static void cesq_handler(const char *notif)
+{
+}
+
+static void any_handler(const char *notif)
+{
+}
+
+static void paused_handler(const char *notif)
+{
+}
+
+static void cesq_isr_handler(const char *notif)
+{
+}
+
+static struct at_monitor_entry *const monitors[] = {
+	&cereg_mon, &cereg_no_prefix_mon, &cereg_roaming_mon, &cesq_mon,
+	&any_mon, &paused_mon, &cesq_isr_mon,
+};
+
+/* Dispatch a notification and return the number of times each monitor received it */
+static void dispatch(const char *notif, uint32_t hits[ARRAY_SIZE(monitors)])
+{
+	for (size_t i = 0; i < ARRAY_SIZE(monitors); i++) {
+		hits[i] = at_monitor_hits_get(monitors[i]);
+	}
+
+	at_monitor_dispatch(notif);
+	k_sleep(K_MSEC(10));
+
+	for (size_t i = 0; i < ARRAY_SIZE(monitors); i++) {
+		hits[i] = at_monitor_hits_get(monitors[i]) - hits[i];
+	}
+}
+
+ZTEST(at_monitor, test_filter_match)
+{
+	uint32_t hits[ARRAY_SIZE(monitors)];
+
+	dispatch("+CEREG: 1,\"002F\",\"0012BEEF\",7\r\n", hits);
+	zassert_equal(hits[0], 1);
+	zassert_equal(hits[1], 1);
+	zassert_equal(hits[2], 0);
+	zassert_equal(hits[3], 0);
+	zassert_equal(hits[4], 1);
+	zassert_equal(hits[5], 0);
+	zassert_equal(hits[6], 0);
+
+	/* Filters that are suffixes or extensions of another filter */
+	dispatch("+CEREG: 5,\"002F\",\"0012BEEF\",7\r\n", hits);
+	zassert_equal(hits[0], 1);
+	zassert_equal(hits[1], 1);
+	zassert_equal(hits[2], 1);
+	zassert_equal(hits[3], 0);
+
+	/* Filters match anywhere in the notification */
+	dispatch("%XMONITOR: +CEREG %CESQ\r\n", hits);
+	zassert_equal(hits[0], 1);
+	zassert_equal(hits[1], 1);
+	zassert_equal(hits[2], 0);
+	zassert_equal(hits[3], 1);
+	zassert_equal(hits[6], 1);
+
+	/* Partial filters do not match */
+	dispatch("+CERE%CES\r\n", hits);
+	zassert_equal(hits[0], 0);
+	zassert_equal(hits[1], 0);
+	zassert_equal(hits[3], 0);
+	zassert_equal(hits[4], 1);
+	zassert_equal(hits[6], 0);
+}
+
+ZTEST(at_monitor, test_pause_resume)
+{
+	uint32_t hits[ARRAY_SIZE(monitors)];
+
+	dispatch("+CEREG: 1\r\n", hits);
+	zassert_equal(hits[5], 0);
+
+	at_monitor_resume(&paused_mon);
+	dispatch("+CEREG: 1\r\n", hits);
+	zassert_equal(hits[5], 1);
+
+	at_monitor_pause(&paused_mon);
+	dispatch("+CEREG: 1\r\n", hits);
+	zassert_equal(hits[5], 0);
+}
+
+ZTEST(at_monitor, test_stats)
+{
+	struct at_monitor_stats before;
+	struct at_monitor_stats after;
+	uint32_t hits[ARRAY_SIZE(monitors)];
+
+	at_monitor_stats_get(&before);
+	dispatch("%CESQ: 54,2,16,2\r\n", hits);
+	dispatch("%XMODEMSLEEP: 1,3600000\r\n", hits);
+	at_monitor_stats_get(&after);
+
+	zassert_equal(after.notif_cnt - before.notif_cnt, 2);
+	zassert_equal(after.drop_cnt, before.drop_cnt);
+	zassert_equal(after.toolong_cnt, before.toolong_cnt);
+}
+
+#if defined(CONFIG_AT_MONITOR_SLAB)
+ZTEST(at_monitor, test_slab_overflow)
+{
+	struct at_monitor_stats before;
+	struct at_monitor_stats after;
+	uint32_t hits = at_monitor_hits_get(&cereg_mon);
+
+	at_monitor_stats_get(&before);
+
+	/* Keep the workqueue from dispatching until all notifications are received */
+	k_sched_lock();
+	for (int i = 0; i < CONFIG_AT_MONITOR_SLAB_COUNT + 1; i++) {
+		at_monitor_dispatch("+CEREG: 1\r\n");
+	}
+	k_sched_unlock();
+	k_sleep(K_MSEC(10));
+
+	at_monitor_stats_get(&after);
+	zassert_equal(after.drop_cnt - before.drop_cnt, 1);
+	zassert_equal(after.queued_max, CONFIG_AT_MONITOR_SLAB_COUNT);
+	zassert_equal(at_monitor_hits_get(&cereg_mon) - hits, CONFIG_AT_MONITOR_SLAB_COUNT);
+
+	/* Longer notifications do not fit in a block */
+	at_monitor_dispatch("+CEREG: 1,\"002F\",\"0012BEEF\",7,,,\"00000110\",\"11100000\"\r\n");
+	k_sleep(K_MSEC(10));
+
+	at_monitor_stats_get(&after);
+	zassert_equal(after.drop_cnt - before.drop_cnt, 1);
+	zassert_equal(after.toolong_cnt - before.toolong_cnt, 1);
+	zassert_equal(at_monitor_hits_get(&cereg_mon) - hits, CONFIG_AT_MONITOR_SLAB_COUNT);
+}
+#endif
+
+ZTEST_SUITE(at_monitor, NULL, NULL, NULL, NULL, NULL);
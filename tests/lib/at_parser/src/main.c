@@ -2088,4 +2088,263 @@ ZTEST(at_parser, test_at_parser_cmd_next)
 	zassert_equal(num, 6);
 }
 
+static const char ncellmeas_rsp[] =
+	/* Status */
+	"%NCELLMEAS: 0,"
+	/* Current cell */
+	"\"00112233\",\"98712\",\"0AB9\",4800,7,63,31,456,4800,"
+	/* Neighbor cells (20) */
+	"333333,100,101,102,0,333333,103,104,105,0,"
+	"333333,106,107,108,0,333333,109,110,111,0,"
+	"444444,112,113,114,0,444444,115,116,117,0,"
+	"444444,118,119,120,0,444444,121,122,123,0,"
+	"555555,124,125,126,0,555555,127,128,129,0,"
+	"555555,130,131,132,0,555555,133,134,135,0,"
+	"666666,136,137,138,0,666666,139,140,141,0,"
+	"666666,142,143,144,0,666666,145,146,147,0,"
+	"777777,148,149,150,0,777777,151,152,153,0,"
+	"888888,154,155,156,0,888888,157,158,159,0,"
+	/* Timing advance for current cell */
+	"11\r\n"
+	"OK\r\n";
+
+#define NCELLMEAS_RSP_COUNT 112
+#define NCELLMEAS_RSP_NEIGHBOR_FIRST 11
+#define NCELLMEAS_RSP_NEIGHBOR_PARAMS 5
+#define NCELLMEAS_RSP_TIMING_ADVANCE 111
+
+/* Expected value of the integer at the given index of ncellmeas_rsp. */
+static int32_t ncellmeas_rsp_expected(size_t index)
+{
+	static const int32_t current_cell[] = { 4800, 7, 63, 31, 456, 4800 };
+	static const int32_t earfcn[] = { 333333, 444444, 555555, 666666, 777777, 888888 };
+	static const uint8_t earfcn_cells[] = { 4, 4, 4, 4, 2, 2 };
+	size_t cell;
+	size_t param;
+	size_t group;
+
+	if (index == 1) {
+		return 0;
+	} else if (index < NCELLMEAS_RSP_NEIGHBOR_FIRST) {
+		return current_cell[index - 5];
+	} else if (index == NCELLMEAS_RSP_TIMING_ADVANCE) {
+		return 11;
+	}
+
+	cell = (index - NCELLMEAS_RSP_NEIGHBOR_FIRST) / NCELLMEAS_RSP_NEIGHBOR_PARAMS;
+	param = (index - NCELLMEAS_RSP_NEIGHBOR_FIRST) % NCELLMEAS_RSP_NEIGHBOR_PARAMS;
+
+	switch (param) {
+	case 0:
+		for (group = 0; cell >= earfcn_cells[group]; group++) {
+			cell -= earfcn_cells[group];
+		}
+		return earfcn[group];
+	case 4:
+		return 0;
+	default:
+		return 100 + cell * 3 + param - 1;
+	}
+}
+
+static bool ncellmeas_rsp_is_int(size_t index)
+{
+	return index == 1 || index >= 5;
+}
+
+ZTEST(at_parser, test_at_parser_ncellmeas_any_order)
+{
+	int ret;
+	struct at_parser parser;
+	int32_t num;
+	size_t count;
+	const char *str;
+	size_t len;
+
+	ret = at_parser_init(&parser, ncellmeas_rsp);
+	zassert_ok(ret);
+
+	/* Backwards, as when the number of cells is known from the last values. */
+	for (size_t i = NCELLMEAS_RSP_COUNT - 1; i >= 5; i--) {
+		ret = at_parser_num_get(&parser, i, &num);
+		zassert_ok(ret, "index %d", i);
+		zassert_equal(num, ncellmeas_rsp_expected(i), "index %d", i);
+	}
+
+	ret = at_parser_string_ptr_get(&parser, 4, &str, &len);
+	zassert_ok(ret);
+	zassert_equal(len, 4);
+	zassert_mem_equal("0AB9", str, len);
+
+	ret = at_parser_num_get(&parser, 1, &num);
+	zassert_ok(ret);
+	zassert_equal(num, 0);
+
+	/* Same value repeatedly. */
+	for (size_t i = 0; i < 3; i++) {
+		ret = at_parser_num_get(&parser, NCELLMEAS_RSP_TIMING_ADVANCE, &num);
+		zassert_ok(ret);
+		zassert_equal(num, 11);
+	}
+
+	ret = at_parser_num_get(&parser, NCELLMEAS_RSP_COUNT, &num);
+	zassert_equal(ret, -EIO);
+
+	ret = at_parser_cmd_count_get(&parser, &count);
+	zassert_ok(ret);
+	zassert_equal(count, NCELLMEAS_RSP_COUNT);
+}
+
+ZTEST(at_parser, test_at_parser_cops_test_rsp)
+{
+	int ret;
+	struct at_parser parser;
+	char buffer[64];
+	size_t len;
+	size_t count;
+
+	const char *cops_rsp =
+		"+COPS: (2,\"Operator A\",\"OpA\",\"24201\",7),"
+		"(1,\"Operator B\",\"OpB\",\"24202\",9),"
+		"(3,\"Operator C\",\"OpC\",\"24203\",7),"
+		"(1,\"Operator D\",\"OpD\",\"24204\",9),,"
+		"(0,1,2,3,4),(0,1,2)\r\n"
+		"OK\r\n";
+
+	ret = at_parser_init(&parser, cops_rsp);
+	zassert_ok(ret);
+
+	ret = at_parser_cmd_count_get(&parser, &count);
+	zassert_ok(ret);
+	zassert_equal(count, 8);
+
+	len = sizeof(buffer);
+	ret = at_parser_string_get(&parser, 7, buffer, &len);
+	zassert_ok(ret);
+	zassert_mem_equal("(0,1,2)", buffer, len);
+
+	len = sizeof(buffer);
+	ret = at_parser_string_get(&parser, 5, buffer, &len);
+	zassert_equal(ret, -ENODATA);
+
+	len = sizeof(buffer);
+	ret = at_parser_string_get(&parser, 3, buffer, &len);
+	zassert_ok(ret);
+	zassert_mem_equal("(3,\"Operator C\",\"OpC\",\"24203\",7)", buffer, len);
+
+	len = sizeof(buffer);
+	ret = at_parser_string_get(&parser, 1, buffer, &len);
+	zassert_ok(ret);
+	zassert_mem_equal("(2,\"Operator A\",\"OpA\",\"24201\",7)", buffer, len);
+}
+
+#define AT_PARSER_BENCHMARK_ROUNDS 100
+
+ZTEST(at_parser, test_at_parser_benchmark)
+{
+	int ret;
+	struct at_parser parser;
+	int32_t num;
+	uint32_t start;
+	uint32_t cycles;
+
+	start = k_cycle_get_32();
+
+	for (size_t round = 0; round < AT_PARSER_BENCHMARK_ROUNDS; round++) {
+		ret = at_parser_init(&parser, ncellmeas_rsp);
+		zassert_ok(ret);
+
+		for (size_t i = NCELLMEAS_RSP_COUNT - 1; i >= 5; i--) {
+			ret = at_parser_num_get(&parser, i, &num);
+			zassert_ok(ret);
+		}
+	}
+
+	cycles = k_cycle_get_32() - start;
+
+	TC_PRINT("%%NCELLMEAS, %d values in reverse order: %u cycles\n",
+		 NCELLMEAS_RSP_COUNT - 5, cycles / AT_PARSER_BENCHMARK_ROUNDS);
+
+	start = k_cycle_get_32();
+
+	for (size_t round = 0; round < AT_PARSER_BENCHMARK_ROUNDS; round++) {
+		ret = at_parser_init(&parser, ncellmeas_rsp);
+		zassert_ok(ret);
+
+		for (size_t i = 5; i < NCELLMEAS_RSP_COUNT; i++) {
+			ret = at_parser_num_get(&parser, i, &num);
+			zassert_ok(ret);
+		}
+	}
+
+	cycles = k_cycle_get_32() - start;
+
+	TC_PRINT("%%NCELLMEAS, %d values in order: %u cycles\n",
+		 NCELLMEAS_RSP_COUNT - 5, cycles / AT_PARSER_BENCHMARK_ROUNDS);
+}
+
+#if defined(CONFIG_AT_PARSER_TOKEN_INDEX)
+#define AT_PARSER_CHUNK_SIZE 7
+
+ZTEST(at_parser, test_at_parser_feed)
+{
+	int ret;
+	struct at_parser parser;
+	char buffer[sizeof(ncellmeas_rsp)];
+	size_t received = 0;
+	size_t count;
+	int32_t num;
+	bool complete = false;
+
+	/* Deliver the response in chunks, as received from the UART. */
+	while (!complete) {
+		size_t chunk = MIN(AT_PARSER_CHUNK_SIZE, strlen(ncellmeas_rsp) - received);
+
+		memcpy(&buffer[received], &ncellmeas_rsp[received], chunk);
+		received += chunk;
+		buffer[received] = '\0';
+		complete = (received == strlen(ncellmeas_rsp));
+
+		if (chunk == received) {
+			ret = at_parser_init_partial(&parser, buffer);
+		} else {
+			ret = at_parser_feed(&parser, complete);
+		}
+		zassert_ok(ret);
+
+		if (!complete) {
+			ret = at_parser_cmd_count_get(&parser, &count);
+			zassert_equal(ret, -EINPROGRESS);
+
+			/* Values are either available or not received yet, never wrong. */
+			for (size_t i = 0; i < NCELLMEAS_RSP_COUNT; i++) {
+				if (!ncellmeas_rsp_is_int(i)) {
+					continue;
+				}
+
+				ret = at_parser_num_get(&parser, i, &num);
+				if (ret == -EINPROGRESS) {
+					continue;
+				}
+				zassert_ok(ret, "index %d", i);
+				zassert_equal(num, ncellmeas_rsp_expected(i), "index %d", i);
+			}
+		}
+	}
+
+	ret = at_parser_feed(&parser, true);
+	zassert_equal(ret, -EALREADY);
+
+	for (size_t i = NCELLMEAS_RSP_COUNT - 1; i >= 5; i--) {
+		ret = at_parser_num_get(&parser, i, &num);
+		zassert_ok(ret, "index %d", i);
+		zassert_equal(num, ncellmeas_rsp_expected(i), "index %d", i);
+	}
+
+	ret = at_parser_cmd_count_get(&parser, &count);
+	zassert_ok(ret);
+	zassert_equal(count, NCELLMEAS_RSP_COUNT);
+}
+#endif /* CONFIG_AT_PARSER_TOKEN_INDEX */
+
 ZTEST_SUITE(at_parser, NULL, NULL, NULL, NULL, NULL);
@@ -5,6 +5,7 @@
  */
 
 #include <zephyr/ztest.h>
+#include <zephyr/tc_util.h>
 #include <errno.h>
 #include <data_fifo.h>
 
@@ -231,4 +232,272 @@ ZTEST(suite_data_fifo, test_data_fifo_data_put_size_zero)
 	zassert_equal(ret, -EINVAL, "block_lock did not return -EINVAL");
 }
 
+#if defined(CONFIG_DATA_FIFO_SPSC)
+ZTEST(suite_data_fifo, test_data_fifo_spsc_put_get_ok)
+{
+	DATA_FIFO_SPSC_DEFINE(data_fifo, 4, 128);
+
+	int ret;
+
+	ret = data_fifo_init(&data_fifo);
+	zassert_equal(ret, 0, "init did not return 0");
+
+	uint8_t *data_ptr;
+	void *data_ptr_read;
+	size_t data_size;
+
+	ret = data_fifo_pointer_last_filled_get(&data_fifo, &data_ptr_read, &data_size, K_NO_WAIT);
+	zassert_equal(ret, -ENOMSG, "last_filled_get did not return -ENOMSG");
+
+	for (uint32_t i = 0; i < 4; i++) {
+		ret = data_fifo_pointer_first_vacant_get(&data_fifo, (void **)&data_ptr, K_NO_WAIT);
+		zassert_equal(ret, 0, "first_vacant_get did not return 0");
+		data_ptr[0] = i;
+
+		internal_test_remaining_elements(&data_fifo, i + 1, i, __LINE__);
+
+		ret = data_fifo_block_lock(&data_fifo, (void **)&data_ptr, i + 1);
+		zassert_equal(ret, 0, "block_lock did not return 0");
+
+		internal_test_remaining_elements(&data_fifo, i + 1, i + 1, __LINE__);
+	}
+
+	ret = data_fifo_pointer_first_vacant_get(&data_fifo, (void **)&data_ptr, K_NO_WAIT);
+	zassert_equal(ret, -ENOMEM, "first_vacant_get did not return -ENOMEM");
+
+	for (uint32_t i = 0; i < 4; i++) {
+		ret = data_fifo_pointer_last_filled_get(&data_fifo, &data_ptr_read, &data_size,
+							K_NO_WAIT);
+		zassert_equal(ret, 0, "last_filled_get did not return 0");
+		zassert_equal(((uint8_t *)data_ptr_read)[0], i, "data contents are not identical");
+		zassert_equal(data_size, i + 1, "data size incorrect");
+
+		internal_test_remaining_elements(&data_fifo, 4 - i, 3 - i, __LINE__);
+
+		data_fifo_block_free(&data_fifo, data_ptr_read);
+
+		internal_test_remaining_elements(&data_fifo, 3 - i, 3 - i, __LINE__);
+	}
+}
+
+ZTEST(suite_data_fifo, test_data_fifo_spsc_cancel_reservation)
+{
+	DATA_FIFO_SPSC_DEFINE(data_fifo, 4, 128);
+
+	int ret;
+	uint8_t *data_ptr;
+	uint8_t *data_ptr_2;
+
+	ret = data_fifo_init(&data_fifo);
+	zassert_equal(ret, 0, "init did not return 0");
+
+	ret = data_fifo_pointer_first_vacant_get(&data_fifo, (void **)&data_ptr, K_NO_WAIT);
+	zassert_equal(ret, 0, "first_vacant_get did not return 0");
+
+	internal_test_remaining_elements(&data_fifo, 1, 0, __LINE__);
+
+	/* Producer gives the block back without locking it */
+	data_fifo_block_free(&data_fifo, data_ptr);
+
+	internal_test_remaining_elements(&data_fifo, 0, 0, __LINE__);
+
+	ret = data_fifo_pointer_first_vacant_get(&data_fifo, (void **)&data_ptr_2, K_NO_WAIT);
+	zassert_equal(ret, 0, "first_vacant_get did not return 0");
+	zassert_equal_ptr(data_ptr, data_ptr_2, "Cancelled block was not reused");
+}
+
+ZTEST(suite_data_fifo, test_data_fifo_spsc_lock_out_of_order)
+{
+	DATA_FIFO_SPSC_DEFINE(data_fifo, 4, 128);
+
+	int ret;
+	uint8_t *data_ptr;
+	uint8_t *data_ptr_2;
+
+	ret = data_fifo_init(&data_fifo);
+	zassert_equal(ret, 0, "init did not return 0");
+
+	ret = data_fifo_pointer_first_vacant_get(&data_fifo, (void **)&data_ptr, K_NO_WAIT);
+	zassert_equal(ret, 0, "first_vacant_get did not return 0");
+
+	ret = data_fifo_pointer_first_vacant_get(&data_fifo, (void **)&data_ptr_2, K_NO_WAIT);
+	zassert_equal(ret, 0, "first_vacant_get did not return 0");
+
+	ret = data_fifo_block_lock(&data_fifo, (void **)&data_ptr_2, 1);
+	zassert_equal(ret, -EPERM, "block_lock did not return -EPERM");
+}
+
+ZTEST(suite_data_fifo, test_data_fifo_spsc_wrap)
+{
+	DATA_FIFO_SPSC_DEFINE(data_fifo, 3, 128);
+
+	int ret;
+	uint8_t *data_ptr;
+	uint8_t *data_ptr_2;
+	void *data_ptr_read;
+	size_t data_size;
+
+	ret = data_fifo_init(&data_fifo);
+	zassert_equal(ret, 0, "init did not return 0");
+
+	/* Go around the ring several times with a number of blocks that is not
+	 * a power of two, keeping two blocks in flight and cancelling a reservation
+	 * on every round.
+	 */
+	for (uint32_t i = 0; i < 20; i++) {
+		ret = data_fifo_pointer_first_vacant_get(&data_fifo, (void **)&data_ptr, K_NO_WAIT);
+		zassert_equal(ret, 0, "first_vacant_get did not return 0");
+		data_ptr[0] = i;
+
+		ret = data_fifo_block_lock(&data_fifo, (void **)&data_ptr, i + 1);
+		zassert_equal(ret, 0, "block_lock did not return 0");
+
+		ret = data_fifo_pointer_first_vacant_get(&data_fifo, (void **)&data_ptr_2,
+							 K_NO_WAIT);
+		zassert_equal(ret, 0, "first_vacant_get did not return 0");
+		zassert_not_equal(data_ptr, data_ptr_2, "Block reserved twice");
+		data_fifo_block_free(&data_fifo, data_ptr_2);
+
+		internal_test_remaining_elements(&data_fifo, i == 0 ? 1 : 2, i == 0 ? 1 : 2,
+						 __LINE__);
+
+		if (i == 0) {
+			continue;
+		}
+
+		ret = data_fifo_pointer_last_filled_get(&data_fifo, &data_ptr_read, &data_size,
+							K_NO_WAIT);
+		zassert_equal(ret, 0, "last_filled_get did not return 0");
+		zassert_equal(((uint8_t *)data_ptr_read)[0], i - 1,
+			      "data contents are not identical");
+		zassert_equal(data_size, i, "data size incorrect");
+
+		data_fifo_block_free(&data_fifo, data_ptr_read);
+	}
+}
+
+#define STRESS_BLOCKS_NUM 10000
+#define STRESS_FIFO_DEPTH 4
+#define STRESS_BLOCK_SIZE 32
+#define STRESS_STACK_SIZE 1024
+#define STRESS_THREAD_PRIO 5
+
+K_THREAD_STACK_DEFINE(producer_stack, STRESS_STACK_SIZE);
+static struct k_thread producer_thread;
+
+DATA_FIFO_DEFINE(stress_fifo_locked, STRESS_FIFO_DEPTH, STRESS_BLOCK_SIZE);
+DATA_FIFO_SPSC_DEFINE(stress_fifo_spsc, STRESS_FIFO_DEPTH, STRESS_BLOCK_SIZE);
+
+static void stress_producer(void *p1, void *p2, void *p3)
+{
+	struct data_fifo *data_fifo = p1;
+	uint32_t *data_ptr;
+	int ret;
+
+	for (uint32_t i = 0; i < STRESS_BLOCKS_NUM; i++) {
+		ret = data_fifo_pointer_first_vacant_get(data_fifo, (void **)&data_ptr, K_FOREVER);
+		zassert_equal(ret, 0, "first_vacant_get did not return 0");
+
+		*data_ptr = i;
+
+		ret = data_fifo_block_lock(data_fifo, (void **)&data_ptr,
+					   sizeof(uint32_t) + (i % 4));
+		zassert_equal(ret, 0, "block_lock did not return 0");
+	}
+}
+
+/* Pass blocks from a producer thread to the consumer (test thread) and check that they
+ * arrive in order. Returns the number of cycles used.
+ */
+static uint32_t stress_run(struct data_fifo *data_fifo)
+{
+	int ret;
+	uint32_t start;
+	void *data_ptr;
+	size_t data_size;
+
+	ret = data_fifo_init(data_fifo);
+	zassert_equal(ret, 0, "init did not return 0");
+
+	start = k_cycle_get_32();
+
+	k_thread_create(&producer_thread, producer_stack, K_THREAD_STACK_SIZEOF(producer_stack),
+			stress_producer, data_fifo, NULL, NULL, STRESS_THREAD_PRIO, 0, K_NO_WAIT);
+
+	for (uint32_t i = 0; i < STRESS_BLOCKS_NUM; i++) {
+		ret = data_fifo_pointer_last_filled_get(data_fifo, &data_ptr, &data_size,
+							K_FOREVER);
+		zassert_equal(ret, 0, "last_filled_get did not return 0");
+		zassert_equal(*(uint32_t *)data_ptr, i, "Block %d received out of order", i);
+		zassert_equal(data_size, sizeof(uint32_t) + (i % 4), "data size incorrect");
+
+		data_fifo_block_free(data_fifo, data_ptr);
+	}
+
+	k_thread_join(&producer_thread, K_FOREVER);
+
+	uint32_t cycles = k_cycle_get_32() - start;
+
+	internal_test_remaining_elements(data_fifo, 0, 0, __LINE__);
+
+	ret = data_fifo_uninit(data_fifo);
+	zassert_equal(ret, 0, "uninit did not return 0");
+
+	return cycles;
+}
+
+ZTEST(suite_data_fifo, test_data_fifo_stress_both_modes)
+{
+	uint32_t cycles_locked = stress_run(&stress_fifo_locked);
+	uint32_t cycles_spsc = stress_run(&stress_fifo_spsc);
+
+	TC_PRINT("%d blocks between threads: %u cycles with slab/msgq, %u cycles with SPSC ring\n",
+		 STRESS_BLOCKS_NUM, cycles_locked, cycles_spsc);
+}
+
+/* Producer and consumer in the same thread, measures the cost of the API itself */
+static uint32_t benchmark_run(struct data_fifo *data_fifo)
+{
+	int ret;
+	uint32_t start;
+	void *data_ptr;
+	size_t data_size;
+
+	ret = data_fifo_init(data_fifo);
+	zassert_equal(ret, 0, "init did not return 0");
+
+	start = k_cycle_get_32();
+
+	for (uint32_t i = 0; i < STRESS_BLOCKS_NUM; i++) {
+		ret = data_fifo_pointer_first_vacant_get(data_fifo, &data_ptr, K_NO_WAIT);
+		zassert_equal(ret, 0, "first_vacant_get did not return 0");
+
+		ret = data_fifo_block_lock(data_fifo, &data_ptr, STRESS_BLOCK_SIZE);
+		zassert_equal(ret, 0, "block_lock did not return 0");
+
+		ret = data_fifo_pointer_last_filled_get(data_fifo, &data_ptr, &data_size,
+							K_NO_WAIT);
+		zassert_equal(ret, 0, "last_filled_get did not return 0");
+
+		data_fifo_block_free(data_fifo, data_ptr);
+	}
+
+	uint32_t cycles = k_cycle_get_32() - start;
+
+	ret = data_fifo_uninit(data_fifo);
+	zassert_equal(ret, 0, "uninit did not return 0");
+
+	return cycles;
+}
+
+ZTEST(suite_data_fifo, test_data_fifo_benchmark_both_modes)
+{
+	uint32_t cycles_locked = benchmark_run(&stress_fifo_locked);
+	uint32_t cycles_spsc = benchmark_run(&stress_fifo_spsc);
+
+	TC_PRINT("Cycles per block: %u with slab/msgq, %u with SPSC ring\n",
+		 cycles_locked / STRESS_BLOCKS_NUM, cycles_spsc / STRESS_BLOCKS_NUM);
+}
+#endif /* CONFIG_DATA_FIFO_SPSC */
+
 ZTEST_SUITE(suite_data_fifo, NULL, NULL, NULL, NULL, NULL);
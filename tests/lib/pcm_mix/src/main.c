@@ -7,6 +7,7 @@
 #include <zephyr/ztest.h>
 #include <errno.h>
 #include <pcm_mix.h>
+#include <zephyr/random/random.h>
 
 #define ZEQ(a, b) zassert_equal(a, b, "fail")
 
@@ -127,4 +128,159 @@ ZTEST(suite_pcm_mix, test_mono_into_stereo_r)
 	verify_array_eq(sample_a, sample_r, ARRAY_SIZE(sample_r));
 }
 
+ZTEST(suite_pcm_mix, test_mono_into_stereo_lr_saturate)
+{
+	int ret;
+	int16_t sample_a[] = { INT16_MAX, 0, INT16_MIN, 0, 1, 2 };
+	int16_t sample_b[] = { 100, -100, 3 };
+	int16_t sample_r[] = { INT16_MAX, 100, INT16_MIN, -100, 4, 5 };
+
+	ret = pcm_mix(sample_a, sizeof(sample_a), sample_b, sizeof(sample_b),
+		      B_MONO_INTO_A_STEREO_LR);
+	ZEQ(ret, 0);
+
+	verify_array_eq(sample_a, sample_r, ARRAY_SIZE(sample_r));
+}
+
+ZTEST(suite_pcm_mix, test_mono_into_stereo_l_too_long)
+{
+	int ret;
+	int16_t sample_a[] = { 10, 10 };
+	int16_t sample_b[] = { -5, 5 };
+	int16_t sample_r[] = { 10, 10 };
+
+	ret = pcm_mix(sample_a, sizeof(sample_a), sample_b, sizeof(sample_b),
+		      B_MONO_INTO_A_STEREO_L);
+	ZEQ(ret, -EPERM);
+
+	/* Buffer A must be left untouched */
+	verify_array_eq(sample_a, sample_r, ARRAY_SIZE(sample_r));
+}
+
+ZTEST(suite_pcm_mix, test_mix_odd_sample_count)
+{
+	int ret;
+	int16_t sample_a[] = { 1, 2, 3, 4, INT16_MAX };
+	int16_t sample_b[] = { 1, 1, 1, 1, 1 };
+	int16_t sample_r[] = { 2, 3, 4, 5, INT16_MAX };
+
+	ret = pcm_mix(sample_a, sizeof(sample_a), sample_b, sizeof(sample_b), B_MONO_INTO_A_MONO);
+	ZEQ(ret, 0);
+
+	verify_array_eq(sample_a, sample_r, ARRAY_SIZE(sample_r));
+}
+
+ZTEST(suite_pcm_mix, test_mix_24_bit)
+{
+	int ret;
+	/* Packed little endian samples: 0x7FFFFF, -2, 0x000010 */
+	uint8_t sample_a[] = { 0xFF, 0xFF, 0x7F, 0xFE, 0xFF, 0xFF, 0x10, 0x00, 0x00 };
+	/* Packed little endian samples: 1, -0x800000, 0x000020 */
+	uint8_t sample_b[] = { 0x01, 0x00, 0x00, 0x00, 0x00, 0x80, 0x20, 0x00, 0x00 };
+	/* Expected: 0x7FFFFF (saturated), -0x800000 (saturated), 0x000030 */
+	uint8_t sample_r[] = { 0xFF, 0xFF, 0x7F, 0x00, 0x00, 0x80, 0x30, 0x00, 0x00 };
+
+	ret = pcm_mix_bit_depth(sample_a, sizeof(sample_a), sample_b, sizeof(sample_b),
+				B_MONO_INTO_A_MONO, 24);
+	ZEQ(ret, 0);
+
+	zassert_mem_equal(sample_a, sample_r, sizeof(sample_r));
+}
+
+ZTEST(suite_pcm_mix, test_mono_into_stereo_r_24_bit)
+{
+	int ret;
+	uint8_t sample_a[] = { 0x01, 0x00, 0x00, 0x01, 0x00, 0x00 };
+	uint8_t sample_b[] = { 0xFF, 0xFF, 0xFF };
+	uint8_t sample_r[] = { 0x01, 0x00, 0x00, 0x00, 0x00, 0x00 };
+
+	ret = pcm_mix_bit_depth(sample_a, sizeof(sample_a), sample_b, sizeof(sample_b),
+				B_MONO_INTO_A_STEREO_R, 24);
+	ZEQ(ret, 0);
+
+	zassert_mem_equal(sample_a, sample_r, sizeof(sample_r));
+}
+
+ZTEST(suite_pcm_mix, test_mix_32_bit)
+{
+	int ret;
+	int32_t sample_a[] = { INT32_MAX, INT32_MIN, 100000, -7 };
+	int32_t sample_b[] = { 1, -1, 100000, 7 };
+	int32_t sample_r[] = { INT32_MAX, INT32_MIN, 200000, 0 };
+
+	ret = pcm_mix_bit_depth(sample_a, sizeof(sample_a), sample_b, sizeof(sample_b),
+				B_MONO_INTO_A_MONO, 32);
+	ZEQ(ret, 0);
+
+	zassert_mem_equal(sample_a, sample_r, sizeof(sample_r));
+}
+
+ZTEST(suite_pcm_mix, test_mono_into_stereo_lr_32_bit)
+{
+	int ret;
+	int32_t sample_a[] = { 10, 20, INT32_MAX, INT32_MIN };
+	int32_t sample_b[] = { 5, -5 };
+	int32_t sample_r[] = { 15, 25, INT32_MAX - 5, INT32_MIN };
+
+	ret = pcm_mix_bit_depth(sample_a, sizeof(sample_a), sample_b, sizeof(sample_b),
+				B_MONO_INTO_A_STEREO_LR, 32);
+	ZEQ(ret, 0);
+
+	zassert_mem_equal(sample_a, sample_r, sizeof(sample_r));
+}
+
+ZTEST(suite_pcm_mix, test_invalid_bit_depth)
+{
+	int ret;
+	int16_t sample_a[] = { 0, 1 };
+
+	ret = pcm_mix_bit_depth(sample_a, sizeof(sample_a), sample_a, sizeof(sample_a),
+				B_MONO_INTO_A_MONO, 8);
+	ZEQ(ret, -EINVAL);
+}
+
+#define BENCHMARK_SAMPLES 960
+#define BENCHMARK_ROUNDS  16
+
+static void benchmark_mode(const char *name, enum pcm_mix_mode mix_mode, uint8_t pcm_bit_depth)
+{
+	static uint32_t buf_a[BENCHMARK_SAMPLES * 2];
+	static uint32_t buf_b[BENCHMARK_SAMPLES];
+	size_t bytes_per_sample = pcm_bit_depth / 8;
+	size_t size_b = BENCHMARK_SAMPLES * bytes_per_sample;
+	size_t size_a = (mix_mode == B_MONO_INTO_A_MONO) ? size_b : (size_b * 2);
+	uint32_t start;
+	uint32_t cycles;
+	int ret;
+
+	for (size_t i = 0; i < ARRAY_SIZE(buf_b); i++) {
+		buf_b[i] = sys_rand32_get();
+		buf_a[i] = sys_rand32_get();
+		buf_a[i + BENCHMARK_SAMPLES] = sys_rand32_get();
+	}
+
+	start = k_cycle_get_32();
+
+	for (size_t i = 0; i < BENCHMARK_ROUNDS; i++) {
+		ret = pcm_mix_bit_depth(buf_a, size_a, buf_b, size_b, mix_mode, pcm_bit_depth);
+		ZEQ(ret, 0);
+	}
+
+	cycles = k_cycle_get_32() - start;
+
+	TC_PRINT("%s %u-bit: %u cycles per sample (x100)\n", name, pcm_bit_depth,
+		 (uint32_t)(((uint64_t)cycles * 100) / (BENCHMARK_SAMPLES * BENCHMARK_ROUNDS)));
+}
+
+ZTEST(suite_pcm_mix, test_benchmark)
+{
+	static const uint8_t bit_depths[] = { 16, 24, 32 };
+
+	for (size_t i = 0; i < ARRAY_SIZE(bit_depths); i++) {
+		benchmark_mode("mono into mono", B_MONO_INTO_A_MONO, bit_depths[i]);
+		benchmark_mode("mono into stereo LR", B_MONO_INTO_A_STEREO_LR, bit_depths[i]);
+		benchmark_mode("mono into stereo L", B_MONO_INTO_A_STEREO_L, bit_depths[i]);
+	}
+}
+
 ZTEST_SUITE(suite_pcm_mix, NULL, NULL, NULL, NULL, NULL);
@@ -1152,4 +1152,135 @@ ZTEST(suite_sample_rate_converter, test_invalid_process_output_buf_too_small)
 		      "Sample rate conversion process did not fail when output buffer is to small");
 }
 
+#if defined(CONFIG_SAMPLE_RATE_CONVERTER_POLYPHASE) &&                                             \
+	defined(CONFIG_SAMPLE_RATE_CONVERTER_BIT_DEPTH_16)
+#define POLYPHASE_DC_LEVEL 10000
+#define POLYPHASE_DC_TOLERANCE 50
+#define POLYPHASE_DC_NUM_BLOCKS_CHECK 20
+#define POLYPHASE_BENCHMARK_NUM_BLOCKS 100
+
+/* Feeds blocks of a constant signal and returns the total number of output samples. The last
+ * output sample is returned through last_sample.
+ */
+static size_t polyphase_dc_run(uint32_t input_sample_rate, uint32_t output_sample_rate,
+			       size_t block_samples, size_t num_blocks, int16_t *last_sample)
+{
+	int ret;
+	int16_t input_samples[CONFIG_SAMPLE_RATE_CONVERTER_BLOCK_SIZE_MAX];
+	int16_t output_samples[CONFIG_SAMPLE_RATE_CONVERTER_BLOCK_SIZE_MAX * 3 + 2];
+	size_t output_written;
+	size_t total_samples = 0;
+
+	for (size_t i = 0; i < block_samples; i++) {
+		input_samples[i] = POLYPHASE_DC_LEVEL;
+	}
+
+	for (size_t i = 0; i < num_blocks; i++) {
+		ret = sample_rate_converter_process(
+			&conv_ctx, SAMPLE_RATE_FILTER_POLYPHASE, input_samples,
+			block_samples * sizeof(int16_t), input_sample_rate, output_samples,
+			sizeof(output_samples), &output_written, output_sample_rate);
+		zassert_equal(ret, 0, "Sample rate conversion process failed");
+
+		total_samples += output_written / sizeof(int16_t);
+	}
+
+	zassert_true(output_written > 0, "No samples produced by the last block");
+	*last_sample = output_samples[(output_written / sizeof(int16_t)) - 1];
+
+	return total_samples;
+}
+
+ZTEST(suite_sample_rate_converter, test_polyphase_44_1khz_to_48khz)
+{
+	int16_t last_sample;
+	size_t total_samples = polyphase_dc_run(44100, 48000, 441, POLYPHASE_DC_NUM_BLOCKS_CHECK,
+						&last_sample);
+
+	zassert_within(total_samples, 480 * POLYPHASE_DC_NUM_BLOCKS_CHECK, 1,
+		       "Unexpected number of output samples %d", total_samples);
+	zassert_within(last_sample, POLYPHASE_DC_LEVEL, POLYPHASE_DC_TOLERANCE,
+		       "Unexpected output level %d", last_sample);
+	zassert_equal(conv_ctx.conversion_ratio, 0, "Conversion ratio not as expected");
+	zassert_equal(conv_ctx.filter_type, SAMPLE_RATE_FILTER_POLYPHASE,
+		      "Filter not as expected");
+}
+
+ZTEST(suite_sample_rate_converter, test_polyphase_48khz_to_44_1khz)
+{
+	int16_t last_sample;
+	size_t total_samples = polyphase_dc_run(48000, 44100, 480, POLYPHASE_DC_NUM_BLOCKS_CHECK,
+						&last_sample);
+
+	zassert_within(total_samples, 441 * POLYPHASE_DC_NUM_BLOCKS_CHECK, 1,
+		       "Unexpected number of output samples %d", total_samples);
+	zassert_within(last_sample, POLYPHASE_DC_LEVEL, POLYPHASE_DC_TOLERANCE,
+		       "Unexpected output level %d", last_sample);
+}
+
+ZTEST(suite_sample_rate_converter, test_polyphase_drift_compensation)
+{
+	int ret;
+	int16_t last_sample;
+	size_t total_samples;
+
+	/* Input clock runs 1000 ppm fast, so 0.1% fewer samples are produced */
+	ret = sample_rate_converter_drift_set(&conv_ctx, 1000);
+	zassert_equal(ret, 0, "Failed to set drift");
+
+	total_samples = polyphase_dc_run(48000, 48000, 480, POLYPHASE_DC_NUM_BLOCKS_CHECK,
+					 &last_sample);
+
+	zassert_within(total_samples, 480 * POLYPHASE_DC_NUM_BLOCKS_CHECK * 999 / 1000, 1,
+		       "Unexpected number of output samples %d", total_samples);
+	zassert_within(last_sample, POLYPHASE_DC_LEVEL, POLYPHASE_DC_TOLERANCE,
+		       "Unexpected output level %d", last_sample);
+}
+
+ZTEST(suite_sample_rate_converter, test_polyphase_invalid_ratio)
+{
+	int ret;
+	int16_t input_samples[] = {1000, 2000, 3000, 4000};
+	int16_t output_samples[4];
+	size_t output_written;
+
+	ret = sample_rate_converter_process(&conv_ctx, SAMPLE_RATE_FILTER_POLYPHASE,
+					    input_samples, sizeof(input_samples), 48000,
+					    output_samples, sizeof(output_samples), &output_written,
+					    8000);
+	zassert_equal(ret, -EINVAL, "Unsupported conversion ratio was accepted");
+
+	ret = sample_rate_converter_drift_set(NULL, 0);
+	zassert_equal(ret, -EINVAL, "Drift set did not fail on NULL context");
+}
+
+ZTEST(suite_sample_rate_converter, test_polyphase_output_buf_too_small)
+{
+	int ret;
+	int16_t input_samples[441] = {0};
+	int16_t output_samples[441];
+	size_t output_written;
+
+	ret = sample_rate_converter_process(&conv_ctx, SAMPLE_RATE_FILTER_POLYPHASE,
+					    input_samples, sizeof(input_samples), 44100,
+					    output_samples, sizeof(output_samples), &output_written,
+					    48000);
+	zassert_equal(ret, -EINVAL,
+		      "Sample rate conversion process did not fail when output buffer is to small");
+}
+
+ZTEST(suite_sample_rate_converter, test_polyphase_benchmark)
+{
+	int16_t last_sample;
+	uint32_t start = k_cycle_get_32();
+
+	(void)polyphase_dc_run(44100, 48000, 441, POLYPHASE_BENCHMARK_NUM_BLOCKS, &last_sample);
+
+	uint32_t cycles = k_cycle_get_32() - start;
+
+	TC_PRINT("Polyphase 44.1 kHz -> 48 kHz: %u cycles per block of 441 samples\n",
+		 cycles / POLYPHASE_BENCHMARK_NUM_BLOCKS);
+}
+#endif /* CONFIG_SAMPLE_RATE_CONVERTER_POLYPHASE && CONFIG_SAMPLE_RATE_CONVERTER_BIT_DEPTH_16 */
+
 ZTEST_SUITE(suite_sample_rate_converter, NULL, NULL, test_setup, NULL, NULL);
@@ -0,0 +1,19 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include "filter_event.h"
+
+static uint8_t filter_event_subtype_get(const struct app_event_header *aeh)
+{
+	return cast_filter_event(aeh)->subtype;
+}
+
+APP_EVENT_TYPE_DEFINE(filter_event,
+		  NULL,
+		  NULL,
+		  APP_EVENT_FLAGS_CREATE());
+
+APP_EVENT_SUBTYPE_REGISTER(filter_event, filter_event_subtype_get);
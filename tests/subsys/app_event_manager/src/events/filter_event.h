@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef _FILTER_EVENT_H_
+#define _FILTER_EVENT_H_
+
+/**
+ * @brief Filter Event
+ * @defgroup filter_event Filter Event
+ * @{
+ */
+
+#include <app_event_manager.h>
+#include <app_event_manager_profiler_tracer.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum filter_event_subtype {
+	FILTER_EVENT_SUBTYPE_A,
+	FILTER_EVENT_SUBTYPE_B,
+	FILTER_EVENT_SUBTYPE_C,
+
+	FILTER_EVENT_SUBTYPE_COUNT
+};
+
+struct filter_event {
+	struct app_event_header header;
+
+	enum filter_event_subtype subtype;
+};
+
+APP_EVENT_TYPE_DECLARE(filter_event);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* _FILTER_EVENT_H_ */
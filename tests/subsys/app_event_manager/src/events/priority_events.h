@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef _PRIORITY_EVENTS_H_
+#define _PRIORITY_EVENTS_H_
+
+/**
+ * @brief Priority Lane Events
+ * @defgroup priority_events Priority Lane Events
+ * @{
+ */
+
+#include <app_event_manager.h>
+#include <app_event_manager_profiler_tracer.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Regular event used to load the normal priority lane. */
+struct load_event {
+	struct app_event_header header;
+
+	uint32_t idx;
+};
+
+APP_EVENT_TYPE_DECLARE(load_event);
+
+/* Event processed in the high priority lane. */
+struct urgent_event {
+	struct app_event_header header;
+
+	uint32_t submit_cycle;
+};
+
+APP_EVENT_TYPE_DECLARE(urgent_event);
+
+#ifdef __cplusplus
+}
+#endif
+
+/**
+ * @}
+ */
+
+#endif /* _PRIORITY_EVENTS_H_ */
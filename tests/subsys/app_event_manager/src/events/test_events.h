@@ -29,6 +29,8 @@ enum test_id {
 	TEST_OOM,
 	TEST_MULTICONTEXT,
 	TEST_NAME_STYLE_SORTING,
+	TEST_PRIORITY_LANES,
+	TEST_SUBSCRIBER_FILTER,
 
 	TEST_CNT
 };
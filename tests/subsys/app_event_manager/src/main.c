@@ -70,6 +70,12 @@ ZTEST(suite0, test_subs_order)
 
 ZTEST(suite0, test_oom)
 {
+	/* The default allocator does not return on OOM error. */
+	if (IS_ENABLED(CONFIG_APP_EVENT_MANAGER_EVENT_ALLOCATOR_SLAB)) {
+		ztest_test_skip();
+		return;
+	}
+
 	test_start(TEST_OOM);
 }
 
@@ -184,6 +190,81 @@ ZTEST(suite0, test_name_style_events_sorting)
 	test_start(TEST_NAME_STYLE_SORTING);
 }
 
+ZTEST(suite0, test_priority_lanes)
+{
+	if (!IS_ENABLED(CONFIG_APP_EVENT_MANAGER_PRIORITY_LANES)) {
+		ztest_test_skip();
+		return;
+	}
+
+	test_start(TEST_PRIORITY_LANES);
+}
+
+ZTEST(suite0, test_subscriber_filter)
+{
+	if (!IS_ENABLED(CONFIG_APP_EVENT_MANAGER_SUBSCRIBER_FILTER)) {
+		ztest_test_skip();
+		return;
+	}
+
+	test_start(TEST_SUBSCRIBER_FILTER);
+}
+
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_EVENT_ALLOCATOR_SLAB)
+ZTEST(suite0, test_event_allocator_slab)
+{
+	void *events[CONFIG_APP_EVENT_MANAGER_SLAB_SMALL_BLOCK_COUNT];
+	struct app_event_manager_slab_stats small;
+	struct app_event_manager_slab_stats medium;
+	struct app_event_manager_slab_stats stats;
+	void *event;
+	size_t cnt;
+
+	zassert_ok(app_event_manager_slab_stats_get(0, &small));
+	zassert_ok(app_event_manager_slab_stats_get(1, &medium));
+	zassert_equal(app_event_manager_slab_stats_get(3, &stats), -ENOENT);
+	zassert_equal(small.num_blocks, CONFIG_APP_EVENT_MANAGER_SLAB_SMALL_BLOCK_COUNT);
+	zassert_true(small.block_size < medium.block_size, "Size classes not sorted");
+
+	/* An event is placed in the smallest size class that can hold it. */
+	event = app_event_manager_alloc(small.block_size + 1);
+	zassert_not_null(event);
+	zassert_ok(app_event_manager_slab_stats_get(1, &stats));
+	zassert_equal(stats.num_used, medium.num_used + 1);
+	app_event_manager_free(event);
+	zassert_ok(app_event_manager_slab_stats_get(1, &stats));
+	zassert_equal(stats.num_used, medium.num_used);
+
+	/* Use all blocks of the small size class. */
+	cnt = small.num_blocks - small.num_used;
+	for (size_t i = 0; i < cnt; i++) {
+		events[i] = app_event_manager_alloc(small.block_size);
+		zassert_not_null(events[i]);
+	}
+
+	zassert_ok(app_event_manager_slab_stats_get(0, &stats));
+	zassert_equal(stats.num_used, small.num_blocks);
+	zassert_equal(stats.max_used, small.num_blocks);
+	zassert_equal(stats.alloc_fail_cnt, small.alloc_fail_cnt);
+
+	/* The exhausted size class falls back to the kernel heap. */
+	event = app_event_manager_alloc(small.block_size);
+	zassert_not_null(event);
+	zassert_ok(app_event_manager_slab_stats_get(0, &stats));
+	zassert_equal(stats.num_used, small.num_blocks);
+	zassert_equal(stats.alloc_fail_cnt, small.alloc_fail_cnt + 1);
+	app_event_manager_free(event);
+
+	for (size_t i = 0; i < cnt; i++) {
+		app_event_manager_free(events[i]);
+	}
+
+	zassert_ok(app_event_manager_slab_stats_get(0, &stats));
+	zassert_equal(stats.num_used, small.num_used);
+	zassert_equal(stats.max_used, small.num_blocks);
+}
+#endif /* CONFIG_APP_EVENT_MANAGER_EVENT_ALLOCATOR_SLAB */
+
 ZTEST_SUITE(suite0, NULL, test_init, NULL, NULL, NULL);
 
 static bool app_event_handler(const struct app_event_header *aeh)
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+
+#include "test_events.h"
+#include "filter_event.h"
+
+#define MODULE test_filter
+#define MODULE_FILTERED test_filter_b
+
+static uint32_t received_all;
+static uint32_t received_filtered;
+
+
+static bool filtered_event_handler(const struct app_event_header *aeh)
+{
+	const struct filter_event *event = cast_filter_event(aeh);
+
+	zassert_not_null(event, "Event unhandled");
+	zassert_equal(event->subtype, FILTER_EVENT_SUBTYPE_B,
+		      "Listener notified about filtered out subtype");
+	received_filtered++;
+
+	return false;
+}
+
+static bool app_event_handler(const struct app_event_header *aeh)
+{
+	if (is_test_start_event(aeh)) {
+		struct test_start_event *st = cast_test_start_event(aeh);
+
+		if (st->test_id != TEST_SUBSCRIBER_FILTER) {
+			return false;
+		}
+
+		received_all = 0;
+		received_filtered = 0;
+
+		for (size_t i = 0; i < FILTER_EVENT_SUBTYPE_COUNT; i++) {
+			struct filter_event *event = new_filter_event();
+
+			event->subtype = i;
+			APP_EVENT_SUBMIT(event);
+		}
+
+		return false;
+	}
+
+	if (is_filter_event(aeh)) {
+		received_all++;
+
+		if (received_all == FILTER_EVENT_SUBTYPE_COUNT) {
+			zassert_equal(received_filtered, 1,
+				      "Filtered listener notified unexpected number of times");
+
+			struct test_end_event *et = new_test_end_event();
+
+			et->test_id = TEST_SUBSCRIBER_FILTER;
+			APP_EVENT_SUBMIT(et);
+		}
+
+		return false;
+	}
+
+	zassert_true(false, "Event unhandled");
+	return false;
+}
+
+APP_EVENT_LISTENER(MODULE_FILTERED, filtered_event_handler);
+APP_EVENT_SUBSCRIBE_EARLY_FILTERED(MODULE_FILTERED, filter_event, BIT(FILTER_EVENT_SUBTYPE_B));
+
+APP_EVENT_LISTENER(MODULE, app_event_handler);
+APP_EVENT_SUBSCRIBE(MODULE, test_start_event);
+APP_EVENT_SUBSCRIBE(MODULE, filter_event);
@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+
+#include "test_events.h"
+#include "priority_events.h"
+
+#define MODULE test_priority
+
+#define LOAD_EVENT_CNT		20
+#define LOAD_EVENT_PROC_TIME_US	1000
+/* The urgent event is submitted while the regular events are being processed. */
+#define URGENT_EVENT_DELAY_US	(LOAD_EVENT_CNT / 4 * LOAD_EVENT_PROC_TIME_US)
+
+static uint32_t load_events_processed;
+static uint32_t load_events_before_urgent;
+static uint32_t urgent_latency_cycles;
+static bool urgent_received;
+
+static void urgent_timer_fn(struct k_timer *timer)
+{
+	struct urgent_event *event = new_urgent_event();
+
+	event->submit_cycle = k_cycle_get_32();
+	APP_EVENT_SUBMIT(event);
+}
+
+static K_TIMER_DEFINE(urgent_timer, urgent_timer_fn, NULL);
+
+static void priority_test_start(void)
+{
+	load_events_processed = 0;
+	urgent_received = false;
+
+	for (uint32_t i = 0; i < LOAD_EVENT_CNT; i++) {
+		struct load_event *event = new_load_event();
+
+		event->idx = i;
+		APP_EVENT_SUBMIT(event);
+	}
+
+	k_timer_start(&urgent_timer, K_USEC(URGENT_EVENT_DELAY_US), K_NO_WAIT);
+}
+
+static void priority_test_end(void)
+{
+	uint32_t latency_us = k_cyc_to_us_ceil32(urgent_latency_cycles);
+
+	TC_PRINT("Urgent event latency: %u us (%u cycles), %u load events processed before\n",
+		 latency_us, urgent_latency_cycles, load_events_before_urgent);
+
+	zassert_true(urgent_received, "Urgent event was not processed");
+	zassert_true(load_events_before_urgent > 0,
+		     "Urgent event was submitted before the regular events were processed");
+	zassert_true(load_events_before_urgent < LOAD_EVENT_CNT / 2,
+		     "Urgent event waited for the queued regular events");
+	/* At most the regular event being processed is waited for. */
+	zassert_true(latency_us < (2 * LOAD_EVENT_PROC_TIME_US),
+		     "Urgent event latency too high");
+
+	struct test_end_event *et = new_test_end_event();
+
+	et->test_id = TEST_PRIORITY_LANES;
+	APP_EVENT_SUBMIT(et);
+}
+
+static bool app_event_handler(const struct app_event_header *aeh)
+{
+	if (is_test_start_event(aeh)) {
+		struct test_start_event *st = cast_test_start_event(aeh);
+
+		if (st->test_id == TEST_PRIORITY_LANES) {
+			priority_test_start();
+		}
+
+		return false;
+	}
+
+	if (is_load_event(aeh)) {
+		const struct load_event *event = cast_load_event(aeh);
+
+		zassert_equal(event->idx, load_events_processed, "Wrong event order");
+
+		/* Simulate time consuming event processing. */
+		k_busy_wait(LOAD_EVENT_PROC_TIME_US);
+		load_events_processed++;
+
+		if (load_events_processed == LOAD_EVENT_CNT) {
+			priority_test_end();
+		}
+
+		return false;
+	}
+
+	if (is_urgent_event(aeh)) {
+		const struct urgent_event *event = cast_urgent_event(aeh);
+
+		urgent_latency_cycles = k_cycle_get_32() - event->submit_cycle;
+		load_events_before_urgent = load_events_processed;
+		urgent_received = true;
+
+		return false;
+	}
+
+	zassert_true(false, "Event unhandled");
+	return false;
+}
+
+APP_EVENT_LISTENER(MODULE, app_event_handler);
+APP_EVENT_SUBSCRIBE(MODULE, test_start_event);
+APP_EVENT_SUBSCRIBE(MODULE, load_event);
+APP_EVENT_SUBSCRIBE(MODULE, urgent_event);
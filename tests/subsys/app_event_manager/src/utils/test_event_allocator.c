@@ -17,6 +17,8 @@ void test_event_allocator_oom_expect(bool expected)
 	oom_expected = expected;
 }
 
+/* The memory slab based default allocator is tested as is. */
+#if !IS_ENABLED(CONFIG_APP_EVENT_MANAGER_EVENT_ALLOCATOR_SLAB)
 void *app_event_manager_alloc(size_t size)
 {
 	void *event = k_malloc(size);
@@ -32,3 +34,4 @@ void app_event_manager_free(void *addr)
 {
 	k_free(addr);
 }
+#endif /* !CONFIG_APP_EVENT_MANAGER_EVENT_ALLOCATOR_SLAB */
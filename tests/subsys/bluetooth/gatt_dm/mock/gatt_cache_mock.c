@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+#include <stdbool.h>
+#include <zephyr/bluetooth/att.h>
+#include <zephyr/bluetooth/conn.h>
+#include <zephyr/bluetooth/gatt.h>
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+
+#define DB_HASH_LEN 16
+
+/* Settings of the cache mock */
+static struct {
+	bool bonded;
+	bool has_hash;
+	uint8_t db_hash[DB_HASH_LEN];
+	size_t reads;
+	struct bt_conn *conn;
+	struct bt_gatt_read_params *params;
+	struct k_work_delayable work;
+} cache_mock_data;
+
+static const bt_addr_le_t peer_addr = {
+	.type = BT_ADDR_LE_PUBLIC,
+	.a.val = {0x01, 0x02, 0x03, 0x04, 0x05, 0x06},
+};
+
+static void bt_gatt_read_work(struct k_work *work)
+{
+	struct bt_gatt_read_params *params = cache_mock_data.params;
+
+	if (cache_mock_data.has_hash) {
+		(void)params->func(cache_mock_data.conn, 0, params, cache_mock_data.db_hash,
+				   sizeof(cache_mock_data.db_hash));
+	} else {
+		(void)params->func(cache_mock_data.conn, BT_ATT_ERR_ATTRIBUTE_NOT_FOUND, params,
+				   NULL, 0);
+	}
+}
+
+void bt_gatt_cache_mock_setup(bool bonded, const uint8_t *db_hash)
+{
+	k_work_init_delayable(&cache_mock_data.work, bt_gatt_read_work);
+	cache_mock_data.bonded = bonded;
+	cache_mock_data.has_hash = (db_hash != NULL);
+	if (db_hash) {
+		memcpy(cache_mock_data.db_hash, db_hash, sizeof(cache_mock_data.db_hash));
+	}
+	cache_mock_data.reads = 0;
+}
+
+size_t bt_gatt_cache_mock_reads(void)
+{
+	return cache_mock_data.reads;
+}
+
+/* Mocked version of the bt_conn_get_info, every connection is made to the same peer */
+int __wrap_bt_conn_get_info(const struct bt_conn *conn, struct bt_conn_info *info)
+{
+	memset(info, 0, sizeof(*info));
+	info->type = BT_CONN_TYPE_LE;
+	info->id = BT_ID_DEFAULT;
+	info->le.dst = &peer_addr;
+
+	return 0;
+}
+
+/* Mocked version of the bt_le_bond_exists */
+bool __wrap_bt_le_bond_exists(uint8_t id, const bt_addr_le_t *addr)
+{
+	return cache_mock_data.bonded;
+}
+
+/* Mocked version of the bt_gatt_read, supports only the Database Hash read */
+/* Call the bt_gatt_cache_mock_setup function first */
+int __wrap_bt_gatt_read(struct bt_conn *conn, struct bt_gatt_read_params *params)
+{
+	printk("Running %s mock\n", __func__);
+
+	zassert_equal(0, params->handle_count, "Expected read by UUID");
+	zassert_true(!bt_uuid_cmp(BT_UUID_GATT_DB_HASH, params->by_uuid.uuid),
+		     "Expected Database Hash read");
+
+	cache_mock_data.conn = conn;
+	cache_mock_data.params = params;
+	cache_mock_data.reads++;
+
+	k_work_schedule(&cache_mock_data.work, K_MSEC(5));
+	return 0;
+}
@@ -12,22 +12,39 @@
 #include <zephyr/sys/util.h>
 
 
+/* Number of discovery procedures that can be simulated at the same time */
+#define DISCOVER_MOCK_SLOTS 2
+
 /* Settings of the discover mock */
-static struct bt_discover_mock {
+static struct {
 	const struct bt_gatt_attr *attr;
 	size_t len;
+	size_t calls;
+} discover_mock_data;
+
+/* Simulated discovery procedure, one for every set of discovery parameters */
+static struct bt_discover_mock {
 	struct bt_conn *conn;
 	struct bt_gatt_discover_params *params;
 	struct k_work_delayable work;
-} discover_mock_data;
+} discover_mock_slots[DISCOVER_MOCK_SLOTS];
 
 static void bt_gatt_discover_work(struct k_work *work);
 
 void bt_gatt_discover_mock_setup(const struct bt_gatt_attr *attr, size_t len)
 {
-	k_work_init_delayable(&discover_mock_data.work, bt_gatt_discover_work);
+	for (size_t i = 0; i < ARRAY_SIZE(discover_mock_slots); i++) {
+		k_work_init_delayable(&discover_mock_slots[i].work, bt_gatt_discover_work);
+		discover_mock_slots[i].params = NULL;
+	}
 	discover_mock_data.attr = attr;
 	discover_mock_data.len  = len;
+	discover_mock_data.calls = 0;
+}
+
+size_t bt_gatt_discover_mock_calls(void)
+{
+	return discover_mock_data.calls;
 }
 
 static bool bt_gatt_primary_check(const struct bt_gatt_attr *attr_cur,
@@ -125,10 +142,26 @@ static void bt_gatt_discover_work(struct k_work *work)
 int bt_gatt_discover(struct bt_conn *conn,
 		     struct bt_gatt_discover_params *params)
 {
+	struct bt_discover_mock *mock_data = NULL;
+
 	printk("Running %s mock\n", __func__);
-	discover_mock_data.conn = conn;
-	discover_mock_data.params = params;
 
-	k_work_schedule(&discover_mock_data.work, K_MSEC(5));
+	for (size_t i = 0; i < ARRAY_SIZE(discover_mock_slots); i++) {
+		if (discover_mock_slots[i].params == params) {
+			mock_data = &discover_mock_slots[i];
+			break;
+		}
+		if (!mock_data && !discover_mock_slots[i].params) {
+			mock_data = &discover_mock_slots[i];
+		}
+	}
+
+	zassert_not_null(mock_data, "Too many discovery procedures");
+
+	mock_data->conn = conn;
+	mock_data->params = params;
+	discover_mock_data.calls++;
+
+	k_work_schedule(&mock_data->work, K_MSEC(5));
 	return 0;
 }
@@ -90,5 +90,31 @@
  */
 void bt_gatt_discover_mock_setup(const struct bt_gatt_attr *attr, size_t len);
 
+/**
+ * @brief Get the number of discovery requests
+ *
+ * @return Number of calls to @ref bt_gatt_discover since the mock setup.
+ */
+size_t bt_gatt_discover_mock_calls(void);
+
+/**
+ * @brief GATT cache mock setup
+ *
+ * This function setups the mocks used by the GATT Discovery Manager cache:
+ * the Database Hash read and the bond information of the peer.
+ *
+ * @param bonded  Whether the peer is bonded.
+ * @param db_hash The Database Hash of the peer or NULL if the peer does
+ *                not have the Database Hash characteristic.
+ */
+void bt_gatt_cache_mock_setup(bool bonded, const uint8_t *db_hash);
+
+/**
+ * @brief Get the number of Database Hash reads
+ *
+ * @return Number of calls to @ref bt_gatt_read since the mock setup.
+ */
+size_t bt_gatt_cache_mock_reads(void);
+
 /** @} */
 #endif /* #define BT_GATT_DISCOVERY_MOCK_H_ */
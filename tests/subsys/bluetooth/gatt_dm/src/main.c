@@ -18,7 +18,8 @@
 #define BT_UUID_EMPTY_CHR BT_UUID_DECLARE_16(0x1235)
 
 static char dummy_conn;
-K_SEM_DEFINE(discovery_finished, 0, 1);
+static char dummy_conn_2;
+K_SEM_DEFINE(discovery_finished, 0, 2);
 
 
 const struct bt_gatt_attr discover_sim[] = {
@@ -93,6 +94,9 @@ void test_before(void *fixture)
 
 	k_sem_reset(&discovery_finished);
 	bt_gatt_discover_mock_setup(discover_sim, ARRAY_SIZE(discover_sim));
+#if defined(CONFIG_BT_GATT_DM_CACHE)
+	bt_gatt_cache_mock_setup(false, NULL);
+#endif
 }
 
 struct bt_gatt_dm *run_dm(const struct bt_uuid *svc_uuid)
@@ -476,3 +480,204 @@ ZTEST(gatt_tests, test_gatt_many_serv_by_uuid)
 	zassert_equal(0, bt_gatt_dm_attr_cnt(dm), "Parameter count after clearing: %d",
 		      bt_gatt_dm_attr_cnt(dm));
 }
+
+ZTEST(gatt_tests, test_gatt_concurrent_discovery)
+{
+	struct bt_gatt_dm *dm_hids = NULL;
+	struct bt_gatt_dm *dm_dis = NULL;
+	const struct bt_gatt_service_val *serv_val;
+	int err;
+
+	err = bt_gatt_dm_start((struct bt_conn *)&dummy_conn, BT_UUID_HIDS, &test_hids_cb,
+			       &dm_hids);
+	zassert_false(err, "bt_gatt_dm_start finished with error: %d", err);
+
+	err = bt_gatt_dm_start((struct bt_conn *)&dummy_conn_2, BT_UUID_DIS, &test_hids_cb,
+			       &dm_dis);
+	zassert_false(err, "bt_gatt_dm_start finished with error: %d", err);
+
+	/* Only one discovery procedure can run on a connection */
+	err = bt_gatt_dm_start((struct bt_conn *)&dummy_conn, BT_UUID_DIS, &test_hids_cb, NULL);
+	zassert_equal(-EALREADY, err, "Unexpected error: %d", err);
+
+	for (int i = 0; i < 2; i++) {
+		err = k_sem_take(&discovery_finished, K_MSEC(SERVICE_DISCOVERY_TIMEOUT));
+		zassert_equal(0, err, "It seems that no callback function was called: %d", err);
+	}
+
+	zassert_not_null(dm_hids, "Device Manager pointer not set");
+	zassert_not_null(dm_dis, "Device Manager pointer not set");
+	zassert_not_equal(dm_hids, dm_dis, "Discovery instance shared by connections");
+
+	zassert_equal_ptr(&dummy_conn, bt_gatt_dm_conn_get(dm_hids), "Unexpected connection");
+	serv_val = bt_gatt_dm_attr_service_val(bt_gatt_dm_service_get(dm_hids));
+	zassert_true(!bt_uuid_cmp(BT_UUID_HIDS, serv_val->uuid), "Invalid service detected");
+	zassert_equal(11, bt_gatt_dm_attr_cnt(dm_hids),
+		      "Unexpected number of attributes detected: %d",
+		      bt_gatt_dm_attr_cnt(dm_hids));
+
+	zassert_equal_ptr(&dummy_conn_2, bt_gatt_dm_conn_get(dm_dis), "Unexpected connection");
+	serv_val = bt_gatt_dm_attr_service_val(bt_gatt_dm_service_get(dm_dis));
+	zassert_true(!bt_uuid_cmp(BT_UUID_DIS, serv_val->uuid), "Invalid service detected");
+	zassert_equal(5, bt_gatt_dm_attr_cnt(dm_dis),
+		      "Unexpected number of attributes detected: %d",
+		      bt_gatt_dm_attr_cnt(dm_dis));
+
+	/* ------------------------------------------------------ */
+	/* Clean up */
+	bt_gatt_dm_data_release(dm_hids);
+	bt_gatt_dm_data_release(dm_dis);
+}
+
+#if defined(CONFIG_BT_GATT_DM_CACHE)
+
+static const uint8_t db_hash_a[16] = {
+	0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08,
+	0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x10,
+};
+
+static const uint8_t db_hash_b[16] = {
+	0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18,
+	0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f, 0x20,
+};
+
+static void cache_test_before(void *fixture)
+{
+	test_before(fixture);
+	bt_gatt_dm_cache_clear(NULL);
+}
+
+/* Run the HIDS discovery and check the result, returns the number of discovery requests */
+static size_t run_dm_hids(void)
+{
+	size_t calls = bt_gatt_discover_mock_calls();
+	const struct bt_gatt_dm_attr *attr_chrc;
+	const struct bt_gatt_dm_attr *attr_desc;
+	const struct bt_gatt_service_val *serv_val;
+	const struct bt_gatt_chrc *chrc_val;
+	struct bt_gatt_dm *dm;
+
+	dm = run_dm(BT_UUID_HIDS);
+	zassert_not_null(dm, "Device Manager pointer not set");
+
+	serv_val = bt_gatt_dm_attr_service_val(bt_gatt_dm_service_get(dm));
+	zassert_true(!bt_uuid_cmp(BT_UUID_HIDS, serv_val->uuid), "Invalid service detected");
+	zassert_equal(11, serv_val->end_handle, "Unexpected end handle");
+	zassert_equal(11, bt_gatt_dm_attr_cnt(dm),
+		      "Unexpected number of attributes detected: %d",
+		      bt_gatt_dm_attr_cnt(dm));
+
+	for (int i = 1; i <= 11; ++i) {
+		zassert_not_null(bt_gatt_dm_attr_by_handle(dm, i), "Attr handle: %d", i);
+	}
+
+	attr_chrc = bt_gatt_dm_char_by_uuid(dm, BT_UUID_HIDS_REPORT);
+	zassert_not_null(attr_chrc, "Unexpected NULL instead of HIDS_REPORT");
+	zassert_equal(6, attr_chrc->handle, "Unexpected handle: %d", attr_chrc->handle);
+	chrc_val = bt_gatt_dm_attr_chrc_val(attr_chrc);
+	zassert_equal(BT_GATT_CHRC_READ | BT_GATT_CHRC_NOTIFY, chrc_val->properties,
+		      "Unexpected HIDS_REPORT properties");
+
+	attr_desc = bt_gatt_dm_desc_by_uuid(dm, attr_chrc, BT_UUID_GATT_CCC);
+	zassert_not_null(attr_desc, "Unexpected NULL");
+	zassert_equal(8, attr_desc->handle, "Unexpected handle: %d", attr_desc->handle);
+
+	bt_gatt_dm_data_release(dm);
+
+	return bt_gatt_discover_mock_calls() - calls;
+}
+
+ZTEST_SUITE(gatt_cache_tests, NULL, NULL, cache_test_before, NULL, NULL);
+
+ZTEST(gatt_cache_tests, test_cache_hit)
+{
+	struct bt_gatt_dm *dm;
+	size_t calls;
+
+	bt_gatt_cache_mock_setup(true, db_hash_a);
+
+	zassert_not_equal(0, run_dm_hids(), "Service discovery not performed");
+	zassert_equal(1, bt_gatt_cache_mock_reads(), "Database Hash not read");
+
+	/* The same service is taken from the cache */
+	zassert_equal(0, run_dm_hids(), "Service discovery performed");
+	zassert_equal(2, bt_gatt_cache_mock_reads(), "Database Hash not read");
+
+	/* A different service is not */
+	calls = bt_gatt_discover_mock_calls();
+	dm = run_dm(BT_UUID_DIS);
+	zassert_not_null(dm, "Device Manager pointer not set");
+	zassert_not_equal(calls, bt_gatt_discover_mock_calls(), "Service discovery not performed");
+	bt_gatt_dm_data_release(dm);
+}
+
+ZTEST(gatt_cache_tests, test_cache_continue)
+{
+	struct bt_gatt_dm *dm;
+	const struct bt_gatt_service_val *serv_val;
+	size_t calls;
+
+	bt_gatt_cache_mock_setup(true, db_hash_a);
+
+	dm = run_dm(NULL);
+	zassert_not_null(dm, "Device Manager pointer not set");
+	bt_gatt_dm_data_release(dm);
+
+	calls = bt_gatt_discover_mock_calls();
+	dm = run_dm(NULL);
+	zassert_not_null(dm, "Device Manager pointer not set");
+	zassert_equal(calls, bt_gatt_discover_mock_calls(), "Service discovery performed");
+	serv_val = bt_gatt_dm_attr_service_val(bt_gatt_dm_service_get(dm));
+	zassert_true(!bt_uuid_cmp(BT_UUID_HIDS, serv_val->uuid), "Invalid service detected");
+
+	/* Discovery continues after the cached service */
+	dm = run_dm_next(dm);
+	zassert_not_null(dm, "Device Manager pointer not set");
+	serv_val = bt_gatt_dm_attr_service_val(bt_gatt_dm_service_get(dm));
+	zassert_true(!bt_uuid_cmp(BT_UUID_DIS, serv_val->uuid), "Invalid service detected");
+	zassert_equal(5, bt_gatt_dm_attr_cnt(dm),
+		      "Unexpected number of attributes detected: %d",
+		      bt_gatt_dm_attr_cnt(dm));
+
+	bt_gatt_dm_data_release(dm);
+}
+
+ZTEST(gatt_cache_tests, test_cache_hash_changed)
+{
+	bt_gatt_cache_mock_setup(true, db_hash_a);
+	zassert_not_equal(0, run_dm_hids(), "Service discovery not performed");
+
+	bt_gatt_cache_mock_setup(true, db_hash_b);
+	zassert_not_equal(0, run_dm_hids(), "Service discovery not performed");
+	zassert_equal(0, run_dm_hids(), "Service discovery performed");
+}
+
+ZTEST(gatt_cache_tests, test_cache_not_bonded)
+{
+	bt_gatt_cache_mock_setup(false, db_hash_a);
+
+	zassert_not_equal(0, run_dm_hids(), "Service discovery not performed");
+	zassert_not_equal(0, run_dm_hids(), "Service discovery not performed");
+	zassert_equal(0, bt_gatt_cache_mock_reads(), "Database Hash read");
+}
+
+ZTEST(gatt_cache_tests, test_cache_no_hash)
+{
+	bt_gatt_cache_mock_setup(true, NULL);
+
+	zassert_not_equal(0, run_dm_hids(), "Service discovery not performed");
+	zassert_not_equal(0, run_dm_hids(), "Service discovery not performed");
+	zassert_equal(2, bt_gatt_cache_mock_reads(), "Database Hash not read");
+}
+
+ZTEST(gatt_cache_tests, test_cache_clear)
+{
+	bt_gatt_cache_mock_setup(true, db_hash_a);
+	zassert_not_equal(0, run_dm_hids(), "Service discovery not performed");
+
+	bt_gatt_dm_cache_clear(NULL);
+	zassert_not_equal(0, run_dm_hids(), "Service discovery not performed");
+	zassert_equal(0, run_dm_hids(), "Service discovery performed");
+}
+
+#endif /* CONFIG_BT_GATT_DM_CACHE */
@@ -0,0 +1,214 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/ztest.h>
+#include <zephyr/bluetooth/mesh.h>
+#include <bluetooth/mesh/rpl_stats.h>
+
+#include <mesh/net.h>
+#include <mesh/rpl.h>
+
+#define ADDR_BASE 0x0100
+
+static struct bt_mesh_net_rx rx_make(uint16_t addr, uint32_t seq, bool old_iv)
+{
+	struct bt_mesh_net_rx rx = {
+		.ctx.addr = addr,
+		.seq = seq,
+		.old_iv = old_iv,
+		.net_if = BT_MESH_NET_IF_ADV,
+		.local_match = true,
+	};
+
+	return rx;
+}
+
+static bool check(uint16_t addr, uint32_t seq, bool old_iv)
+{
+	struct bt_mesh_net_rx rx = rx_make(addr, seq, old_iv);
+
+	return bt_mesh_rpl_check(&rx, NULL, false);
+}
+
+static void fill(uint16_t first, uint16_t count)
+{
+	for (uint16_t i = 0; i < count; i++) {
+		zassert_false(check(first + i, 1, false));
+	}
+}
+
+ZTEST(bt_mesh_rpl, test_replay)
+{
+	struct bt_mesh_rpl_stats stats;
+
+	zassert_false(check(ADDR_BASE, 10, false));
+	zassert_true(check(ADDR_BASE, 10, false));
+	zassert_true(check(ADDR_BASE, 9, false));
+	zassert_false(check(ADDR_BASE, 11, false));
+
+	/* Other addresses are not affected */
+	zassert_false(check(ADDR_BASE + 1, 10, false));
+
+	/* Messages from the local node and not addressed to it are not checked */
+	struct bt_mesh_net_rx rx = rx_make(ADDR_BASE, 10, false);
+
+	rx.net_if = BT_MESH_NET_IF_LOCAL;
+	zassert_false(bt_mesh_rpl_check(&rx, NULL, false));
+
+	rx = rx_make(ADDR_BASE, 10, false);
+	rx.local_match = false;
+	zassert_false(bt_mesh_rpl_check(&rx, NULL, false));
+	zassert_true(bt_mesh_rpl_check(&rx, NULL, true));
+
+	bt_mesh_rpl_stats_get(&stats);
+	zassert_equal(stats.lookups, 6);
+	zassert_equal(stats.replays, 3);
+	zassert_equal(stats.entries, 2);
+}
+
+ZTEST(bt_mesh_rpl, test_iv_index)
+{
+	zassert_false(check(ADDR_BASE, 100, false));
+
+	/* Messages on the old IV Index are rejected once a message on the
+	 * current IV Index has been received.
+	 */
+	zassert_true(check(ADDR_BASE, 200, true));
+
+	/* Entries become old on IV Index update. */
+	bt_mesh_rpl_reset();
+	zassert_true(check(ADDR_BASE, 100, true));
+	zassert_false(check(ADDR_BASE, 101, true));
+
+	/* Any sequence number is accepted on the new IV Index. */
+	zassert_false(check(ADDR_BASE, 1, false));
+	zassert_true(check(ADDR_BASE, 1000, true));
+}
+
+ZTEST(bt_mesh_rpl, test_segmented)
+{
+	struct bt_mesh_net_rx rx_a = rx_make(ADDR_BASE, 10, false);
+	struct bt_mesh_net_rx rx_b = rx_make(ADDR_BASE + 1, 10, false);
+	struct bt_mesh_rpl *rpl_a;
+	struct bt_mesh_rpl *rpl_b;
+
+	/* The slot is not updated until the message has been reassembled. */
+	zassert_false(bt_mesh_rpl_check(&rx_a, &rpl_a, false));
+	zassert_equal(rpl_a->src, 0);
+	zassert_false(check(ADDR_BASE, 10, false));
+	zassert_true(check(ADDR_BASE, 10, false));
+
+	/* Once the address is in the list, its entry is returned. */
+	rx_a.seq = 11;
+	zassert_false(bt_mesh_rpl_check(&rx_a, &rpl_a, false));
+	zassert_equal(rpl_a->src, ADDR_BASE);
+	bt_mesh_rpl_update(rpl_a, &rx_a);
+	zassert_true(check(ADDR_BASE, 11, false));
+
+	/* Two new addresses get the same free slot, and the last one to
+	 * complete takes it.
+	 */
+	rx_a = rx_make(ADDR_BASE + 2, 10, false);
+	zassert_false(bt_mesh_rpl_check(&rx_a, &rpl_a, false));
+	zassert_false(bt_mesh_rpl_check(&rx_b, &rpl_b, false));
+	zassert_equal_ptr(rpl_a, rpl_b);
+
+	bt_mesh_rpl_update(rpl_a, &rx_a);
+	bt_mesh_rpl_update(rpl_b, &rx_b);
+	zassert_true(check(ADDR_BASE + 1, 10, false));
+	zassert_true(check(ADDR_BASE, 11, false));
+	zassert_false(check(ADDR_BASE + 2, 10, false));
+	zassert_true(check(ADDR_BASE + 2, 10, false));
+}
+
+ZTEST(bt_mesh_rpl, test_full)
+{
+	struct bt_mesh_rpl_stats stats;
+
+	fill(ADDR_BASE, CONFIG_BT_MESH_CRPL);
+
+	zassert_true(check(ADDR_BASE + CONFIG_BT_MESH_CRPL, 1, false));
+
+	/* Existing entries are still found. */
+	for (uint16_t i = 0; i < CONFIG_BT_MESH_CRPL; i++) {
+		zassert_true(check(ADDR_BASE + i, 1, false));
+		zassert_false(check(ADDR_BASE + i, 2, false));
+	}
+
+	bt_mesh_rpl_stats_get(&stats);
+	zassert_equal(stats.full, 1);
+	zassert_equal(stats.entries, CONFIG_BT_MESH_CRPL);
+	zassert_equal(stats.entries_max, CONFIG_BT_MESH_CRPL);
+}
+
+ZTEST(bt_mesh_rpl, test_reset)
+{
+	struct bt_mesh_rpl_stats stats;
+	uint16_t count = 16;
+
+	/* Every other entry is refreshed after the first IV Index update, so
+	 * the others are evicted on the second one.
+	 */
+	fill(ADDR_BASE, count);
+	bt_mesh_rpl_reset();
+
+	for (uint16_t i = 0; i < count; i += 2) {
+		zassert_false(check(ADDR_BASE + i, 2, false));
+	}
+
+	bt_mesh_rpl_reset();
+
+	bt_mesh_rpl_stats_get(&stats);
+	zassert_equal(stats.evicted, count / 2);
+	zassert_equal(stats.entries, count / 2);
+	zassert_equal(stats.entries_max, count);
+
+	for (uint16_t i = 0; i < count; i++) {
+		/* Remaining entries moved, but are still found. */
+		zassert_equal(check(ADDR_BASE + i, 2, true), !(i % 2), "addr 0x%04x",
+			      ADDR_BASE + i);
+	}
+
+	/* Freed entries can be reused. */
+	fill(ADDR_BASE + count, CONFIG_BT_MESH_CRPL - count);
+	zassert_true(check(ADDR_BASE + CONFIG_BT_MESH_CRPL, 1, false));
+}
+
+ZTEST(bt_mesh_rpl, test_lookup_benchmark)
+{
+	static const uint16_t sizes[] = {32, 128, 512, CONFIG_BT_MESH_CRPL};
+	struct bt_mesh_rpl_stats stats;
+
+	for (size_t i = 0; i < ARRAY_SIZE(sizes); i++) {
+		uint32_t start;
+		uint32_t cycles;
+
+		bt_mesh_rpl_clear();
+		fill(ADDR_BASE, sizes[i]);
+		bt_mesh_rpl_stats_reset();
+
+		start = k_cycle_get_32();
+		for (uint16_t j = 0; j < sizes[i]; j++) {
+			(void)check(ADDR_BASE + j, 1, false);
+		}
+		cycles = k_cycle_get_32() - start;
+
+		bt_mesh_rpl_stats_get(&stats);
+		zassert_equal(stats.replays, sizes[i]);
+
+		TC_PRINT("RPL of %u entries: %u cycles and %u.%02u probes per lookup\n", sizes[i],
+			 cycles / sizes[i], stats.probes / sizes[i],
+			 (stats.probes * 100 / sizes[i]) % 100);
+	}
+}
+
+static void rpl_before(void *fixture)
+{
+	bt_mesh_rpl_clear();
+	bt_mesh_rpl_stats_reset();
+}
+
+ZTEST_SUITE(bt_mesh_rpl, NULL, NULL, rpl_before, NULL, NULL);
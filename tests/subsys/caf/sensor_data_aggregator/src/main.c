@@ -4,17 +4,23 @@
  * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
  */
 
+#include <string.h>
 #include <zephyr/ztest.h>
 #include <app_event_manager.h>
 
 #include "test_events.h"
 #include <caf/events/sensor_event.h>
+#include <caf/events/sensor_data_aggregator_event.h>
+#include <caf/sensor_data_aggregator.h>
 #include "test_config.h"
 #include <zephyr/drivers/sensor.h>
 
 static enum test_id cur_test_id;
 static K_SEM_DEFINE(test_end_sem, 0, 1);
 
+static struct sensor_data_aggregator_event overflow_events[OVERFLOW_TEST_AGG_BUF_COUNT];
+static size_t overflow_event_cnt;
+
 
 static void *test_init(void)
 {
@@ -101,6 +107,90 @@ ZTEST(caf_sensor_aggregator_tests, test_status)
 	test_start(TEST_STATUS);
 }
 
+static void overflow_test_submit(int first, int count)
+{
+	for (int i = first; i < first + count; i++) {
+		struct sensor_event *se = new_sensor_event(sizeof(struct sensor_value));
+		struct sensor_value value = {
+			.val1 = i,
+		};
+
+		zassert_not_null(se, "Failed to allocate event");
+		se->descr = OVERFLOW_TEST_AGG_DESCR;
+		se->dyndata.size = sizeof(value);
+		memcpy(se->dyndata.data, &value, sizeof(value));
+		APP_EVENT_SUBMIT(se);
+		k_yield();
+	}
+
+	/* Let the aggregator handle all of the samples */
+	k_sleep(K_MSEC(100));
+}
+
+static void overflow_test_check_event(const struct sensor_data_aggregator_event *event,
+				      int first)
+{
+	zassert_equal(event->sample_cnt, OVERFLOW_TEST_SAMPLES_IN_AGG_BUF);
+	zassert_not_null(event->timestamps);
+
+	for (int i = 0; i < event->sample_cnt; i++) {
+		zassert_equal(event->samples[i].val1, first + i, "Incorrect sample order");
+		if (i > 0) {
+			zassert_true(event->timestamps[i] >= event->timestamps[i - 1]);
+		}
+	}
+}
+
+static void overflow_test_release(const struct sensor_data_aggregator_event *event)
+{
+	struct sensor_data_aggregator_release_buffer_event *release_evt =
+		new_sensor_data_aggregator_release_buffer_event();
+
+	release_evt->samples = event->samples;
+	release_evt->sensor_descr = event->sensor_descr;
+	APP_EVENT_SUBMIT(release_evt);
+}
+
+ZTEST(caf_sensor_aggregator_tests, test_overflow)
+{
+	const int buffered = OVERFLOW_TEST_SAMPLES_IN_AGG_BUF * OVERFLOW_TEST_AGG_BUF_COUNT;
+	struct sensor_data_aggregator_stats stats;
+
+	cur_test_id = TEST_OVERFLOW;
+	overflow_event_cnt = 0;
+
+	/* Buffers are not released, so the samples that do not fit are dropped */
+	overflow_test_submit(0, buffered + OVERFLOW_TEST_SAMPLES_IN_AGG_BUF);
+
+	zassert_equal(overflow_event_cnt, OVERFLOW_TEST_AGG_BUF_COUNT);
+	overflow_test_check_event(&overflow_events[0], 0);
+	overflow_test_check_event(&overflow_events[1], OVERFLOW_TEST_SAMPLES_IN_AGG_BUF);
+
+	zassert_ok(sensor_data_aggregator_stats_get(OVERFLOW_TEST_AGG_DESCR, &stats));
+	zassert_equal(stats.sample_cnt, buffered);
+	zassert_equal(stats.drop_cnt, OVERFLOW_TEST_SAMPLES_IN_AGG_BUF);
+	zassert_equal(stats.max_used, buffered);
+
+	/* Aggregation continues once the buffers are released */
+	overflow_test_release(&overflow_events[0]);
+	overflow_test_release(&overflow_events[1]);
+	overflow_event_cnt = 0;
+
+	overflow_test_submit(0, OVERFLOW_TEST_SAMPLES_IN_AGG_BUF);
+
+	zassert_equal(overflow_event_cnt, 1);
+	overflow_test_check_event(&overflow_events[0], 0);
+	overflow_test_release(&overflow_events[0]);
+
+	zassert_ok(sensor_data_aggregator_stats_get(OVERFLOW_TEST_AGG_DESCR, &stats));
+	zassert_equal(stats.sample_cnt, buffered + OVERFLOW_TEST_SAMPLES_IN_AGG_BUF);
+	zassert_equal(stats.drop_cnt, OVERFLOW_TEST_SAMPLES_IN_AGG_BUF);
+
+	zassert_equal(sensor_data_aggregator_stats_get("unknown_sensor", &stats), -ENOENT);
+
+	cur_test_id = TEST_IDLE;
+}
+
 static bool app_event_handler(const struct app_event_header *aeh)
 {
 	if (is_test_end_event(aeh)) {
@@ -114,6 +204,19 @@ static bool app_event_handler(const struct app_event_header *aeh)
 		return false;
 	}
 
+	if (is_sensor_data_aggregator_event(aeh)) {
+		const struct sensor_data_aggregator_event *event =
+			cast_sensor_data_aggregator_event(aeh);
+
+		if (strcmp(event->sensor_descr, OVERFLOW_TEST_AGG_DESCR) == 0) {
+			zassert_true(overflow_event_cnt < ARRAY_SIZE(overflow_events),
+				     "Too many buffers received");
+			overflow_events[overflow_event_cnt++] = *event;
+		}
+
+		return false;
+	}
+
 	zassert_unreachable("Wrong event type received");
 	return false;
 }
@@ -122,3 +225,4 @@ ZTEST_SUITE(caf_sensor_aggregator_tests, NULL, test_init, NULL, NULL, NULL);
 
 APP_EVENT_LISTENER(test_main, app_event_handler);
 APP_EVENT_SUBSCRIBE(test_main, test_end_event);
+APP_EVENT_SUBSCRIBE(test_main, sensor_data_aggregator_event);
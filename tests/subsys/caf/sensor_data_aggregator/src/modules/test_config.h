@@ -13,6 +13,9 @@
 #define BASIC_TEST_AGG_EVENTS 80
 #define ORDER_TEST_AGG_EVENTS 2
 #define STATUS_TEST_SENSOR_EVENTS 4
+#define OVERFLOW_TEST_SAMPLES_IN_AGG_BUF 100
+#define OVERFLOW_TEST_AGG_BUF_COUNT 2
 #define BASIC_TEST_AGG_DESCR "void_basic_test_sensor"
 #define ORDER_TEST_AGG_DESCR "void_order_test_sensor"
 #define STATUS_TEST_AGG_DESCR "void_status_test_sensor"
+#define OVERFLOW_TEST_AGG_DESCR "void_overflow_test_sensor"
@@ -34,6 +34,11 @@ static bool app_event_handler(const struct app_event_header *aeh)
 		const struct sensor_data_aggregator_event *event =
 			cast_sensor_data_aggregator_event(aeh);
 
+		/* Buffers are released by the overflow test itself. */
+		if (strcmp(event->sensor_descr, OVERFLOW_TEST_AGG_DESCR) == 0) {
+			return false;
+		}
+
 		struct sensor_data_aggregator_release_buffer_event *release_evt =
 		new_sensor_data_aggregator_release_buffer_event();
 
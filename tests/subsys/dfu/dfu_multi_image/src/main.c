@@ -319,6 +319,42 @@ ZTEST(dfu_multi_image_test, test_too_large_package)
 	zassert_equal(err, -ESPIPE, "DFU passed despite of trailing data");
 }
 
+ZTEST(dfu_multi_image_test, test_data_gap)
+{
+	int err;
+	uint8_t buffer[128];
+	size_t offset;
+
+	ctx.expected = two_image_package_expected;
+
+	err = simulate_reset(buffer, sizeof(buffer));
+	zassert_ok(err, "DFU init failed");
+
+	err = dfu_multi_image_write(0, two_image_package, 10);
+	zassert_ok(err, "DFU write failed");
+
+	/*
+	 * Test that a chunk leaving a gap is rejected, and that the DFU can continue from
+	 * the expected offset. Data that was already received is skipped.
+	 */
+	err = dfu_multi_image_write(20, two_image_package + 20, 10);
+	zassert_equal(err, -ESPIPE, "DFU accepted a data gap");
+
+	err = dfu_multi_image_write(5, two_image_package + 5, 20);
+	zassert_ok(err, "DFU write failed after a data gap");
+
+	offset = dfu_multi_image_offset();
+	zassert_equal(offset, 25, "Incorrect offset");
+
+	err = dfu_multi_image_write(offset, two_image_package + offset,
+				    sizeof(two_image_package) - offset);
+	zassert_ok(err, "DFU write failed");
+
+	err = dfu_multi_image_done(true);
+	zassert_ok(err, "DFU done failed");
+	zassert_equal(ctx.current_image_no, ctx.expected.image_count, "Too few images written");
+}
+
 ZTEST(dfu_multi_image_test, test_skipped_image)
 {
 	uint8_t buffer[128];
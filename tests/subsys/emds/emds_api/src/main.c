@@ -23,7 +23,8 @@ enum test_states {
 	EMDS_TS_STORE_DATA,
 	EMDS_TS_CLEAR_FLASH,
 	EMDS_TS_NO_STORE,
-	EMDS_TS_SEVERAL_STORE
+	EMDS_TS_SEVERAL_STORE,
+	EMDS_TS_INCREMENTAL_STORE
 };
 
 static int iteration;
@@ -37,6 +38,7 @@ static enum test_states state[] = {
 	EMDS_TS_EMPTY_FLASH,
 	EMDS_TS_NO_STORE,
 	EMDS_TS_EMPTY_FLASH,
+	EMDS_TS_INCREMENTAL_STORE,
 	EMDS_TS_CLEAR_FLASH,
 };
 
@@ -75,6 +77,8 @@ static char *print_state(enum test_states s)
 		return "SEVERAL_STORE";
 	case EMDS_TS_NO_STORE:
 		return "NO_STORE";
+	case EMDS_TS_INCREMENTAL_STORE:
+		return "INCREMENTAL_STORE";
 	default:
 		return "UNKNOWN";
 	}
@@ -147,19 +151,24 @@ static void load_empty_flash(void)
 			  "Data has changed");
 }
 
-static void load_flash(int idx)
+static void load_entries(int d_idx, int s_idx)
 {
 	memset(d_data, 0, sizeof(d_data));
 	memset(s_data, 0, sizeof(s_data));
 
 	zassert_equal(emds_load(), 0, "Load failed");
 
-	zassert_mem_equal(d_data, &expect_d_data[idx][0][0], sizeof(d_data),
+	zassert_mem_equal(d_data, &expect_d_data[d_idx][0][0], sizeof(d_data),
 			  "Data has changed");
-	zassert_mem_equal(s_data, &expect_s_data[idx][0], sizeof(s_data),
+	zassert_mem_equal(s_data, &expect_s_data[s_idx][0], sizeof(s_data),
 			  "Data has changed");
 }
 
+static void load_flash(int idx)
+{
+	load_entries(idx, idx);
+}
+
 static void prepare(void)
 {
 	zassert_equal(emds_store(), -ECANCELED, "Prepare must be done before store");
@@ -171,12 +180,14 @@ static void prepare(void)
 	zassert_true(emds_is_ready(), "EMDS should be ready");
 }
 
-static void store(int idx)
+static size_t store_entries(int d_idx, int s_idx)
 {
+	size_t written;
+
 	zassert_true(emds_is_ready(), "Store should be ready to execute");
 
-	memcpy(d_data, &expect_d_data[idx][0][0], sizeof(d_data));
-	memcpy(s_data, &expect_s_data[idx][0], sizeof(s_data));
+	memcpy(d_data, &expect_d_data[d_idx][0][0], sizeof(d_data));
+	memcpy(s_data, &expect_s_data[s_idx][0], sizeof(s_data));
 
 #if defined(CONFIG_BT) && !defined(CONFIG_BT_LL_SW_SPLIT)
 	/* Disable bluetooth and mpsl scheduler if bluetooth is enabled. */
@@ -198,10 +209,19 @@ static void store(int idx)
 
 	zassert_equal(emds_store_time_get(&estimate_store_time_us), 0, "Getting store time failed");
 
-	printf("Store time: Actual %dus, Worst case:  %dus\n",
-	       store_time_us, estimate_store_time_us);
+	zassert_equal(emds_store_written_get(&written), 0, "Getting written size failed");
+
+	printf("Store time: Actual %dus, Worst case:  %dus, Written: %zu bytes\n",
+	       store_time_us, estimate_store_time_us, written);
 
 	zassert_true((store_time_us < estimate_store_time_us), "Store takes to long time");
+
+	return written;
+}
+
+static void store(int idx)
+{
+	(void)store_entries(idx, idx);
 }
 
 static void clear(void)
@@ -249,6 +269,13 @@ static bool pragma_several_store(const void *s)
 	return *state == EMDS_TS_SEVERAL_STORE;
 }
 
+static bool pragma_incremental_store(const void *s)
+{
+	const enum test_states *state = s;
+
+	return *state == EMDS_TS_INCREMENTAL_STORE;
+}
+
 #if CONFIG_SETTINGS
 static int emds_test_settings_set(const char *name, size_t len,
 				  settings_read_cb read_cb, void *cb_arg)
@@ -326,12 +353,46 @@ ZTEST(several_store, test_several_store)
 	load_flash(0);
 }
 
+ZTEST(incremental_store, test_incremental_store)
+{
+	size_t d_size = ARRAY_SIZE(d_entries) * (sizeof(d_data[0]) + sizeof(struct emds_data_entry));
+	size_t full_size;
+	size_t written;
+
+	zassert_equal(emds_store_size_get(&full_size), 0, "Getting store size failed");
+	full_size += sizeof(struct emds_snapshot_metadata);
+	d_size += sizeof(struct emds_snapshot_metadata);
+
+	/* Only the dynamic entries change. */
+	load_flash(0);
+	prepare();
+	written = store_entries(1, 0);
+	zassert_equal(written, IS_ENABLED(CONFIG_EMDS_INCREMENTAL) ? d_size : full_size,
+		      "Wrong written size: %zu", written);
+	load_entries(1, 0);
+
+	/* Nothing changes. */
+	prepare();
+	written = store_entries(1, 0);
+	zassert_equal(written, IS_ENABLED(CONFIG_EMDS_INCREMENTAL) ? 0 : full_size,
+		      "Wrong written size: %zu", written);
+	load_entries(1, 0);
+
+	/* The static entry is loaded from the oldest snapshot. */
+	prepare();
+	written = store_entries(0, 0);
+	zassert_equal(written, IS_ENABLED(CONFIG_EMDS_INCREMENTAL) ? d_size : full_size,
+		      "Wrong written size: %zu", written);
+	load_flash(0);
+}
+
 ZTEST_SUITE(_setup, pragma_always, NULL, NULL, NULL, NULL);
 ZTEST_SUITE(empty_flash, pragma_empty_flash, NULL, NULL, NULL, NULL);
 ZTEST_SUITE(store_data, pragma_store_data, NULL, NULL, NULL, NULL);
 ZTEST_SUITE(clear_flash, pragma_clear_flash, NULL, NULL, NULL, NULL);
 ZTEST_SUITE(no_store, pragma_no_store, NULL, NULL, NULL, NULL);
 ZTEST_SUITE(several_store, pragma_several_store, NULL, NULL, NULL, NULL);
+ZTEST_SUITE(incremental_store, pragma_incremental_store, NULL, NULL, NULL, NULL);
 
 void test_main(void)
 {
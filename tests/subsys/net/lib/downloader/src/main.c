@@ -8,12 +8,15 @@
 
 #include <net/downloader.h>
 #include <net/downloader_transport_coap.h>
+#include <net/downloader_transport_http.h>
 #include <zephyr/net/socket.h>
 #include <zephyr/net/coap.h>
+#include <zephyr/settings/settings.h>
 
 #include <zephyr/fff.h>
 #include <sys/types.h>
 #include <errno.h>
+#include <stdio.h>
 
 #define HOSTNAME "server.com"
 #define HOSTNAME2 "server2.com"
@@ -158,6 +161,18 @@
 
 #define FD 0
 
+#define PIPELINE_FILE_SIZE 4096
+#define PIPELINE_RANGE 256
+#define PIPELINE_DEPTH 4
+#define PIPELINE_RTT_MS 20
+
+#define COAP_WINDOW_FILE_SIZE 4096
+#define COAP_WINDOW_SIZE 4
+#define COAP_WINDOW_RTT_MS 20
+
+#define CHECKPOINT_NAME "test"
+#define CHECKPOINT_STOP_AT 2000
+
 static int dl_callback(const struct downloader_evt *event);
 static int dl_callback_abort(const struct downloader_evt *event);
 
@@ -201,6 +216,19 @@ static struct downloader_host_cfg dl_host_conf_w_sec_tags_range_override_32 = {
 	.range_override = 32,
 };
 
+static struct downloader_host_cfg dl_host_cfg_range_override = {
+	.pdn_id = 1,
+	.keep_connection = true,
+	.range_override = PIPELINE_RANGE,
+};
+
+static struct downloader_host_cfg dl_host_cfg_checkpoint = {
+	.pdn_id = 1,
+	.keep_connection = true,
+	.range_override = PIPELINE_RANGE,
+	.checkpoint = CHECKPOINT_NAME,
+};
+
 static struct downloader_host_cfg dl_host_conf_w_sec_tags_and_cid = {
 	.pdn_id = 1,
 	.sec_tag_list = sec_tags,
@@ -251,6 +279,13 @@ FAKE_VALUE_FUNC(int, coap_append_size2_option, struct coap_packet *, struct coap
 FAKE_VALUE_FUNC(struct coap_transmission_parameters, coap_get_transmission_parameters);
 FAKE_VALUE_FUNC(int, coap_pending_init, struct coap_pending *, const struct coap_packet *,
 		const struct sockaddr *, const struct coap_transmission_parameters *);
+FAKE_VALUE_FUNC(int, coap_find_options, const struct coap_packet *, uint16_t,
+		struct coap_option *, uint16_t);
+FAKE_VALUE_FUNC(int, coap_append_option_int, struct coap_packet *, uint16_t, unsigned int);
+FAKE_VALUE_FUNC(int, settings_save_one, const char *, const void *, size_t);
+FAKE_VALUE_FUNC(int, settings_delete, const char *);
+FAKE_VALUE_FUNC(int, settings_load_subtree_direct, const char *, settings_load_direct_cb,
+		void *);
 
 uint16_t message_id;
 uint16_t coap_next_id(void)
@@ -1136,6 +1171,420 @@ struct coap_transmission_parameters coap_get_transmission_parameters_ok(void)
 	return coap_transmission_params;
 }
 
+/* Fake HTTP server answering range requests one round-trip time after they are sent.
+ * Responses to pipelined requests are returned back to back, as they would be read
+ * from a TCP socket. The content of the file is the offset of each byte.
+ */
+static struct {
+	struct {
+		size_t from;
+		size_t to;
+		int64_t ready_at;
+	} requests[16];
+	size_t requests_cnt;
+	size_t requests_max;
+	const char *etag;
+	char response[512];
+	size_t response_len;
+	size_t response_off;
+} http_server;
+
+static void http_server_reset(void)
+{
+	memset(&http_server, 0, sizeof(http_server));
+	http_server.etag = "\"v1\"";
+}
+
+static bool http_server_response_next(void)
+{
+	size_t hdr_len;
+	size_t from = http_server.requests[0].from;
+	size_t to = http_server.requests[0].to;
+
+	if (!http_server.requests_cnt || http_server.requests[0].ready_at > k_uptime_get()) {
+		return false;
+	}
+
+	hdr_len = snprintf(http_server.response, sizeof(http_server.response),
+			   "HTTP/1.1 206 Partial Content\r\n"
+			   "Content-Range: bytes %u-%u/%u\r\n"
+			   "Content-Length: %u\r\n"
+			   "ETag: %s\r\n"
+			   "\r\n",
+			   (unsigned int)from, (unsigned int)to, PIPELINE_FILE_SIZE,
+			   (unsigned int)(to - from + 1), http_server.etag);
+	TEST_ASSERT(hdr_len + (to - from + 1) <= sizeof(http_server.response));
+
+	for (size_t i = from; i <= to; i++) {
+		http_server.response[hdr_len + i - from] = (uint8_t)i;
+	}
+
+	http_server.response_len = hdr_len + (to - from + 1);
+	http_server.response_off = 0;
+	http_server.requests_cnt--;
+	memmove(&http_server.requests[0], &http_server.requests[1],
+		http_server.requests_cnt * sizeof(http_server.requests[0]));
+
+	return true;
+}
+
+ssize_t z_impl_zsock_sendto_http_server(int sock, const void *buf, size_t len, int flags,
+					const struct sockaddr *dest_addr, socklen_t addrlen)
+{
+	char *p;
+	unsigned int from;
+	unsigned int to;
+
+	TEST_ASSERT_EQUAL(FD, sock);
+
+	p = strnstr(buf, "Range: bytes=", len);
+	TEST_ASSERT_NOT_NULL(p);
+	TEST_ASSERT_EQUAL(2, sscanf(p, "Range: bytes=%u-%u", &from, &to));
+	TEST_ASSERT(http_server.requests_cnt < ARRAY_SIZE(http_server.requests));
+
+	http_server.requests[http_server.requests_cnt].from = from;
+	http_server.requests[http_server.requests_cnt].to = to;
+	http_server.requests[http_server.requests_cnt].ready_at =
+		k_uptime_get() + PIPELINE_RTT_MS;
+	http_server.requests_cnt++;
+	http_server.requests_max = MAX(http_server.requests_max, http_server.requests_cnt);
+
+	return len;
+}
+
+static ssize_t z_impl_zsock_recvfrom_http_server(
+	int sock, void *buf, size_t max_len, int flags, struct sockaddr *src_addr,
+	socklen_t *addrlen)
+{
+	size_t len = 0;
+	size_t chunk;
+
+	TEST_ASSERT_EQUAL(FD, sock);
+
+	if (http_server.response_off == http_server.response_len) {
+		if (!http_server.requests_cnt) {
+			errno = EAGAIN;
+			return -1;
+		}
+
+		/* Wait for the first response to arrive */
+		k_sleep(K_TIMEOUT_ABS_MS(http_server.requests[0].ready_at));
+		http_server_response_next();
+	}
+
+	while (len < max_len) {
+		if (http_server.response_off == http_server.response_len &&
+		    !http_server_response_next()) {
+			break;
+		}
+
+		chunk = MIN(max_len - len, http_server.response_len - http_server.response_off);
+		memcpy((char *)buf + len, &http_server.response[http_server.response_off], chunk);
+		http_server.response_off += chunk;
+		len += chunk;
+	}
+
+	return len;
+}
+
+/* Fake CoAP server answering Block2 requests one round-trip time after they are sent.
+ * The CoAP library is faked as well: the server takes the message ID and the Block2 option of
+ * a request as they are added to it, and a response carries a struct coap_server_response
+ * followed by the payload. The content of the file is the offset of each byte.
+ */
+struct coap_server_response {
+	uint16_t id;
+	uint16_t len;
+	uint32_t block;
+};
+
+static struct {
+	struct {
+		uint16_t id;
+		uint32_t block;
+		int64_t ready_at;
+	} requests[16];
+	size_t requests_cnt;
+	size_t requests_max;
+	/* Request being built */
+	uint16_t id;
+	uint32_t block;
+	/* Largest block size sent by the server */
+	enum coap_block_size block_size_max;
+	/* Number of the request that is lost, if set */
+	size_t drop;
+	size_t sent;
+	uint32_t rcvtimeo;
+	struct coap_server_response response;
+	const uint8_t *payload;
+} coap_server;
+
+static void coap_server_reset(void)
+{
+	memset(&coap_server, 0, sizeof(coap_server));
+	coap_server.block_size_max = COAP_BLOCK_1024;
+}
+
+static int coap_packet_init_server(struct coap_packet *cpkt, uint8_t *data, uint16_t max_len,
+				   uint8_t ver, uint8_t type, uint8_t token_len,
+				   const uint8_t *token, uint8_t code, uint16_t id)
+{
+	cpkt->data = data;
+	cpkt->offset = 4;
+	cpkt->max_len = max_len;
+	coap_server.id = id;
+
+	return 0;
+}
+
+static int coap_append_option_int_server(struct coap_packet *cpkt, uint16_t code,
+					 unsigned int val)
+{
+	if (code == COAP_OPTION_BLOCK2) {
+		coap_server.block = val;
+	}
+
+	return 0;
+}
+
+static int coap_append_block2_option_server(struct coap_packet *cpkt,
+					    struct coap_block_context *ctx)
+{
+	coap_server.block = ((ctx->current / coap_block_size_to_bytes(ctx->block_size)) << 4) |
+			    ctx->block_size;
+
+	return 0;
+}
+
+static int coap_block_transfer_init_server(struct coap_block_context *ctx,
+					   enum coap_block_size block_size, size_t total_size)
+{
+	ctx->block_size = block_size;
+	ctx->total_size = total_size;
+	ctx->current = 0;
+
+	return 0;
+}
+
+static int coap_update_from_block_server(const struct coap_packet *cpkt,
+					 struct coap_block_context *ctx)
+{
+	ctx->total_size = COAP_WINDOW_FILE_SIZE;
+
+	return 0;
+}
+
+static size_t coap_next_block_server(const struct coap_packet *cpkt,
+				     struct coap_block_context *ctx)
+{
+	ctx->current += coap_server.response.len;
+
+	return ctx->current < ctx->total_size ? ctx->current : 0;
+}
+
+static int coap_pending_init_server(struct coap_pending *pending,
+				    const struct coap_packet *request,
+				    const struct sockaddr *addr,
+				    const struct coap_transmission_parameters *params)
+{
+	pending->id = coap_server.id;
+	pending->timeout = 0;
+	pending->retries = params->max_retransmission;
+
+	return 0;
+}
+
+static bool coap_pending_cycle_server(struct coap_pending *pending)
+{
+	if (pending->timeout == 0) {
+		pending->timeout = 4 * COAP_WINDOW_RTT_MS;
+	} else if (pending->retries-- > 0) {
+		pending->timeout *= 2;
+	} else {
+		return false;
+	}
+
+	pending->t0 = k_uptime_get_32();
+
+	return true;
+}
+
+static void coap_pending_clear_server(struct coap_pending *pending)
+{
+	pending->timeout = 0;
+}
+
+static struct coap_transmission_parameters coap_get_transmission_parameters_server(void)
+{
+	return (struct coap_transmission_parameters) {
+		.ack_timeout = 4 * COAP_WINDOW_RTT_MS,
+		.coap_backoff_percent = 150,
+		.max_retransmission = 4,
+	};
+}
+
+static int coap_packet_parse_server(struct coap_packet *cpkt, uint8_t *data, uint16_t len,
+				    struct coap_option *options, uint8_t opt_num)
+{
+	TEST_ASSERT(len >= sizeof(coap_server.response));
+
+	memcpy(&coap_server.response, data, sizeof(coap_server.response));
+	coap_server.payload = data + sizeof(coap_server.response);
+
+	return 0;
+}
+
+static uint16_t coap_header_get_id_server(const struct coap_packet *cpkt)
+{
+	return coap_server.response.id;
+}
+
+static int coap_get_option_int_server(const struct coap_packet *cpkt, uint16_t code)
+{
+	switch (code) {
+	case COAP_OPTION_BLOCK2:
+		return coap_server.response.block;
+	case COAP_OPTION_SIZE2:
+		return COAP_WINDOW_FILE_SIZE;
+	default:
+		return -ENOENT;
+	}
+}
+
+static const uint8_t *coap_packet_get_payload_server(const struct coap_packet *cpkt,
+						     uint16_t *len)
+{
+	*len = coap_server.response.len;
+
+	return coap_server.payload;
+}
+
+static int z_impl_zsock_setsockopt_coap_server(int sock, int level, int optname,
+					       const void *optval, socklen_t optlen)
+{
+	const struct timeval *timeo = optval;
+
+	if (level == SOL_SOCKET && optname == SO_RCVTIMEO) {
+		coap_server.rcvtimeo = timeo->tv_sec * MSEC_PER_SEC + timeo->tv_usec / USEC_PER_MSEC;
+	}
+
+	return 0;
+}
+
+static ssize_t z_impl_zsock_sendto_coap_server(int sock, const void *buf, size_t len, int flags,
+					       const struct sockaddr *dest_addr,
+					       socklen_t addrlen)
+{
+	TEST_ASSERT_EQUAL(FD, sock);
+
+	coap_server.sent++;
+	if (coap_server.sent == coap_server.drop) {
+		return len;
+	}
+
+	TEST_ASSERT(coap_server.requests_cnt < ARRAY_SIZE(coap_server.requests));
+
+	coap_server.requests[coap_server.requests_cnt].id = coap_server.id;
+	coap_server.requests[coap_server.requests_cnt].block = coap_server.block;
+	coap_server.requests[coap_server.requests_cnt].ready_at =
+		k_uptime_get() + COAP_WINDOW_RTT_MS;
+	coap_server.requests_cnt++;
+	coap_server.requests_max = MAX(coap_server.requests_max, coap_server.requests_cnt);
+
+	return len;
+}
+
+static ssize_t z_impl_zsock_recvfrom_coap_server(
+	int sock, void *buf, size_t max_len, int flags, struct sockaddr *src_addr,
+	socklen_t *addrlen)
+{
+	struct coap_server_response response;
+	uint8_t *payload = (uint8_t *)buf + sizeof(response);
+	enum coap_block_size szx;
+	size_t offset;
+
+	TEST_ASSERT_EQUAL(FD, sock);
+
+	if (!coap_server.requests_cnt ||
+	    coap_server.requests[0].ready_at > k_uptime_get() + coap_server.rcvtimeo) {
+		k_sleep(K_MSEC(coap_server.rcvtimeo));
+		errno = EAGAIN;
+		return -1;
+	}
+
+	k_sleep(K_TIMEOUT_ABS_MS(coap_server.requests[0].ready_at));
+
+	/* The server may answer with a smaller block than requested */
+	szx = GET_BLOCK_SIZE(coap_server.requests[0].block);
+	offset = GET_BLOCK_NUM(coap_server.requests[0].block) * coap_block_size_to_bytes(szx);
+	szx = MIN(szx, coap_server.block_size_max);
+
+	response.id = coap_server.requests[0].id;
+	response.len = MIN(coap_block_size_to_bytes(szx), COAP_WINDOW_FILE_SIZE - offset);
+	response.block = ((offset / coap_block_size_to_bytes(szx)) << 4) | szx;
+	if (offset + response.len < COAP_WINDOW_FILE_SIZE) {
+		response.block |= 0x08;
+	}
+
+	TEST_ASSERT(sizeof(response) + response.len <= max_len);
+
+	memcpy(buf, &response, sizeof(response));
+	for (size_t i = 0; i < response.len; i++) {
+		payload[i] = (uint8_t)(offset + i);
+	}
+
+	coap_server.requests_cnt--;
+	memmove(&coap_server.requests[0], &coap_server.requests[1],
+		coap_server.requests_cnt * sizeof(coap_server.requests[0]));
+
+	return sizeof(response) + response.len;
+}
+
+/* Settings storage holding a single value in RAM */
+static struct {
+	char key[32];
+	uint8_t value[128];
+	size_t len;
+} settings_store;
+
+static int settings_save_one_ram(const char *name, const void *value, size_t val_len)
+{
+	TEST_ASSERT(val_len <= sizeof(settings_store.value));
+
+	strncpy(settings_store.key, name, sizeof(settings_store.key) - 1);
+	memcpy(settings_store.value, value, val_len);
+	settings_store.len = val_len;
+
+	return 0;
+}
+
+static int settings_delete_ram(const char *name)
+{
+	if (strcmp(settings_store.key, name) == 0) {
+		memset(&settings_store, 0, sizeof(settings_store));
+	}
+
+	return 0;
+}
+
+static ssize_t settings_store_read(void *cb_arg, void *data, size_t len)
+{
+	len = MIN(len, settings_store.len);
+	memcpy(data, settings_store.value, len);
+
+	return len;
+}
+
+static int settings_load_subtree_direct_ram(const char *subtree, settings_load_direct_cb cb,
+					    void *param)
+{
+	if (settings_store.len && strcmp(settings_store.key, subtree) == 0) {
+		return cb("", settings_store.len, settings_store_read, NULL, param);
+	}
+
+	return 0;
+}
+
 struct pipe {
 	struct downloader_evt data[10];
 	uint8_t wr_idx;
@@ -1232,6 +1681,42 @@ static int dl_callback_abort(const struct downloader_evt *event)
 	return 1; /* stop download*/
 }
 
+static size_t dl_received;
+static size_t dl_corrupted;
+static size_t dl_stop_at;
+
+/* Verifies the content served by the fake HTTP server, without queueing fragment events.
+ * Refuses the fragment that would go past dl_stop_at, if set.
+ */
+static int dl_callback_verify(const struct downloader_evt *event)
+{
+	const uint8_t *data;
+
+	TEST_ASSERT(event != NULL);
+
+	if (event->id != DOWNLOADER_EVT_FRAGMENT) {
+		printk("event: %s\n", dl_event_id_str(event->id));
+		pipe_put(&event_pipe, event);
+		/* Stop on errors */
+		return event->id == DOWNLOADER_EVT_ERROR;
+	}
+
+	if (dl_stop_at && dl_received + event->fragment.len > dl_stop_at) {
+		return 1;
+	}
+
+	data = event->fragment.buf;
+	for (size_t i = 0; i < event->fragment.len; i++) {
+		if (data[i] != (uint8_t)(dl_received + i)) {
+			dl_corrupted++;
+		}
+	}
+
+	dl_received += event->fragment.len;
+
+	return 0;
+}
+
 static struct downloader_evt dl_wait_for_event(enum downloader_evt_id event,
 						     k_timeout_t timeout)
 {
@@ -1449,6 +1934,179 @@ void test_downloader_get_https_partial_content_partial_2nd_header(void)
 	dl_wait_for_event(DOWNLOADER_EVT_DEINITIALIZED, K_SECONDS(1));
 }
 
+static int64_t dl_http_ranged_download(uint8_t pipeline_depth)
+{
+	int err;
+	int64_t start;
+	struct downloader_cfg cfg = {
+		.callback = dl_callback_verify,
+		.buf = dl_buf,
+		.buf_size = sizeof(dl_buf),
+	};
+	struct downloader_transport_http_cfg http_cfg = {
+		.pipeline_depth = pipeline_depth,
+	};
+
+	http_server_reset();
+	dl_received = 0;
+	dl_corrupted = 0;
+	dl_stop_at = 0;
+
+	err = downloader_init(&dl, &cfg);
+	TEST_ASSERT_EQUAL(0, err);
+
+	err = downloader_transport_http_set_config(&dl, &http_cfg);
+	TEST_ASSERT_EQUAL(0, err);
+
+	zsock_getaddrinfo_fake.custom_fake = zsock_getaddrinfo_server_ipv6_fail_ipv4_ok;
+	zsock_freeaddrinfo_fake.custom_fake = zsock_freeaddrinfo_server_ipv4;
+	z_impl_zsock_socket_fake.custom_fake = z_impl_zsock_socket_http_ipv4_ok;
+	z_impl_zsock_connect_fake.custom_fake = z_impl_zsock_connect_ipv4_ok;
+	z_impl_zsock_setsockopt_fake.custom_fake = z_impl_zsock_setsockopt_http_ok;
+	z_impl_zsock_sendto_fake.custom_fake = z_impl_zsock_sendto_http_server;
+	z_impl_zsock_recvfrom_fake.custom_fake = z_impl_zsock_recvfrom_http_server;
+
+	start = k_uptime_get();
+
+	err = downloader_get(&dl, &dl_host_cfg_range_override, HTTP_URL, 0);
+	TEST_ASSERT_EQUAL(0, err);
+
+	dl_wait_for_event(DOWNLOADER_EVT_DONE, K_SECONDS(3));
+
+	start = k_uptime_get() - start;
+
+	TEST_ASSERT_EQUAL(PIPELINE_FILE_SIZE, dl_received);
+	TEST_ASSERT_EQUAL(0, dl_corrupted);
+	TEST_ASSERT_EQUAL(PIPELINE_FILE_SIZE / PIPELINE_RANGE, z_impl_zsock_sendto_fake.call_count);
+	TEST_ASSERT(http_server.requests_max <= MAX(pipeline_depth, 1));
+
+	downloader_deinit(&dl);
+	dl_wait_for_event(DOWNLOADER_EVT_DEINITIALIZED, K_SECONDS(1));
+
+	return MAX(start, 1);
+}
+
+void test_downloader_get_http_pipelined(void)
+{
+	dl_http_ranged_download(PIPELINE_DEPTH);
+
+	/* Ranges were requested before the previous ones were received */
+	TEST_ASSERT(http_server.requests_max > 1);
+}
+
+void test_downloader_get_http_pipelined_throughput(void)
+{
+	int64_t sequential;
+	int64_t pipelined;
+
+	sequential = dl_http_ranged_download(1);
+	pipelined = dl_http_ranged_download(PIPELINE_DEPTH);
+
+	printk("%d ranges of %d bytes, RTT %d ms\n", PIPELINE_FILE_SIZE / PIPELINE_RANGE,
+	       PIPELINE_RANGE, PIPELINE_RTT_MS);
+	printk("pipeline depth 1: %lld ms, %lld B/s\n", sequential,
+	       (int64_t)PIPELINE_FILE_SIZE * MSEC_PER_SEC / sequential);
+	printk("pipeline depth %d: %lld ms, %lld B/s\n", PIPELINE_DEPTH, pipelined,
+	       (int64_t)PIPELINE_FILE_SIZE * MSEC_PER_SEC / pipelined);
+
+	TEST_ASSERT(pipelined * 2 < sequential);
+}
+
+static struct downloader_evt dl_checkpoint_download(size_t from, size_t stop_at,
+						     enum downloader_evt_id expected)
+{
+	int err;
+	struct downloader_evt evt;
+	struct downloader_cfg cfg = {
+		.callback = dl_callback_verify,
+		.buf = dl_buf,
+		.buf_size = sizeof(dl_buf),
+	};
+
+	dl_received = from;
+	dl_corrupted = 0;
+	dl_stop_at = stop_at;
+	http_server.requests_cnt = 0;
+	http_server.response_len = 0;
+	http_server.response_off = 0;
+
+	err = downloader_init(&dl, &cfg);
+	TEST_ASSERT_EQUAL(0, err);
+
+	zsock_getaddrinfo_fake.custom_fake = zsock_getaddrinfo_server_ipv6_fail_ipv4_ok;
+	zsock_freeaddrinfo_fake.custom_fake = zsock_freeaddrinfo_server_ipv4;
+	z_impl_zsock_socket_fake.custom_fake = z_impl_zsock_socket_http_ipv4_ok;
+	z_impl_zsock_connect_fake.custom_fake = z_impl_zsock_connect_ipv4_ok;
+	z_impl_zsock_setsockopt_fake.custom_fake = z_impl_zsock_setsockopt_http_ok;
+	z_impl_zsock_sendto_fake.custom_fake = z_impl_zsock_sendto_http_server;
+	z_impl_zsock_recvfrom_fake.custom_fake = z_impl_zsock_recvfrom_http_server;
+	settings_save_one_fake.custom_fake = settings_save_one_ram;
+	settings_delete_fake.custom_fake = settings_delete_ram;
+	settings_load_subtree_direct_fake.custom_fake = settings_load_subtree_direct_ram;
+
+	err = downloader_get(&dl, &dl_host_cfg_checkpoint, HTTP_URL, from);
+	TEST_ASSERT_EQUAL(0, err);
+
+	evt = dl_wait_for_event(expected, K_SECONDS(3));
+	TEST_ASSERT_EQUAL(0, dl_corrupted);
+
+	downloader_deinit(&dl);
+	dl_wait_for_event(DOWNLOADER_EVT_DEINITIALIZED, K_SECONDS(1));
+
+	return evt;
+}
+
+void test_downloader_checkpoint_resume(void)
+{
+	int err;
+	size_t from;
+
+	http_server_reset();
+	memset(&settings_store, 0, sizeof(settings_store));
+
+	dl_checkpoint_download(0, CHECKPOINT_STOP_AT, DOWNLOADER_EVT_STOPPED);
+	/* File version, intermediate checkpoint and final checkpoint when stopped */
+	TEST_ASSERT(settings_save_one_fake.call_count >= 3);
+
+	err = downloader_checkpoint_get(CHECKPOINT_NAME, HTTP_URL_FILE2, &from);
+	TEST_ASSERT_EQUAL(-ESTALE, err);
+
+	err = downloader_checkpoint_get(CHECKPOINT_NAME, HTTP_URL, &from);
+	TEST_ASSERT_EQUAL(0, err);
+	TEST_ASSERT_EQUAL(dl_received, from);
+	TEST_ASSERT(from > 0 && from <= CHECKPOINT_STOP_AT);
+
+	/* Resume, as after a reboot */
+	dl_checkpoint_download(from, 0, DOWNLOADER_EVT_DONE);
+	TEST_ASSERT_EQUAL(PIPELINE_FILE_SIZE, dl_received);
+
+	/* The checkpoint is deleted when the download completes */
+	err = downloader_checkpoint_get(CHECKPOINT_NAME, HTTP_URL, &from);
+	TEST_ASSERT_EQUAL(-ENOENT, err);
+}
+
+void test_downloader_checkpoint_file_changed(void)
+{
+	int err;
+	size_t from;
+	struct downloader_evt evt;
+
+	http_server_reset();
+	memset(&settings_store, 0, sizeof(settings_store));
+
+	dl_checkpoint_download(0, CHECKPOINT_STOP_AT, DOWNLOADER_EVT_STOPPED);
+
+	err = downloader_checkpoint_get(CHECKPOINT_NAME, HTTP_URL, &from);
+	TEST_ASSERT_EQUAL(0, err);
+
+	/* The file is replaced on the server */
+	http_server.etag = "\"v2\"";
+
+	evt = dl_checkpoint_download(from, 0, DOWNLOADER_EVT_ERROR);
+	TEST_ASSERT_EQUAL(-ESTALE, evt.error);
+	TEST_ASSERT_EQUAL(from, dl_received);
+}
+
 void test_downloader_https_unlimited_redirect(void)
 {
 	int err;
@@ -1959,6 +2617,124 @@ void test_downloader_get_coap_bad_header_code_timeout(void)
 	dl_wait_for_event(DOWNLOADER_EVT_DEINITIALIZED, K_SECONDS(1));
 }
 
+static int64_t dl_coap_windowed_download(uint8_t window_size)
+{
+	int err;
+	int64_t start;
+	struct downloader_cfg cfg = {
+		.callback = dl_callback_verify,
+		.buf = dl_buf,
+		.buf_size = sizeof(dl_buf),
+	};
+	struct downloader_transport_coap_cfg coap_cfg = {
+		.block_size = COAP_BLOCK_256,
+		.max_retransmission = 4,
+		.window_size = window_size,
+	};
+
+	dl_received = 0;
+	dl_corrupted = 0;
+	dl_stop_at = 0;
+
+	err = downloader_init(&dl, &cfg);
+	TEST_ASSERT_EQUAL(0, err);
+
+	err = downloader_transport_coap_set_config(&dl, &coap_cfg);
+	TEST_ASSERT_EQUAL(0, err);
+
+	zsock_getaddrinfo_fake.custom_fake = zsock_getaddrinfo_server_ok;
+	zsock_freeaddrinfo_fake.custom_fake = zsock_freeaddrinfo_server_ipv6;
+	z_impl_zsock_socket_fake.custom_fake = z_impl_zsock_socket_coap_ipv6_ok;
+	z_impl_zsock_connect_fake.custom_fake = z_impl_zsock_connect_ipv6_ok;
+	z_impl_zsock_setsockopt_fake.custom_fake = z_impl_zsock_setsockopt_coap_server;
+	z_impl_zsock_sendto_fake.custom_fake = z_impl_zsock_sendto_coap_server;
+	z_impl_zsock_recvfrom_fake.custom_fake = z_impl_zsock_recvfrom_coap_server;
+
+	coap_packet_init_fake.custom_fake = coap_packet_init_server;
+	coap_append_option_int_fake.custom_fake = coap_append_option_int_server;
+	coap_append_block2_option_fake.custom_fake = coap_append_block2_option_server;
+	coap_block_transfer_init_fake.custom_fake = coap_block_transfer_init_server;
+	coap_update_from_block_fake.custom_fake = coap_update_from_block_server;
+	coap_next_block_fake.custom_fake = coap_next_block_server;
+	coap_pending_init_fake.custom_fake = coap_pending_init_server;
+	coap_pending_cycle_fake.custom_fake = coap_pending_cycle_server;
+	coap_pending_clear_fake.custom_fake = coap_pending_clear_server;
+	coap_get_transmission_parameters_fake.custom_fake = coap_get_transmission_parameters_server;
+	coap_packet_parse_fake.custom_fake = coap_packet_parse_server;
+	coap_header_get_id_fake.custom_fake = coap_header_get_id_server;
+	coap_header_get_type_fake.custom_fake = coap_header_get_type_ack;
+	coap_header_get_code_fake.custom_fake = coap_header_get_code_ok;
+	coap_get_option_int_fake.custom_fake = coap_get_option_int_server;
+	coap_packet_get_payload_fake.custom_fake = coap_packet_get_payload_server;
+
+	start = k_uptime_get();
+
+	err = downloader_get(&dl, &dl_host_cfg, COAP_URL, 0);
+	TEST_ASSERT_EQUAL(0, err);
+
+	dl_wait_for_event(DOWNLOADER_EVT_DONE, K_SECONDS(3));
+
+	start = k_uptime_get() - start;
+
+	TEST_ASSERT_EQUAL(COAP_WINDOW_FILE_SIZE, dl_received);
+	TEST_ASSERT_EQUAL(0, dl_corrupted);
+	TEST_ASSERT(coap_server.requests_max <= MAX(window_size, 1));
+
+	downloader_deinit(&dl);
+	dl_wait_for_event(DOWNLOADER_EVT_DEINITIALIZED, K_SECONDS(1));
+
+	return MAX(start, 1);
+}
+
+void test_downloader_get_coap_windowed(void)
+{
+	int64_t lockstep;
+	int64_t windowed;
+	size_t blocks = COAP_WINDOW_FILE_SIZE / 256;
+
+	coap_server_reset();
+	lockstep = dl_coap_windowed_download(1);
+	TEST_ASSERT_EQUAL(blocks, coap_server.sent);
+
+	coap_server_reset();
+	windowed = dl_coap_windowed_download(COAP_WINDOW_SIZE);
+	TEST_ASSERT_EQUAL(blocks, coap_server.sent);
+
+	/* Blocks were requested before the previous ones were received */
+	TEST_ASSERT(coap_server.requests_max > 1);
+
+	printk("%zu blocks of %d bytes, RTT %d ms\n", blocks, 256, COAP_WINDOW_RTT_MS);
+	printk("window 1: %lld ms, %lld B/s\n", lockstep,
+	       (int64_t)COAP_WINDOW_FILE_SIZE * MSEC_PER_SEC / lockstep);
+	printk("window %d: %lld ms, %lld B/s\n", COAP_WINDOW_SIZE, windowed,
+	       (int64_t)COAP_WINDOW_FILE_SIZE * MSEC_PER_SEC / windowed);
+
+	TEST_ASSERT(windowed * 2 < lockstep);
+}
+
+void test_downloader_get_coap_windowed_block_lost(void)
+{
+	coap_server_reset();
+	/* Lose the request of the third block, the following ones are received before it */
+	coap_server.drop = 3;
+
+	dl_coap_windowed_download(COAP_WINDOW_SIZE);
+
+	/* Only the lost block was requested again */
+	TEST_ASSERT_EQUAL(COAP_WINDOW_FILE_SIZE / 256 + 1, coap_server.sent);
+}
+
+void test_downloader_get_coap_windowed_block_size(void)
+{
+	coap_server_reset();
+	coap_server.block_size_max = COAP_BLOCK_128;
+
+	dl_coap_windowed_download(COAP_WINDOW_SIZE);
+
+	/* The first block of the smaller size was kept, the rest were requested at that size */
+	TEST_ASSERT_EQUAL(COAP_WINDOW_FILE_SIZE / 128, coap_server.sent);
+}
+
 void test_downloader_get_einval(void)
 {
 	int err;
@@ -2507,6 +3283,11 @@ void setUp(void)
 	RESET_FAKE(coap_append_size2_option);
 	RESET_FAKE(coap_get_transmission_parameters);
 	RESET_FAKE(coap_pending_init);
+	RESET_FAKE(coap_find_options);
+	RESET_FAKE(coap_append_option_int);
+	RESET_FAKE(settings_save_one);
+	RESET_FAKE(settings_delete);
+	RESET_FAKE(settings_load_subtree_direct);
 
 	pipe_reset(&event_pipe);
 }
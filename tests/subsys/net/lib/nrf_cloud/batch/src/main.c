@@ -0,0 +1,262 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <zephyr/fff.h>
+#include <zephyr/ztest.h>
+#include <modem/lte_lc.h>
+#include <net/nrf_cloud.h>
+#include <net/nrf_cloud_batch.h>
+#include <nrf_cloud_fsm.h>
+
+DEFINE_FFF_GLOBALS;
+
+#define SENT_MAX     8
+#define SENT_SIZE    CONFIG_NRF_CLOUD_BATCH_BUF_SIZE
+#define SAMPLE_TS    1735686000123LL
+#define MAX_AGE_WAIT K_MSEC(CONFIG_NRF_CLOUD_BATCH_MAX_AGE * MSEC_PER_SEC + 500)
+
+FAKE_VALUE_FUNC(int, nrf_cloud_send, const struct nrf_cloud_tx_data *);
+FAKE_VALUE_FUNC(enum nfsm_state, nfsm_get_current_state);
+FAKE_VALUE_FUNC(int, nrf_cloud_sensor_data_json_write, const struct nrf_cloud_sensor_data *,
+		char *, size_t *);
+FAKE_VALUE_FUNC(const char *, nrf_cloud_sensor_app_id_lookup, enum nrf_cloud_sensor);
+FAKE_VALUE_FUNC(int, date_time_now, int64_t *);
+FAKE_VOID_FUNC(lte_lc_register_handler, lte_lc_evt_handler_t);
+
+/* Copies of the bulk messages sent, as the batch buffer is reused */
+static char sent[SENT_MAX][SENT_SIZE];
+static size_t sent_count;
+
+static int nrf_cloud_send_custom(const struct nrf_cloud_tx_data *msg)
+{
+	zassert_equal(msg->topic_type, NRF_CLOUD_TOPIC_BULK);
+	zassert_true(msg->data.len < SENT_SIZE);
+	zassert_true(sent_count < SENT_MAX);
+
+	memcpy(sent[sent_count], msg->data.ptr, msg->data.len);
+	sent[sent_count][msg->data.len] = '\0';
+	sent_count++;
+
+	return 0;
+}
+
+static enum nfsm_state nfsm_get_current_state_connected(void)
+{
+	return STATE_DC_CONNECTED;
+}
+
+static enum nfsm_state nfsm_get_current_state_disconnected(void)
+{
+	return STATE_CONNECTED;
+}
+
+/* Same semantics as the library implementation, with a simpler message */
+static int nrf_cloud_sensor_data_json_write_custom(const struct nrf_cloud_sensor_data *sensor,
+						   char *buf, size_t *len)
+{
+	char msg[SENT_SIZE];
+	int msg_len;
+
+	if (sensor->ts_ms > 0) {
+		msg_len = snprintf(msg, sizeof(msg), "{\"appId\":\"TEMP\",\"data\":\"%s\",\"ts\":%lld}",
+				   (const char *)sensor->data.ptr, (long long)sensor->ts_ms);
+	} else {
+		msg_len = snprintf(msg, sizeof(msg), "{\"appId\":\"TEMP\",\"data\":\"%s\"}",
+				   (const char *)sensor->data.ptr);
+	}
+
+	if (buf) {
+		if ((size_t)msg_len >= *len) {
+			return -E2BIG;
+		}
+		memcpy(buf, msg, msg_len + 1);
+	}
+
+	*len = msg_len;
+
+	return 0;
+}
+
+static int date_time_now_custom(int64_t *ts)
+{
+	*ts = SAMPLE_TS;
+
+	return 0;
+}
+
+static int sensor_add(const char *data)
+{
+	const struct nrf_cloud_sensor_data sensor = {
+		.type = NRF_CLOUD_SENSOR_TEMP,
+		.data.ptr = data,
+		.data.len = strlen(data),
+		.ts_ms = NRF_CLOUD_NO_TIMESTAMP,
+	};
+
+	return nrf_cloud_batch_sensor_data_add(&sensor);
+}
+
+static void before_each(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	RESET_FAKE(nrf_cloud_send);
+	RESET_FAKE(nfsm_get_current_state);
+	RESET_FAKE(nrf_cloud_sensor_data_json_write);
+	RESET_FAKE(nrf_cloud_sensor_app_id_lookup);
+	RESET_FAKE(date_time_now);
+
+	nrf_cloud_send_fake.custom_fake = nrf_cloud_send_custom;
+	nfsm_get_current_state_fake.custom_fake = nfsm_get_current_state_connected;
+	nrf_cloud_sensor_data_json_write_fake.custom_fake =
+		nrf_cloud_sensor_data_json_write_custom;
+	nrf_cloud_sensor_app_id_lookup_fake.return_val = "TEMP";
+	date_time_now_fake.return_val = -ENODATA;
+
+	nrf_cloud_batch_clear();
+	sent_count = 0;
+}
+
+ZTEST(nrf_cloud_batch, test_bulk_message)
+{
+	zassert_ok(sensor_add("1"));
+	zassert_ok(sensor_add("2"));
+	zassert_ok(nrf_cloud_batch_msg_add("{\"appId\":\"HUMID\",\"data\":\"3\"}"));
+	zassert_equal(nrf_cloud_batch_count_get(), 3);
+	zassert_equal(nrf_cloud_send_fake.call_count, 0);
+
+	zassert_ok(nrf_cloud_batch_flush());
+	zassert_equal(nrf_cloud_batch_count_get(), 0);
+	zassert_equal(sent_count, 1);
+	zassert_str_equal(sent[0], "[{\"appId\":\"TEMP\",\"data\":\"1\"},"
+				   "{\"appId\":\"TEMP\",\"data\":\"2\"},"
+				   "{\"appId\":\"HUMID\",\"data\":\"3\"}]");
+
+	/* Nothing left to send */
+	zassert_ok(nrf_cloud_batch_flush());
+	zassert_equal(sent_count, 1);
+}
+
+ZTEST(nrf_cloud_batch, test_timestamp)
+{
+	date_time_now_fake.custom_fake = date_time_now_custom;
+
+	zassert_ok(sensor_add("1"));
+	zassert_ok(nrf_cloud_batch_flush());
+	zassert_equal(sent_count, 1);
+	zassert_str_equal(sent[0], "[{\"appId\":\"TEMP\",\"data\":\"1\",\"ts\":1735686000123}]");
+}
+
+ZTEST(nrf_cloud_batch, test_flush_when_full)
+{
+	char data[8];
+	int added = 0;
+	size_t received = 0;
+
+	while (sent_count < 2) {
+		snprintf(data, sizeof(data), "%d", added);
+		zassert_ok(sensor_add(data));
+		added++;
+	}
+
+	/* Each bulk message is complete, and no sample is lost or sent twice */
+	for (size_t i = 0; i < sent_count; i++) {
+		size_t len = strlen(sent[i]);
+
+		zassert_true(len < CONFIG_NRF_CLOUD_BATCH_BUF_SIZE);
+		zassert_equal(sent[i][0], '[');
+		zassert_equal(sent[i][len - 1], ']');
+
+		for (const char *msg = sent[i]; (msg = strstr(msg, "\"data\":\"")) != NULL;
+		     msg++) {
+			zassert_equal(atoi(msg + strlen("\"data\":\"")), received);
+			received++;
+		}
+	}
+
+	zassert_equal(received + nrf_cloud_batch_count_get(), added);
+}
+
+ZTEST(nrf_cloud_batch, test_kept_when_not_connected)
+{
+	size_t count;
+	int err;
+
+	nfsm_get_current_state_fake.custom_fake = nfsm_get_current_state_disconnected;
+
+	zassert_ok(sensor_add("1"));
+	zassert_equal(nrf_cloud_batch_flush(), -EACCES);
+	zassert_equal(nrf_cloud_batch_count_get(), 1);
+
+	/* New messages are rejected once the batch is full */
+	do {
+		count = nrf_cloud_batch_count_get();
+		err = sensor_add("1");
+	} while (err == 0);
+
+	zassert_equal(err, -ENOBUFS);
+	zassert_equal(nrf_cloud_batch_count_get(), count);
+	zassert_equal(sent_count, 0);
+
+	nfsm_get_current_state_fake.custom_fake = nfsm_get_current_state_connected;
+	zassert_ok(nrf_cloud_batch_flush());
+	zassert_equal(sent_count, 1);
+	zassert_equal(nrf_cloud_batch_count_get(), 0);
+}
+
+ZTEST(nrf_cloud_batch, test_message_too_big)
+{
+	char msg[CONFIG_NRF_CLOUD_BATCH_BUF_SIZE];
+
+	memset(msg, 'x', sizeof(msg) - 1);
+	msg[0] = '{';
+	msg[sizeof(msg) - 1] = '\0';
+
+	zassert_equal(nrf_cloud_batch_msg_add(msg), -E2BIG);
+	zassert_equal(nrf_cloud_batch_msg_add("[]"), -EINVAL);
+	zassert_equal(nrf_cloud_batch_count_get(), 0);
+}
+
+ZTEST(nrf_cloud_batch, test_max_age)
+{
+	zassert_ok(sensor_add("1"));
+	zassert_equal(sent_count, 0);
+
+	k_sleep(MAX_AGE_WAIT);
+	zassert_equal(sent_count, 1);
+	zassert_equal(nrf_cloud_batch_count_get(), 0);
+}
+
+ZTEST(nrf_cloud_batch, test_flush_on_rrc_connected)
+{
+	lte_lc_evt_handler_t handler;
+	struct lte_lc_evt evt = {
+		.type = LTE_LC_EVT_RRC_UPDATE,
+		.rrc_mode = LTE_LC_RRC_MODE_CONNECTED,
+	};
+
+	zassert_ok(sensor_add("1"));
+
+	/* The handler is registered once, when the first message is added */
+	zassert_equal(lte_lc_register_handler_fake.call_count, 1);
+	handler = lte_lc_register_handler_fake.arg0_val;
+
+	evt.rrc_mode = LTE_LC_RRC_MODE_IDLE;
+	handler(&evt);
+	k_sleep(K_MSEC(10));
+	zassert_equal(sent_count, 0);
+
+	evt.rrc_mode = LTE_LC_RRC_MODE_CONNECTED;
+	handler(&evt);
+	k_sleep(K_MSEC(10));
+	zassert_equal(sent_count, 1);
+	zassert_equal(nrf_cloud_batch_count_get(), 0);
+}
+
+ZTEST_SUITE(nrf_cloud_batch, NULL, NULL, before_each, NULL, NULL);
@@ -0,0 +1,372 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <stdlib.h>
+#include <string.h>
+#include <cJSON.h>
+#include <net/nrf_cloud_defs.h>
+#include "nrf_cloud_json_writer.h"
+
+#define MSG_BUF_SIZE	   256
+#define BENCHMARK_ROUNDS   200
+#define SAMPLE_TS	   1735686000123LL
+#define SAMPLE_SENSOR_DATA "23.45"
+#define SAMPLE_LOG_LEVEL   3
+
+struct sample_pvt {
+	double lat;
+	double lon;
+	double accuracy;
+	double alt;
+	double speed;
+	double heading;
+};
+
+static const struct sample_pvt pvt = {
+	.lat = 63.42198706744704,
+	.lon = 10.437808861037931,
+	.accuracy = 12.5,
+	.alt = 46.3,
+	.speed = 0.1,
+	.heading = 271.35,
+};
+
+enum msg_type {
+	MSG_SENSOR,
+	MSG_PVT,
+	MSG_NUMBER,
+	MSG_SHADOW_CTRL,
+	MSG_TYPE_COUNT
+};
+
+static const char *const msg_type_str[] = {
+	[MSG_SENSOR] = "sensor",
+	[MSG_PVT] = "PVT",
+	[MSG_NUMBER] = "message",
+	[MSG_SHADOW_CTRL] = "control",
+};
+
+/* Heap usage of cJSON, tracked through its allocation hooks */
+static size_t heap_used;
+static size_t heap_peak;
+
+static void *tracked_malloc(size_t size)
+{
+	size_t *block = malloc(sizeof(size_t) + size);
+
+	if (!block) {
+		return NULL;
+	}
+
+	*block = size;
+	heap_used += size;
+	heap_peak = MAX(heap_peak, heap_used);
+
+	return block + 1;
+}
+
+static void tracked_free(void *ptr)
+{
+	size_t *block = ptr;
+
+	if (!block) {
+		return;
+	}
+
+	block--;
+	heap_used -= *block;
+	free(block);
+}
+
+/* Rejected shadow control change: nulls in desired, the device settings in reported */
+static void tree_shadow_ctrl(cJSON *root)
+{
+	cJSON *state = cJSON_AddObjectToObjectCS(root, NRF_CLOUD_JSON_KEY_STATE);
+	cJSON *desired = cJSON_AddObjectToObjectCS(state, NRF_CLOUD_JSON_KEY_DES);
+	cJSON *ctrl = cJSON_AddObjectToObjectCS(desired, NRF_CLOUD_JSON_KEY_CTRL);
+	cJSON *reported;
+
+	cJSON_AddNullToObjectCS(ctrl, NRF_CLOUD_JSON_KEY_ALERT);
+	cJSON_AddNullToObjectCS(ctrl, NRF_CLOUD_JSON_KEY_LOG);
+
+	reported = cJSON_AddObjectToObjectCS(state, NRF_CLOUD_JSON_KEY_REP);
+	ctrl = cJSON_AddObjectToObjectCS(reported, NRF_CLOUD_JSON_KEY_CTRL);
+	cJSON_AddBoolToObjectCS(ctrl, NRF_CLOUD_JSON_KEY_ALERT, true);
+	cJSON_AddNumberToObjectCS(ctrl, NRF_CLOUD_JSON_KEY_LOG, SAMPLE_LOG_LEVEL);
+}
+
+static void writer_shadow_ctrl(struct nrf_cloud_json_writer *w)
+{
+	nrf_cloud_json_writer_obj_start(w, NRF_CLOUD_JSON_KEY_STATE);
+	nrf_cloud_json_writer_obj_start(w, NRF_CLOUD_JSON_KEY_DES);
+	nrf_cloud_json_writer_obj_start(w, NRF_CLOUD_JSON_KEY_CTRL);
+	nrf_cloud_json_writer_null_add(w, NRF_CLOUD_JSON_KEY_ALERT);
+	nrf_cloud_json_writer_null_add(w, NRF_CLOUD_JSON_KEY_LOG);
+	nrf_cloud_json_writer_obj_end(w);
+	nrf_cloud_json_writer_obj_end(w);
+
+	nrf_cloud_json_writer_obj_start(w, NRF_CLOUD_JSON_KEY_REP);
+	nrf_cloud_json_writer_obj_start(w, NRF_CLOUD_JSON_KEY_CTRL);
+	nrf_cloud_json_writer_bool_add(w, NRF_CLOUD_JSON_KEY_ALERT, true);
+	nrf_cloud_json_writer_int_add(w, NRF_CLOUD_JSON_KEY_LOG, SAMPLE_LOG_LEVEL);
+	nrf_cloud_json_writer_obj_end(w);
+	nrf_cloud_json_writer_obj_end(w);
+	nrf_cloud_json_writer_obj_end(w);
+}
+
+/* Builds a message the way the library did before the streaming writer was introduced */
+static char *tree_encode(enum msg_type type)
+{
+	cJSON *root = cJSON_CreateObject();
+	cJSON *data;
+	char *out;
+
+	if (type == MSG_SHADOW_CTRL) {
+		tree_shadow_ctrl(root);
+		goto print;
+	}
+
+	cJSON_AddStringToObjectCS(root, NRF_CLOUD_JSON_APPID_KEY,
+				  type == MSG_PVT ? NRF_CLOUD_JSON_APPID_VAL_GNSS :
+						    NRF_CLOUD_JSON_APPID_VAL_TEMP);
+	cJSON_AddStringToObjectCS(root, NRF_CLOUD_JSON_MSG_TYPE_KEY,
+				  NRF_CLOUD_JSON_MSG_TYPE_VAL_DATA);
+	cJSON_AddNumberToObjectCS(root, NRF_CLOUD_MSG_TIMESTAMP_KEY, SAMPLE_TS);
+
+	switch (type) {
+	case MSG_SENSOR:
+		cJSON_AddStringToObjectCS(root, NRF_CLOUD_JSON_DATA_KEY, SAMPLE_SENSOR_DATA);
+		break;
+	case MSG_PVT:
+		data = cJSON_AddObjectToObject(root, NRF_CLOUD_JSON_DATA_KEY);
+		cJSON_AddNumberToObjectCS(data, NRF_CLOUD_JSON_GNSS_PVT_KEY_LON, pvt.lon);
+		cJSON_AddNumberToObjectCS(data, NRF_CLOUD_JSON_GNSS_PVT_KEY_LAT, pvt.lat);
+		cJSON_AddNumberToObjectCS(data, NRF_CLOUD_JSON_GNSS_PVT_KEY_ACCURACY,
+					  pvt.accuracy);
+		cJSON_AddNumberToObjectCS(data, NRF_CLOUD_JSON_GNSS_PVT_KEY_ALTITUDE, pvt.alt);
+		cJSON_AddNumberToObjectCS(data, NRF_CLOUD_JSON_GNSS_PVT_KEY_SPEED, pvt.speed);
+		cJSON_AddNumberToObjectCS(data, NRF_CLOUD_JSON_GNSS_PVT_KEY_HEADING,
+					  pvt.heading);
+		break;
+	default:
+		cJSON_AddNumberToObjectCS(root, NRF_CLOUD_JSON_DATA_KEY, 23.45);
+		break;
+	}
+
+print:
+	out = cJSON_PrintUnformatted(root);
+	cJSON_Delete(root);
+
+	return out;
+}
+
+static int writer_encode(enum msg_type type, char *buf, size_t size, size_t *len)
+{
+	struct nrf_cloud_json_writer w;
+
+	nrf_cloud_json_writer_init(&w, buf, size);
+	nrf_cloud_json_writer_obj_start(&w, NULL);
+
+	if (type == MSG_SHADOW_CTRL) {
+		writer_shadow_ctrl(&w);
+		goto finish;
+	}
+
+	nrf_cloud_json_writer_str_add(&w, NRF_CLOUD_JSON_APPID_KEY,
+				      type == MSG_PVT ? NRF_CLOUD_JSON_APPID_VAL_GNSS :
+							NRF_CLOUD_JSON_APPID_VAL_TEMP);
+	nrf_cloud_json_writer_str_add(&w, NRF_CLOUD_JSON_MSG_TYPE_KEY,
+				      NRF_CLOUD_JSON_MSG_TYPE_VAL_DATA);
+	nrf_cloud_json_writer_int_add(&w, NRF_CLOUD_MSG_TIMESTAMP_KEY, SAMPLE_TS);
+
+	switch (type) {
+	case MSG_SENSOR:
+		nrf_cloud_json_writer_str_add(&w, NRF_CLOUD_JSON_DATA_KEY, SAMPLE_SENSOR_DATA);
+		break;
+	case MSG_PVT:
+		nrf_cloud_json_writer_obj_start(&w, NRF_CLOUD_JSON_DATA_KEY);
+		nrf_cloud_json_writer_num_add(&w, NRF_CLOUD_JSON_GNSS_PVT_KEY_LON, pvt.lon);
+		nrf_cloud_json_writer_num_add(&w, NRF_CLOUD_JSON_GNSS_PVT_KEY_LAT, pvt.lat);
+		nrf_cloud_json_writer_num_add(&w, NRF_CLOUD_JSON_GNSS_PVT_KEY_ACCURACY,
+					      pvt.accuracy);
+		nrf_cloud_json_writer_num_add(&w, NRF_CLOUD_JSON_GNSS_PVT_KEY_ALTITUDE, pvt.alt);
+		nrf_cloud_json_writer_num_add(&w, NRF_CLOUD_JSON_GNSS_PVT_KEY_SPEED, pvt.speed);
+		nrf_cloud_json_writer_num_add(&w, NRF_CLOUD_JSON_GNSS_PVT_KEY_HEADING,
+					      pvt.heading);
+		nrf_cloud_json_writer_obj_end(&w);
+		break;
+	default:
+		nrf_cloud_json_writer_num_add(&w, NRF_CLOUD_JSON_DATA_KEY, 23.45);
+		break;
+	}
+
+finish:
+	nrf_cloud_json_writer_obj_end(&w);
+
+	return nrf_cloud_json_writer_finish(&w, len);
+}
+
+static void *suite_setup(void)
+{
+	cJSON_Hooks hooks = {
+		.malloc_fn = tracked_malloc,
+		.free_fn = tracked_free,
+	};
+
+	cJSON_InitHooks(&hooks);
+
+	return NULL;
+}
+
+ZTEST(nrf_cloud_json_writer, test_same_as_cjson)
+{
+	char buf[MSG_BUF_SIZE];
+	size_t len;
+	char *expected;
+
+	for (int type = 0; type < MSG_TYPE_COUNT; type++) {
+		expected = tree_encode(type);
+		zassert_not_null(expected);
+		zassert_ok(writer_encode(type, buf, sizeof(buf), &len));
+		zassert_equal(len, strlen(expected));
+		zassert_str_equal(buf, expected);
+		cJSON_free(expected);
+	}
+}
+
+ZTEST(nrf_cloud_json_writer, test_numbers)
+{
+	const double values[] = { 0, -0.0, 1, -17, 2147483647.0, 3e9, 0.1, 1.0 / 3, -1e-7,
+				   1.7976931348623157e308, 63.429199218751229 };
+	struct nrf_cloud_json_writer w;
+	char buf[MSG_BUF_SIZE];
+	char *expected;
+	cJSON *root;
+
+	root = cJSON_CreateObject();
+	nrf_cloud_json_writer_init(&w, buf, sizeof(buf));
+	nrf_cloud_json_writer_obj_start(&w, NULL);
+
+	for (size_t i = 0; i < ARRAY_SIZE(values); i++) {
+		cJSON_AddNumberToObject(root, "n", values[i]);
+		nrf_cloud_json_writer_num_add(&w, "n", values[i]);
+	}
+
+	nrf_cloud_json_writer_obj_end(&w);
+	zassert_ok(nrf_cloud_json_writer_finish(&w, NULL));
+
+	expected = cJSON_PrintUnformatted(root);
+	zassert_str_equal(buf, expected);
+	cJSON_free(expected);
+	cJSON_Delete(root);
+}
+
+ZTEST(nrf_cloud_json_writer, test_string_escape)
+{
+	const char *str = "quote\" backslash\\ /\b\f\n\r\t\x01\x1f \xc3\xa6";
+	struct nrf_cloud_json_writer w;
+	char buf[MSG_BUF_SIZE];
+	char *expected;
+	cJSON *root;
+
+	root = cJSON_CreateObject();
+	cJSON_AddStringToObject(root, str, str);
+	expected = cJSON_PrintUnformatted(root);
+
+	nrf_cloud_json_writer_init(&w, buf, sizeof(buf));
+	nrf_cloud_json_writer_obj_start(&w, NULL);
+	nrf_cloud_json_writer_str_add(&w, str, str);
+	nrf_cloud_json_writer_obj_end(&w);
+	zassert_ok(nrf_cloud_json_writer_finish(&w, NULL));
+	zassert_str_equal(buf, expected);
+
+	cJSON_free(expected);
+	cJSON_Delete(root);
+}
+
+ZTEST(nrf_cloud_json_writer, test_buffer_size)
+{
+	char buf[MSG_BUF_SIZE];
+	size_t needed;
+	size_t len;
+
+	/* Without a buffer, only the length is computed */
+	zassert_ok(writer_encode(MSG_PVT, NULL, 0, &needed));
+
+	/* The NUL terminator does not fit */
+	zassert_equal(writer_encode(MSG_PVT, buf, needed, &len), -E2BIG);
+
+	zassert_ok(writer_encode(MSG_PVT, buf, needed + 1, &len));
+	zassert_equal(len, needed);
+	zassert_equal(strlen(buf), needed);
+}
+
+ZTEST(nrf_cloud_json_writer, test_invalid_nesting)
+{
+	struct nrf_cloud_json_writer w;
+	char buf[MSG_BUF_SIZE];
+
+	/* Members outside of an object */
+	nrf_cloud_json_writer_init(&w, buf, sizeof(buf));
+	nrf_cloud_json_writer_str_add(&w, "key", "value");
+	zassert_equal(nrf_cloud_json_writer_finish(&w, NULL), -EINVAL);
+
+	/* Unterminated object */
+	nrf_cloud_json_writer_init(&w, buf, sizeof(buf));
+	nrf_cloud_json_writer_obj_start(&w, NULL);
+	nrf_cloud_json_writer_obj_start(&w, "nested");
+	nrf_cloud_json_writer_obj_end(&w);
+	zassert_equal(nrf_cloud_json_writer_finish(&w, NULL), -EINVAL);
+
+	/* Too deep */
+	nrf_cloud_json_writer_init(&w, buf, sizeof(buf));
+	nrf_cloud_json_writer_obj_start(&w, NULL);
+	for (int i = 0; i < NRF_CLOUD_JSON_WRITER_DEPTH_MAX; i++) {
+		nrf_cloud_json_writer_obj_start(&w, "nested");
+	}
+	zassert_equal(nrf_cloud_json_writer_finish(&w, NULL), -EINVAL);
+}
+
+ZTEST(nrf_cloud_json_writer, test_benchmark)
+{
+	char buf[MSG_BUF_SIZE];
+	uint32_t start;
+	uint64_t tree_cycles;
+	uint64_t writer_cycles;
+	size_t len;
+	char *out;
+
+	for (int type = 0; type < MSG_TYPE_COUNT; type++) {
+		heap_peak = heap_used;
+		tree_cycles = 0;
+		writer_cycles = 0;
+
+		for (int i = 0; i < BENCHMARK_ROUNDS; i++) {
+			start = k_cycle_get_32();
+			out = tree_encode(type);
+			tree_cycles += k_cycle_get_32() - start;
+			zassert_not_null(out);
+			cJSON_free(out);
+
+			start = k_cycle_get_32();
+			zassert_ok(writer_encode(type, buf, sizeof(buf), &len));
+			writer_cycles += k_cycle_get_32() - start;
+		}
+
+		TC_PRINT("%-8s %3zu bytes: cJSON tree %4zu B heap peak, %6llu ns; "
+			 "writer 0 B heap, %6llu ns\n",
+			 msg_type_str[type], len, heap_peak - heap_used,
+			 k_cyc_to_ns_floor64(tree_cycles / BENCHMARK_ROUNDS),
+			 k_cyc_to_ns_floor64(writer_cycles / BENCHMARK_ROUNDS));
+
+		zassert_equal(heap_used, 0, "cJSON leaked %zu bytes", heap_used);
+		zassert_true(heap_peak > 0);
+	}
+}
+
+ZTEST_SUITE(nrf_cloud_json_writer, NULL, suite_setup, NULL, NULL, NULL);
@@ -0,0 +1,19 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* DUMMY FILE ONLY TO BE USED FOR TESTING */
+#ifndef FLASH_MAP_PM_H_
+#define FLASH_MAP_PM_H_
+
+#include <pm_config.h>
+#include <zephyr/device.h>
+
+extern const struct device pgps_test_flash;
+
+#define FLASH_AREA_ID(label) PM_##label##_ID
+#define FLASH_AREA_DEVICE(label) (&pgps_test_flash)
+
+#endif /* FLASH_MAP_PM_H_ */
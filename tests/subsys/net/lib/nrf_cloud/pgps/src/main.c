@@ -0,0 +1,489 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <zephyr/fff.h>
+#include <zephyr/ztest.h>
+#include <zephyr/storage/stream_flash.h>
+#include <zephyr/storage/flash_map.h>
+#include <zephyr/settings/settings.h>
+#include <zephyr/sys/iterable_sections.h>
+#include <date_time.h>
+#include <flash_map_pm.h>
+#include <net/nrf_cloud_agnss.h>
+#include <net/nrf_cloud_pgps.h>
+#include <nrf_cloud_fsm.h>
+#include <nrf_cloud_download.h>
+#include <nrf_cloud_pgps_schema_v1.h>
+#include <nrf_cloud_pgps_utils.h>
+
+DEFINE_FFF_GLOBALS;
+
+#define PAGE_SIZE         4096
+#define PERIOD_MIN        240
+#define FIRST_GPS_DAY     16000
+#define DL_SIZE           (sizeof(struct nrf_cloud_pgps_header) + \
+			   NUM_PREDICTIONS * PGPS_PREDICTION_DL_SIZE)
+#define SETTINGS_MAX      4
+#define BLOCK_INDEX_KEY   "nrf_cloud_pgps/block_index"
+
+FAKE_VALUE_FUNC(uint32_t, nrfx_nvmc_flash_page_size_get);
+FAKE_VALUE_FUNC(int, flash_area_open, uint8_t, const struct flash_area **);
+FAKE_VALUE_FUNC(int, stream_flash_init, struct stream_flash_ctx *, const struct device *,
+		uint8_t *, size_t, size_t, size_t, stream_flash_callback_t);
+FAKE_VALUE_FUNC(int, stream_flash_buffered_write, struct stream_flash_ctx *, const uint8_t *,
+		size_t, bool);
+FAKE_VALUE_FUNC(void *, nrf_cloud_malloc, size_t);
+FAKE_VALUE_FUNC(int, date_time_now, int64_t *);
+FAKE_VALUE_FUNC(int, settings_subsys_init);
+FAKE_VALUE_FUNC(int, settings_load_subtree, const char *);
+FAKE_VALUE_FUNC(int, settings_save_one, const char *, const void *, size_t);
+FAKE_VALUE_FUNC(int, downloader_init, struct downloader *, struct downloader_cfg *);
+FAKE_VALUE_FUNC(int, downloader_cancel, struct downloader *);
+FAKE_VALUE_FUNC(int, nrf_cloud_download_start, struct nrf_cloud_download_data *const);
+FAKE_VOID_FUNC(nrf_cloud_download_end);
+FAKE_VALUE_FUNC(int, nrf_cloud_agnss_process, const char *, size_t);
+FAKE_VOID_FUNC(nrf_cloud_agnss_processed, struct nrf_modem_gnss_agnss_data_frame *);
+FAKE_VALUE_FUNC(enum nfsm_state, nfsm_get_current_state);
+
+const struct device pgps_test_flash = {
+	.name = "pgps_test_flash",
+};
+
+static const struct flash_area pgps_test_area = {
+	.fa_id = PM_APP_ID,
+	.fa_dev = &pgps_test_flash,
+};
+
+/* Predictions are stored in RAM, which the library accesses like internal flash */
+static uint8_t storage[NUM_PREDICTIONS * BLOCK_SIZE] __aligned(PAGE_SIZE);
+static uint8_t *stream_pos;
+static uint8_t *stream_end;
+static uint8_t page_buf[PAGE_SIZE];
+
+/* Prediction set as downloaded, and as the library stored it before predictions were
+ * written to flash while being downloaded.
+ */
+static uint8_t download[DL_SIZE];
+static uint8_t expected[NUM_PREDICTIONS * BLOCK_SIZE];
+static uint16_t gps_day;
+
+/* Settings storage in RAM, which is kept when the library is initialized again */
+static struct {
+	char key[32];
+	uint8_t value[NUM_BLOCKS * sizeof(uint32_t)];
+	size_t len;
+} settings_store[SETTINGS_MAX];
+static int block_index_saves;
+
+static int available_count;
+static int ready_count;
+static int request_count;
+static uint16_t requested;
+static struct nrf_cloud_pgps_prediction *available;
+
+static int flash_area_open_custom(uint8_t id, const struct flash_area **fa)
+{
+	zassert_equal(id, PM_APP_ID);
+	*fa = &pgps_test_area;
+
+	return 0;
+}
+
+static int stream_flash_init_custom(struct stream_flash_ctx *ctx, const struct device *fdev,
+				    uint8_t *buf, size_t buf_len, size_t offset, size_t size,
+				    stream_flash_callback_t cb)
+{
+	uint8_t *start = (uint8_t *)(uintptr_t)offset;
+
+	zassert_equal(fdev, &pgps_test_flash);
+	zassert_true((start >= storage) && (start + size <= storage + sizeof(storage)));
+
+	stream_pos = start;
+	stream_end = start + size;
+
+	return 0;
+}
+
+static int stream_flash_buffered_write_custom(struct stream_flash_ctx *ctx, const uint8_t *data,
+					      size_t len, bool flush)
+{
+	if (len) {
+		zassert_true(stream_pos + len <= stream_end);
+		memcpy(stream_pos, data, len);
+		stream_pos += len;
+	}
+
+	return 0;
+}
+
+static void *nrf_cloud_malloc_custom(size_t size)
+{
+	zassert_true(size <= sizeof(page_buf));
+
+	return page_buf;
+}
+
+/* One hour into the first prediction of the current set */
+static int date_time_now_custom(int64_t *unix_time_ms)
+{
+	int64_t gps_sec = (int64_t)gps_day * SEC_PER_DAY + SEC_PER_HOUR;
+
+	*unix_time_ms = (gps_sec - GPS_TO_UTC_LEAP_SECONDS + GPS_TO_UNIX_UTC_OFFSET_SECONDS) *
+			MSEC_PER_SEC;
+
+	return 0;
+}
+
+static int settings_save_one_custom(const char *name, const void *value, size_t val_len)
+{
+	int i;
+
+	zassert_true(val_len <= sizeof(settings_store[0].value));
+
+	for (i = 0; i < SETTINGS_MAX; i++) {
+		if ((settings_store[i].key[0] == '\0') ||
+		    (strcmp(settings_store[i].key, name) == 0)) {
+			break;
+		}
+	}
+	zassert_true(i < SETTINGS_MAX);
+
+	strncpy(settings_store[i].key, name, sizeof(settings_store[i].key) - 1);
+	memcpy(settings_store[i].value, value, val_len);
+	settings_store[i].len = val_len;
+
+	if (strcmp(name, BLOCK_INDEX_KEY) == 0) {
+		block_index_saves++;
+	}
+
+	return 0;
+}
+
+static ssize_t settings_store_read(void *cb_arg, void *data, size_t len)
+{
+	int i = POINTER_TO_INT(cb_arg);
+
+	len = MIN(len, settings_store[i].len);
+	memcpy(data, settings_store[i].value, len);
+
+	return len;
+}
+
+static int settings_load_subtree_custom(const char *subtree)
+{
+	size_t prefix_len = strlen(subtree);
+
+	STRUCT_SECTION_FOREACH(settings_handler_static, handler) {
+		if (strcmp(handler->name, subtree) != 0) {
+			continue;
+		}
+
+		for (int i = 0; i < SETTINGS_MAX; i++) {
+			const char *key = settings_store[i].key;
+
+			if ((strncmp(key, subtree, prefix_len) == 0) && (key[prefix_len] == '/')) {
+				handler->h_set(&key[prefix_len + 1], settings_store[i].len,
+					       settings_store_read, INT_TO_POINTER(i));
+			}
+		}
+	}
+
+	return 0;
+}
+
+static uint32_t *saved_block_index(void)
+{
+	for (int i = 0; i < SETTINGS_MAX; i++) {
+		if (strcmp(settings_store[i].key, BLOCK_INDEX_KEY) == 0) {
+			zassert_equal(settings_store[i].len, NUM_BLOCKS * sizeof(uint32_t));
+			return (uint32_t *)settings_store[i].value;
+		}
+	}
+
+	zassert_unreachable("Block index not saved");
+	return NULL;
+}
+
+static void pgps_event_handler(struct nrf_cloud_pgps_event *event)
+{
+	switch (event->type) {
+	case PGPS_EVT_AVAILABLE:
+		available = event->prediction;
+		available_count++;
+		break;
+	case PGPS_EVT_READY:
+		ready_count++;
+		break;
+	case PGPS_EVT_REQUEST:
+		requested = event->request->prediction_count;
+		request_count++;
+		break;
+	default:
+		break;
+	}
+}
+
+static uint32_t prediction_sentinel(int pnum)
+{
+	return (uint32_t)((int64_t)gps_day * SEC_PER_DAY + pnum * PERIOD_MIN * SEC_PER_MIN);
+}
+
+/* Create the next set of predictions, starting a week after the previous one, so that each
+ * set updates the block index.
+ */
+static void new_prediction_set(void)
+{
+	struct nrf_cloud_pgps_header *header = (struct nrf_cloud_pgps_header *)download;
+	uint8_t *dl = download + sizeof(*header);
+
+	gps_day = gps_day ? gps_day + DAYS_PER_WEEK : FIRST_GPS_DAY;
+
+	header->schema_version = NRF_CLOUD_PGPS_BIN_SCHEMA_VERSION;
+	header->array_type = NRF_CLOUD_PGPS_PREDICTION_HEADER;
+	header->num_items = 1;
+	header->prediction_count = NUM_PREDICTIONS;
+	header->prediction_size = PGPS_PREDICTION_DL_SIZE;
+	header->prediction_period_min = PERIOD_MIN;
+	header->gps_day = gps_day;
+	header->gps_time_of_day = 0;
+
+	memset(expected, 0xff, sizeof(expected));
+
+	for (int pnum = 0; pnum < NUM_PREDICTIONS; pnum++) {
+		struct nrf_cloud_pgps_prediction *p =
+			(struct nrf_cloud_pgps_prediction *)&expected[pnum * BLOCK_SIZE];
+		uint32_t sentinel = prediction_sentinel(pnum);
+		struct pgps_prediction_head head = {
+			.time_type = NRF_CLOUD_AGNSS_GPS_SYSTEM_CLOCK,
+			.time_count = 1,
+			.time = {
+				.date_day = sentinel / SEC_PER_DAY,
+				.time_full_s = sentinel % SEC_PER_DAY,
+			},
+			.ephemeris_type = NRF_CLOUD_AGNSS_GPS_EPHEMERIDES,
+			.ephemeris_count = NRF_CLOUD_PGPS_NUM_SV,
+		};
+
+		memcpy(dl, &head, sizeof(head));
+		dl += sizeof(head);
+
+		p->time_type = head.time_type;
+		p->time_count = head.time_count;
+		p->time = head.time;
+		p->schema_version = NRF_CLOUD_AGNSS_BIN_SCHEMA_VERSION;
+		p->ephemeris_type = head.ephemeris_type;
+		p->ephemeris_count = head.ephemeris_count;
+
+		for (int sv = 0; sv < NRF_CLOUD_PGPS_NUM_SV; sv++) {
+			struct nrf_cloud_agnss_ephemeris *eph = &p->ephemerii[sv];
+			uint8_t *eph_data = (uint8_t *)eph;
+
+			/* One satellite per prediction has no ephemeris */
+			for (size_t i = 0; i < sizeof(*eph); i++) {
+				eph_data[i] = (sv == pnum % NRF_CLOUD_PGPS_NUM_SV) ? 0 : rand();
+			}
+			eph->sv_id = sv + 1;
+
+			memcpy(dl, eph, sizeof(*eph));
+			dl += sizeof(*eph);
+
+			if (sv == pnum % NRF_CLOUD_PGPS_NUM_SV) {
+				eph->health = NRF_CLOUD_PGPS_EMPTY_EPHEM_HEALTH;
+			}
+		}
+
+		p->sentinel = sentinel;
+	}
+
+	zassert_equal(dl, download + sizeof(download));
+}
+
+static void pgps_init(void)
+{
+	struct nrf_cloud_pgps_init_param param = {
+		.event_handler = pgps_event_handler,
+		.storage_base = (uint32_t)(uintptr_t)storage,
+		.storage_size = sizeof(storage),
+	};
+
+	zassert_ok(nrf_cloud_pgps_init(&param));
+}
+
+/* Pass the downloaded set to the library in fragments of up to max_fragment bytes,
+ * or all at once if max_fragment is 0.
+ */
+static void pgps_load(size_t max_fragment)
+{
+	static uint8_t fragment[DL_SIZE];
+	size_t offset = 0;
+	size_t len;
+
+	zassert_equal(request_count, 1);
+	zassert_equal(requested, NUM_PREDICTIONS);
+
+	block_index_saves = 0;
+	zassert_ok(nrf_cloud_pgps_begin_update());
+
+	while (offset < sizeof(download)) {
+		if (max_fragment) {
+			len = 1 + rand() % max_fragment;
+		} else {
+			len = sizeof(download);
+		}
+		if (offset == 0) {
+			/* The library needs the whole header in the first fragment */
+			len = MAX(len, sizeof(struct nrf_cloud_pgps_header));
+		}
+		len = MIN(len, sizeof(download) - offset);
+
+		/* The download buffer is reused for the next fragment */
+		memcpy(fragment, &download[offset], len);
+		memset(&fragment[len], 0xaa, sizeof(fragment) - len);
+
+		zassert_ok(nrf_cloud_pgps_process_update(fragment, len));
+		offset += len;
+	}
+
+	zassert_ok(nrf_cloud_pgps_finish_update());
+	zassert_equal(ready_count, 1);
+}
+
+/* Start on blank flash with a new set of predictions, which the library requests */
+static void pgps_request(void)
+{
+	nrf_cloud_pgps_request_reset();
+	memset(storage, 0xff, sizeof(storage));
+	new_prediction_set();
+
+	available_count = 0;
+	ready_count = 0;
+	request_count = 0;
+	requested = 0;
+
+	pgps_init();
+}
+
+static void check_block_index(void)
+{
+	const uint32_t *saved_index = saved_block_index();
+
+	for (int i = 0; i < NUM_BLOCKS; i++) {
+		zassert_equal(npgps_get_block_sentinel(i), prediction_sentinel(i),
+			      "block %d", i);
+		zassert_equal(saved_index[i], prediction_sentinel(i), "block %d", i);
+	}
+}
+
+static void before_each(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	RESET_FAKE(nrfx_nvmc_flash_page_size_get);
+	RESET_FAKE(flash_area_open);
+	RESET_FAKE(stream_flash_init);
+	RESET_FAKE(stream_flash_buffered_write);
+	RESET_FAKE(nrf_cloud_malloc);
+	RESET_FAKE(date_time_now);
+	RESET_FAKE(settings_subsys_init);
+	RESET_FAKE(settings_load_subtree);
+	RESET_FAKE(settings_save_one);
+
+	nrfx_nvmc_flash_page_size_get_fake.return_val = PAGE_SIZE;
+	flash_area_open_fake.custom_fake = flash_area_open_custom;
+	stream_flash_init_fake.custom_fake = stream_flash_init_custom;
+	stream_flash_buffered_write_fake.custom_fake = stream_flash_buffered_write_custom;
+	nrf_cloud_malloc_fake.custom_fake = nrf_cloud_malloc_custom;
+	date_time_now_fake.custom_fake = date_time_now_custom;
+	settings_load_subtree_fake.custom_fake = settings_load_subtree_custom;
+	settings_save_one_fake.custom_fake = settings_save_one_custom;
+
+	srand(1);
+	pgps_request();
+}
+
+ZTEST(nrf_cloud_pgps, test_index_saved)
+{
+	pgps_load(0);
+	zassert_mem_equal(storage, expected, sizeof(storage));
+	zassert_equal(block_index_saves, 1);
+	check_block_index();
+
+	/* All predictions are found through the index, which does not change */
+	request_count = 0;
+	block_index_saves = 0;
+	pgps_init();
+
+	zassert_equal(request_count, 0);
+	zassert_equal(available_count, 1);
+	zassert_equal_ptr(available, storage);
+	zassert_equal(block_index_saves, 0);
+}
+
+ZTEST(nrf_cloud_pgps, test_index_mismatch)
+{
+	uint32_t *saved_index;
+
+	pgps_load(0);
+
+	/* Entries that do not match the stored predictions are not trusted */
+	saved_index = saved_block_index();
+	saved_index[0] = prediction_sentinel(1);
+	saved_index[1] = prediction_sentinel(0);
+
+	request_count = 0;
+	block_index_saves = 0;
+	pgps_init();
+
+	zassert_equal(request_count, 0);
+	zassert_equal(available_count, 1);
+	zassert_equal_ptr(available, storage);
+
+	/* The index is corrected once the predictions have been validated */
+	zassert_equal(block_index_saves, 1);
+	check_block_index();
+}
+
+ZTEST(nrf_cloud_pgps, test_index_interrupted)
+{
+	struct nrf_cloud_pgps_prediction *p =
+		(struct nrf_cloud_pgps_prediction *)&storage[5 * BLOCK_SIZE];
+
+	pgps_load(0);
+
+	/* The index is ignored for a prediction whose sentinel was not written */
+	p->sentinel = UINT32_MAX;
+
+	request_count = 0;
+	pgps_init();
+
+	zassert_equal(request_count, 1);
+	zassert_equal(requested, NUM_PREDICTIONS - 5);
+}
+
+ZTEST(nrf_cloud_pgps, test_fragmented_download)
+{
+	static const size_t max_fragments[] = {
+		1, 7, 64, 700, 1500, 3 * PGPS_PREDICTION_DL_SIZE
+	};
+
+	pgps_load(0);
+	zassert_mem_equal(storage, expected, sizeof(storage));
+	check_block_index();
+
+	/* Elements of predictions split across fragments are stored the same way */
+	for (int i = 0; i < ARRAY_SIZE(max_fragments); i++) {
+		pgps_request();
+		pgps_load(max_fragments[i]);
+
+		zassert_mem_equal(storage, expected, sizeof(storage),
+				  "max fragment %zu", max_fragments[i]);
+		check_block_index();
+	}
+}
+
+ZTEST_SUITE(nrf_cloud_pgps, NULL, NULL, before_each, NULL, NULL);
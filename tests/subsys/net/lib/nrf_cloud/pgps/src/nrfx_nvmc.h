@@ -0,0 +1,12 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* DUMMY FILE ONLY TO BE USED FOR TESTING */
+#ifndef NRFX_NVMC_H__
+#define NRFX_NVMC_H__
+#include <stdint.h>
+uint32_t nrfx_nvmc_flash_page_size_get(void);
+#endif /* NRFX_NVMC_H__ */
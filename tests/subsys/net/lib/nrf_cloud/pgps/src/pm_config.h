@@ -0,0 +1,11 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* DUMMY FILE ONLY TO BE USED FOR TESTING */
+#ifndef PM_CONFIG_H__
+#define PM_CONFIG_H__
+#define PM_APP_ID 0
+#endif /* PM_CONFIG_H__ */
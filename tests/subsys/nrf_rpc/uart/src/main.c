@@ -0,0 +1,234 @@
+/*
+ * Copyright (c) 2025 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <nrf_rpc/nrf_rpc_uart.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/drivers/serial/uart_emul.h>
+#include <zephyr/sys/byteorder.h>
+#include <zephyr/ztest.h>
+
+#include <string.h>
+
+#define RPC_UART_NODE DT_NODELABEL(rpc_uart)
+
+/* Bytes moved from the TX to the RX side of the emulated link per millisecond (~1 Mbaud) */
+#define LINK_BYTES_PER_MS   100
+#define LINK_CHUNK_SIZE	    64
+/* Skips acknowledgments that may still be in flight */
+#define LINK_CORRUPT_OFFSET 32
+
+#define PACKET_HDR_SIZE	  sizeof(uint32_t)
+#define PACKET_MAX_SIZE	  256
+#define BENCHMARK_PACKETS 100
+#define RECEIVE_TIMEOUT	  K_SECONDS(5)
+
+static const struct device *const uart_dev = DEVICE_DT_GET(RPC_UART_NODE);
+static const struct nrf_rpc_tr *const transport = &NRF_RPC_UART_TRANSPORT(RPC_UART_NODE);
+
+static K_SEM_DEFINE(rx_sem, 0, K_SEM_MAX_LIMIT);
+static uint32_t rx_expected;
+static uint32_t rx_errors;
+
+static size_t link_bytes;
+static size_t link_corrupt_at = SIZE_MAX;
+
+/* The transport is connected to itself: the frames and the acknowledgments it writes are
+ * delivered back to it through the emulated link, at the modeled rate.
+ */
+static void link_work_handler(struct k_work *work)
+{
+	struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+	uint8_t chunk[LINK_CHUNK_SIZE];
+	size_t budget = LINK_BYTES_PER_MS;
+	uint32_t len;
+
+	while (budget > 0) {
+		len = uart_emul_get_tx_data(uart_dev, chunk, MIN(budget, sizeof(chunk)));
+		if (len == 0) {
+			break;
+		}
+
+		if (link_corrupt_at >= link_bytes && link_corrupt_at < link_bytes + len) {
+			uint8_t *byte = &chunk[link_corrupt_at - link_bytes];
+
+			/* Do not turn the byte into a delimiter, to only break the frame CRC. */
+			*byte ^= ((*byte ^ 0x01) == 0x7e || (*byte ^ 0x01) == 0x7d) ? 0x04 : 0x01;
+			link_corrupt_at = SIZE_MAX;
+		}
+
+		link_bytes += len;
+		budget -= len;
+		uart_emul_put_rx_data(uart_dev, chunk, len);
+	}
+
+	k_work_schedule(dwork, K_MSEC(1));
+}
+
+static K_WORK_DELAYABLE_DEFINE(link_work, link_work_handler);
+
+static void rx_thread_find(const struct k_thread *thread, void *user_data)
+{
+	const struct k_thread **rx_thread = user_data;
+
+	if (strcmp(k_thread_name_get((k_tid_t)thread), "rpc uart rx") == 0) {
+		*rx_thread = thread;
+	}
+}
+
+/* Returns the number of cycles spent by the transport RX thread so far. */
+static uint64_t rx_thread_cycles(void)
+{
+	const struct k_thread *rx_thread = NULL;
+	k_thread_runtime_stats_t stats;
+
+	k_thread_foreach(rx_thread_find, &rx_thread);
+	zassert_not_null(rx_thread);
+	zassert_ok(k_thread_runtime_stats_get((k_tid_t)rx_thread, &stats));
+
+	return stats.execution_cycles;
+}
+
+static size_t packet_len(uint32_t index)
+{
+	return PACKET_HDR_SIZE + 1 + (index * 37) % (PACKET_MAX_SIZE - PACKET_HDR_SIZE);
+}
+
+static void receive_handler(const struct nrf_rpc_tr *tr, const uint8_t *data, size_t len,
+			    void *context)
+{
+	uint32_t index;
+
+	if (len < PACKET_HDR_SIZE) {
+		rx_errors++;
+		goto out;
+	}
+
+	index = sys_get_le32(data);
+
+	if (index != rx_expected || len != packet_len(index)) {
+		rx_errors++;
+		goto out;
+	}
+
+	for (size_t i = PACKET_HDR_SIZE; i < len; i++) {
+		/* The pattern contains HDLC delimiters and escape bytes. */
+		if (data[i] != (uint8_t)(index + i)) {
+			rx_errors++;
+			goto out;
+		}
+	}
+
+	rx_expected++;
+
+out:
+	k_sem_give(&rx_sem);
+}
+
+static int packet_send(uint32_t index)
+{
+	size_t len = packet_len(index);
+	uint8_t *data = transport->api->tx_buf_alloc(transport, &len);
+
+	sys_put_le32(index, data);
+
+	for (size_t i = PACKET_HDR_SIZE; i < len; i++) {
+		data[i] = (uint8_t)(index + i);
+	}
+
+	return transport->api->send(transport, data, len);
+}
+
+static void packets_receive(uint32_t count)
+{
+	for (uint32_t i = 0; i < count; i++) {
+		zassert_ok(k_sem_take(&rx_sem, RECEIVE_TIMEOUT), "Packet not received");
+	}
+
+	zassert_equal(rx_errors, 0, "Received %u invalid packets", rx_errors);
+}
+
+static void *suite_setup(void)
+{
+	zassert_true(device_is_ready(uart_dev));
+	zassert_ok(transport->api->init(transport, receive_handler, NULL));
+	k_work_schedule(&link_work, K_MSEC(1));
+
+	return NULL;
+}
+
+static void before_each(void *f)
+{
+	ARG_UNUSED(f);
+
+	k_sem_reset(&rx_sem);
+	rx_errors = 0;
+}
+
+ZTEST(nrf_rpc_uart, test_send_receive)
+{
+	uint32_t first = rx_expected;
+
+	for (uint32_t i = 0; i < 20; i++) {
+		zassert_ok(packet_send(first + i));
+	}
+
+	packets_receive(20);
+	zassert_equal(rx_expected, first + 20);
+}
+
+ZTEST(nrf_rpc_uart, test_retransmission)
+{
+	uint32_t first = rx_expected;
+
+	Z_TEST_SKIP_IFNDEF(CONFIG_NRF_RPC_UART_RELIABLE);
+
+	/* Break the CRC of one of the next frames, so that it is not acknowledged. */
+	link_corrupt_at = link_bytes + LINK_CORRUPT_OFFSET;
+
+	for (uint32_t i = 0; i < 5; i++) {
+		zassert_ok(packet_send(first + i));
+	}
+
+	packets_receive(5);
+	zassert_equal(rx_expected, first + 5);
+	zassert_equal(k_sem_count_get(&rx_sem), 0, "Duplicate packet delivered");
+}
+
+ZTEST(nrf_rpc_uart, test_throughput)
+{
+	uint32_t first = rx_expected;
+	int64_t send_time = 0;
+	int64_t start;
+	int64_t elapsed;
+	uint64_t rx_cycles;
+	size_t bytes = 0;
+
+	start = k_uptime_get();
+	rx_cycles = rx_thread_cycles();
+
+	for (uint32_t i = 0; i < BENCHMARK_PACKETS; i++) {
+		int64_t send_start = k_uptime_get();
+
+		zassert_ok(packet_send(first + i));
+		send_time += k_uptime_get() - send_start;
+		bytes += packet_len(first + i);
+	}
+
+	packets_receive(BENCHMARK_PACKETS);
+	elapsed = MAX(k_uptime_get() - start, 1);
+	rx_cycles = rx_thread_cycles() - rx_cycles;
+
+	TC_PRINT("TX window %d: %u packets, %zu bytes in %lld ms, %lld B/s, %lld us per send\n",
+		 CONFIG_NRF_RPC_UART_TX_WINDOW_SIZE, BENCHMARK_PACKETS, bytes, elapsed,
+		 (int64_t)bytes * MSEC_PER_SEC / elapsed,
+		 send_time * USEC_PER_MSEC / BENCHMARK_PACKETS);
+	TC_PRINT("RX %s: %llu cycles, %llu cycles per 100 bytes\n",
+		 IS_ENABLED(CONFIG_NRF_RPC_UART_RX_IN_PLACE) ? "in place" : "copied", rx_cycles,
+		 rx_cycles * 100 / bytes);
+}
+
+ZTEST_SUITE(nrf_rpc_uart, NULL, suite_setup, before_each, NULL, NULL);